@@ -125,6 +125,43 @@ PROJECTM_EXPORT void projectm_load_preset_file(projectm_handle instance, const c
 PROJECTM_EXPORT void projectm_load_preset_data(projectm_handle instance, const char* data,
                                                bool smooth_transition);
 
+/**
+ * @brief Loads a precompiled preset bundle.
+ *
+ * Preset bundles (.milkc files) are created with the projectM-preset-compiler tool from a directory
+ * of .milk files. After loading a bundle, all presets it contains are created from the precompiled
+ * data when loaded via projectm_load_preset_file(), which is considerably faster than parsing the
+ * preset files. Preset paths are matched relative to the directory containing the bundle file.
+ *
+ * If a preset file was modified after the bundle was compiled, it is loaded from source instead.
+ * Multiple bundles can be loaded, they're searched in the order they were added.
+ *
+ * @param instance The projectM instance handle.
+ * @param filename The bundle file to load.
+ * @return True if the bundle was loaded successfully, false if an error occurred.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT bool projectm_load_preset_bundle(projectm_handle instance, const char* filename);
+
+/**
+ * @brief Lists all files with the given extension in a directory or zip archive.
+ *
+ * If the path points to a zip archive, the returned file names are virtual paths consisting of
+ * the archive path followed by the path inside the archive, e.g. "presets.zip/Geiss/Reaction.milk".
+ * These can be passed to projectm_load_preset_file() directly, textures are also loaded from
+ * archives added to the texture search paths. The archive index is only built once and cached
+ * until the archive file is modified.
+ *
+ * @param path The directory or zip archive to list.
+ * @param extension The file extension to match case-insensitively, including the dot, e.g. ".milk".
+ *                  If NULL or empty, all files are returned.
+ * @param recursive If true, files in subdirectories are also returned.
+ * @return A NULL-terminated array of file names, which must be freed with projectm_free_string_array().
+ *         Returns NULL if the path is neither a directory nor a readable zip archive.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT char** projectm_list_files(const char* path, const char* extension, bool recursive);
+
 /**
  * @brief Reloads all textures.
  *
@@ -52,6 +52,149 @@ extern "C" {
  */
 PROJECTM_EXPORT void projectm_write_debug_image_on_next_frame(projectm_handle instance, const char* output_file);
 
+/**
+ * @brief Returns the number of OpenGL state changes made while rendering the last frame.
+ *
+ * projectM tracks bound programs, vertex arrays, textures, samplers, framebuffers and the blend
+ * state while rendering a frame, and skips any state change which wouldn't have an effect. The
+ * counts can be used to measure the rendering overhead of presets.
+ *
+ * @param instance The projectM instance handle.
+ * @param[out] issued Receives the number of state changes sent to OpenGL. Can be NULL.
+ * @param[out] elided Receives the number of redundant state changes which were skipped. Can be NULL.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT void projectm_get_gl_state_change_counts(projectm_handle instance, uint32_t* issued, uint32_t* elided);
+
+/**
+ * @brief Returns the number of render passes run and skipped while rendering the last frame.
+ * Preset render passes which wouldn't change the output image, e.g. fully transparent borders or
+ * unused blur levels, are culled. During a transition, the passes of both presets are counted.
+ * @param instance The projectM instance handle.
+ * @param[out] executed Receives the number of render passes which were run. Can be NULL.
+ * @param[out] culled Receives the number of render passes which were skipped. Can be NULL.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT void projectm_get_render_pass_counts(projectm_handle instance, uint32_t* executed, uint32_t* culled);
+
+/**
+ * @brief Returns the names of the render passes skipped while rendering the last frame.
+ * The names are separated by commas, e.g. "motion_vectors,border". The string is empty if no pass
+ * was skipped.
+ * @param instance The projectM instance handle.
+ * @return The comma-separated pass names. Must be freed with projectm_free_string() after use.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT char* projectm_get_culled_render_passes(projectm_handle instance);
+
+/**
+ * @brief Returns the occupancy of the render target texture pool.
+ *
+ * Presets lease their framebuffer images, motion vector maps and blur textures from a pool shared
+ * by all presets of an instance, and return them when they are destroyed or resized. Unused
+ * textures are kept for the next preset as long as the current presets use textures with the same
+ * size and format, and are deleted after a few frames otherwise.
+ *
+ * @param instance The projectM instance handle.
+ * @param[out] statistics Receives the pool statistics.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT void projectm_get_texture_pool_statistics(projectm_handle instance, projectm_texture_pool_statistics* statistics);
+
+/**
+ * @brief Enables or disables measuring the costs of each render pass.
+ *
+ * If enabled, the GPU time, draw calls and OpenGL state changes of each render pass are recorded.
+ * GPU times are measured with timestamp queries, which are read back a few frames later to avoid
+ * stalling the GPU. If the OpenGL context doesn't support timestamp queries, only draw calls and
+ * state changes are recorded.
+ *
+ * Profiling is disabled by default and has no overhead while disabled. Disabling it discards all
+ * recorded timings.
+ *
+ * @param instance The projectM instance handle.
+ * @param enabled True to enable render pass profiling, false to disable it.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT void projectm_set_gpu_profiling_enabled(projectm_handle instance, bool enabled);
+
+/**
+ * @brief Returns whether render pass profiling is enabled.
+ * @param instance The projectM instance handle.
+ * @return True if render pass profiling is enabled, false otherwise.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT bool projectm_get_gpu_profiling_enabled(projectm_handle instance);
+
+/**
+ * @brief Returns the render pass costs of the most recent profiled frames.
+ *
+ * Timings are returned oldest frame first, and in render order within each frame. During a
+ * transition, the passes of the incoming preset are followed by those of the outgoing preset.
+ * The last few rendered frames are not included until their GPU times are available. Up to 120
+ * frames are kept.
+ *
+ * Call this function with a NULL timings pointer to query the number of available timings.
+ *
+ * @param instance The projectM instance handle.
+ * @param frame_count The maximum number of frames to return timings for.
+ * @param[out] timings An array receiving up to max_timings pass timings, or NULL.
+ * @param max_timings The number of elements in the timings array.
+ * @return The number of pass timings available for the requested frames, which may be larger than max_timings.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT size_t projectm_get_render_pass_timings(projectm_handle instance, uint32_t frame_count,
+                                                        projectm_render_pass_timing* timings, size_t max_timings);
+
+/**
+ * @brief Returns the CPU costs of the last rendered frame.
+ *
+ * The record time covers evaluating the per-pixel mesh, custom waveform and custom shape code and
+ * recording their drawing commands. With deferred command recording, this work runs on a worker
+ * thread while the rendering thread submits the commands of the previous components, and the wait
+ * time shows how long the rendering thread was blocked by the worker.
+ *
+ * @param instance The projectM instance handle.
+ * @param[out] statistics Receives the frame statistics.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT void projectm_get_frame_cpu_statistics(projectm_handle instance, projectm_frame_cpu_statistics* statistics);
+
+/**
+ * @brief Enables or disables recording CPU trace events in all projectM instances.
+ *
+ * Trace events measure the CPU time spent in the main stages of libprojectM, e.g. audio analysis,
+ * per-frame and per-pixel expressions, custom waveforms and shapes, preset loading and shader
+ * compilation. Events are only recorded if libprojectM was built with the ENABLE_TRACING CMake
+ * option. Otherwise, the trace markers aren't compiled in and no events are recorded.
+ *
+ * Tracing is disabled by default. While disabled, each trace marker only costs a single flag check.
+ * Recorded events are kept when disabling tracing.
+ *
+ * @param enabled True to record trace events, false to stop recording.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT void projectm_set_tracing_enabled(bool enabled);
+
+/**
+ * @brief Returns whether CPU trace events are recorded.
+ * @return True if tracing is enabled, false otherwise.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT bool projectm_get_tracing_enabled();
+
+/**
+ * @brief Returns the recorded CPU trace events in the Chrome trace event JSON format.
+ *
+ * The result can be saved to a file and loaded into chrome://tracing or the Perfetto UI. Each
+ * thread keeps its most recent 16384 events.
+ *
+ * @param seconds Only events which ended within this many seconds before the call are returned.
+ * @return A JSON string with the trace events. Must be freed with projectm_free_string() after use.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT char* projectm_get_trace_json(double seconds);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -55,6 +55,16 @@ PROJECTM_EXPORT char* projectm_alloc_string(unsigned int length);
  */
 PROJECTM_EXPORT void projectm_free_string(const char* str);
 
+/**
+ * @brief Frees a NULL-terminated array of strings returned by a projectM API call.
+ *
+ * Frees all strings in the array and the array itself.
+ *
+ * @param array The array of strings to free.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT void projectm_free_string_array(char** array);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
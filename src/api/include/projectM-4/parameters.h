@@ -394,6 +394,219 @@ PROJECTM_EXPORT void projectm_set_preset_start_clean(projectm_handle instance, b
  */
 PROJECTM_EXPORT bool projectm_get_preset_start_clean(projectm_handle instance);
 
+/**
+ * @brief Sets the resolution at which the outgoing preset is rendered during a soft transition.
+ *
+ * While transitioning, both presets are rendered each frame. Rendering the outgoing preset at a
+ * lower resolution reduces the cost of transition frames. Its image is upscaled when blending it
+ * with the incoming preset, which is always rendered at full resolution.
+ *
+ * @param instance The projectM instance handle.
+ * @param scale The outgoing preset's resolution relative to the viewport size. Values are clamped
+ *              to the range 0.1 to 1.0. Default: 1.0
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT void projectm_set_transition_outgoing_scale(projectm_handle instance, float scale);
+
+/**
+ * @brief Returns the resolution at which the outgoing preset is rendered during a soft transition.
+ * @param instance The projectM instance handle.
+ * @return The outgoing preset's resolution relative to the viewport size.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT float projectm_get_transition_outgoing_scale(projectm_handle instance);
+
+/**
+ * @brief Sets how often the outgoing preset is rendered during a soft transition.
+ *
+ * With an interval larger than 1, the outgoing preset is only rendered every n-th frame of the
+ * transition. In the frames in between, its last image is blended with the incoming preset again.
+ *
+ * @param instance The projectM instance handle.
+ * @param interval The number of frames between two rendered frames of the outgoing preset. 0 is
+ *                 treated as 1. Default: 1
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT void projectm_set_transition_outgoing_frame_interval(projectm_handle instance, uint32_t interval);
+
+/**
+ * @brief Returns how often the outgoing preset is rendered during a soft transition.
+ * @param instance The projectM instance handle.
+ * @return The number of frames between two rendered frames of the outgoing preset.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT uint32_t projectm_get_transition_outgoing_frame_interval(projectm_handle instance);
+
+/**
+ * @brief Enables or disables dynamic resolution scaling.
+ *
+ * If enabled, presets are rendered at an internal resolution smaller than the viewport when
+ * frames take longer than the target frame time, and the final image is upscaled to the viewport
+ * size. The frame time is measured on the GPU using timer queries if available, otherwise the
+ * CPU time spent in projectm_opengl_render_frame() is used.
+ *
+ * @param instance The projectM instance handle.
+ * @param enabled True to enable dynamic resolution scaling, false to always render at the viewport size. Default: false
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT void projectm_set_dynamic_resolution_enabled(projectm_handle instance, bool enabled);
+
+/**
+ * @brief Returns whether dynamic resolution scaling is enabled.
+ * @param instance The projectM instance handle.
+ * @return True if dynamic resolution scaling is enabled, false otherwise.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT bool projectm_get_dynamic_resolution_enabled(projectm_handle instance);
+
+/**
+ * @brief Sets the frame time dynamic resolution scaling tries to stay below.
+ * @param instance The projectM instance handle.
+ * @param milliseconds The target frame time in milliseconds. Values below 1 are clamped to 1. Default: 16
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT void projectm_set_dynamic_resolution_target_frame_time(projectm_handle instance, double milliseconds);
+
+/**
+ * @brief Returns the frame time dynamic resolution scaling tries to stay below.
+ * @param instance The projectM instance handle.
+ * @return The target frame time in milliseconds.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT double projectm_get_dynamic_resolution_target_frame_time(projectm_handle instance);
+
+/**
+ * @brief Sets the range of the dynamic resolution scale factor.
+ *
+ * Both values are relative to the viewport size and clamped to the range 0.1 to 1.0. If max_scale
+ * is smaller than min_scale, min_scale is used for both.
+ *
+ * @param instance The projectM instance handle.
+ * @param min_scale The smallest scale factor. Default: 0.5
+ * @param max_scale The largest scale factor. Default: 1.0
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT void projectm_set_dynamic_resolution_scale_limits(projectm_handle instance, float min_scale, float max_scale);
+
+/**
+ * @brief Returns the range of the dynamic resolution scale factor.
+ * @param instance The projectM instance handle.
+ * @param min_scale Valid pointer to a float variable that will receive the smallest scale factor.
+ * @param max_scale Valid pointer to a float variable that will receive the largest scale factor.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT void projectm_get_dynamic_resolution_scale_limits(projectm_handle instance, float* min_scale, float* max_scale);
+
+/**
+ * @brief Returns the scale factor presets are currently rendered at.
+ *
+ * The internal resolution is the viewport size multiplied by this value.
+ *
+ * @param instance The projectM instance handle.
+ * @return The current render scale. Always 1.0 if dynamic resolution scaling is disabled.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT float projectm_get_dynamic_resolution_scale(projectm_handle instance);
+
+/**
+ * @brief Sets the color format of the preset main images.
+ *
+ * Presets render each frame on top of the previous one, so the main image format determines the
+ * precision and range of the feedback loop. Lower precision formats save memory bandwidth, e.g.
+ * on integrated GPUs or software renderers, while floating-point formats keep values above 1.0
+ * between frames, which can change the look of some presets. Formats with fewer alpha bits reduce
+ * the precision of the alpha channel in the rendered image, and R11F_G11F_B10F has no alpha at all.
+ *
+ * The images are only reallocated if the format changes. The current image is kept.
+ *
+ * Invalid values are ignored. If the OpenGL context can't render to floating-point textures, e.g.
+ * OpenGL ES 3.0 without GL_EXT_color_buffer_float, PROJECTM_RENDER_FORMAT_RGBA8 is used instead.
+ *
+ * @param instance The projectM instance handle.
+ * @param format The render target color format. Default: PROJECTM_RENDER_FORMAT_RGBA8
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT void projectm_set_main_render_format(projectm_handle instance, projectm_render_format format);
+
+/**
+ * @brief Returns the color format of the preset main images.
+ * @param instance The projectM instance handle.
+ * @return The render target color format.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT projectm_render_format projectm_get_main_render_format(projectm_handle instance);
+
+/**
+ * @brief Sets the color format of the preset blur textures.
+ *
+ * The blur textures are only read by preset shaders and don't need an alpha channel, so any
+ * format can be used without visible differences besides precision.
+ *
+ * The textures are only reallocated if the format changes.
+ *
+ * Invalid values are ignored. If the OpenGL context can't render to floating-point textures, e.g.
+ * OpenGL ES 3.0 without GL_EXT_color_buffer_float, PROJECTM_RENDER_FORMAT_RGBA8 is used instead.
+ *
+ * @param instance The projectM instance handle.
+ * @param format The render target color format. Default: PROJECTM_RENDER_FORMAT_RGBA8
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT void projectm_set_blur_render_format(projectm_handle instance, projectm_render_format format);
+
+/**
+ * @brief Returns the color format of the preset blur textures.
+ * @param instance The projectM instance handle.
+ * @return The render target color format.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT projectm_render_format projectm_get_blur_render_format(projectm_handle instance);
+
+/**
+ * @brief Sets how long a new window size must stay unchanged before the presets are resized.
+ *
+ * Resizing reallocates all preset framebuffers and textures. While the window is resized
+ * interactively, presets keep rendering at the previous size and the image is scaled to the
+ * window, until projectm_set_window_size() wasn't called with a different size for the given
+ * number of frames.
+ *
+ * @param instance The projectM instance handle.
+ * @param frames The number of frames. 0 resizes the presets immediately. Default: 10
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT void projectm_set_resize_settle_frames(projectm_handle instance, uint32_t frames);
+
+/**
+ * @brief Returns how long a new window size must stay unchanged before the presets are resized.
+ * @param instance The projectM instance handle.
+ * @return The number of frames.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT uint32_t projectm_get_resize_settle_frames(projectm_handle instance);
+
+/**
+ * @brief Enables or disables recording the preset drawing commands on a worker thread.
+ *
+ * Presets evaluate the per-pixel, custom waveform and custom shape code on the CPU before drawing.
+ * If enabled, this work runs on a worker thread, while the rendering thread submits the drawing
+ * commands of the components which are already evaluated. The rendered images are the same in
+ * both modes.
+ *
+ * If the platform can't start threads, the commands are recorded on the rendering thread.
+ *
+ * @param instance The projectM instance handle.
+ * @param enabled True to record on a worker thread, false to record on the rendering thread. Default: false
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT void projectm_set_deferred_command_recording(projectm_handle instance, bool enabled);
+
+/**
+ * @brief Returns whether the preset drawing commands are recorded on a worker thread.
+ * @param instance The projectM instance handle.
+ * @return True if deferred command recording is enabled, false otherwise.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT bool projectm_get_deferred_command_recording(projectm_handle instance);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -0,0 +1,141 @@
+/**
+ * @file preset_index.h
+ * @copyright 2003-2025 projectM Team
+ * @brief Persistent index of preset metadata for fast preset browsing and selection.
+ * @since 4.2.0
+ *
+ * projectM -- Milkdrop-esque visualisation SDK
+ * Copyright (C)2003-2024 projectM Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * See 'LICENSE.txt' included within this release
+ *
+ */
+
+#pragma once
+
+#include "projectM-4/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Opens a preset index file.
+ *
+ * The index file is memory-mapped and doesn't need a projectM instance. If the file doesn't exist
+ * or was written by an incompatible projectM version, the index is empty until it is refreshed.
+ *
+ * @param index_file The path of the index file. It will be created on the first refresh.
+ * @return A handle to the preset index, or NULL if index_file is NULL.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT projectm_preset_index_handle projectm_preset_index_open(const char* index_file);
+
+/**
+ * @brief Closes a preset index and frees all associated resources.
+ * @param index The preset index handle. Can be NULL.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT void projectm_preset_index_destroy(projectm_preset_index_handle index);
+
+/**
+ * @brief Scans preset directories and archives and updates the index file.
+ *
+ * Only presets which are new or whose modification time or size changed since the last refresh
+ * are read and parsed. Presets no longer found in any of the paths are removed from the index.
+ * Existing paths and indices returned by other functions are invalidated by this call.
+ *
+ * @param index The preset index handle.
+ * @param paths An array of directories or zip archives to scan recursively for .milk files.
+ * @param count The number of elements in paths.
+ * @return The number of preset files parsed, or -1 if the index file couldn't be written.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT int projectm_preset_index_refresh(projectm_preset_index_handle index,
+                                                  const char** paths, size_t count);
+
+/**
+ * @brief Returns the number of presets in the index.
+ * @param index The preset index handle.
+ * @return The number of indexed presets.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT size_t projectm_preset_index_size(projectm_preset_index_handle index);
+
+/**
+ * @brief Returns the absolute path of an indexed preset.
+ *
+ * Presets are sorted by path. The returned path can be passed to projectm_load_preset_file().
+ *
+ * @param index The preset index handle.
+ * @param preset_index The zero-based preset index.
+ * @return The preset path, or NULL if the index is out of range. Free with projectm_free_string().
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT char* projectm_preset_index_get_path(projectm_preset_index_handle index, size_t preset_index);
+
+/**
+ * @brief Searches the index for a preset file.
+ * @param index The preset index handle.
+ * @param preset_file The preset file path, relative to the current working directory or absolute.
+ * @return The zero-based preset index, or -1 if the preset is not indexed.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT int projectm_preset_index_find(projectm_preset_index_handle index, const char* preset_file);
+
+/**
+ * @brief Returns all indexed presets inside a directory or zip archive.
+ *
+ * This only queries the index and doesn't access the file system, so presets added after the last
+ * refresh are not returned.
+ *
+ * @param index The preset index handle.
+ * @param path The directory or archive path, relative to the current working directory or absolute.
+ * @param recursive If true, presets in subdirectories are also returned.
+ * @return A NULL-terminated array of absolute preset paths sorted by path, or NULL if the index
+ *         contains no presets inside the path. Free with projectm_free_string_array().
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT char** projectm_preset_index_list(projectm_preset_index_handle index, const char* path, bool recursive);
+
+/**
+ * @brief Retrieves the metadata of an indexed preset.
+ * @param index The preset index handle.
+ * @param preset_index The zero-based preset index.
+ * @param info A pointer to the structure receiving the metadata.
+ * @return True if the metadata was retrieved, false if the index is out of range.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT bool projectm_preset_index_get_info(projectm_preset_index_handle index, size_t preset_index,
+                                                    projectm_preset_info* info);
+
+/**
+ * @brief Returns the user textures referenced by an indexed preset.
+ *
+ * Names are lower-case and without sampler prefixes or file extensions, built-in textures like
+ * noise or blur textures are not included.
+ *
+ * @param index The preset index handle.
+ * @param preset_index The zero-based preset index.
+ * @return A NULL-terminated array of texture names, or NULL if the index is out of range. Free
+ *         with projectm_free_string_array().
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT char** projectm_preset_index_get_textures(projectm_preset_index_handle index, size_t preset_index);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
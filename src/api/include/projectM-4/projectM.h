@@ -32,6 +32,7 @@
 #include "projectM-4/logging.h"
 #include "projectM-4/memory.h"
 #include "projectM-4/parameters.h"
+#include "projectM-4/preset_index.h"
 #include "projectM-4/render_opengl.h"
 #include "projectM-4/touch.h"
 #include "projectM-4/version.h"
@@ -39,6 +39,9 @@ extern "C" {
 struct projectm;                          //!< Opaque projectM instance type.
 typedef struct projectm* projectm_handle; //!< A pointer to the opaque projectM instance.
 
+struct projectm_preset_index;                                       //!< Opaque preset index type.
+typedef struct projectm_preset_index* projectm_preset_index_handle; //!< A pointer to the opaque preset index.
+
 /**
  * For specifying audio data format.
  * @since 4.0.0
@@ -93,6 +96,92 @@ typedef enum
     PROJECTM_LOG_LEVEL_FATAL = 6   //!< Irrecoverable errors preventing projectM from working.
 } projectm_log_level;
 
+/**
+ * Flags describing the contents of an indexed preset.
+ * @since 4.2.0
+ */
+typedef enum
+{
+    PROJECTM_PRESET_HAS_PER_FRAME_CODE = 1,    //!< Preset has per-frame init or per-frame code.
+    PROJECTM_PRESET_HAS_PER_PIXEL_CODE = 2,    //!< Preset has per-pixel (per-vertex) code.
+    PROJECTM_PRESET_HAS_WARP_SHADER = 4,       //!< Preset has a warp shader and PSVERSION_WARP > 0.
+    PROJECTM_PRESET_HAS_COMPOSITE_SHADER = 8,  //!< Preset has a composite shader and PSVERSION_COMP > 0.
+    PROJECTM_PRESET_IN_ARCHIVE = 16            //!< Preset is located inside an archive.
+} projectm_preset_flags;
+
+/**
+ * Metadata of a single preset in a preset index.
+ * @since 4.2.0
+ */
+typedef struct
+{
+    int64_t modification_time;    //!< Modification time of the file (or archive) in file system clock ticks.
+    uint64_t file_size;           //!< Size of the preset file in bytes.
+    uint64_t content_hash;        //!< 64-bit hash of the preset file contents.
+    uint32_t flags;               //!< Combination of projectm_preset_flags values.
+    int preset_version;           //!< MILKDROP_PRESET_VERSION, 100 if not set.
+    int warp_shader_version;      //!< Effective warp shader model version, 0 if none.
+    int composite_shader_version; //!< Effective composite shader model version, 0 if none.
+    int wave_count;               //!< Number of enabled custom waveforms.
+    int shape_count;              //!< Number of enabled custom shapes.
+    float cost_estimate;          //!< Relative estimate of the expression evaluation cost per frame.
+} projectm_preset_info;
+
+/**
+ * Color formats of the internal render targets.
+ *
+ * All formats except PROJECTM_RENDER_FORMAT_RGBA16F use 32 bits per pixel.
+ * @since 4.2.0
+ */
+typedef enum
+{
+    PROJECTM_RENDER_FORMAT_RGBA8 = 0,          //!< 8 bits per channel. Same as Milkdrop.
+    PROJECTM_RENDER_FORMAT_RGB10_A2 = 1,       //!< 10 bits per color channel, 2 bits alpha.
+    PROJECTM_RENDER_FORMAT_R11F_G11F_B10F = 2, //!< Unsigned floating-point colors, no alpha channel.
+    PROJECTM_RENDER_FORMAT_RGBA16F = 3         //!< 16-bit floating-point per channel, twice the memory bandwidth.
+} projectm_render_format;
+
+/**
+ * Measured costs of a single render pass.
+ * @since 4.2.0
+ */
+typedef struct
+{
+    char name[32];           //!< Pass name, e.g. "warp" or "composite". Always null-terminated.
+    uint32_t frame;          //!< Number of the frame the pass was rendered in.
+    double gpu_milliseconds; //!< GPU time spent in the pass, or a negative value if it couldn't be measured.
+    uint32_t draw_calls;     //!< Number of draw calls issued by the pass.
+    uint32_t state_changes;  //!< Number of OpenGL state changes issued by the pass.
+} projectm_render_pass_timing;
+
+/**
+ * Occupancy of the render target texture pool shared by all presets.
+ * @since 4.2.0
+ */
+typedef struct
+{
+    uint32_t leased_textures;   //!< Number of textures currently used by presets or render passes.
+    uint64_t leased_bytes;      //!< Estimated memory used by the leased textures.
+    uint32_t released_textures; //!< Number of unused textures kept for reuse.
+    uint64_t released_bytes;    //!< Estimated memory used by the unused textures.
+    uint64_t allocations;       //!< Number of textures allocated since the instance was created.
+    uint64_t reuses;            //!< Number of texture requests served with an unused texture instead of allocating one.
+} projectm_texture_pool_statistics;
+
+/**
+ * CPU costs of rendering a single frame.
+ * @since 4.2.0
+ */
+typedef struct
+{
+    double frame_time_ms;   //!< CPU time spent rendering the frame, including waiting for recorded commands.
+    double record_time_ms;  //!< CPU time spent evaluating preset components and recording their drawing commands.
+    double wait_time_ms;    //!< Time the rendering thread waited for the recording thread. Always 0 if recording isn't deferred.
+    uint32_t command_lists; //!< Number of command lists recorded, one per drawn preset component.
+    uint32_t commands;      //!< Number of drawing commands recorded.
+    bool deferred;          //!< True if the commands were recorded on a worker thread.
+} projectm_frame_cpu_statistics;
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
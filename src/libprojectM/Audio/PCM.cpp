@@ -1,5 +1,7 @@
 #include "Audio/PCM.hpp"
 
+#include <Tracing.hpp>
+
 namespace libprojectM {
 namespace Audio {
 
@@ -48,6 +50,8 @@ void PCM::Add(int16_t const* const samples, uint32_t channels, size_t const coun
 
 void PCM::UpdateFrameAudioData(double secondsSinceLastFrame, uint32_t frame)
 {
+    TRACE_SCOPE("PCM::UpdateFrameAudioData");
+
     // 1. Copy audio data from input buffer
     CopyNewWaveformData(m_inputBufferL, m_waveformL);
     CopyNewWaveformData(m_inputBufferR, m_waveformR);
@@ -0,0 +1,38 @@
+#include "AudioTexture.hpp"
+
+namespace libprojectM {
+namespace MilkdropPreset {
+
+AudioTexture::AudioTexture()
+    // Half floats are filterable on all platforms, 32 bit floats are not on OpenGL ES.
+    : m_texture(std::make_shared<Renderer::Texture>("audio", m_texels.data(), GL_TEXTURE_2D, Audio::SpectrumSamples, 1, 0,
+                                                    GL_RGBA16F, GL_RGBA, GL_FLOAT, false))
+{
+}
+
+void AudioTexture::Update(const Audio::FrameAudioData& audioData)
+{
+    static_assert(Audio::SpectrumSamples >= Audio::WaveformSamples, "Audio texture is narrower than the waveform data");
+
+    for (int sample = 0; sample < Audio::SpectrumSamples; sample++)
+    {
+        auto* texel = &m_texels[sample * 4];
+        if (sample < Audio::WaveformSamples)
+        {
+            texel[0] = audioData.waveformLeft[sample];
+            texel[1] = audioData.waveformRight[sample];
+        }
+        texel[2] = audioData.spectrumLeft[sample];
+        texel[3] = audioData.spectrumRight[sample];
+    }
+
+    m_texture->Update(m_texels.data());
+}
+
+auto AudioTexture::Texture() const -> const std::shared_ptr<Renderer::Texture>&
+{
+    return m_texture;
+}
+
+} // namespace MilkdropPreset
+} // namespace libprojectM
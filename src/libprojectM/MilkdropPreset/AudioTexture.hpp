@@ -0,0 +1,53 @@
+/**
+ * @file AudioTexture.hpp
+ * @brief Uploads the frame's waveform and spectrum data into a small floating-point texture.
+ */
+#pragma once
+
+#include <Audio/AudioConstants.hpp>
+#include <Audio/FrameAudioData.hpp>
+
+#include <Renderer/Texture.hpp>
+
+#include <array>
+#include <memory>
+
+namespace libprojectM {
+namespace MilkdropPreset {
+
+/**
+ * @brief Uploads the frame's waveform and spectrum data into a small floating-point texture.
+ *
+ * The texture is 512x1 texels. The red and green channels contain the left and right waveform
+ * samples, the blue and alpha channels the left and right spectrum values. Waveform texels past
+ * the last available sample are zero.
+ *
+ * Contains the unsmoothed data and is exposed to preset shaders as "sampler_audio".
+ */
+class AudioTexture
+{
+public:
+    /**
+     * Constructor. Allocates the texture.
+     */
+    AudioTexture();
+
+    /**
+     * @brief Uploads the audio data of the current frame.
+     * @param audioData The frame audio data.
+     */
+    void Update(const Audio::FrameAudioData& audioData);
+
+    /**
+     * @brief Returns the audio data texture.
+     * @return A shared pointer to the texture.
+     */
+    auto Texture() const -> const std::shared_ptr<Renderer::Texture>&;
+
+private:
+    std::array<float, Audio::SpectrumSamples * 4> m_texels{}; //!< Interleaved RGBA texel data for uploading.
+    std::shared_ptr<Renderer::Texture> m_texture;              //!< The audio data texture.
+};
+
+} // namespace MilkdropPreset
+} // namespace libprojectM
@@ -6,6 +6,7 @@
 #include "MilkdropStaticShaders.hpp"
 
 #include <Renderer/BlendMode.hpp>
+#include <Renderer/GLStateCache.hpp>
 #include <Renderer/Point.hpp>
 #include <Renderer/ShaderCache.hpp>
 
@@ -18,8 +19,6 @@ BlurTexture::BlurTexture()
     : m_blurMesh(Renderer::VertexBufferUsage::StaticDraw, false, true)
     , m_blurSampler(std::make_shared<Renderer::Sampler>(GL_CLAMP_TO_EDGE, GL_LINEAR))
 {
-    m_blurFramebuffer.CreateColorAttachment(0, 0);
-
     // Initialize blur mesh with a single fullscreen quad.
     m_blurMesh.SetRenderPrimitiveType(Renderer::Mesh::PrimitiveType::TriangleStrip);
 
@@ -35,21 +34,30 @@ BlurTexture::BlurTexture()
 
     m_blurMesh.Update();
 
-    // Initialize with empty textures.
-    for (size_t i = 0; i < m_blurTextures.size(); i++)
+    // Initialize with empty textures. Horizontal pass textures are acquired from the pool when blurring.
+    for (size_t i = 1; i < m_blurTextures.size(); i += 2)
     {
-        std::string textureName;
-        if (i % 2 == 1)
-        {
-            textureName = "blur" + std::to_string(i / 2 + 1);
-        }
+        m_blurTextures[i] = std::make_shared<Renderer::Texture>("blur" + std::to_string(i / 2 + 1), 0, GL_TEXTURE_2D, 0, 0, false);
+    }
+}
+
+BlurTexture::~BlurTexture()
+{
+    if (m_texturePool == nullptr)
+    {
+        return;
+    }
 
-        m_blurTextures[i] = std::make_shared<Renderer::Texture>(textureName, 0, GL_TEXTURE_2D, 0, 0, false);
+    for (const auto& texture : m_blurTextures)
+    {
+        m_texturePool->Release(texture);
     }
 }
 
 void BlurTexture::Initialize(const Renderer::RenderContext& renderContext)
 {
+    m_texturePool = renderContext.texturePool;
+
     auto staticShaders = libprojectM::MilkdropPreset::MilkdropStaticShaders::Get();
 
     // Load/compile shader sources
@@ -80,30 +88,35 @@ void BlurTexture::SetRequiredBlurLevel(BlurTexture::BlurLevel level)
     m_blurLevel = std::max(level, m_blurLevel);
 }
 
+auto BlurTexture::RequiredBlurLevel() const -> BlurLevel
+{
+    return m_blurLevel;
+}
+
 auto BlurTexture::GetDescriptorsForBlurLevel(BlurTexture::BlurLevel blurLevel) const -> std::vector<Renderer::TextureSamplerDescriptor>
 {
     std::vector<Renderer::TextureSamplerDescriptor> descriptors;
 
     if (blurLevel == BlurLevel::Blur3)
     {
-        descriptors.emplace_back(m_blurTextures[1], m_blurSampler, m_blurTextures[1]->Name(), std::string());
-        descriptors.emplace_back(m_blurTextures[3], m_blurSampler, m_blurTextures[3]->Name(), std::string());
-        descriptors.emplace_back(m_blurTextures[5], m_blurSampler, m_blurTextures[5]->Name(), std::string());
+        descriptors.emplace_back(m_blurTextures[1], m_blurSampler, "blur1", std::string());
+        descriptors.emplace_back(m_blurTextures[3], m_blurSampler, "blur2", std::string());
+        descriptors.emplace_back(m_blurTextures[5], m_blurSampler, "blur3", std::string());
     }
     if (blurLevel == BlurLevel::Blur2)
     {
-        descriptors.emplace_back(m_blurTextures[1], m_blurSampler, m_blurTextures[1]->Name(), std::string());
-        descriptors.emplace_back(m_blurTextures[3], m_blurSampler, m_blurTextures[3]->Name(), std::string());
+        descriptors.emplace_back(m_blurTextures[1], m_blurSampler, "blur1", std::string());
+        descriptors.emplace_back(m_blurTextures[3], m_blurSampler, "blur2", std::string());
     }
     if (blurLevel == BlurLevel::Blur1)
     {
-        descriptors.emplace_back(m_blurTextures[1], m_blurSampler, m_blurTextures[1]->Name(), std::string());
+        descriptors.emplace_back(m_blurTextures[1], m_blurSampler, "blur1", std::string());
     }
 
     return descriptors;
 }
 
-void BlurTexture::Update(const Renderer::Texture& sourceTexture, const PerFrameContext& perFrameContext)
+void BlurTexture::Update(const Renderer::Texture& sourceTexture, const PerFrameContext& perFrameContext, const Renderer::RenderContext& renderContext)
 {
     if (m_blurLevel == BlurLevel::None)
     {
@@ -116,7 +129,9 @@ void BlurTexture::Update(const Renderer::Texture& sourceTexture, const PerFrameC
         return;
     }
 
-    AllocateTextures(sourceTexture);
+    auto const textureFormat = Renderer::TextureFormat::FromRenderFormat(renderContext.blurRenderFormat);
+    AllocateTextures(sourceTexture, textureFormat);
+    auto& texturePool = *m_texturePool;
 
     unsigned int const passes = static_cast<int>(m_blurLevel) * 2;
     auto const blur1EdgeDarken = static_cast<float>(*perFrameContext.blur1_edge_darken);
@@ -144,17 +159,21 @@ void BlurTexture::Update(const Renderer::Texture& sourceTexture, const PerFrameC
     bias[2] = -tempMin * scale[2];
 
     // Remember previously bound framebuffer
-    GLint origReadFramebuffer;
-    GLint origDrawFramebuffer;
-    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &origReadFramebuffer);
-    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &origDrawFramebuffer);
-
-    m_blurFramebuffer.Bind(0);
+    auto& stateCache = Renderer::GLStateCache::Current();
+    auto const origReadFramebuffer = stateCache.BoundFramebuffer(GL_READ_FRAMEBUFFER);
+    auto const origDrawFramebuffer = stateCache.BoundFramebuffer(GL_DRAW_FRAMEBUFFER);
 
     Renderer::BlendMode::Set(true, Renderer::BlendMode::Function::One, Renderer::BlendMode::Function::Zero);
 
     for (unsigned int pass = 0; pass < passes; pass++)
     {
+        if (pass % 2 == 0)
+        {
+            // Horizontal passes are only read by the following vertical pass.
+            m_blurTextures[pass] = texturePool.Acquire(m_blurTextureSizes[pass].width, m_blurTextureSizes[pass].height, textureFormat);
+            AttachTexture(static_cast<int>(pass));
+        }
+
         if (m_blurTextures[pass]->TextureID() == 0)
         {
             continue;
@@ -172,9 +191,12 @@ void BlurTexture::Update(const Renderer::Texture& sourceTexture, const PerFrameC
         }
         if (!blurShader)
         {
-            return;
+            break;
         }
 
+        // Each pass reads the previous pass' texture and renders directly into its own.
+        m_blurFramebuffer.Bind(static_cast<int>(pass));
+
         blurShader->Bind();
         blurShader->SetUniformInt("texture_sampler", 0);
 
@@ -184,12 +206,10 @@ void BlurTexture::Update(const Renderer::Texture& sourceTexture, const PerFrameC
         if (pass == 0)
         {
             sourceTexture.Bind(0);
-            blurShader->SetUniformInt("flipVertical", 1);
         }
         else
         {
             m_blurTextures[pass - 1]->Bind(0);
-            blurShader->SetUniformInt("flipVertical", 0);
         }
         m_blurSampler->Bind(0);
 
@@ -257,18 +277,26 @@ void BlurTexture::Update(const Renderer::Texture& sourceTexture, const PerFrameC
         // Draw fullscreen quad
         m_blurMesh.Draw();
 
-        // Save to blur texture
-        m_blurTextures[pass]->Bind(0);
-        glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, m_blurTextures[pass]->Width(), m_blurTextures[pass]->Height());
-        m_blurTextures[pass]->Unbind(0);
+        if (pass % 2 == 1)
+        {
+            texturePool.Release(m_blurTextures[pass - 1]);
+            m_blurTextures[pass - 1].reset();
+        }
+    }
+
+    // Return any texture left over if blurring was stopped early.
+    for (size_t i = 0; i < m_blurTextures.size(); i += 2)
+    {
+        texturePool.Release(m_blurTextures[i]);
+        m_blurTextures[i].reset();
     }
 
     Renderer::Mesh::Unbind();
     Renderer::BlendMode::Set(false, Renderer::BlendMode::Function::SourceAlpha, Renderer::BlendMode::Function::OneMinusSourceAlpha);
 
     // Bind previous framebuffer and reset viewport size
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, origReadFramebuffer);
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, origDrawFramebuffer);
+    stateCache.BindFramebuffer(GL_READ_FRAMEBUFFER, origReadFramebuffer);
+    stateCache.BindFramebuffer(GL_DRAW_FRAMEBUFFER, origDrawFramebuffer);
     glViewport(0, 0, sourceTexture.Width(), sourceTexture.Height());
 
     Renderer::Shader::Unbind();
@@ -325,18 +353,19 @@ void BlurTexture::GetSafeBlurMinMaxValues(const PerFrameContext& perFrameContext
     }
 }
 
-void BlurTexture::AllocateTextures(const Renderer::Texture& sourceTexture)
+void BlurTexture::AllocateTextures(const Renderer::Texture& sourceTexture, const Renderer::TextureFormat& format)
 {
     int width = sourceTexture.Width();
     int height = sourceTexture.Height();
 
-    if (m_blurTextures[0] != nullptr &&
+    if (m_blurTextures[1]->TextureID() != 0 &&
         width > 0 &&
         height > 0 &&
         width == m_sourceTextureWidth &&
-        height == m_sourceTextureHeight)
+        height == m_sourceTextureHeight &&
+        format == m_textureFormat)
     {
-        // Size unchanged, return.
+        // Size and format unchanged, return.
         return;
     }
 
@@ -357,24 +386,37 @@ void BlurTexture::AllocateTextures(const Renderer::Texture& sourceTexture)
         int width2 = ((width + 3) / 16) * 16;
         int height2 = ((height + 3) / 4) * 4;
 
-        if (i == 0)
-        {
-            // Only use as much space as needed to render the blur textures.
-            m_blurFramebuffer.SetSize(width2, height2);
-        }
+        m_blurTextureSizes[i] = {width2, height2};
 
-        std::string textureName;
-        if (i % 2 == 1)
+        if (i % 2 == 0)
         {
-            textureName = "blur" + std::to_string(i / 2 + 1);
+            continue;
         }
 
-        // This will automatically replace any old texture.
-        m_blurTextures[i] = std::make_shared<Renderer::Texture>(textureName, width2, height2, false);
+        // Return the old texture first, so a texture with the new size and format can take its place.
+        m_texturePool->Release(m_blurTextures[i]);
+        m_blurTextures[i] = m_texturePool->Acquire(width2, height2, format, Renderer::TexturePool::Usage::BlurLevel);
+        AttachTexture(static_cast<int>(i));
     }
 
     m_sourceTextureWidth = sourceTexture.Width();
     m_sourceTextureHeight = sourceTexture.Height();
+    m_textureFormat = format;
+}
+
+void BlurTexture::AttachTexture(int pass)
+{
+    const auto& texture = m_blurTextures[pass];
+    if (m_blurFramebuffer.GetColorAttachmentTexture(pass, 0) == texture)
+    {
+        return;
+    }
+
+    // Attach the texture as the render target of this pass' framebuffer.
+    auto attachment = std::make_shared<Renderer::TextureAttachment>(Renderer::TextureAttachment::AttachmentType::Color, 0, 0);
+    attachment->Texture(texture);
+    m_blurFramebuffer.RemoveColorAttachment(pass, 0);
+    m_blurFramebuffer.SetAttachment(pass, 0, attachment);
 }
 
 } // namespace MilkdropPreset
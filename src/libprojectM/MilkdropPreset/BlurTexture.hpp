@@ -8,6 +8,7 @@
 #include <Renderer/Mesh.hpp>
 #include <Renderer/RenderContext.hpp>
 #include <Renderer/Shader.hpp>
+#include <Renderer/TexturePool.hpp>
 #include <Renderer/TextureSamplerDescriptor.hpp>
 
 #include <array>
@@ -47,13 +48,15 @@ public:
     BlurTexture();
 
     /**
-     * Destructor.
+     * Destructor. Returns the blur level textures to the texture pool.
      */
-    virtual ~BlurTexture() = default;
+    virtual ~BlurTexture();
 
     /**
      * @brief Initializes the blur texture.
-     * @param renderContext
+     * The blur level textures are leased from the render context's texture pool, which must
+     * outlive this instance.
+     * @param renderContext The render context.
      */
     void Initialize(const Renderer::RenderContext& renderContext);
 
@@ -64,6 +67,12 @@ public:
      */
     void SetRequiredBlurLevel(BlurLevel level);
 
+    /**
+     * @brief Returns the blur level required by the preset's shaders.
+     * @return The blur level, BlurLevel::None if no blur textures are used.
+     */
+    auto RequiredBlurLevel() const -> BlurLevel;
+
     /**
      * @brief Returns a list of descriptors for the given blur level.
      * The blur textures don't need to be present and can be empty placeholders.
@@ -73,10 +82,14 @@ public:
 
     /**
      * @brief Renders the required blur passes on the given texture.
+     * The intermediate textures of the horizontal passes are acquired from the texture pool and
+     * released as soon as the following vertical pass is done. All blur textures use the render
+     * context's blur format and are reallocated if it changes.
      * @param sourceTexture The texture to create the blur levels from.
      * @param perFrameContext The per-frame variables.
+     * @param renderContext The render context with the blur texture format.
      */
-    void Update(const Renderer::Texture& sourceTexture, const PerFrameContext& perFrameContext);
+    void Update(const Renderer::Texture& sourceTexture, const PerFrameContext& perFrameContext, const Renderer::RenderContext& renderContext);
 
     /**
      * @brief Binds the user-readable blur textures to the texture slots starting with the given index.
@@ -100,23 +113,41 @@ public:
 private:
     static constexpr int NumBlurTextures = 6; //!< Maximum number of blur passes/textures.
 
+    /**
+     * @brief Size of a blur texture.
+     */
+    struct TextureSize {
+        int width{};  //!< Width in pixels.
+        int height{}; //!< Height in pixels.
+    };
+
     /**
      * Allocates the blur textures.
      * @param sourceTexture The source texture.
+     * @param format The blur texture format.
+     */
+    void AllocateTextures(const Renderer::Texture& sourceTexture, const Renderer::TextureFormat& format);
+
+    /**
+     * @brief Attaches the texture of the given pass to the pass' framebuffer, if not already attached.
+     * @param pass The blur pass index.
      */
-    void AllocateTextures(const Renderer::Texture& sourceTexture);
+    void AttachTexture(int pass);
 
     Renderer::Mesh m_blurMesh; //!< The blur mesh (a simple quad).
 
     std::weak_ptr<Renderer::Shader> m_blur1Shader; //!< The shader used on the first blur pass.
     std::weak_ptr<Renderer::Shader> m_blur2Shader; //!< The shader used for subsequent blur passes after the initial pass.
 
-    int m_sourceTextureWidth{};  //!< Width of the source texture used to create the blur textures.
-    int m_sourceTextureHeight{}; //!< Height of the source texture used to create the blur textures.
+    Renderer::TexturePool* m_texturePool{};  //!< The pool all blur textures are leased from.
+    int m_sourceTextureWidth{};              //!< Width of the source texture used to create the blur textures.
+    int m_sourceTextureHeight{};             //!< Height of the source texture used to create the blur textures.
+    Renderer::TextureFormat m_textureFormat; //!< Format of the allocated blur textures.
 
-    Renderer::Framebuffer m_blurFramebuffer;                                        //!< The framebuffer used to draw the blur textures.
+    Renderer::Framebuffer m_blurFramebuffer{NumBlurTextures};                       //!< One framebuffer per blur texture, each pass renders directly into its texture.
     std::shared_ptr<Renderer::Sampler> m_blurSampler;                               //!< The blur sampler.
-    std::array<std::shared_ptr<Renderer::Texture>, NumBlurTextures> m_blurTextures; //!< The blur textures for each pass.
+    std::array<std::shared_ptr<Renderer::Texture>, NumBlurTextures> m_blurTextures; //!< The blur textures for each pass. Textures of horizontal passes are only set while blurring.
+    std::array<TextureSize, NumBlurTextures> m_blurTextureSizes{};                  //!< The blur texture size of each pass.
     BlurLevel m_blurLevel{BlurLevel::None};                                         //!< Current blur level.
 };
 
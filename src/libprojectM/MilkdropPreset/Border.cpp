@@ -27,6 +27,12 @@ Border::Border(PresetState& presetState)
     }});
 }
 
+auto Border::IsVisible(const PerFrameContext& presetPerFrameContext) -> bool
+{
+    return static_cast<float>(*presetPerFrameContext.ob_a) > 0.001f ||
+           static_cast<float>(*presetPerFrameContext.ib_a) > 0.001f;
+}
+
 void Border::Draw(const PerFrameContext& presetPerFrameContext)
 {
     // Draw Borders
@@ -18,6 +18,13 @@ public:
 
     explicit Border(PresetState& presetState);
 
+    /**
+     * @brief Returns whether any of the two borders is visible.
+     * @param presetPerFrameContext The per-frame context variables.
+     * @return true if the inner or outer border isn't fully transparent.
+     */
+    static auto IsVisible(const PerFrameContext& presetPerFrameContext) -> bool;
+
     /**
      * Draws the border.
      * @param presetPerFrameContext The per-frame context variables.
@@ -1,10 +1,14 @@
 #include "CustomShape.hpp"
 
-#include "PresetFileParser.hpp"
+#include "PresetDataSource.hpp"
 
 #include <Renderer/BlendMode.hpp>
+#include <Renderer/GLStateCache.hpp>
 #include <Renderer/TextureManager.hpp>
 
+#include <Tracing.hpp>
+
+#include <algorithm>
 #include <vector>
 
 namespace libprojectM {
@@ -25,38 +29,36 @@ CustomShape::CustomShape(PresetState& presetState)
     m_perFrameContext.RegisterBuiltinVariables();
 }
 
-void CustomShape::Initialize(PresetFileParser& parsedFile, int index)
+void CustomShape::Initialize(const PresetDataSource& parsedFile, int index)
 {
-    std::string const shapecodePrefix = "shapecode_" + std::to_string(index) + "_";
-
     m_index = index;
-    m_enabled = parsedFile.GetBool(shapecodePrefix + "enabled", m_enabled);
-    m_sides = parsedFile.GetInt(shapecodePrefix + "sides", m_sides);
-    m_additive = parsedFile.GetBool(shapecodePrefix + "additive", m_additive);
-    m_thickOutline = parsedFile.GetBool(shapecodePrefix + "thickOutline", m_thickOutline);
-    m_textured = parsedFile.GetBool(shapecodePrefix + "textured", m_textured);
-    m_instances = parsedFile.GetInt(shapecodePrefix + "num_inst", m_instances);
-    m_x = parsedFile.GetFloat(shapecodePrefix + "x", m_x);
-    m_y = parsedFile.GetFloat(shapecodePrefix + "y", m_y);
-    m_radius = parsedFile.GetFloat(shapecodePrefix + "rad", m_radius);
-    m_angle = parsedFile.GetFloat(shapecodePrefix + "ang", m_angle);
-    m_tex_ang = parsedFile.GetFloat(shapecodePrefix + "tex_ang", m_tex_ang);
-    m_tex_zoom = parsedFile.GetFloat(shapecodePrefix + "tex_zoom", m_tex_zoom);
-    m_r = parsedFile.GetFloat(shapecodePrefix + "r", m_r);
-    m_g = parsedFile.GetFloat(shapecodePrefix + "g", m_g);
-    m_b = parsedFile.GetFloat(shapecodePrefix + "b", m_b);
-    m_a = parsedFile.GetFloat(shapecodePrefix + "a", m_a);
-    m_r2 = parsedFile.GetFloat(shapecodePrefix + "r2", m_r2);
-    m_g2 = parsedFile.GetFloat(shapecodePrefix + "g2", m_g2);
-    m_b2 = parsedFile.GetFloat(shapecodePrefix + "b2", m_b2);
-    m_a2 = parsedFile.GetFloat(shapecodePrefix + "a2", m_a2);
-    m_border_r = parsedFile.GetFloat(shapecodePrefix + "border_r", m_border_r);
-    m_border_g = parsedFile.GetFloat(shapecodePrefix + "border_g", m_border_g);
-    m_border_b = parsedFile.GetFloat(shapecodePrefix + "border_b", m_border_b);
-    m_border_a = parsedFile.GetFloat(shapecodePrefix + "border_a", m_border_a);
+    m_enabled = parsedFile.GetBool(PresetKeyTable::Slot(ShapeKey::Enabled, m_index), m_enabled);
+    m_sides = parsedFile.GetInt(PresetKeyTable::Slot(ShapeKey::Sides, m_index), m_sides);
+    m_additive = parsedFile.GetBool(PresetKeyTable::Slot(ShapeKey::Additive, m_index), m_additive);
+    m_thickOutline = parsedFile.GetBool(PresetKeyTable::Slot(ShapeKey::ThickOutline, m_index), m_thickOutline);
+    m_textured = parsedFile.GetBool(PresetKeyTable::Slot(ShapeKey::Textured, m_index), m_textured);
+    m_instances = parsedFile.GetInt(PresetKeyTable::Slot(ShapeKey::Instances, m_index), m_instances);
+    m_x = parsedFile.GetFloat(PresetKeyTable::Slot(ShapeKey::X, m_index), m_x);
+    m_y = parsedFile.GetFloat(PresetKeyTable::Slot(ShapeKey::Y, m_index), m_y);
+    m_radius = parsedFile.GetFloat(PresetKeyTable::Slot(ShapeKey::Radius, m_index), m_radius);
+    m_angle = parsedFile.GetFloat(PresetKeyTable::Slot(ShapeKey::Angle, m_index), m_angle);
+    m_tex_ang = parsedFile.GetFloat(PresetKeyTable::Slot(ShapeKey::TexAngle, m_index), m_tex_ang);
+    m_tex_zoom = parsedFile.GetFloat(PresetKeyTable::Slot(ShapeKey::TexZoom, m_index), m_tex_zoom);
+    m_r = parsedFile.GetFloat(PresetKeyTable::Slot(ShapeKey::R, m_index), m_r);
+    m_g = parsedFile.GetFloat(PresetKeyTable::Slot(ShapeKey::G, m_index), m_g);
+    m_b = parsedFile.GetFloat(PresetKeyTable::Slot(ShapeKey::B, m_index), m_b);
+    m_a = parsedFile.GetFloat(PresetKeyTable::Slot(ShapeKey::A, m_index), m_a);
+    m_r2 = parsedFile.GetFloat(PresetKeyTable::Slot(ShapeKey::R2, m_index), m_r2);
+    m_g2 = parsedFile.GetFloat(PresetKeyTable::Slot(ShapeKey::G2, m_index), m_g2);
+    m_b2 = parsedFile.GetFloat(PresetKeyTable::Slot(ShapeKey::B2, m_index), m_b2);
+    m_a2 = parsedFile.GetFloat(PresetKeyTable::Slot(ShapeKey::A2, m_index), m_a2);
+    m_border_r = parsedFile.GetFloat(PresetKeyTable::Slot(ShapeKey::BorderR, m_index), m_border_r);
+    m_border_g = parsedFile.GetFloat(PresetKeyTable::Slot(ShapeKey::BorderG, m_index), m_border_g);
+    m_border_b = parsedFile.GetFloat(PresetKeyTable::Slot(ShapeKey::BorderB, m_index), m_border_b);
+    m_border_a = parsedFile.GetFloat(PresetKeyTable::Slot(ShapeKey::BorderA, m_index), m_border_a);
 
     // projectM addition: texture name to use for rendering the shape
-    m_image = parsedFile.GetString(shapecodePrefix + "image", "");
+    m_image = parsedFile.GetString(PresetKeyTable::Slot(ShapeKey::Image, m_index), "");
 }
 
 void CustomShape::CompileCodeAndRunInitExpressions()
@@ -72,7 +74,12 @@ void CustomShape::CompileCodeAndRunInitExpressions()
     m_perFrameContext.CompilePerFrameCode(m_presetState.customShapePerFrameCode[m_index], *this);
 }
 
-void CustomShape::Draw()
+auto CustomShape::Enabled() const -> bool
+{
+    return m_enabled;
+}
+
+void CustomShape::Record(Renderer::CommandList& commandList)
 {
     static constexpr float pi = 3.141592653589793f;
 
@@ -81,7 +88,16 @@ void CustomShape::Draw()
         return;
     }
 
-    Renderer::BlendMode::SetBlendActive(true);
+    TRACE_SCOPE("CustomShape::Record");
+
+    // Each instance is evaluated and its geometry stored here, the draw commands only read it.
+    m_instanceDraws.resize(static_cast<size_t>(std::max(m_instances, 0)));
+    m_instanceVertices.clear();
+    m_instanceUVs.clear();
+
+    commandList.Record([]() {
+        Renderer::BlendMode::SetBlendActive(true);
+    });
 
     for (int instance = 0; instance < m_instances; instance++)
     {
@@ -98,17 +114,11 @@ void CustomShape::Draw()
             sides = 100;
         }
 
-        // Additive Drawing or Overwrite
-        Renderer::BlendMode::SetBlendFunction(Renderer::BlendMode::Function::SourceAlpha,
-                                              static_cast<int>(*m_perFrameContext.additive) != 0
-                                                  ? Renderer::BlendMode::Function::One
-                                                  : Renderer::BlendMode::Function::OneMinusSourceAlpha);
-
-        auto& vertexData = m_fillMesh.Vertices();
-        auto& colorData = m_fillMesh.Colors();
-
-        vertexData[0] = Renderer::Point(static_cast<float>(*m_perFrameContext.x * 2.0 - 1.0),
-                                        static_cast<float>(*m_perFrameContext.y * -2.0 + 1.0));
+        auto& instanceDraw = m_instanceDraws[instance];
+        instanceDraw.firstVertex = static_cast<uint32_t>(m_instanceVertices.size());
+        instanceDraw.sides = sides;
+        instanceDraw.additive = static_cast<int>(*m_perFrameContext.additive) != 0;
+        instanceDraw.textured = static_cast<int>(*m_perFrameContext.textured) != 0;
 
         // x = f*255.0 & 0xFF = (f*255.0) % 256
         // f' = x/255.0 = f % (256/255)
@@ -116,15 +126,24 @@ void CustomShape::Draw()
         // 2.0 -> 254 (0xFE)
         // -1.0 -> 0x01
 
-        colorData[0] = Renderer::Color::Modulo(Renderer::Color(static_cast<float>(*m_perFrameContext.r),
-                                                               static_cast<float>(*m_perFrameContext.g),
-                                                               static_cast<float>(*m_perFrameContext.b),
-                                                               static_cast<float>(*m_perFrameContext.a)));
+        instanceDraw.centerColor = Renderer::Color::Modulo(Renderer::Color(static_cast<float>(*m_perFrameContext.r),
+                                                                           static_cast<float>(*m_perFrameContext.g),
+                                                                           static_cast<float>(*m_perFrameContext.b),
+                                                                           static_cast<float>(*m_perFrameContext.a)));
+
+        instanceDraw.edgeColor = Renderer::Color::Modulo(Renderer::Color(static_cast<float>(*m_perFrameContext.r2),
+                                                                         static_cast<float>(*m_perFrameContext.g2),
+                                                                         static_cast<float>(*m_perFrameContext.b2),
+                                                                         static_cast<float>(*m_perFrameContext.a2)));
 
-        colorData[1] = Renderer::Color::Modulo(Renderer::Color(static_cast<float>(*m_perFrameContext.r2),
-                                                               static_cast<float>(*m_perFrameContext.g2),
-                                                               static_cast<float>(*m_perFrameContext.b2),
-                                                               static_cast<float>(*m_perFrameContext.a2)));
+        instanceDraw.borderColor = Renderer::Color(static_cast<float>(*m_perFrameContext.border_r),
+                                                   static_cast<float>(*m_perFrameContext.border_g),
+                                                   static_cast<float>(*m_perFrameContext.border_b),
+                                                   static_cast<float>(*m_perFrameContext.border_a));
+
+        Renderer::Point const center(static_cast<float>(*m_perFrameContext.x * 2.0 - 1.0),
+                                     static_cast<float>(*m_perFrameContext.y * -2.0 + 1.0));
+        m_instanceVertices.push_back(center);
 
         for (int i = 1; i < sides + 1; i++)
         {
@@ -132,159 +151,159 @@ void CustomShape::Draw()
             const float angle = cornerProgress * pi * 2.0f + static_cast<float>(*m_perFrameContext.ang) + pi * 0.25f;
 
             // Todo: There's still some issue with aspect ratio here, as everything gets squashed horizontally if Y > x.
-            vertexData[i] = Renderer::Point(vertexData[0].X() + static_cast<float>(*m_perFrameContext.rad) * cosf(angle) * m_presetState.renderContext.aspectY,
-                                            vertexData[0].Y() + static_cast<float>(*m_perFrameContext.rad) * sinf(angle));
-
-            colorData[i] = colorData[1];
+            m_instanceVertices.emplace_back(center.X() + static_cast<float>(*m_perFrameContext.rad) * cosf(angle) * m_presetState.renderContext.aspectY,
+                                            center.Y() + static_cast<float>(*m_perFrameContext.rad) * sinf(angle));
         }
 
         // Duplicate last vertex.
-        vertexData[sides + 1] = vertexData[1];
-        colorData[sides + 1] = colorData[1];
+        m_instanceVertices.push_back(m_instanceVertices[instanceDraw.firstVertex + 1]);
 
-        m_fillMesh.SetUseUV(static_cast<int>(*m_perFrameContext.textured) != 0);
-
-        if (m_fillMesh.UseUV())
+        if (instanceDraw.textured)
         {
-            auto shader = m_presetState.texturedShader.lock();
-            shader->Bind();
-            shader->SetUniformMat4x4("vertex_transformation", PresetState::orthogonalProjection);
-            shader->SetUniformInt("texture_sampler", 0);
-
-            // Textured shape, either main texture or texture from "image" key
-            auto textureAspectY = m_presetState.renderContext.aspectY;
-            if (m_image.empty())
-            {
-                assert(!m_presetState.mainTexture.expired());
-                m_presetState.mainTexture.lock()->Bind(0);
-            }
-            else
-            {
-                auto desc = m_presetState.renderContext.textureManager->GetTexture(m_image);
-                if (!desc.Empty())
-                {
-                    desc.Bind(0, *shader);
-                    textureAspectY = 1.0f;
-                }
-                else
-                {
-                    // No texture found, fall back to main texture.
-                    assert(!m_presetState.mainTexture.expired());
-                    m_presetState.mainTexture.lock()->Bind(0);
-                }
-            }
-
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-
-            auto& uvs = m_fillMesh.UVs();
-
-            uvs[0] = Renderer::TextureUV(0.5f, 0.5f);
+            // The texture is only known when drawing, so the texture aspect ratio is applied to U then.
+            m_instanceUVs.resize(instanceDraw.firstVertex);
+            m_instanceUVs.emplace_back(0.0f, 0.5f);
 
             for (int i = 1; i < sides + 1; i++)
             {
                 const float cornerProgress = static_cast<float>(i - 1) / static_cast<float>(sides);
                 const float angle = cornerProgress * pi * 2.0f + static_cast<float>(*m_perFrameContext.tex_ang) + pi * 0.25f;
 
-                uvs[i] = Renderer::TextureUV(0.5f + 0.5f * cosf(angle) / static_cast<float>(*m_perFrameContext.tex_zoom) * textureAspectY,
-                                             1.0f - (0.5f - 0.5f * sinf(angle) / static_cast<float>(*m_perFrameContext.tex_zoom))); // Vertical flip required!
+                m_instanceUVs.emplace_back(0.5f * cosf(angle) / static_cast<float>(*m_perFrameContext.tex_zoom),
+                                           1.0f - (0.5f - 0.5f * sinf(angle) / static_cast<float>(*m_perFrameContext.tex_zoom))); // Vertical flip required!
             }
 
-            uvs[sides + 1] = uvs[1];
-        }
-        else
-        {
-            // Untextured (creates a color gradient: center=r/g/b/a to border=r2/b2/g2/a2)
-            auto shader = m_presetState.untexturedShader.lock();
-            shader->Bind();
-            shader->SetUniformMat4x4("vertex_transformation", PresetState::orthogonalProjection);
+            m_instanceUVs.push_back(m_instanceUVs[instanceDraw.firstVertex + 1]);
         }
 
-        m_fillMesh.Indices().Resize(sides + 2);
-        m_fillMesh.Indices().MakeContinuous();
-        m_fillMesh.Update();
-        m_fillMesh.Draw();
+        commandList.Record([this, instance]() {
+            DrawInstance(m_instanceDraws[instance]);
+        });
+    }
 
-        glBindTexture(GL_TEXTURE_2D, 0);
-        Renderer::Sampler::Unbind(0);
+    commandList.Record([]() {
+        Renderer::Mesh::Unbind();
+        Renderer::Shader::Unbind();
 
-        if (*m_perFrameContext.border_a > 0.0001f)
-        {
-            m_outlineMesh.Indices().Resize(sides);
-            m_outlineMesh.Indices().MakeContinuous();
+#ifndef USE_GLES
+        Renderer::GLStateCache::Current().SetCapability(GL_LINE_SMOOTH, false);
+#endif
+        Renderer::BlendMode::SetBlendActive(false);
+    });
+}
 
-            auto& points = m_outlineMesh.Vertices();
+void CustomShape::DrawInstance(const InstanceDraw& instanceDraw)
+{
+    int const sides = instanceDraw.sides;
+    auto const firstVertex = m_instanceVertices.begin() + instanceDraw.firstVertex;
 
-            for (int i = 0; i < sides; i++)
-            {
-                points[i] = m_fillMesh.Vertex(i + 1);
-            }
+    // Additive Drawing or Overwrite
+    Renderer::BlendMode::SetBlendFunction(Renderer::BlendMode::Function::SourceAlpha,
+                                          instanceDraw.additive
+                                              ? Renderer::BlendMode::Function::One
+                                              : Renderer::BlendMode::Function::OneMinusSourceAlpha);
 
-            auto shader = m_presetState.untexturedShader.lock();
-            shader->Bind();
-            shader->SetUniformMat4x4("vertex_transformation", PresetState::orthogonalProjection);
-            shader->SetUniformFloat("vertex_point_size", 1.0f);
-
-            glVertexAttrib4f(1,
-                             static_cast<float>(*m_perFrameContext.border_r),
-                             static_cast<float>(*m_perFrameContext.border_g),
-                             static_cast<float>(*m_perFrameContext.border_b),
-                             static_cast<float>(*m_perFrameContext.border_a));
-            glLineWidth(1);
-#ifndef USE_GLES
-            glEnable(GL_LINE_SMOOTH);
-#endif
+    auto& vertexData = m_fillMesh.Vertices();
+    auto& colorData = m_fillMesh.Colors();
 
-            const auto iterations = m_thickOutline ? 4 : 1;
+    std::copy(firstVertex, firstVertex + sides + 2, vertexData.Get().begin());
 
-            // Need to use +/- 1.0 here instead of 2.0 used in Milkdrop to achieve the same rendering result.
-            const auto incrementX = 1.0f / static_cast<float>(m_presetState.renderContext.viewportSizeX);
-            const auto incrementY = 1.0f / static_cast<float>(m_presetState.renderContext.viewportSizeY);
+    colorData[0] = instanceDraw.centerColor;
+    std::fill(colorData.Get().begin() + 1, colorData.Get().begin() + sides + 2, instanceDraw.edgeColor);
 
-            // If thick outline is used, draw the shape four times with slight offsets
-            // (top left, top right, bottom right, bottom left).
-            for (auto iteration = 0; iteration < iterations; iteration++)
+    m_fillMesh.SetUseUV(instanceDraw.textured);
+
+    if (m_fillMesh.UseUV())
+    {
+        auto shader = m_presetState.texturedShader.lock();
+        shader->Bind();
+        shader->SetUniformMat4x4("vertex_transformation", PresetState::orthogonalProjection);
+        shader->SetUniformInt("texture_sampler", 0);
+
+        // Textured shape, either main texture or texture from "image" key
+        auto textureAspectY = m_presetState.renderContext.aspectY;
+        if (m_image.empty())
+        {
+            assert(!m_presetState.mainTexture.expired());
+            m_presetState.mainTexture.lock()->Bind(0);
+        }
+        else
+        {
+            auto desc = m_presetState.renderContext.textureManager->GetTexture(m_image);
+            if (!desc.Empty())
+            {
+                desc.Bind(0, *shader);
+                textureAspectY = 1.0f;
+            }
+            else
             {
-                switch (iteration)
-                {
-                    case 0:
-                        break;
-
-                    case 1:
-                        for (auto j = 0; j < sides; j++)
-                        {
-                            points[j].SetX(points[j].X() + incrementX);
-                        }
-                        break;
-
-                    case 2:
-                        for (auto j = 0; j < sides; j++)
-                        {
-                            points[j].SetY(points[j].Y() + incrementY);
-                        }
-                        break;
-
-                    case 3:
-                        for (auto j = 0; j < sides; j++)
-                        {
-                            points[j].SetX(points[j].X() - incrementX);
-                        }
-                        break;
-                }
-
-                m_outlineMesh.Update();
-                m_outlineMesh.Draw();
+                // No texture found, fall back to main texture.
+                assert(!m_presetState.mainTexture.expired());
+                m_presetState.mainTexture.lock()->Bind(0);
             }
         }
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+        auto& uvs = m_fillMesh.UVs();
+        for (int i = 0; i < sides + 2; i++)
+        {
+            auto const& uv = m_instanceUVs[instanceDraw.firstVertex + i];
+            uvs[i] = Renderer::TextureUV(0.5f + uv.U() * textureAspectY, uv.V());
+        }
+    }
+    else
+    {
+        // Untextured (creates a color gradient: center=r/g/b/a to border=r2/b2/g2/a2)
+        auto shader = m_presetState.untexturedShader.lock();
+        shader->Bind();
+        shader->SetUniformMat4x4("vertex_transformation", PresetState::orthogonalProjection);
     }
 
-    Renderer::Mesh::Unbind();
-    Renderer::Shader::Unbind();
+    m_fillMesh.Indices().Resize(sides + 2);
+    m_fillMesh.Indices().MakeContinuous();
+    m_fillMesh.Update();
+    m_fillMesh.Draw();
 
+    Renderer::GLStateCache::Current().BindTexture(0, GL_TEXTURE_2D, 0);
+    Renderer::Sampler::Unbind(0);
+
+    if (instanceDraw.borderColor.A() > 0.0001f)
+    {
+        m_outlineMesh.Indices().Resize(sides);
+        m_outlineMesh.Indices().MakeContinuous();
+
+        std::copy(firstVertex + 1, firstVertex + sides + 1, m_outlineMesh.Vertices().Get().begin());
+
+        auto shader = m_presetState.untexturedShader.lock();
+        shader->Bind();
+        shader->SetUniformMat4x4("vertex_transformation", PresetState::orthogonalProjection);
+        shader->SetUniformFloat("vertex_point_size", 1.0f);
+
+        glVertexAttrib4f(1,
+                         instanceDraw.borderColor.R(),
+                         instanceDraw.borderColor.G(),
+                         instanceDraw.borderColor.B(),
+                         instanceDraw.borderColor.A());
+        glLineWidth(1);
 #ifndef USE_GLES
-    glDisable(GL_LINE_SMOOTH);
+        Renderer::GLStateCache::Current().SetCapability(GL_LINE_SMOOTH, true);
 #endif
-    Renderer::BlendMode::SetBlendActive(false);
+
+        const auto instances = m_thickOutline ? 4 : 1;
+
+        // Need to use +/- 1.0 here instead of 2.0 used in Milkdrop to achieve the same rendering result.
+        const auto incrementX = 1.0f / static_cast<float>(m_presetState.renderContext.viewportSizeX);
+        const auto incrementY = 1.0f / static_cast<float>(m_presetState.renderContext.viewportSizeY);
+
+        // If thick outline is used, draw the shape as four instances with slight offsets
+        // (top left, top right, bottom right, bottom left), see the untextured vertex shader.
+        shader->SetUniformFloat2("thick_offset", {incrementX, incrementY});
+
+        m_outlineMesh.Update();
+        m_outlineMesh.Draw(instances);
+    }
 }
 
 } // namespace MilkdropPreset
@@ -4,14 +4,18 @@
 #include "PresetState.hpp"
 #include "ShapePerFrameContext.hpp"
 
+#include <Renderer/CommandList.hpp>
 #include <Renderer/Mesh.hpp>
 
 #include <projectm-eval.h>
 
+#include <cstdint>
+#include <vector>
+
 namespace libprojectM {
 namespace MilkdropPreset {
 
-class PresetFileParser;
+class PresetDataSource;
 
 /**
  * @brief Renders a custom shape with or without a texture.
@@ -28,10 +32,10 @@ public:
 
     /**
      * @brief Loads the initial values and code from the preset file.
-     * @param parsedFile The file parser with the preset data.
+     * @param parsedFile The parsed or precompiled preset data.
      * @param index The waveform index.
      */
-    void Initialize(PresetFileParser& parsedFile, int index);
+    void Initialize(const PresetDataSource& parsedFile, int index);
 
     /**
      * @brief Compiles all code blocks and runs the init expression.
@@ -40,11 +44,38 @@ public:
     void CompileCodeAndRunInitExpressions();
 
     /**
-     * @brief Renders the shape.
+     * @brief Returns whether the shape is drawn at all.
+     * @return true if the shape is enabled in the preset, false if not.
+     */
+    auto Enabled() const -> bool;
+
+    /**
+     * @brief Runs the per-frame code of all instances and records the commands to render them.
+     * Doesn't call OpenGL, so it can be run on the command recording thread.
+     * @param commandList The command list to record the draw commands into.
      */
-    void Draw();
+    void Record(Renderer::CommandList& commandList);
 
 private:
+    /**
+     * @brief Draw parameters of a single shape instance, computed by Record().
+     */
+    struct InstanceDraw {
+        uint32_t firstVertex{};      //!< Index of the center vertex in m_instanceVertices and m_instanceUVs.
+        int sides{};                 //!< Number of corners, 3 to 100.
+        bool additive{false};        //!< If true, the instance is blended additively.
+        bool textured{false};        //!< If true, the instance is filled with a texture.
+        Renderer::Color centerColor; //!< Fill color in the center.
+        Renderer::Color edgeColor;   //!< Fill color at the corners.
+        Renderer::Color borderColor; //!< Outline color. No outline is drawn if alpha is zero.
+    };
+
+    /**
+     * @brief Uploads and draws the fill and outline meshes of a recorded instance.
+     * @param instanceDraw The instance to draw.
+     */
+    void DrawInstance(const InstanceDraw& instanceDraw);
+
     Renderer::Mesh m_outlineMesh; //!< The shape's border/outline mesh.
     Renderer::Mesh m_fillMesh; //!< The shape's color/texture mesh.
 
@@ -89,6 +120,10 @@ private:
     PresetState& m_presetState; //!< The global preset state.
     ShapePerFrameContext m_perFrameContext;
 
+    std::vector<InstanceDraw> m_instanceDraws;       //!< The instances recorded in the current frame.
+    std::vector<Renderer::Point> m_instanceVertices; //!< Fill vertices of all recorded instances: center, corners and the first corner again.
+    std::vector<Renderer::TextureUV> m_instanceUVs;  //!< Texture coordinates of the textured instances, with U relative to the center and not yet scaled by the texture aspect ratio.
+
     friend class ShapePerFrameContext;
 };
 
@@ -1,9 +1,12 @@
 #include "CustomWaveform.hpp"
 
 #include "PerFrameContext.hpp"
-#include "PresetFileParser.hpp"
+#include "PresetDataSource.hpp"
 
 #include <Renderer/BlendMode.hpp>
+#include <Renderer/GLStateCache.hpp>
+
+#include <Tracing.hpp>
 
 #include <algorithm>
 #include <cmath>
@@ -27,25 +30,22 @@ CustomWaveform::CustomWaveform(PresetState& presetState)
     m_mesh.SetVertexCount(std::max(Audio::SpectrumSamples, Audio::WaveformSamples) * 2 + 2);
 }
 
-void CustomWaveform::Initialize(PresetFileParser& parsedFile, int index)
+void CustomWaveform::Initialize(const PresetDataSource& parsedFile, int index)
 {
-    std::string const wavecodePrefix = "wavecode_" + std::to_string(index) + "_";
-    std::string const wavePrefix = "wave_" + std::to_string(index) + "_";
-
     m_index = index;
-    m_enabled = parsedFile.GetBool(wavecodePrefix + "enabled", m_enabled);
-    m_samples = parsedFile.GetInt(wavecodePrefix + "samples", m_samples);
-    m_sep = parsedFile.GetInt(wavecodePrefix + "sep", m_sep);
-    m_spectrum = parsedFile.GetBool(wavecodePrefix + "bSpectrum", m_spectrum);
-    m_useDots = parsedFile.GetBool(wavecodePrefix + "bUseDots", m_useDots);
-    m_drawThick = parsedFile.GetBool(wavecodePrefix + "bDrawThick", m_drawThick);
-    m_additive = parsedFile.GetBool(wavecodePrefix + "bAdditive", m_additive);
-    m_scaling = parsedFile.GetFloat(wavecodePrefix + "scaling", m_scaling);
-    m_smoothing = parsedFile.GetFloat(wavecodePrefix + "smoothing", m_smoothing);
-    m_r = parsedFile.GetFloat(wavecodePrefix + "r", m_r);
-    m_g = parsedFile.GetFloat(wavecodePrefix + "g", m_g);
-    m_b = parsedFile.GetFloat(wavecodePrefix + "b", m_b);
-    m_a = parsedFile.GetFloat(wavecodePrefix + "a", m_a);
+    m_enabled = parsedFile.GetBool(PresetKeyTable::Slot(WaveKey::Enabled, m_index), m_enabled);
+    m_samples = parsedFile.GetInt(PresetKeyTable::Slot(WaveKey::Samples, m_index), m_samples);
+    m_sep = parsedFile.GetInt(PresetKeyTable::Slot(WaveKey::Sep, m_index), m_sep);
+    m_spectrum = parsedFile.GetBool(PresetKeyTable::Slot(WaveKey::Spectrum, m_index), m_spectrum);
+    m_useDots = parsedFile.GetBool(PresetKeyTable::Slot(WaveKey::UseDots, m_index), m_useDots);
+    m_drawThick = parsedFile.GetBool(PresetKeyTable::Slot(WaveKey::DrawThick, m_index), m_drawThick);
+    m_additive = parsedFile.GetBool(PresetKeyTable::Slot(WaveKey::Additive, m_index), m_additive);
+    m_scaling = parsedFile.GetFloat(PresetKeyTable::Slot(WaveKey::Scaling, m_index), m_scaling);
+    m_smoothing = parsedFile.GetFloat(PresetKeyTable::Slot(WaveKey::Smoothing, m_index), m_smoothing);
+    m_r = parsedFile.GetFloat(PresetKeyTable::Slot(WaveKey::R, m_index), m_r);
+    m_g = parsedFile.GetFloat(PresetKeyTable::Slot(WaveKey::G, m_index), m_g);
+    m_b = parsedFile.GetFloat(PresetKeyTable::Slot(WaveKey::B, m_index), m_b);
+    m_a = parsedFile.GetFloat(PresetKeyTable::Slot(WaveKey::A, m_index), m_a);
 
     m_mesh.SetRenderPrimitiveType(m_useDots ? Renderer::Mesh::PrimitiveType::Points : Renderer::Mesh::PrimitiveType::LineStrip);
 }
@@ -64,7 +64,12 @@ void CustomWaveform::CompileCodeAndRunInitExpressions(const PerFrameContext& pre
     m_perPointContext.CompilePerPointCode(m_presetState.customWavePerPointCode[m_index], *this);
 }
 
-void CustomWaveform::Draw(const PerFrameContext& presetPerFrameContext)
+auto CustomWaveform::Enabled() const -> bool
+{
+    return m_enabled;
+}
+
+void CustomWaveform::Record(Renderer::CommandList& commandList, const PerFrameContext& presetPerFrameContext)
 {
     static_assert(Audio::WaveformSamples <= WaveformMaxPoints, "WaveformMaxPoints is larger than WaveformSamples");
     static_assert(Audio::SpectrumSamples <= WaveformMaxPoints, "WaveformMaxPoints is larger than SpectrumSamples");
@@ -74,6 +79,8 @@ void CustomWaveform::Draw(const PerFrameContext& presetPerFrameContext)
         return;
     }
 
+    TRACE_SCOPE("CustomWaveform::Record");
+
     int const maxSampleCount{m_spectrum ? Audio::SpectrumSamples : Audio::WaveformSamples};
 
     int sampleCount = std::min(maxSampleCount, static_cast<int>(*m_perFrameContext.samples));
@@ -159,8 +166,15 @@ void CustomWaveform::Draw(const PerFrameContext& presetPerFrameContext)
 
     SmoothWave(points, colors);
 
+    commandList.Record([this]() {
+        DrawMesh();
+    });
+}
+
+void CustomWaveform::DrawMesh()
+{
 #ifndef USE_GLES
-    glDisable(GL_LINE_SMOOTH);
+    Renderer::GLStateCache::Current().SetCapability(GL_LINE_SMOOTH, false);
 #endif
     glLineWidth(1);
 
@@ -179,51 +193,18 @@ void CustomWaveform::Draw(const PerFrameContext& presetPerFrameContext)
     shader->SetUniformMat4x4("vertex_transformation", PresetState::orthogonalProjection);
     shader->SetUniformFloat("vertex_point_size", m_drawThick ? 2.0f : 1.0f);
 
-    auto iterations = (m_drawThick && !m_useDots) ? 4 : 1;
+    auto instances = (m_drawThick && !m_useDots) ? 4 : 1;
 
     // Need to use +/- 1.0 here instead of 2.0 used in Milkdrop to achieve the same rendering result.
     auto incrementX = 1.0f / static_cast<float>(m_presetState.renderContext.viewportSizeX);
     auto incrementY = 1.0f / static_cast<float>(m_presetState.renderContext.viewportSizeX);
 
-    size_t smoothedVertexCount = m_mesh.Indices().Size();
+    // If thick outline is used, draw the wave as four instances with slight offsets
+    // (top left, top right, bottom right, bottom left), see the untextured vertex shader.
+    shader->SetUniformFloat2("thick_offset", {incrementX, incrementY});
 
-    auto& vertices = m_mesh.Vertices();
-
-    // If thick outline is used, draw the shape four times with slight offsets
-    // (top left, top right, bottom right, bottom left).
-    for (auto iteration = 0; iteration < iterations; iteration++)
-    {
-        switch (iteration)
-        {
-            case 0:
-            default:
-                break;
-
-            case 1:
-                for (size_t j = 0; j < smoothedVertexCount; j++)
-                {
-                    vertices[j].SetX(vertices[j].X() + incrementX);
-                }
-                break;
-
-            case 2:
-                for (size_t j = 0; j < smoothedVertexCount; j++)
-                {
-                    vertices[j].SetY(vertices[j].Y() + incrementY);
-                }
-                break;
-
-            case 3:
-                for (size_t j = 0; j < smoothedVertexCount; j++)
-                {
-                    vertices[j].SetX(vertices[j].X() - incrementX);
-                }
-                break;
-        }
-
-        m_mesh.Update();
-        m_mesh.Draw();
-    }
+    m_mesh.Update();
+    m_mesh.Draw(instances);
 
     m_mesh.Unbind();
     Renderer::Shader::Unbind();
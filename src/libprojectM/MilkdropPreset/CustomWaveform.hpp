@@ -4,6 +4,7 @@
 #include "WaveformPerPointContext.hpp"
 
 #include <Renderer/Color.hpp>
+#include <Renderer/CommandList.hpp>
 #include <Renderer/Mesh.hpp>
 #include <Renderer/Point.hpp>
 
@@ -12,7 +13,7 @@
 namespace libprojectM {
 namespace MilkdropPreset {
 
-class PresetFileParser;
+class PresetDataSource;
 
 class CustomWaveform
 {
@@ -26,10 +27,10 @@ public:
 
     /**
      * @brief Loads the initial values and code from the preset file.
-     * @param parsedFile The file parser with the preset data.
+     * @param parsedFile The parsed or precompiled preset data.
      * @param index The waveform index.
      */
-    void Initialize(PresetFileParser& parsedFile, int index);
+    void Initialize(const PresetDataSource& parsedFile, int index);
 
     /**
      * @brief Compiles all code blocks and runs the init expression.
@@ -39,12 +40,25 @@ public:
     void CompileCodeAndRunInitExpressions(const PerFrameContext& presetPerFrameContext);
 
     /**
-     * @brief Renders the waveform.
+     * @brief Returns whether the waveform is drawn at all.
+     * @return true if the waveform is enabled in the preset, false if not.
+     */
+    auto Enabled() const -> bool;
+
+    /**
+     * @brief Runs the per-frame and per-point code and records the commands to render the waveform.
+     * Doesn't call OpenGL, so it can be run on the command recording thread.
+     * @param commandList The command list to record the draw commands into.
      * @param presetPerFrameContext The per-frame context to retrieve the init Q vars from.
      */
-    void Draw(const PerFrameContext& presetPerFrameContext);
+    void Record(Renderer::CommandList& commandList, const PerFrameContext& presetPerFrameContext);
 
 private:
+    /**
+     * @brief Uploads and draws the waveform mesh generated by Record().
+     */
+    void DrawMesh();
+
     /**
      * @brief Initializes the per-frame context with the preset per-frame state.
      * @param presetPerFrameContext The preset per-frame context to pull q vars from.
@@ -2,6 +2,14 @@
 
 #include "IdlePreset.hpp"
 #include "MilkdropPreset.hpp"
+#include "MilkdropPresetExceptions.hpp"
+#include "PresetBundle.hpp"
+#include "PresetFileParser.hpp"
+
+#include <Logging.hpp>
+
+#include <fstream>
+#include <vector>
 
 namespace libprojectM {
 namespace MilkdropPreset {
@@ -30,5 +38,49 @@ std::unique_ptr<Preset> Factory::LoadPresetFromStream(std::istream& data)
     return std::make_unique<MilkdropPreset>(data);
 }
 
+std::unique_ptr<Preset> Factory::LoadPresetFromBundle(const PresetBundle& bundle, int index, const std::string& path)
+{
+    std::ifstream sourceStream(path, std::ios_base::in | std::ios_base::binary | std::ios_base::ate);
+    if (!sourceStream.good())
+    {
+        // Only the bundle is available, e.g. presets were shipped in compiled form only.
+        return std::make_unique<MilkdropPreset>(bundle.Preset(index), path);
+    }
+
+    auto const sourceSize = sourceStream.tellg();
+    if (sourceSize < 0 || static_cast<uint64_t>(sourceSize) != bundle.SourceSize(index))
+    {
+        LOG_DEBUG("[MilkdropPresetFactory] Bundled preset \"" + path + "\" is outdated, loading from source.");
+        return {};
+    }
+
+    if (PresetBundle::ModificationTime(path) == bundle.SourceModificationTime(index))
+    {
+        return std::make_unique<MilkdropPreset>(bundle.Preset(index), path);
+    }
+
+    // The file was touched or copied, only use the bundle if the contents are still the same.
+    std::vector<char> sourceData(static_cast<size_t>(sourceSize));
+    sourceStream.seekg(0, std::ios_base::beg);
+    if (!sourceStream.read(sourceData.data(), sourceSize))
+    {
+        return {};
+    }
+
+    if (PresetBundle::HashSource(sourceData.data(), sourceData.size()) == bundle.SourceHash(index))
+    {
+        return std::make_unique<MilkdropPreset>(bundle.Preset(index), path);
+    }
+
+    // The data was read anyway, so parse it directly instead of reading the file again.
+    LOG_DEBUG("[MilkdropPresetFactory] Bundled preset \"" + path + "\" is outdated, loading from source.");
+    PresetFileParser parser;
+    if (!parser.Read(std::move(sourceData)))
+    {
+        throw MilkdropPresetLoadException("[MilkdropPresetFactory] Could not parse preset file \"" + path + "\".");
+    }
+    return std::make_unique<MilkdropPreset>(parser, path);
+}
+
 } // namespace MilkdropPreset
 } // namespace libprojectM
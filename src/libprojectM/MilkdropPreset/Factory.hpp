@@ -15,10 +15,13 @@
 #include <PresetFactory.hpp>
 
 #include <memory>
+#include <string>
 
 namespace libprojectM {
 namespace MilkdropPreset {
 
+class PresetBundle;
+
 class Factory : public PresetFactory
 {
 
@@ -32,6 +35,20 @@ public:
         return ".milk .prjm";
     }
 
+    /**
+     * @brief Creates a preset from a bundle record if its source file is unchanged.
+     *
+     * The bundle record is used without reading the source file if its size and modification time
+     * match the bundle, or if the file doesn't exist. If only the modification time differs, the
+     * file contents are hashed, and parsed directly if they differ from the bundle.
+     *
+     * @param bundle The bundle containing the preset.
+     * @param index The preset index in the bundle.
+     * @param path The preset source file path.
+     * @return The preset, or nullptr if the source file changed and must be loaded with LoadPresetFromFile().
+     */
+    static std::unique_ptr<Preset> LoadPresetFromBundle(const PresetBundle& bundle, int index, const std::string& path);
+
 };
 
 } // namespace MilkdropPreset
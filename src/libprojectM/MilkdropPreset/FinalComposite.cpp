@@ -13,7 +13,7 @@ namespace MilkdropPreset {
 static std::string const defaultCompositeShader = "shader_body\n{\nret = tex2D(sampler_main, uv).xyz;\n}";
 
 FinalComposite::FinalComposite()
-    : m_compositeMesh(Renderer::VertexBufferUsage::StreamDraw, true, true)
+    : m_compositeMesh(Renderer::VertexBufferUsage::StaticDraw, false, true)
 {
     m_compositeMesh.SetRenderPrimitiveType(Renderer::Mesh::PrimitiveType::Triangles);
 
@@ -61,15 +61,8 @@ void FinalComposite::LoadCompositeShader(const PresetState& presetState)
     }
     else
     {
-        // Video echo OR gamma adjustment with random hue.
-        m_videoEcho = std::make_unique<VideoEcho>(presetState);
-        if (presetState.brighten ||
-            presetState.darken ||
-            presetState.solarize ||
-            presetState.invert)
-        {
-            m_filters = std::make_unique<Filters>(presetState);
-        }
+        // Video echo OR gamma adjustment with random hue, followed by the color filters.
+        m_postProcess = std::make_unique<PostProcess>(presetState);
     }
 }
 
@@ -91,6 +84,8 @@ void FinalComposite::CompileCompositeShader(PresetState& presetState)
             m_compositeShader->LoadCode(defaultCompositeShader);
             m_compositeShader->LoadTexturesAndCompile(presetState);
         }
+
+        m_hueShaderColors = m_compositeShader->Shader().GetUniform<glm::mat4x4>("hue_shader_colors");
     }
 }
 
@@ -99,23 +94,19 @@ void FinalComposite::Draw(const PresetState& presetState, const PerFrameContext&
     if (m_compositeShader)
     {
         InitializeMesh(presetState);
-        ApplyHueShaderColors(presetState);
 
         // Render the grid
         Renderer::BlendMode::SetBlendActive(false);
         m_compositeShader->LoadVariables(presetState, perFrameContext);
+        m_compositeShader->Shader().SetUniform(m_hueShaderColors, HueShaderColors(presetState));
 
         m_compositeMesh.Draw();
         Renderer::Mesh::Unbind();
     }
     else
     {
-        // Apply old-school filters
-        m_videoEcho->Draw();
-        if (m_filters)
-        {
-            m_filters->Draw();
-        }
+        // Apply old-school effects
+        m_postProcess->Draw();
     }
 
     Renderer::Shader::Unbind();
@@ -126,6 +117,11 @@ auto FinalComposite::HasCompositeShader() const -> bool
     return m_compositeShader != nullptr;
 }
 
+auto FinalComposite::UsesBlurTextures() const -> bool
+{
+    return m_compositeShader && m_compositeShader->RequiredBlurLevel() != BlurTexture::BlurLevel::None;
+}
+
 void FinalComposite::InitializeMesh(const PresetState& presetState)
 {
     if (m_viewportWidth == presetState.renderContext.viewportSizeX &&
@@ -317,60 +313,26 @@ void FinalComposite::UvToMathSpace(float aspectX, float aspectY,
     }
 }
 
-void FinalComposite::ApplyHueShaderColors(const PresetState& presetState)
+auto FinalComposite::HueShaderColors(const PresetState& presetState) -> glm::mat4x4
 {
-    std::array<std::array<float, 3>, 4> shade = {{{1.0f, 1.0f, 1.0f},
-                                                  {1.0f, 1.0f, 1.0f},
-                                                  {1.0f, 1.0f, 1.0f},
-                                                  {1.0f, 1.0f, 1.0f}}};
+    glm::mat4x4 colors;
 
     for (int i = 0; i < 4; i++)
     {
         auto const indexFloat = static_cast<float>(i);
-        shade[i][0] = 0.6f + 0.3f * sinf(presetState.renderContext.time * 30.0f * 0.0143f + 3 + indexFloat * 21 + presetState.hueRandomOffsets[3]);
-        shade[i][1] = 0.6f + 0.3f * sinf(presetState.renderContext.time * 30.0f * 0.0107f + 1 + indexFloat * 13 + presetState.hueRandomOffsets[1]);
-        shade[i][2] = 0.6f + 0.3f * sinf(presetState.renderContext.time * 30.0f * 0.0129f + 6 + indexFloat * 9 + presetState.hueRandomOffsets[2]);
+        glm::vec3 shade{0.6f + 0.3f * sinf(presetState.renderContext.time * 30.0f * 0.0143f + 3 + indexFloat * 21 + presetState.hueRandomOffsets[3]),
+                        0.6f + 0.3f * sinf(presetState.renderContext.time * 30.0f * 0.0107f + 1 + indexFloat * 13 + presetState.hueRandomOffsets[1]),
+                        0.6f + 0.3f * sinf(presetState.renderContext.time * 30.0f * 0.0129f + 6 + indexFloat * 9 + presetState.hueRandomOffsets[2])};
 
-        float const max = std::max(shade[i][0], std::max(shade[i][1], shade[i][2]));
+        float const max = std::max(shade[0], std::max(shade[1], shade[2]));
 
-        for (int k = 0; k < 3; k++)
-        {
-            shade[i][k] /= max;
-            shade[i][k] = 0.5f + 0.5f * shade[i][k];
-        }
-    }
+        shade /= max;
+        shade = 0.5f + 0.5f * shade;
 
-    // Interpolate and apply to all grid vertices.
-    auto& vertices = m_compositeMesh.Vertices();
-    auto& colors = m_compositeMesh.Colors();
-
-    for (int gridY = 0; gridY < compositeGridHeight; gridY++)
-    {
-        for (int gridX = 0; gridX < compositeGridWidth; gridX++)
-        {
-            auto vertexIndex = gridX + gridY * compositeGridWidth;
-            float x = vertices[vertexIndex].X() * 0.5f + 0.5f;
-            float y = vertices[vertexIndex].Y() * 0.5f + 0.5f;
-
-            std::array<float, 3> color{{1.0f, 1.0f, 1.0f}};
-            for (int col = 0; col < 3; col++)
-            {
-                color[col] = shade[0][col] * (x) * (y) +
-                             shade[1][col] * (1 - x) * (y) +
-                             shade[2][col] * (x) * (1 - y) +
-                             shade[3][col] * (1 - x) * (1 - y);
-            }
-
-            colors[vertexIndex] = {color[0],
-                                   color[1],
-                                   color[2],
-                                   1.0f};
-        }
+        colors[i] = glm::vec4(shade, 1.0f);
     }
 
-    // Only update color buffer.
-    m_compositeMesh.Bind();
-    m_compositeMesh.Colors().Update();
+    return colors;
 }
 
 } // namespace MilkdropPreset
@@ -1,8 +1,7 @@
 #pragma once
 
-#include "Filters.hpp"
 #include "MilkdropShader.hpp"
-#include "VideoEcho.hpp"
+#include "PostProcess.hpp"
 
 #include <Renderer/Mesh.hpp>
 
@@ -45,6 +44,12 @@ public:
      */
     auto HasCompositeShader() const -> bool;
 
+    /**
+     * @brief Returns whether the composite shader samples any blur texture.
+     * @return true if the compiled composite shader uses a blur texture, false if not or if there is no composite shader.
+     */
+    auto UsesBlurTextures() const -> bool;
+
 private:
     /**
      * Composite mesh vertex with all required attributes.
@@ -77,25 +82,27 @@ private:
                               float u, float v, float& rad, float& ang);
 
     /**
-     * @brief Calculates the randomized, slowly changing diffuse colors.
+     * @brief Calculates the randomized, slowly changing diffuse colors of the four screen corners.
+     * The composite vertex shader interpolates them across the grid.
      * @param presetState The preset state to retrieve the configuration values from.
+     * @return The corner colors, one per matrix column.
      */
-    void ApplyHueShaderColors(const PresetState& presetState);
+    static auto HueShaderColors(const PresetState& presetState) -> glm::mat4x4;
 
     static constexpr int compositeGridWidth{32};
     static constexpr int compositeGridHeight{24};
     static constexpr int vertexCount{compositeGridWidth * compositeGridHeight};
     static constexpr int indexCount{(compositeGridWidth - 2) * (compositeGridHeight - 2) * 6};
 
-    Renderer::Mesh m_compositeMesh;                                                                 //!< The composite shader mesh.
-    Renderer::VertexBuffer<Renderer::Point> m_radiusAngle{Renderer::VertexBufferUsage::StreamDraw}; //!< Additional vertex attribute array for radius and angle.
+    Renderer::Mesh m_compositeMesh;                                                                 //!< The composite shader mesh. Only updated if the viewport size changes.
+    Renderer::VertexBuffer<Renderer::Point> m_radiusAngle{Renderer::VertexBufferUsage::StaticDraw}; //!< Additional vertex attribute array for radius and angle.
+    Renderer::UniformHandle<glm::mat4x4> m_hueShaderColors;                                         //!< The hue_shader_colors uniform of the composite shader.
 
     int m_viewportWidth{};  //!< Last known viewport width.
     int m_viewportHeight{}; //!< Last known viewport height.
 
     std::unique_ptr<MilkdropShader> m_compositeShader; //!< The composite shader. Either preset-defined or empty.
-    std::unique_ptr<VideoEcho> m_videoEcho;            //!< Video echo effect. Used if no composite shader is loaded and video echo is enabled.
-    std::unique_ptr<Filters> m_filters;                //!< Color post-processing filters. Used if no composite shader is loaded.
+    std::unique_ptr<PostProcess> m_postProcess;        //!< Video echo, gamma and color filters. Used if no composite shader is loaded.
 };
 
 } // namespace MilkdropPreset
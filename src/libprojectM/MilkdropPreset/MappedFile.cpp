@@ -0,0 +1,128 @@
+#include "MappedFile.hpp"
+
+#include <fstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <windows.h>
+
+// Fall back to boost if compiler doesn't support C++17
+#include PROJECTM_FILESYSTEM_INCLUDE
+using namespace PROJECTM_FILESYSTEM_NAMESPACE::filesystem;
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace libprojectM {
+namespace MilkdropPreset {
+
+MappedFile::MappedFile(const std::string& fileName)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path(fileName).wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        throw std::runtime_error("Could not open file \"" + fileName + "\".");
+    }
+    m_fileHandle = file;
+
+    LARGE_INTEGER fileSize{};
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0)
+    {
+        Unmap();
+        throw std::runtime_error("File \"" + fileName + "\" is empty.");
+    }
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+
+    m_mappingHandle = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mappingHandle != nullptr)
+    {
+        m_data = static_cast<const char*>(MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    }
+    if (m_data != nullptr)
+    {
+        return;
+    }
+#else
+    int const fileDescriptor = open(fileName.c_str(), O_RDONLY);
+    if (fileDescriptor < 0)
+    {
+        throw std::runtime_error("Could not open file \"" + fileName + "\".");
+    }
+
+    struct stat fileStat{};
+    if (fstat(fileDescriptor, &fileStat) != 0 || fileStat.st_size <= 0)
+    {
+        close(fileDescriptor);
+        throw std::runtime_error("File \"" + fileName + "\" is empty.");
+    }
+    m_size = static_cast<size_t>(fileStat.st_size);
+
+    void* mappedData = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    close(fileDescriptor);
+
+    if (mappedData != MAP_FAILED)
+    {
+        m_data = static_cast<const char*>(mappedData);
+        return;
+    }
+#endif
+
+    // Mapping not supported, e.g. on some virtual file systems. Read the whole file instead.
+    std::ifstream fileStream(fileName, std::ios_base::in | std::ios_base::binary);
+    m_fallbackData.resize(m_size);
+    if (!fileStream.read(m_fallbackData.data(), static_cast<std::streamsize>(m_size)))
+    {
+        Unmap();
+        throw std::runtime_error("Could not read file \"" + fileName + "\".");
+    }
+    m_data = m_fallbackData.data();
+}
+
+MappedFile::~MappedFile()
+{
+    Unmap();
+}
+
+auto MappedFile::Data() const -> const char*
+{
+    return m_data;
+}
+
+auto MappedFile::Size() const -> size_t
+{
+    return m_size;
+}
+
+void MappedFile::Unmap()
+{
+#ifdef _WIN32
+    if (m_data != nullptr && m_fallbackData.empty())
+    {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mappingHandle != nullptr)
+    {
+        CloseHandle(m_mappingHandle);
+        m_mappingHandle = nullptr;
+    }
+    if (m_fileHandle != nullptr)
+    {
+        CloseHandle(m_fileHandle);
+        m_fileHandle = nullptr;
+    }
+#else
+    if (m_data != nullptr && m_fallbackData.empty())
+    {
+        munmap(const_cast<char*>(m_data), m_size);
+    }
+#endif
+    m_data = nullptr;
+}
+
+} // namespace MilkdropPreset
+} // namespace libprojectM
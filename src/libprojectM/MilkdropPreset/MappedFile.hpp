@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace libprojectM {
+namespace MilkdropPreset {
+
+/**
+ * @brief Read-only memory mapping of a whole file.
+ *
+ * Falls back to reading the file into memory if the platform or file system doesn't support mapping it.
+ */
+class MappedFile
+{
+public:
+    /**
+     * @brief Opens and maps the given file.
+     * @param fileName The file to map.
+     * @throws std::runtime_error If the file can't be opened or read, or if it is empty.
+     */
+    explicit MappedFile(const std::string& fileName);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    auto operator=(const MappedFile&) -> MappedFile& = delete;
+
+    /**
+     * @brief Returns a pointer to the file contents.
+     * @return The first byte of the file contents. Valid as long as this object exists.
+     */
+    auto Data() const -> const char*;
+
+    /**
+     * @brief Returns the file size.
+     * @return The size of the file in bytes.
+     */
+    auto Size() const -> size_t;
+
+private:
+    void Unmap();
+
+    const char* m_data{nullptr};      //!< The file contents.
+    size_t m_size{};                  //!< The file size in bytes.
+    std::vector<char> m_fallbackData; //!< File contents if mapping failed.
+#ifdef _WIN32
+    void* m_fileHandle{nullptr};    //!< The open file handle.
+    void* m_mappingHandle{nullptr}; //!< The file mapping handle.
+#endif
+};
+
+} // namespace MilkdropPreset
+} // namespace libprojectM
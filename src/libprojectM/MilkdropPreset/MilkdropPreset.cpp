@@ -25,11 +25,34 @@
 #include "MilkdropPresetExceptions.hpp"
 #include "PresetFileParser.hpp"
 
+#include <Renderer/CommandRecorder.hpp>
+#include <Renderer/FileSource.hpp>
+
 #include <Logging.hpp>
+#include <Tracing.hpp>
 
 namespace libprojectM {
 namespace MilkdropPreset {
 
+namespace {
+
+/**
+ * @brief Logs all keys in the parsed file which are not used by presets, e.g. typos.
+ */
+void LogUnknownKeys(const PresetFileParser& parser)
+{
+#ifdef ENABLE_DEBUG_LOGGING
+    for (const auto& key : parser.UnknownKeys())
+    {
+        LOG_DEBUG("[MilkdropPreset] Ignoring unknown preset key \"" + key + "\".")
+    }
+#else
+    static_cast<void>(parser);
+#endif
+}
+
+} // namespace
+
 MilkdropPreset::MilkdropPreset(const std::string& absoluteFilePath)
     : m_absoluteFilePath(absoluteFilePath)
     , m_perFrameContext(m_state.globalMemory, &m_state.globalRegisters)
@@ -53,9 +76,26 @@ MilkdropPreset::MilkdropPreset(std::istream& presetData)
     Load(presetData);
 }
 
+MilkdropPreset::MilkdropPreset(const PresetDataSource& presetData, const std::string& absoluteFilePath)
+    : m_absoluteFilePath(absoluteFilePath)
+    , m_perFrameContext(m_state.globalMemory, &m_state.globalRegisters)
+    , m_perPixelContext(m_state.globalMemory, &m_state.globalRegisters)
+    , m_motionVectors(m_state)
+    , m_waveform(m_state)
+    , m_darkenCenter(m_state)
+    , m_border(m_state)
+{
+    LOG_DEBUG("[MilkdropPreset] Loading precompiled preset \"" + absoluteFilePath + "\".")
+
+    SetFilename(ParseFilename(absoluteFilePath));
+
+    InitializePreset(presetData);
+}
+
 void MilkdropPreset::Initialize(const Renderer::RenderContext& renderContext)
 {
     assert(renderContext.textureManager);
+    assert(renderContext.texturePool);
     m_state.renderContext = renderContext;
     m_state.blurTexture.Initialize(renderContext);
     m_state.LoadShaders();
@@ -63,9 +103,34 @@ void MilkdropPreset::Initialize(const Renderer::RenderContext& renderContext)
     // Initialize variables and code now we have a proper render state.
     CompileCodeAndRunInitExpressions();
 
-    // Update framebuffer and texture sizes if needed
+    // Lease the offscreen rendering surfaces from the shared pool, so presets reuse each other's textures.
+    if (!m_motionVectorUVMap)
+    {
+        auto& texturePool = *renderContext.texturePool;
+        auto const mainImageFormat = Renderer::TextureFormat::FromRenderFormat(renderContext.mainRenderFormat);
+        m_framebuffer.CreateColorAttachment(0, 0, texturePool, Renderer::TexturePool::Usage::MainImage, mainImageFormat); // Main image 1
+        m_framebuffer.CreateColorAttachment(1, 0, texturePool, Renderer::TexturePool::Usage::MainImage, mainImageFormat); // Main image 2
+        m_motionVectorUVMap = std::make_shared<Renderer::TextureAttachment>(texturePool, Renderer::TexturePool::Usage::MotionVectors,
+                                                                            Renderer::TextureFormat{GL_RG16F, GL_RG, GL_FLOAT}, 0, 0);
+    }
+
+    // Update framebuffer and texture formats and sizes if needed
+    SetMainImageFormat(renderContext);
     m_framebuffer.SetSize(renderContext.viewportSizeX, renderContext.viewportSizeY);
     m_motionVectorUVMap->SetSize(renderContext.viewportSizeX, renderContext.viewportSizeY);
+
+    // Leased images may still contain the frames of a previous preset.
+    if (m_framebuffer.Width() > 0 && m_framebuffer.Height() > 0)
+    {
+        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+        for (int image = 0; image < 2; image++)
+        {
+            m_framebuffer.Bind(image);
+            glClear(GL_COLOR_BUFFER_BIT);
+        }
+        Renderer::Framebuffer::Unbind();
+    }
+
     if (m_state.mainTexture.expired())
     {
         m_state.mainTexture = m_framebuffer.GetColorAttachmentTexture(1, 0);
@@ -73,96 +138,192 @@ void MilkdropPreset::Initialize(const Renderer::RenderContext& renderContext)
 
     m_perPixelMesh.CompileWarpShader(m_state);
     m_finalComposite.CompileCompositeShader(m_state);
+
+    // The graph depends on which shaders compiled, so it's rebuilt with the next frame.
+    m_renderGraph.Clear();
 }
 
 void MilkdropPreset::RenderFrame(const libprojectM::Audio::FrameAudioData& audioData, const Renderer::RenderContext& renderContext)
 {
     m_state.audioData = audioData;
+    m_state.audioTexture.Update(audioData);
     m_state.renderContext = renderContext;
 
-    // Update framebuffer and u/v texture size if needed
+    // Update framebuffer format and size and u/v texture size if needed
+    auto const lastFrameImage = m_framebuffer.GetColorAttachmentTexture(m_previousFrameBuffer, 0);
+    bool reallocated = SetMainImageFormat(renderContext);
     if (m_framebuffer.SetSize(renderContext.viewportSizeX, renderContext.viewportSizeY))
     {
         m_motionVectorUVMap->SetSize(renderContext.viewportSizeX, renderContext.viewportSizeY);
         m_isFirstFrame = true;
+        reallocated = true;
     }
 
+    if (reallocated)
+    {
+        // Keep the image when resizing or changing the format, e.g. if the outgoing preset of a transition is rendered at a lower resolution.
+        if (lastFrameImage && !lastFrameImage->Empty())
+        {
+            glViewport(0, 0, renderContext.viewportSizeX, renderContext.viewportSizeY);
+            m_flipTexture.Draw(*renderContext.shaderCache, lastFrameImage, m_framebuffer, m_previousFrameBuffer, false, false);
+        }
+    }
+
+    // All images are drawn top row first, so the shaders can sample the previous frame without flipping it.
     m_state.mainTexture = m_framebuffer.GetColorAttachmentTexture(m_previousFrameBuffer, 0);
 
     // First evaluate per-frame code
     PerFrameUpdate();
 
-    glViewport(0, 0, renderContext.viewportSizeX, renderContext.viewportSizeY);
+    if (m_renderGraph.Empty())
+    {
+        BuildRenderGraph();
+    }
 
-    m_framebuffer.Bind(m_previousFrameBuffer);
-    // Motion vector field. Drawn to the previous frame texture before warping it.
-    // Only do it after drawing one frame after init or resize.
-    if (!m_isFirstFrame)
+    // The per-pixel mesh, custom shapes and custom waves run their code and generate their vertices
+    // while recording, on a worker thread if enabled. Their passes only replay the commands.
+    // No expression code may run on this thread until the recording is finished.
+    auto& commandRecorder = *renderContext.commandRecorder;
+    m_warpCommands = commandRecorder.Add([this](Renderer::CommandList& commandList) {
+        m_perPixelMesh.Record(commandList, m_state, m_perFrameContext, m_perPixelContext);
+    });
+
+    for (size_t index = 0; index < m_customShapes.size(); index++)
     {
-        m_motionVectors.Draw(m_perFrameContext, m_motionVectorUVMap->Texture());
+        auto& shape = m_customShapes[index];
+        if (shape->Enabled())
+        {
+            m_shapeCommands[index] = commandRecorder.Add([&shape](Renderer::CommandList& commandList) {
+                shape->Record(commandList);
+            });
+        }
     }
 
-    // y-flip the previous frame and assign the flipped texture as "main"
-    m_flipTexture.Draw(*renderContext.shaderCache, m_framebuffer.GetColorAttachmentTexture(m_previousFrameBuffer, 0), nullptr, true, false);
-    m_state.mainTexture = m_flipTexture.Texture();
+    for (size_t index = 0; index < m_customWaveforms.size(); index++)
+    {
+        auto& wave = m_customWaveforms[index];
+        if (wave->Enabled())
+        {
+            m_waveCommands[index] = commandRecorder.Add([this, &wave](Renderer::CommandList& commandList) {
+                wave->Record(commandList, m_perFrameContext);
+            });
+        }
+    }
 
-    // We now draw to the current framebuffer.
-    m_framebuffer.Bind(m_currentFrameBuffer);
+    commandRecorder.Start();
 
-    // Add motion vector u/v texture for the warp mesh draw and clean both buffers.
-    m_framebuffer.SetAttachment(m_currentFrameBuffer, 1, m_motionVectorUVMap);
+    glViewport(0, 0, renderContext.viewportSizeX, renderContext.viewportSizeY);
 
-    // Draw previous frame image warped via per-pixel mesh and warp shader
-    m_perPixelMesh.Draw(m_state, m_perFrameContext, m_perPixelContext);
+    // Only draw motion vectors after drawing one frame after init or resize.
+    m_renderGraph.SetEnabled(m_motionVectorsPass, !m_isFirstFrame && MotionVectors::IsVisible(m_perFrameContext));
+    m_renderGraph.SetEnabled(m_darkenCenterPass, *m_perFrameContext.darken_center > 0);
+    m_renderGraph.SetEnabled(m_borderPass, Border::IsVisible(m_perFrameContext));
 
-    // Remove the u/v texture from the framebuffer.
-    m_framebuffer.RemoveColorAttachment(m_currentFrameBuffer, 1);
+    m_renderGraph.Execute(renderContext.renderGraphStatistics, renderContext.gpuProfiler);
+    commandRecorder.Finish();
 
-    // Update blur textures
-    {
-        const auto warpedImage = m_framebuffer.GetColorAttachmentTexture(m_previousFrameBuffer, 0);
-        assert(warpedImage.get());
-        m_state.blurTexture.Update(*warpedImage, m_perFrameContext);
-    }
+    // Swap framebuffer IDs for the next frame.
+    std::swap(m_currentFrameBuffer, m_previousFrameBuffer);
+
+    m_isFirstFrame = false;
+}
+
+void MilkdropPreset::BuildRenderGraph()
+{
+    // Passes only reference members, as the graph is kept for the whole lifetime of the preset.
+    // Anything changing per frame is read from the preset state or set in RenderFrame().
 
-    // Draw audio-data-related stuff
-    for (auto& shape : m_customShapes)
+    // Motion vector field. Drawn to the previous frame texture before warping it.
+    m_motionVectorsPass = m_renderGraph.AddPass(
+        "motion_vectors", {"motion_vector_uv", "previous_frame"}, {"previous_frame"}, [this]() {
+            m_framebuffer.Bind(m_previousFrameBuffer);
+            m_motionVectors.Draw(m_perFrameContext, m_motionVectorUVMap->Texture());
+        });
+
+    // Draw previous frame image warped via per-pixel mesh and warp shader
+    m_renderGraph.AddPass(
+        "warp", {"previous_frame"}, {"current_frame", "motion_vector_uv"}, [this]() {
+            // We now draw to the current framebuffer.
+            m_framebuffer.Bind(m_currentFrameBuffer);
+
+            // Add motion vector u/v texture for the warp mesh draw and clean both buffers.
+            m_framebuffer.SetAttachment(m_currentFrameBuffer, 1, m_motionVectorUVMap);
+
+            m_state.renderContext.commandRecorder->Replay(m_warpCommands);
+
+            // Remove the u/v texture from the framebuffer.
+            m_framebuffer.RemoveColorAttachment(m_currentFrameBuffer, 1);
+        });
+
+    // Update blur textures. Restores the current framebuffer binding afterwards.
+    m_renderGraph.AddPass(
+        "blur", {"previous_frame"}, {"blur"}, [this]() {
+            const auto warpedImage = m_framebuffer.GetColorAttachmentTexture(m_previousFrameBuffer, 0);
+            assert(warpedImage.get());
+            m_state.blurTexture.Update(*warpedImage, m_perFrameContext, m_state.renderContext);
+        });
+
+    // Draw audio-data-related stuff. Custom shapes and waves are enabled or disabled when loading the preset.
+    for (size_t index = 0; index < m_customShapes.size(); index++)
     {
-        shape->Draw();
+        m_renderGraph.AddPass(
+            "custom_shape_" + std::to_string(index), {"current_frame", "previous_frame"}, {"current_frame"}, [this, index]() {
+                m_state.renderContext.commandRecorder->Replay(m_shapeCommands[index]);
+            },
+            m_customShapes[index]->Enabled());
     }
-    for (auto& wave : m_customWaveforms)
+    for (size_t index = 0; index < m_customWaveforms.size(); index++)
     {
-        wave->Draw(m_perFrameContext);
+        m_renderGraph.AddPass(
+            "custom_wave_" + std::to_string(index), {"current_frame"}, {"current_frame"}, [this, index]() {
+                m_state.renderContext.commandRecorder->Replay(m_waveCommands[index]);
+            },
+            m_customWaveforms[index]->Enabled());
     }
-    m_waveform.Draw(m_perFrameContext);
+    m_renderGraph.AddPass(
+        "waveform", {"current_frame"}, {"current_frame"}, [this]() {
+            m_waveform.Draw(m_perFrameContext);
+        });
 
     // Done in DrawSprites() in Milkdrop
-    if (*m_perFrameContext.darken_center > 0)
+    m_darkenCenterPass = m_renderGraph.AddPass(
+        "darken_center", {"current_frame"}, {"current_frame"}, [this]() {
+            m_darkenCenter.Draw();
+        });
+    m_borderPass = m_renderGraph.AddPass(
+        "border", {"current_frame"}, {"current_frame"}, [this]() {
+            m_border.Draw(m_perFrameContext);
+        });
+
+    // Blur textures are only needed if the warp or composite shader samples them. The composite shader
+    // reads the blur textures of this frame, the warp shader those left by the previous frame.
+    std::vector<std::string> compositeReads{"current_frame"};
+    if (m_finalComposite.UsesBlurTextures())
     {
-        m_darkenCenter.Draw();
+        compositeReads.emplace_back("blur");
     }
-    m_border.Draw(m_perFrameContext);
 
-    // y-flip the image for final compositing again
-    m_flipTexture.Draw(*renderContext.shaderCache, m_framebuffer.GetColorAttachmentTexture(m_currentFrameBuffer, 0), nullptr, true, false);
-    m_state.mainTexture = m_flipTexture.Texture();
+    m_renderGraph.AddPass(
+        "composite", compositeReads, {"output"}, [this]() {
+            // The current frame is the "main" texture for final compositing.
+            m_state.mainTexture = m_framebuffer.GetColorAttachmentTexture(m_currentFrameBuffer, 0);
 
-    // We no longer need the previous frame image, use it to render the final composite.
-    m_framebuffer.BindRead(m_currentFrameBuffer);
-    m_framebuffer.BindDraw(m_previousFrameBuffer);
+            // We no longer need the previous frame image, use it to render the final composite.
+            m_framebuffer.BindRead(m_currentFrameBuffer);
+            m_framebuffer.BindDraw(m_previousFrameBuffer);
 
-    m_finalComposite.Draw(m_state, m_perFrameContext);
+            m_finalComposite.Draw(m_state, m_perFrameContext);
+        });
 
-    if (!m_finalComposite.HasCompositeShader())
+    // The current frame and u/v map are used by the next frame, and so are the blur textures if the
+    // warp shader samples them.
+    m_renderGraph.AddOutput("output");
+    m_renderGraph.AddOutput("current_frame");
+    m_renderGraph.AddOutput("motion_vector_uv");
+    if (m_perPixelMesh.UsesBlurTextures())
     {
-        // Flip texture again in "previous" framebuffer as old-school effects are still upside down.
-        m_flipTexture.Draw(*renderContext.shaderCache, m_framebuffer.GetColorAttachmentTexture(m_previousFrameBuffer, 0), m_framebuffer, m_previousFrameBuffer, true, false);
+        m_renderGraph.AddOutput("blur");
     }
-
-    // Swap framebuffer IDs for the next frame.
-    std::swap(m_currentFrameBuffer, m_previousFrameBuffer);
-
-    m_isFirstFrame = false;
 }
 
 auto MilkdropPreset::OutputTexture() const -> std::shared_ptr<Renderer::Texture>
@@ -176,7 +337,19 @@ void MilkdropPreset::DrawInitialImage(const std::shared_ptr<Renderer::Texture>&
     m_framebuffer.SetSize(renderContext.viewportSizeX, renderContext.viewportSizeY);
 
     // Render to previous framebuffer, as this is the image used to draw the next frame on.
-    m_flipTexture.Draw(*renderContext.shaderCache, image, m_framebuffer, m_previousFrameBuffer);
+    // The framebuffer stores images top row first, so flip the preset output image.
+    m_flipTexture.Draw(*renderContext.shaderCache, image, m_framebuffer, m_previousFrameBuffer, true, false);
+}
+
+auto MilkdropPreset::SetMainImageFormat(const Renderer::RenderContext& renderContext) -> bool
+{
+    auto const format = Renderer::TextureFormat::FromRenderFormat(renderContext.mainRenderFormat);
+
+    // Both images are swapped each frame, so they always need the same format.
+    bool const firstChanged = m_framebuffer.SetColorAttachmentFormat(0, 0, format);
+    bool const secondChanged = m_framebuffer.SetColorAttachmentFormat(1, 0, format);
+
+    return firstChanged || secondChanged;
 }
 
 void MilkdropPreset::BindFramebuffer()
@@ -184,11 +357,14 @@ void MilkdropPreset::BindFramebuffer()
     if (m_framebuffer.Width() > 0 && m_framebuffer.Height() > 0)
     {
         m_framebuffer.BindDraw(m_previousFrameBuffer);
+        glViewport(0, 0, m_framebuffer.Width(), m_framebuffer.Height());
     }
 }
 
 void MilkdropPreset::PerFrameUpdate()
 {
+    TRACE_SCOPE("MilkdropPreset::PerFrameUpdate");
+
     m_perFrameContext.LoadStateVariables(m_state);
     m_perPixelContext.LoadStateReadOnlyVariables(m_state, m_perFrameContext);
 
@@ -207,15 +383,18 @@ void MilkdropPreset::Load(const std::string& pathname)
 
     SetFilename(ParseFilename(pathname));
 
+    // Read via FileSource, as the preset may be located inside an archive.
+    std::vector<char> presetData;
     PresetFileParser parser;
 
-    if (!parser.Read(pathname))
+    if (!Renderer::FileSource::Read(pathname, presetData, PresetFileParser::maxFileSize) || !parser.Read(std::move(presetData)))
     {
         const std::string error = "[MilkdropPreset] Could not parse preset file \"" + pathname + "\".";
         LOG_ERROR(error)
         throw MilkdropPresetLoadException(error);
     }
 
+    LogUnknownKeys(parser);
     InitializePreset(parser);
 }
 
@@ -232,18 +411,12 @@ void MilkdropPreset::Load(std::istream& stream)
         throw MilkdropPresetLoadException(error);
     }
 
+    LogUnknownKeys(parser);
     InitializePreset(parser);
 }
 
-void MilkdropPreset::InitializePreset(PresetFileParser& parsedFile)
+void MilkdropPreset::InitializePreset(const PresetDataSource& parsedFile)
 {
-    // Create the offscreen rendering surfaces.
-    m_motionVectorUVMap = std::make_shared<Renderer::TextureAttachment>(GL_RG16F, GL_RG, GL_FLOAT, 0, 0);
-    m_framebuffer.CreateColorAttachment(0, 0); // Main image 1
-    m_framebuffer.CreateColorAttachment(1, 0); // Main image 2
-
-    Renderer::Framebuffer::Unbind();
-
     // Load global init variables into the state
     m_state.Initialize(parsedFile);
 
@@ -273,6 +446,8 @@ void MilkdropPreset::InitializePreset(PresetFileParser& parsedFile)
 
 void MilkdropPreset::CompileCodeAndRunInitExpressions()
 {
+    TRACE_SCOPE("MilkdropPreset::CompileCodeAndRunInitExpressions");
+
     // Per-frame init and code
     m_perFrameContext.LoadStateVariables(m_state);
     m_perFrameContext.EvaluateInitCode(m_state);
@@ -37,16 +37,16 @@
 
 #include <Renderer/CopyTexture.hpp>
 #include <Renderer/Framebuffer.hpp>
+#include <Renderer/RenderGraph.hpp>
 
 #include <memory>
 #include <string>
 
 namespace libprojectM {
-class PresetFileParser;
-
 namespace MilkdropPreset {
 
 class Factory;
+class PresetDataSource;
 
 class MilkdropPreset : public ::libprojectM::Preset
 {
@@ -66,6 +66,13 @@ public:
      */
     MilkdropPreset(std::istream& presetData);
 
+    /**
+     * @brief Creates a MilkdropPreset from already parsed or precompiled preset data.
+     * @param presetData The preset data to initialize the preset from.
+     * @param absoluteFilePath The absolute file path of the original preset file.
+     */
+    MilkdropPreset(const PresetDataSource& presetData, const std::string& absoluteFilePath);
+
     /**
      * @brief Initializes the preset with rendering-related data.
      * @param renderContext The initial render context.
@@ -93,15 +100,28 @@ private:
 
     void Load(std::istream& stream);
 
-    void InitializePreset(PresetFileParser& parsedFile);
+    void InitializePreset(const PresetDataSource& parsedFile);
 
     void CompileCodeAndRunInitExpressions();
 
+    /**
+     * @brief Applies the render context's main image format to both framebuffer images.
+     * @param renderContext The current render context.
+     * @return true if the images were reallocated, false if the format didn't change.
+     */
+    auto SetMainImageFormat(const Renderer::RenderContext& renderContext) -> bool;
+
     /**
      * @brief Compiles the warp and composite shaders.
      */
     void LoadShaderCode();
 
+    /**
+     * @brief Adds all render passes of the preset to the render graph.
+     * The graph is built once and then executed every frame.
+     */
+    void BuildRenderGraph();
+
     auto ParseFilename(const std::string& filename) -> std::string;
 
     std::string m_absoluteFilePath; //!< The absolute file path of the MilkdropPreset
@@ -124,10 +144,18 @@ private:
     std::array<std::unique_ptr<CustomShape>, CustomShapeCount> m_customShapes;          //!< Custom shapes in this preset.
     DarkenCenter m_darkenCenter;                                                        //!< Center darkening effect.
     Border m_border;                                                                    //!< Inner/outer borders.
-    Renderer::CopyTexture m_flipTexture;                                                //!< Texture flip filter
+    Renderer::CopyTexture m_flipTexture;                                                //!< Texture flip filter for the initial image
 
     FinalComposite m_finalComposite; //!< Final composite shader or filters.
 
+    Renderer::RenderGraph m_renderGraph;                      //!< Schedules the passes of each frame, skipping invisible ones.
+    size_t m_motionVectorsPass{};                             //!< Render graph index of the motion vectors pass.
+    size_t m_darkenCenterPass{};                              //!< Render graph index of the darken center pass.
+    size_t m_borderPass{};                                    //!< Render graph index of the border pass.
+    size_t m_warpCommands{};                                  //!< Recorded commands of the warp mesh in the current frame.
+    std::array<size_t, CustomShapeCount> m_shapeCommands{};   //!< Recorded commands of each custom shape in the current frame.
+    std::array<size_t, CustomWaveformCount> m_waveCommands{}; //!< Recorded commands of each custom waveform in the current frame.
+
     bool m_isFirstFrame{true}; //!< Controls drawing the motion vectors starting with the second frame.
 };
 
@@ -61,5 +61,32 @@ private:
     std::string m_message;
 };
 
+/**
+ * @brief Exception for precompiled preset bundle errors.
+ */
+class PresetBundleException : public std::exception
+{
+public:
+    PresetBundleException(std::string message)
+        : m_message(std::move(message))
+    {
+    }
+
+    virtual ~PresetBundleException() = default;
+
+    const char* what() const noexcept override
+    {
+        return m_message.c_str();
+    }
+
+    const std::string& message() const
+    {
+        return m_message;
+    }
+
+private:
+    std::string m_message;
+};
+
 } // namespace MilkdropPreset
 } // namespace libprojectM
@@ -23,6 +23,14 @@ using libprojectM::MilkdropPreset::MilkdropStaticShaders;
 
 static auto floatRand = []() { return static_cast<float>(rand() % 7381) / 7380.0f; };
 
+// The uniform block structs are uploaded as-is and must match the std140 layout.
+static_assert(sizeof(glm::vec4) == 16 && sizeof(glm::mat3x4) == 48, "glm types don't match the std140 layout");
+static_assert(sizeof(MilkdropShader::FrameUniforms) == (1 + 14 + QVarCount / 4) * 16 + 20 * 48, "FrameUniforms has padding");
+static_assert(sizeof(MilkdropShader::StaticUniforms) == 16 + 4 * 48, "StaticUniforms has padding");
+
+constexpr GLuint MilkdropShader::FrameUniformsBindingPoint;
+constexpr GLuint MilkdropShader::StaticUniformsBindingPoint;
+
 MilkdropShader::MilkdropShader(ShaderType type)
     : m_type(type)
     , m_randValues({floatRand(), floatRand(), floatRand(), floatRand()})
@@ -33,7 +41,8 @@ MilkdropShader::MilkdropShader(ShaderType type)
         for (int i = 0; i < 4; i++)
         {
             float const m_randTranslationMult = 1;
-            float const rotMult = 0.9f * powf(index / 8.0f, 3.2f);
+            // The first four rotations (rot_s1 to rot_s4) are static.
+            float const rotMult = index < 4 ? 0.0f : 0.9f * powf(index / 8.0f, 3.2f);
             m_randTranslation[index].x = (floatRand() * 2 - 1) * m_randTranslationMult;
             m_randTranslation[index].y = (floatRand() * 2 - 1) * m_randTranslationMult;
             m_randTranslation[index].z = (floatRand() * 2 - 1) * m_randTranslationMult;
@@ -72,7 +81,7 @@ void MilkdropShader::LoadTexturesAndCompile(PresetState& presetState)
 
         std::string lowerCaseName = Utils::ToLower(baseName);
 
-        // The "main" and "blurX" textures are preset-specific and are not managed by TextureManager.
+        // The "main", "blurX" and "audio" textures are preset-specific and are not managed by TextureManager.
         if (lowerCaseName == "main")
         {
             Renderer::TextureSamplerDescriptor desc(presetState.mainTexture.lock(),
@@ -83,6 +92,17 @@ void MilkdropShader::LoadTexturesAndCompile(PresetState& presetState)
             continue;
         }
 
+        // Frame audio data, updated once per frame.
+        if (lowerCaseName == "audio")
+        {
+            Renderer::TextureSamplerDescriptor desc(presetState.audioTexture.Texture(),
+                                                    presetState.renderContext.textureManager->GetSampler(name),
+                                                    name,
+                                                    "audio");
+            m_textureSamplerDescriptors.push_back(std::move(desc));
+            continue;
+        }
+
         // A few presets directly use the (undocumented) sampler name.
         if (lowerCaseName == "blur1")
         {
@@ -163,98 +183,85 @@ void MilkdropShader::LoadVariables(const PresetState& presetState, const PerFram
 
     m_shader.Bind();
 
-    m_shader.SetUniformMat4x4("vertex_transformation", PresetState::orthogonalProjection);
-
-    m_shader.SetUniformFloat4("rand_frame", {floatRand(),
-                                             floatRand(),
-                                             floatRand(),
-                                             floatRand()});
-    m_shader.SetUniformFloat4("rand_preset", {m_randValues[0],
-                                              m_randValues[1],
-                                              m_randValues[2],
-                                              m_randValues[3]});
-
-    m_shader.SetUniformFloat4("_c0", {presetState.renderContext.aspectX,
-                                      presetState.renderContext.aspectY,
-                                      1.0f / presetState.renderContext.aspectX,
-                                      1.0f / presetState.renderContext.aspectY});
-    m_shader.SetUniformFloat4("_c1", {0.0,
-                                      0.0,
-                                      0.0,
-                                      0.0});
-    m_shader.SetUniformFloat4("_c2", {timeSincePresetStartWrapped,
-                                      presetState.renderContext.fps,
-                                      presetState.renderContext.frame,
-                                      presetState.renderContext.progress});
-    m_shader.SetUniformFloat4("_c3", {presetState.audioData.bass,
-                                      presetState.audioData.mid,
-                                      presetState.audioData.treb,
-                                      presetState.audioData.vol});
-    m_shader.SetUniformFloat4("_c4", {presetState.audioData.bassAtt,
-                                      presetState.audioData.midAtt,
-                                      presetState.audioData.trebAtt,
-                                      presetState.audioData.volAtt});
-    m_shader.SetUniformFloat4("_c5", {blurMax[0] - blurMin[0],
-                                      blurMin[0],
-                                      blurMax[1] - blurMin[1],
-                                      blurMin[1]});
-    m_shader.SetUniformFloat4("_c6", {blurMax[2] - blurMin[2],
-                                      blurMin[2],
-                                      blurMin[0],
-                                      blurMax[0]});
-    m_shader.SetUniformFloat4("_c7", {presetState.renderContext.viewportSizeX,
-                                      presetState.renderContext.viewportSizeY,
-                                      1.0f / static_cast<float>(presetState.renderContext.viewportSizeX),
-                                      1.0f / static_cast<float>(presetState.renderContext.viewportSizeY)});
-
-    m_shader.SetUniformFloat4("_c8", {0.5f + 0.5f * cosf(floatTime * 0.329f + 1.2f),
-                                      0.5f + 0.5f * cosf(floatTime * 1.293f + 3.9f),
-                                      0.5f + 0.5f * cosf(floatTime * 5.070f + 2.5f),
-                                      0.5f + 0.5f * cosf(floatTime * 20.051f + 5.4f)});
-
-    m_shader.SetUniformFloat4("_c9", {0.5f + 0.5f * sinf(floatTime * 0.329f + 1.2f),
-                                      0.5f + 0.5f * sinf(floatTime * 1.293f + 3.9f),
-                                      0.5f + 0.5f * sinf(floatTime * 5.070f + 2.5f),
-                                      0.5f + 0.5f * sinf(floatTime * 20.051f + 5.4f)});
-
-    m_shader.SetUniformFloat4("_c10", {0.5f + 0.5f * cosf(floatTime * 0.0050f + 2.7f),
-                                       0.5f + 0.5f * cosf(floatTime * 0.0085f + 5.3f),
-                                       0.5f + 0.5f * cosf(floatTime * 0.0133f + 4.5f),
-                                       0.5f + 0.5f * cosf(floatTime * 0.0217f + 3.8f)});
-
-    m_shader.SetUniformFloat4("_c11", {0.5f + 0.5f * sinf(floatTime * 0.0050f + 2.7f),
-                                       0.5f + 0.5f * sinf(floatTime * 0.0085f + 5.3f),
-                                       0.5f + 0.5f * sinf(floatTime * 0.0133f + 4.5f),
-                                       0.5f + 0.5f * sinf(floatTime * 0.0217f + 3.8f)});
-
-    m_shader.SetUniformFloat4("_c12", {mipX,
-                                       mipY,
-                                       mipAvg,
-                                       0});
-    m_shader.SetUniformFloat4("_c13", {blurMin[1],
-                                       blurMax[1],
-                                       blurMin[2],
-                                       blurMax[2]});
-
-
-    std::array<glm::mat4, 24> tempMatrices{};
-
-    // write matrices
-    for (int i = 0; i < 20; i++)
-    {
-        glm::mat4 const rotationX = glm::rotate(glm::mat4(1.0f), m_randRotationCenters[i].x + m_randRotationSpeeds[i].x * floatTime, glm::vec3(1.0f, 0.0f, 0.0f));
-        glm::mat4 const rotationY = glm::rotate(glm::mat4(1.0f), m_randRotationCenters[i].y + m_randRotationSpeeds[i].y * floatTime, glm::vec3(0.0f, 1.0f, 0.0f));
-        glm::mat4 const rotationZ = glm::rotate(glm::mat4(1.0f), m_randRotationCenters[i].z + m_randRotationSpeeds[i].z * floatTime, glm::vec3(0.0f, 0.0f, 1.0f));
-
-        glm::mat4 const randomTranslation = glm::translate(glm::mat4(1.0f), glm::vec3(m_randTranslation[i].x, m_randTranslation[i].y, m_randTranslation[i].z));
-
-        tempMatrices[i] = randomTranslation * rotationX;
-        tempMatrices[i] = rotationZ * tempMatrices[i];
-        tempMatrices[i] = rotationY * tempMatrices[i];
+    m_shader.SetUniform(m_vertexTransformation, PresetState::orthogonalProjection);
+
+    auto& uniforms = m_frameUniforms;
+
+    uniforms.randFrame = {floatRand(),
+                          floatRand(),
+                          floatRand(),
+                          floatRand()};
+
+    uniforms.constants[0] = {presetState.renderContext.aspectX,
+                             presetState.renderContext.aspectY,
+                             1.0f / presetState.renderContext.aspectX,
+                             1.0f / presetState.renderContext.aspectY};
+    uniforms.constants[1] = {0.0,
+                             0.0,
+                             0.0,
+                             0.0};
+    uniforms.constants[2] = {timeSincePresetStartWrapped,
+                             presetState.renderContext.fps,
+                             presetState.renderContext.frame,
+                             presetState.renderContext.progress};
+    uniforms.constants[3] = {presetState.audioData.bass,
+                             presetState.audioData.mid,
+                             presetState.audioData.treb,
+                             presetState.audioData.vol};
+    uniforms.constants[4] = {presetState.audioData.bassAtt,
+                             presetState.audioData.midAtt,
+                             presetState.audioData.trebAtt,
+                             presetState.audioData.volAtt};
+    uniforms.constants[5] = {blurMax[0] - blurMin[0],
+                             blurMin[0],
+                             blurMax[1] - blurMin[1],
+                             blurMin[1]};
+    uniforms.constants[6] = {blurMax[2] - blurMin[2],
+                             blurMin[2],
+                             blurMin[0],
+                             blurMax[0]};
+    uniforms.constants[7] = {presetState.renderContext.viewportSizeX,
+                             presetState.renderContext.viewportSizeY,
+                             1.0f / static_cast<float>(presetState.renderContext.viewportSizeX),
+                             1.0f / static_cast<float>(presetState.renderContext.viewportSizeY)};
+
+    uniforms.constants[8] = {0.5f + 0.5f * cosf(floatTime * 0.329f + 1.2f),
+                             0.5f + 0.5f * cosf(floatTime * 1.293f + 3.9f),
+                             0.5f + 0.5f * cosf(floatTime * 5.070f + 2.5f),
+                             0.5f + 0.5f * cosf(floatTime * 20.051f + 5.4f)};
+
+    uniforms.constants[9] = {0.5f + 0.5f * sinf(floatTime * 0.329f + 1.2f),
+                             0.5f + 0.5f * sinf(floatTime * 1.293f + 3.9f),
+                             0.5f + 0.5f * sinf(floatTime * 5.070f + 2.5f),
+                             0.5f + 0.5f * sinf(floatTime * 20.051f + 5.4f)};
+
+    uniforms.constants[10] = {0.5f + 0.5f * cosf(floatTime * 0.0050f + 2.7f),
+                              0.5f + 0.5f * cosf(floatTime * 0.0085f + 5.3f),
+                              0.5f + 0.5f * cosf(floatTime * 0.0133f + 4.5f),
+                              0.5f + 0.5f * cosf(floatTime * 0.0217f + 3.8f)};
+
+    uniforms.constants[11] = {0.5f + 0.5f * sinf(floatTime * 0.0050f + 2.7f),
+                              0.5f + 0.5f * sinf(floatTime * 0.0085f + 5.3f),
+                              0.5f + 0.5f * sinf(floatTime * 0.0133f + 4.5f),
+                              0.5f + 0.5f * sinf(floatTime * 0.0217f + 3.8f)};
+
+    uniforms.constants[12] = {mipX,
+                              mipY,
+                              mipAvg,
+                              0};
+    uniforms.constants[13] = {blurMin[1],
+                              blurMax[1],
+                              blurMin[2],
+                              blurMax[2]};
+
+    // write matrices, the first four static ones are in the static uniform block.
+    for (size_t i = 4; i < 20; i++)
+    {
+        uniforms.rotations[i - 4] = RandomRotation(i, floatTime);
     }
 
     // the last 4 are totally random, each frame
-    for (int i = 20; i < 24; i++)
+    for (size_t i = 16; i < 20; i++)
     {
         glm::mat4 const rotationX = glm::rotate(glm::mat4(1.0f), floatRand() * 6.28f, glm::vec3(1.0f, 0.0f, 0.0f));
         glm::mat4 const rotationY = glm::rotate(glm::mat4(1.0f), floatRand() * 6.28f, glm::vec3(0.0f, 1.0f, 0.0f));
@@ -262,47 +269,24 @@ void MilkdropShader::LoadVariables(const PresetState& presetState, const PerFram
 
         glm::mat4 const randomTranslation = glm::translate(glm::mat4(1.0f), glm::vec3(floatRand(), floatRand(), floatRand()));
 
-        tempMatrices[i] = randomTranslation * rotationX;
-        tempMatrices[i] = rotationZ * tempMatrices[i];
-        tempMatrices[i] = rotationY * tempMatrices[i];
-    }
-
-    m_shader.SetUniformMat3x4("rot_s1", tempMatrices[0]);
-    m_shader.SetUniformMat3x4("rot_s2", tempMatrices[1]);
-    m_shader.SetUniformMat3x4("rot_s3", tempMatrices[2]);
-    m_shader.SetUniformMat3x4("rot_s4", tempMatrices[3]);
-    m_shader.SetUniformMat3x4("rot_d1", tempMatrices[4]);
-    m_shader.SetUniformMat3x4("rot_d2", tempMatrices[5]);
-    m_shader.SetUniformMat3x4("rot_d3", tempMatrices[6]);
-    m_shader.SetUniformMat3x4("rot_d4", tempMatrices[7]);
-    m_shader.SetUniformMat3x4("rot_f1", tempMatrices[8]);
-    m_shader.SetUniformMat3x4("rot_f2", tempMatrices[9]);
-    m_shader.SetUniformMat3x4("rot_f3", tempMatrices[10]);
-    m_shader.SetUniformMat3x4("rot_f4", tempMatrices[11]);
-    m_shader.SetUniformMat3x4("rot_vf1", tempMatrices[12]);
-    m_shader.SetUniformMat3x4("rot_vf2", tempMatrices[13]);
-    m_shader.SetUniformMat3x4("rot_vf3", tempMatrices[14]);
-    m_shader.SetUniformMat3x4("rot_vf4", tempMatrices[15]);
-    m_shader.SetUniformMat3x4("rot_uf1", tempMatrices[16]);
-    m_shader.SetUniformMat3x4("rot_uf2", tempMatrices[17]);
-    m_shader.SetUniformMat3x4("rot_uf3", tempMatrices[18]);
-    m_shader.SetUniformMat3x4("rot_uf4", tempMatrices[19]);
-    m_shader.SetUniformMat3x4("rot_rand1", tempMatrices[20]);
-    m_shader.SetUniformMat3x4("rot_rand2", tempMatrices[21]);
-    m_shader.SetUniformMat3x4("rot_rand3", tempMatrices[22]);
-    m_shader.SetUniformMat3x4("rot_rand4", tempMatrices[23]);
+        uniforms.rotations[i] = rotationY * (rotationZ * (randomTranslation * rotationX));
+    }
 
     // set program uniform "_q[a-h]" values (_qa.x, _qa.y, _qa.z, _qa.w, _qb.x, _qb.y ... ) alias q[1-32]
     for (int i = 0; i < QVarCount; i += 4)
     {
-        std::string varName = "_q";
-        varName.push_back(static_cast<char>('a' + i / 4));
-        m_shader.SetUniformFloat4(varName.c_str(), {presetState.frameQVariables[i],
-                                                    presetState.frameQVariables[i + 1],
-                                                    presetState.frameQVariables[i + 2],
-                                                    presetState.frameQVariables[i + 3]});
+        uniforms.qVars[i / 4] = {presetState.frameQVariables[i],
+                                 presetState.frameQVariables[i + 1],
+                                 presetState.frameQVariables[i + 2],
+                                 presetState.frameQVariables[i + 3]};
     }
 
+    // One upload for all per-frame values. The block binding points are shared by all preset
+    // shaders, so only the buffers need to be bound.
+    m_frameUniformBuffer.Update(uniforms);
+    m_frameUniformBuffer.Bind(FrameUniformsBindingPoint);
+    m_staticUniformBuffer.Bind(StaticUniformsBindingPoint);
+
     // Bind all texture and sampler descriptors. This includes the main and blur textures.
     GLint textureUnit{0};
     for (auto& desc : m_mainTextureDescriptors)
@@ -329,6 +313,11 @@ auto MilkdropShader::Shader() -> Renderer::Shader&
     return m_shader;
 }
 
+auto MilkdropShader::RequiredBlurLevel() const -> BlurTexture::BlurLevel
+{
+    return m_maxBlurLevelRequired;
+}
+
 void MilkdropShader::PreprocessPresetShader(std::string& program)
 {
     std::string shaderTypeString = "composite";
@@ -680,6 +669,38 @@ void MilkdropShader::TranspileHLSLShader(const PresetState& presetState, std::st
     {
         m_shader.CompileProgram(MilkdropStaticShaders::Get()->GetPresetCompVertexShader(), generator.GetResult());
     }
+
+    InitializeUniforms();
+}
+
+void MilkdropShader::InitializeUniforms()
+{
+    m_vertexTransformation = m_shader.GetUniform<glm::mat4x4>("vertex_transformation");
+
+    m_shader.BindUniformBlock("PresetFrameUniforms", FrameUniformsBindingPoint);
+    m_shader.BindUniformBlock("PresetStaticUniforms", StaticUniformsBindingPoint);
+
+    StaticUniforms uniforms;
+    uniforms.randPreset = {m_randValues[0],
+                           m_randValues[1],
+                           m_randValues[2],
+                           m_randValues[3]};
+    for (size_t i = 0; i < uniforms.rotations.size(); i++)
+    {
+        uniforms.rotations[i] = RandomRotation(i, 0.0f);
+    }
+    m_staticUniformBuffer.Update(uniforms);
+}
+
+auto MilkdropShader::RandomRotation(size_t index, float time) const -> glm::mat4
+{
+    glm::mat4 const rotationX = glm::rotate(glm::mat4(1.0f), m_randRotationCenters[index].x + m_randRotationSpeeds[index].x * time, glm::vec3(1.0f, 0.0f, 0.0f));
+    glm::mat4 const rotationY = glm::rotate(glm::mat4(1.0f), m_randRotationCenters[index].y + m_randRotationSpeeds[index].y * time, glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 const rotationZ = glm::rotate(glm::mat4(1.0f), m_randRotationCenters[index].z + m_randRotationSpeeds[index].z * time, glm::vec3(0.0f, 0.0f, 1.0f));
+
+    glm::mat4 const randomTranslation = glm::translate(glm::mat4(1.0f), glm::vec3(m_randTranslation[index].x, m_randTranslation[index].y, m_randTranslation[index].z));
+
+    return rotationY * (rotationZ * (randomTranslation * rotationX));
 }
 
 void MilkdropShader::UpdateMaxBlurLevel(BlurTexture::BlurLevel requestedLevel)
@@ -8,9 +8,14 @@
 #pragma once
 
 #include "BlurTexture.hpp"
+#include "Constants.hpp"
 
 #include <Renderer/Shader.hpp>
 #include <Renderer/TextureManager.hpp>
+#include <Renderer/UniformBuffer.hpp>
+
+#include <glm/mat3x4.hpp>
+#include <glm/vec4.hpp>
 
 #include <array>
 #include <set>
@@ -34,6 +39,29 @@ public:
         CompositeShader //!< Composite shader
     };
 
+    static constexpr GLuint FrameUniformsBindingPoint = 0;  //!< Binding point of the PresetFrameUniforms block, shared by all preset shaders.
+    static constexpr GLuint StaticUniformsBindingPoint = 1; //!< Binding point of the PresetStaticUniforms block, shared by all preset shaders.
+
+    /**
+     * @brief Contents of the PresetFrameUniforms block, updated each frame.
+     * Must match the std140 layout of the block declared in the preset shader header.
+     */
+    struct FrameUniforms {
+        glm::vec4 randFrame;                        //!< rand_frame
+        std::array<glm::vec4, 14> constants;        //!< _c0 to _c13
+        std::array<glm::vec4, QVarCount / 4> qVars; //!< _qa to _qh
+        std::array<glm::mat3x4, 20> rotations;      //!< rot_d1 to rot_rand4
+    };
+
+    /**
+     * @brief Contents of the PresetStaticUniforms block, uploaded once after compiling the shader.
+     * Must match the std140 layout of the block declared in the preset shader header.
+     */
+    struct StaticUniforms {
+        glm::vec4 randPreset;                 //!< rand_preset
+        std::array<glm::mat3x4, 4> rotations; //!< rot_s1 to rot_s4
+    };
+
     /**
      * constructor.
      * @param type The preset shader type.
@@ -67,6 +95,12 @@ public:
      */
     auto Shader() -> Renderer::Shader&;
 
+    /**
+     * @brief Returns the highest blur level sampled by this shader.
+     * @return The blur level, or BlurLevel::None if the shader samples no blur texture.
+     */
+    auto RequiredBlurLevel() const -> BlurTexture::BlurLevel;
+
 private:
     /**
      * @brief Prepares the shader code to be translated into GLSL.
@@ -94,6 +128,20 @@ private:
      */
     void UpdateMaxBlurLevel(BlurTexture::BlurLevel requestedLevel);
 
+    /**
+     * @brief Sets up uniforms and uniform blocks after the program was compiled.
+     * Uploads the static uniform block, as its contents never change afterwards.
+     */
+    void InitializeUniforms();
+
+    /**
+     * @brief Calculates a random rotation matrix with a small translation.
+     * @param index The index of the random rotation values to use.
+     * @param time The time to apply the rotation speed with.
+     * @return The rotation matrix.
+     */
+    auto RandomRotation(size_t index, float time) const -> glm::mat4;
+
     ShaderType m_type{ShaderType::WarpShader}; //!< Type of this shader.
     std::string m_fragmentShaderCode;          //!< The original preset fragment shader code.
     std::string m_preprocessedCode;            //!< The preprocessed preset shader code.
@@ -109,6 +157,11 @@ private:
     std::array<glm::vec3, 20> m_randRotationSpeeds{};  //!< Random rotation speeds which don't change every frame.
 
     Renderer::Shader m_shader;
+
+    Renderer::UniformHandle<glm::mat4x4> m_vertexTransformation;   //!< The vertex_transformation uniform.
+    FrameUniforms m_frameUniforms{};                               //!< Per-frame uniform values.
+    Renderer::UniformBuffer<FrameUniforms> m_frameUniformBuffer;   //!< Buffer holding the per-frame uniform block.
+    Renderer::UniformBuffer<StaticUniforms> m_staticUniformBuffer; //!< Buffer holding the static uniform block.
 };
 
 } // namespace MilkdropPreset
@@ -3,6 +3,7 @@
 #include "MilkdropStaticShaders.hpp"
 
 #include <Renderer/BlendMode.hpp>
+#include <Renderer/GLStateCache.hpp>
 #include <Renderer/ShaderCache.hpp>
 #include <Renderer/TextureManager.hpp>
 
@@ -13,15 +14,20 @@ namespace MilkdropPreset {
 
 MotionVectors::MotionVectors(PresetState& presetState)
     : m_presetState(presetState)
-    , m_motionVectorMesh(Renderer::VertexBufferUsage::StreamDraw)
 {
-    m_motionVectorMesh.SetRenderPrimitiveType(Renderer::Mesh::PrimitiveType::Lines);
+}
+
+auto MotionVectors::IsVisible(const PerFrameContext& presetPerFrameContext) -> bool
+{
+    return *presetPerFrameContext.mv_a >= 0.0001f &&
+           static_cast<int>(*presetPerFrameContext.mv_x) > 0 &&
+           static_cast<int>(*presetPerFrameContext.mv_y) > 0;
 }
 
 void MotionVectors::Draw(const PerFrameContext& presetPerFrameContext, std::shared_ptr<Renderer::Texture> motionTexture)
 {
     // Don't draw if invisible.
-    if (*presetPerFrameContext.mv_a < 0.0001f)
+    if (!IsVisible(presetPerFrameContext))
     {
         return;
     }
@@ -29,11 +35,6 @@ void MotionVectors::Draw(const PerFrameContext& presetPerFrameContext, std::shar
     int countX = static_cast<int>(*presetPerFrameContext.mv_x);
     int countY = static_cast<int>(*presetPerFrameContext.mv_y);
 
-    if (countX <= 0 || countY <= 0)
-    {
-        return;
-    }
-
     float divertX = static_cast<float>(*presetPerFrameContext.mv_x) - static_cast<float>(countX);
     float divertY = static_cast<float>(*presetPerFrameContext.mv_y) - static_cast<float>(countY);
 
@@ -61,8 +62,6 @@ void MotionVectors::Draw(const PerFrameContext& presetPerFrameContext, std::shar
     float const inverseHeight = 1.25f / static_cast<float>(m_presetState.renderContext.viewportSizeY);
     float const minimumLength = sqrtf(inverseWidth * inverseWidth + inverseHeight * inverseHeight);
 
-    m_motionVectorMesh.SetVertexCount(static_cast<std::size_t>(countX + 1) * 2); // countX + 1 lines for each grid row, 2 vertices each.
-
     Renderer::BlendMode::Set(true, Renderer::BlendMode::Function::SourceAlpha, Renderer::BlendMode::Function::OneMinusSourceAlpha);
 
     auto shader = GetShader();
@@ -71,6 +70,11 @@ void MotionVectors::Draw(const PerFrameContext& presetPerFrameContext, std::shar
     shader->SetUniformFloat("length_multiplier", static_cast<float>(*presetPerFrameContext.mv_l));
     shader->SetUniformFloat("minimum_length", minimumLength);
 
+    // Grid positions are calculated in the vertex shader from the vertex and instance IDs.
+    shader->SetUniformFloat2("grid_scale", {1.0f / (static_cast<float>(countX) + divertX + 0.25f - 1.0f),
+                                            1.0f / (static_cast<float>(countY) + divertY + 0.25f - 1.0f)});
+    shader->SetUniformFloat2("grid_offset", {divertX2, -divertY2});
+
     shader->SetUniformInt("warp_coordinates", 0);
 
     motionTexture->Bind(0, m_sampler);
@@ -83,41 +87,19 @@ void MotionVectors::Draw(const PerFrameContext& presetPerFrameContext, std::shar
 
     glLineWidth(1);
 #ifndef USE_GLES
-    glEnable(GL_LINE_SMOOTH);
+    Renderer::GLStateCache::Current().SetCapability(GL_LINE_SMOOTH, true);
 #endif
 
-    auto& lineVertices = m_motionVectorMesh.Vertices();
-
-    for (int y = 0; y < countY; y++)
-    {
-        float const posY = (static_cast<float>(y) + 0.25f) / (static_cast<float>(countY) + divertY + 0.25f - 1.0f) - divertY2;
-
-        if (posY > 0.0001f && posY < 0.9999f)
-        {
-            int vertex = 0;
-            for (int x = 0; x < countX; x++)
-            {
-                float const posX = (static_cast<float>(x) + 0.25f) / (static_cast<float>(countX) + divertX + 0.25f - 1.0f) + divertX2;
-
-                if (posX > 0.0001f && posX < 0.9999f)
-                {
-                    lineVertices[vertex + 1] = lineVertices[vertex] = {posX, posY};
-
-                    vertex += 2;
-                }
-            }
-
-            // Draw a row of lines.
-            m_motionVectorMesh.Update();
-            m_motionVectorMesh.Draw();
-        }
-    }
+    // One instance per grid row, each drawing countX lines.
+    m_vertexArray.Bind();
+    glDrawArraysInstanced(GL_LINES, 0, countX * 2, countY);
+    Renderer::GLStateCache::Current().CountDrawCall();
 
-    Renderer::Mesh::Unbind();
+    Renderer::VertexArray::Unbind();
     Renderer::Shader::Unbind();
 
 #ifndef USE_GLES
-    glDisable(GL_LINE_SMOOTH);
+    Renderer::GLStateCache::Current().SetCapability(GL_LINE_SMOOTH, false);
 #endif
 
     Renderer::BlendMode::SetBlendActive(false);
@@ -3,7 +3,9 @@
 #include "PerFrameContext.hpp"
 #include "PresetState.hpp"
 
-#include <Renderer/Mesh.hpp>
+#include <Renderer/Sampler.hpp>
+#include <Renderer/Shader.hpp>
+#include <Renderer/VertexArray.hpp>
 
 #include <memory>
 
@@ -17,6 +19,10 @@ namespace MilkdropPreset {
  * on the CPU, projectM does this within the Motion Vector vertex shader. The Warp effect draws the
  * final U/V coordinates to a float texture, which is then used in the next frame to calculate the
  * vector length at the location of the line origin.
+ *
+ * The whole vector field is drawn with a single instanced draw call without any vertex data. The
+ * line positions are derived from the vertex and instance IDs, only the grid size and offsets are
+ * passed as uniforms.
  */
 class MotionVectors
 {
@@ -25,6 +31,13 @@ public:
 
     explicit MotionVectors(PresetState& presetState);
 
+    /**
+     * @brief Returns whether the motion vectors are visible.
+     * @param presetPerFrameContext The per-frame context variables.
+     * @return true if the vectors aren't fully transparent and the grid has at least one vector.
+     */
+    static auto IsVisible(const PerFrameContext& presetPerFrameContext) -> bool;
+
     /**
      * Renders the motion vectors.
      * @param presetPerFrameContext The per-frame context variables.
@@ -37,7 +50,7 @@ private:
 
     PresetState& m_presetState; //!< The global preset state.
 
-    Renderer::Mesh m_motionVectorMesh; //!< The Motion Vector geometry.
+    Renderer::VertexArray m_vertexArray; //!< Empty vertex array object, required for drawing.
 
     std::weak_ptr<Renderer::Shader> m_motionVectorShader;                                                           //!< The motion vector shader, calculates the trace positions in the GPU.
     std::shared_ptr<Renderer::Sampler> m_sampler{std::make_shared<Renderer::Sampler>(GL_CLAMP_TO_EDGE, GL_LINEAR)}; //!< The texture sampler.
@@ -7,40 +7,33 @@
 #include "PresetState.hpp"
 
 #include <Logging.hpp>
+#include <Tracing.hpp>
 #include <Renderer/BlendMode.hpp>
+#include <Renderer/GLStateCache.hpp>
 #include <Renderer/ShaderCache.hpp>
+#include <Renderer/StreamingBuffer.hpp>
 
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <cstring>
 
 namespace libprojectM {
 namespace MilkdropPreset {
 
 PerPixelMesh::PerPixelMesh()
-    : m_warpMesh(Renderer::VertexBufferUsage::StreamDraw)
 {
-    m_warpMesh.SetRenderPrimitiveType(Renderer::Mesh::PrimitiveType::Triangles);
-
-    m_warpMesh.Bind();
-    m_radiusAngleBuffer.Bind();
-    m_zoomRotWarpBuffer.Bind();
-    m_centerBuffer.Bind();
-    m_distanceBuffer.Bind();
-    m_stretchBuffer.Bind();
-
-    m_radiusAngleBuffer.InitializeAttributePointer(3);
-    m_zoomRotWarpBuffer.InitializeAttributePointer(4);
-    m_centerBuffer.InitializeAttributePointer(5);
-    m_distanceBuffer.InitializeAttributePointer(6);
-    m_stretchBuffer.InitializeAttributePointer(7);
+    m_vertexArray.Bind();
+    m_indices.Bind();
 
+    Renderer::VertexBuffer<Renderer::Point>::SetEnableAttributeArray(0, true);
     Renderer::VertexBuffer<Renderer::Point>::SetEnableAttributeArray(3, true);
     Renderer::VertexBuffer<Renderer::Point>::SetEnableAttributeArray(4, true);
     Renderer::VertexBuffer<Renderer::Point>::SetEnableAttributeArray(5, true);
     Renderer::VertexBuffer<Renderer::Point>::SetEnableAttributeArray(6, true);
     Renderer::VertexBuffer<Renderer::Point>::SetEnableAttributeArray(7, true);
 
-    Renderer::Mesh::Unbind();
+    Renderer::VertexArray::Unbind();
 }
 
 void PerPixelMesh::LoadWarpShader(const PresetState& presetState)
@@ -83,9 +76,15 @@ void PerPixelMesh::CompileWarpShader(PresetState& presetState)
     }
 }
 
-void PerPixelMesh::Draw(const PresetState& presetState,
-                        const PerFrameContext& perFrameContext,
-                        PerPixelContext& perPixelContext)
+auto PerPixelMesh::UsesBlurTextures() const -> bool
+{
+    return m_warpShader && m_warpShader->RequiredBlurLevel() != BlurTexture::BlurLevel::None;
+}
+
+void PerPixelMesh::Record(Renderer::CommandList& commandList,
+                          const PresetState& presetState,
+                          const PerFrameContext& perFrameContext,
+                          PerPixelContext& perPixelContext)
 {
     if (presetState.renderContext.viewportSizeX == 0 ||
         presetState.renderContext.viewportSizeY == 0 ||
@@ -101,8 +100,11 @@ void PerPixelMesh::Draw(const PresetState& presetState,
     // Calculate the dynamic movement values
     CalculateMesh(presetState, perFrameContext, perPixelContext);
 
-    // Render the resulting mesh.
-    WarpedBlit(presetState, perFrameContext);
+    // Upload and render the resulting mesh.
+    commandList.Record([this, &presetState, &perFrameContext]() {
+        UploadVertices();
+        WarpedBlit(presetState, perFrameContext);
+    });
 }
 
 void PerPixelMesh::InitializeMesh(const PresetState& presetState)
@@ -116,14 +118,8 @@ void PerPixelMesh::InitializeMesh(const PresetState& presetState)
         // Grid size has changed, resize buffers accordingly
         const size_t vertexCount = (m_gridSizeX + 1) * (m_gridSizeY + 1);
 
-        m_warpMesh.SetVertexCount(vertexCount);
-        m_radiusAngleBuffer.Resize(vertexCount);
-        m_zoomRotWarpBuffer.Resize(vertexCount);
-        m_centerBuffer.Resize(vertexCount);
-        m_distanceBuffer.Resize(vertexCount);
-        m_stretchBuffer.Resize(vertexCount);
-
-        m_warpMesh.Indices().Resize(m_gridSizeX * m_gridSizeY * 6);
+        m_vertices.Resize(vertexCount);
+        m_indices.Resize(m_gridSizeX * m_gridSizeY * 6);
     }
     else if (m_viewportWidth == presetState.renderContext.viewportSizeX &&
              m_viewportHeight == presetState.renderContext.viewportSizeY)
@@ -136,7 +132,7 @@ void PerPixelMesh::InitializeMesh(const PresetState& presetState)
     const float aspectY = presetState.renderContext.aspectY;
 
     // Either viewport size or mesh size changed, reinitialize the vertices.
-    auto& vertices = m_warpMesh.Vertices();
+    auto& vertices = m_vertices.Get();
     int vertexIndex{0};
     for (int gridY = 0; gridY <= m_gridSizeY; gridY++)
     {
@@ -144,17 +140,18 @@ void PerPixelMesh::InitializeMesh(const PresetState& presetState)
         {
             const float x = static_cast<float>(gridX) / static_cast<float>(m_gridSizeX) * 2.0f - 1.0f;
             const float y = static_cast<float>(gridY) / static_cast<float>(m_gridSizeY) * 2.0f - 1.0f;
-            vertices[vertexIndex] = {x, y};
+            auto& vertex = vertices[vertexIndex];
+            vertex.position = {x, y};
 
             // Milkdrop uses sqrtf, but hypotf is probably safer.
-            m_radiusAngleBuffer[vertexIndex].radius = hypotf(x * aspectX, y * aspectY);
+            vertex.radiusAngle.radius = hypotf(x * aspectX, y * aspectY);
             if (gridY == m_gridSizeY / 2 && gridX == m_gridSizeX / 2)
             {
-                m_radiusAngleBuffer[vertexIndex].angle = 0.0f;
+                vertex.radiusAngle.angle = 0.0f;
             }
             else
             {
-                m_radiusAngleBuffer[vertexIndex].angle = atan2f(y * aspectY, x * aspectX);
+                vertex.radiusAngle.angle = atan2f(y * aspectY, x * aspectX);
             }
 
             vertexIndex++;
@@ -186,19 +183,23 @@ void PerPixelMesh::InitializeMesh(const PresetState& presetState)
                 // 0 - 1      3
                 //   /      /
                 // 2      4 - 5
-                m_warpMesh.Indices()[vertexListIndex++] = vertex;
-                m_warpMesh.Indices()[vertexListIndex++] = vertex + 1;
-                m_warpMesh.Indices()[vertexListIndex++] = vertex + m_gridSizeX + 1;
-                m_warpMesh.Indices()[vertexListIndex++] = vertex + 1;
-                m_warpMesh.Indices()[vertexListIndex++] = vertex + m_gridSizeX + 1;
-                m_warpMesh.Indices()[vertexListIndex++] = vertex + m_gridSizeX + 2;
+                m_indices[vertexListIndex++] = vertex;
+                m_indices[vertexListIndex++] = vertex + 1;
+                m_indices[vertexListIndex++] = vertex + m_gridSizeX + 1;
+                m_indices[vertexListIndex++] = vertex + 1;
+                m_indices[vertexListIndex++] = vertex + m_gridSizeX + 1;
+                m_indices[vertexListIndex++] = vertex + m_gridSizeX + 2;
             }
         }
     }
+
+    m_indicesChanged = true;
 }
 
 void PerPixelMesh::CalculateMesh(const PresetState& presetState, const PerFrameContext& perFrameContext, PerPixelContext& perPixelContext)
 {
+    TRACE_SCOPE("PerPixelMesh::CalculateMesh");
+
     // Cache some per-frame values as floats
     float zoom = static_cast<float>(*perFrameContext.zoom);
     float zoomExp = static_cast<float>(*perFrameContext.zoomexp);
@@ -214,17 +215,17 @@ void PerPixelMesh::CalculateMesh(const PresetState& presetState, const PerFrameC
     int vertex = 0;
 
     // Can't make this multithreaded as per-pixel code may use gmegabuf or regXX vars.
-    auto& vertices = m_warpMesh.Vertices();
+    auto& vertices = m_vertices.Get();
     for (int y = 0; y <= m_gridSizeY; y++)
     {
         for (int x = 0; x <= m_gridSizeX; x++)
         {
-            auto& curVertex = vertices[vertex];
-            auto& curRadiusAngle = m_radiusAngleBuffer[vertex];
-            auto& curZoomRotWarp = m_zoomRotWarpBuffer[vertex];
-            auto& curCenter = m_centerBuffer[vertex];
-            auto& curDistance = m_distanceBuffer[vertex];
-            auto& curStretch = m_stretchBuffer[vertex];
+            auto& curVertex = vertices[vertex].position;
+            auto& curRadiusAngle = vertices[vertex].radiusAngle;
+            auto& curZoomRotWarp = vertices[vertex].zoomRotWarp;
+            auto& curCenter = vertices[vertex].center;
+            auto& curDistance = vertices[vertex].distance;
+            auto& curStretch = vertices[vertex].stretch;
 
             // Execute per-vertex/per-pixel code if the preset uses it.
             if (perPixelContext.perPixelCodeHandle)
@@ -271,13 +272,36 @@ void PerPixelMesh::CalculateMesh(const PresetState& presetState, const PerFrameC
             vertex++;
         }
     }
+}
+
+void PerPixelMesh::UploadVertices()
+{
+    m_vertexArray.Bind();
+
+    if (m_indicesChanged)
+    {
+        m_indices.Update();
+        m_indicesChanged = false;
+    }
+
+    GLintptr offset{};
+    auto* streamingBuffer = Renderer::StreamingBuffer::Current();
+    if (streamingBuffer != nullptr)
+    {
+        auto const& vertices = m_vertices.Get();
+        auto const allocation = streamingBuffer->Allocate(sizeof(WarpVertex) * vertices.size());
+        std::memcpy(allocation.data, vertices.data(), sizeof(WarpVertex) * vertices.size());
+        streamingBuffer->Commit();
+        offset = allocation.offset;
+    }
+    else
+    {
+        m_vertices.Update();
+    }
+
+    WarpVertex::InitializeAttributePointers(offset);
 
-    m_warpMesh.Update();
-    m_radiusAngleBuffer.Update();
-    m_zoomRotWarpBuffer.Update();
-    m_centerBuffer.Update();
-    m_distanceBuffer.Update();
-    m_stretchBuffer.Update();
+    Renderer::VertexArray::Unbind();
 }
 
 void PerPixelMesh::WarpedBlit(const PresetState& presetState,
@@ -348,13 +372,27 @@ void PerPixelMesh::WarpedBlit(const PresetState& presetState,
     }
     m_perPixelSampler.Bind(0);
 
-    m_warpMesh.Draw();
+    m_vertexArray.Bind();
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(m_indices.Size()), GL_UNSIGNED_INT, nullptr);
+    Renderer::GLStateCache::Current().CountDrawCall();
 
-    Renderer::Mesh::Unbind();
+    Renderer::VertexArray::Unbind();
     Renderer::Sampler::Unbind(0);
     Renderer::Shader::Unbind();
 }
 
+void PerPixelMesh::WarpVertex::InitializeAttributePointers(GLintptr offset)
+{
+    constexpr auto stride = static_cast<GLsizei>(sizeof(WarpVertex));
+
+    Renderer::Point::InitializeAttributePointer(0, stride, offset + offsetof(WarpVertex, position));
+    RadiusAngle::InitializeAttributePointer(3, stride, offset + offsetof(WarpVertex, radiusAngle));
+    ZoomRotWarp::InitializeAttributePointer(4, stride, offset + offsetof(WarpVertex, zoomRotWarp));
+    Renderer::Point::InitializeAttributePointer(5, stride, offset + offsetof(WarpVertex, center));
+    Renderer::Point::InitializeAttributePointer(6, stride, offset + offsetof(WarpVertex, distance));
+    Renderer::Point::InitializeAttributePointer(7, stride, offset + offsetof(WarpVertex, stretch));
+}
+
 auto PerPixelMesh::GetDefaultWarpShader(const PresetState& presetState) -> std::shared_ptr<Renderer::Shader>
 {
     auto perPixelMeshShader = m_perPixelMeshShader.lock();
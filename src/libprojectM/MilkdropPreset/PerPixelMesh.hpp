@@ -1,7 +1,14 @@
 #pragma once
 
-#include <Renderer/Mesh.hpp>
+#include <Renderer/CommandList.hpp>
+#include <Renderer/Point.hpp>
+#include <Renderer/Sampler.hpp>
 #include <Renderer/Shader.hpp>
+#include <Renderer/VertexArray.hpp>
+#include <Renderer/VertexBuffer.hpp>
+#include <Renderer/VertexIndexArray.hpp>
+
+#include <memory>
 
 namespace libprojectM {
 namespace MilkdropPreset {
@@ -23,6 +30,9 @@ class MilkdropShader;
  * increases the CPU usage as the per-pixel expression needs to be run for every grid point.
  *
  * The mesh size can be changed between frames, the class will reallocate the buffers if needed.
+ *
+ * All vertex attributes are stored interleaved in a single vertex, which is uploaded once per frame
+ * into the current Renderer::StreamingBuffer.
  */
 class PerPixelMesh
 {
@@ -42,14 +52,23 @@ public:
     void CompileWarpShader(PresetState& presetState);
 
     /**
-     * @brief Renders the transformation mesh.
+     * @brief Returns whether the warp shader samples any blur texture.
+     * @return true if the compiled warp shader uses a blur texture, false if not or if there is no warp shader.
+     */
+    auto UsesBlurTextures() const -> bool;
+
+    /**
+     * @brief Runs the per-pixel code and records the commands to render the transformation mesh.
+     * Doesn't call OpenGL, so it can be run on the command recording thread.
+     * @param commandList The command list to record the vertex upload and draw commands into.
      * @param presetState The preset state to retrieve the configuration values from.
      * @param presetPerFrameContext The per-frame context to retrieve the initial vars from.
      * @param perPixelContext The per-pixel code context to use.
      */
-    void Draw(const PresetState& presetState,
-              const PerFrameContext& perFrameContext,
-              PerPixelContext& perPixelContext);
+    void Record(Renderer::CommandList& commandList,
+                const PresetState& presetState,
+                const PerFrameContext& perFrameContext,
+                PerPixelContext& perPixelContext);
 
 
 private:
@@ -60,9 +79,9 @@ private:
         float radius{};
         float angle{};
 
-        static void InitializeAttributePointer(uint32_t attributeIndex)
+        static void InitializeAttributePointer(uint32_t attributeIndex, GLsizei stride = sizeof(RadiusAngle), GLintptr offset = 0)
         {
-            glVertexAttribPointer(attributeIndex, sizeof(RadiusAngle) / sizeof(float), GL_FLOAT, GL_FALSE, sizeof(RadiusAngle), nullptr);
+            glVertexAttribPointer(attributeIndex, sizeof(RadiusAngle) / sizeof(float), GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(offset));
         }
     };
 
@@ -75,12 +94,30 @@ private:
         float rot{};
         float warp{};
 
-        static void InitializeAttributePointer(uint32_t attributeIndex)
+        static void InitializeAttributePointer(uint32_t attributeIndex, GLsizei stride = sizeof(ZoomRotWarp), GLintptr offset = 0)
         {
-            glVertexAttribPointer(attributeIndex, sizeof(ZoomRotWarp) / sizeof(float), GL_FLOAT, GL_FALSE, sizeof(ZoomRotWarp), nullptr);
+            glVertexAttribPointer(attributeIndex, sizeof(ZoomRotWarp) / sizeof(float), GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(offset));
         }
     };
 
+    /**
+     * Interleaved attributes of a single warp mesh vertex.
+     */
+    struct WarpVertex {
+        Renderer::Point position; //!< Vertex position, attribute 0.
+        RadiusAngle radiusAngle;  //!< Radius and angle, attribute 3.
+        ZoomRotWarp zoomRotWarp;  //!< Zoom, zoom exponent, rotation and warp, attribute 4.
+        Renderer::Point center;   //!< Center coordinates, attribute 5.
+        Renderer::Point distance; //!< Distance values, attribute 6.
+        Renderer::Point stretch;  //!< Stretch values, attribute 7.
+
+        /**
+         * @brief Initializes the attribute array pointers for all vertex attributes.
+         * @param offset The byte offset of the first vertex in the bound buffer.
+         */
+        static void InitializeAttributePointers(GLintptr offset);
+    };
+
     /**
      * @brief Initializes the vertex array and fills in static data if needed.
      *
@@ -102,6 +139,13 @@ private:
                        const PerFrameContext& perFrameContext,
                        PerPixelContext& perPixelContext);
 
+    /**
+     * @brief Uploads the vertex data and points the attribute arrays to it.
+     * Uses the current streaming buffer, or the mesh's own vertex buffer if there is none.
+     * Also uploads the indices if the grid was regenerated.
+     */
+    void UploadVertices();
+
     /**
      * @brief Draws the warp mesh with or without a warp shader.
      * If the preset doesn't use a warp shader, a default textured shader is used.
@@ -121,12 +165,11 @@ private:
     int m_viewportWidth{};  //!< Last known viewport width.
     int m_viewportHeight{}; //!< Last known viewport height.
 
-    Renderer::Mesh m_warpMesh;                                                                         //!< The Warp effect mesh
-    Renderer::VertexBuffer<RadiusAngle> m_radiusAngleBuffer{Renderer::VertexBufferUsage::StreamDraw};  //!< Vertex attribute buffer for radius and angle values.
-    Renderer::VertexBuffer<ZoomRotWarp> m_zoomRotWarpBuffer{Renderer::VertexBufferUsage::StreamDraw};  //!< Vertex attribute buffer for zoom, roation and warp values.
-    Renderer::VertexBuffer<Renderer::Point> m_centerBuffer{Renderer::VertexBufferUsage::StreamDraw};   //!< Vertex attribute buffer for center coordinate values.
-    Renderer::VertexBuffer<Renderer::Point> m_distanceBuffer{Renderer::VertexBufferUsage::StreamDraw}; //!< Vertex attribute buffer for distance values.
-    Renderer::VertexBuffer<Renderer::Point> m_stretchBuffer{Renderer::VertexBufferUsage::StreamDraw};  //!< Vertex attribute buffer for stretch values.
+    bool m_indicesChanged{false}; //!< If true, the indices were regenerated and are uploaded with the next vertices.
+
+    Renderer::VertexArray m_vertexArray;                                                     //!< The warp mesh vertex array object.
+    Renderer::VertexBuffer<WarpVertex> m_vertices{Renderer::VertexBufferUsage::DynamicDraw}; //!< Warp mesh vertices. Only uploaded into this buffer without a streaming buffer.
+    Renderer::VertexIndexArray m_indices{Renderer::VertexBufferUsage::StaticDraw};           //!< Triangle list indices of the warp mesh.
 
     std::weak_ptr<Renderer::Shader> m_perPixelMeshShader;             //!< Special shader which calculates the per-pixel UV coordinates.
     std::unique_ptr<MilkdropShader> m_warpShader;                     //!< The warp shader. Either preset-defined or a default shader.
@@ -0,0 +1,169 @@
+#include "PostProcess.hpp"
+
+#include "MilkdropStaticShaders.hpp"
+
+#include <Renderer/BlendMode.hpp>
+#include <Renderer/ShaderCache.hpp>
+#include <Renderer/ShaderDefines.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace libprojectM {
+namespace MilkdropPreset {
+
+PostProcess::PostProcess(const PresetState& presetState)
+    : m_presetState(presetState)
+    , m_mesh(Renderer::VertexBufferUsage::DynamicDraw, true, true)
+{
+    m_mesh.SetRenderPrimitiveType(Renderer::Mesh::PrimitiveType::TriangleStrip);
+    m_mesh.SetVertexCount(4);
+    m_mesh.UVs().Set({{0.0f, 0.0f},
+                      {1.0f, 0.0f},
+                      {0.0f, 1.0f},
+                      {1.0f, 1.0f}});
+}
+
+void PostProcess::Draw()
+{
+    UpdateMesh();
+
+    // Milkdrop adds gamma - 1 extra copies of each image, but only redraws the image with video echo if gamma > 1.
+    float const gammaAdj = m_presetState.gammaAdj;
+    float gamma = gammaAdj;
+    float alphaGain;
+    if (UsesVideoEcho())
+    {
+        int const redrawCount = gammaAdj > 0.001f ? static_cast<int>(gammaAdj - 0.0001f) : 0;
+        if (redrawCount == 0)
+        {
+            gamma = 1.0f;
+        }
+        alphaGain = static_cast<float>(redrawCount + 1);
+    }
+    else
+    {
+        alphaGain = static_cast<float>(static_cast<int>(gammaAdj - 0.0001f) + 1);
+    }
+
+    auto shader = GetShader();
+    shader->Bind();
+    shader->SetUniformMat4x4("vertex_transformation", PresetState::orthogonalProjection);
+    shader->SetUniformInt("texture_sampler", 0);
+
+    // Video echo: the second image is zoomed around the center and optionally flipped.
+    shader->SetUniformFloat("echo_scale", 1.0f / m_presetState.videoEchoZoom);
+    shader->SetUniformFloat("echo_alpha", m_presetState.videoEchoAlpha);
+    shader->SetUniformFloat("gamma", gamma);
+    shader->SetUniformFloat("alpha_gain", alphaGain);
+
+    auto mainTexture = m_presetState.mainTexture.lock();
+    if (mainTexture)
+    {
+        mainTexture->Bind(0);
+        m_sampler.Bind(0);
+    }
+
+    Renderer::BlendMode::SetBlendActive(false);
+
+    m_mesh.Draw();
+
+    Renderer::Mesh::Unbind();
+    Renderer::Shader::Unbind();
+
+    if (mainTexture)
+    {
+        mainTexture->Unbind(0);
+        Renderer::Sampler::Unbind(0);
+    }
+}
+
+void PostProcess::UpdateMesh()
+{
+    float const aspect = m_presetState.renderContext.viewportSizeX / static_cast<float>(m_presetState.renderContext.viewportSizeY * m_presetState.renderContext.invAspectY);
+    float aspectMultX = 1.0f;
+    float aspectMultY = 1.0f;
+
+    if (aspect > 1)
+    {
+        aspectMultY = aspect;
+    }
+    else
+    {
+        aspectMultX = 1.0f / aspect;
+    }
+
+    float const fOnePlusInvWidth = 1.0f + 1.0f / static_cast<float>(m_presetState.renderContext.viewportSizeX);
+    float const fOnePlusInvHeight = 1.0f + 1.0f / static_cast<float>(m_presetState.renderContext.viewportSizeY);
+    m_mesh.Vertices().Set({{-fOnePlusInvWidth * aspectMultX, fOnePlusInvHeight * aspectMultY},
+                           {fOnePlusInvWidth * aspectMultX, fOnePlusInvHeight * aspectMultY},
+                           {-fOnePlusInvWidth * aspectMultX, -fOnePlusInvHeight * aspectMultY},
+                           {fOnePlusInvWidth * aspectMultX, -fOnePlusInvHeight * aspectMultY}});
+
+    auto& colors = m_mesh.Colors();
+    for (int i = 0; i < 4; i++)
+    {
+        auto const indexFloat = static_cast<float>(i);
+        std::array<float, 3> shade{
+            {0.6f + 0.3f * sinf(m_presetState.renderContext.time * 30.0f * 0.0143f + 3 + indexFloat * 21 + m_presetState.hueRandomOffsets[3]),
+             0.6f + 0.3f * sinf(m_presetState.renderContext.time * 30.0f * 0.0107f + 1 + indexFloat * 13 + m_presetState.hueRandomOffsets[1]),
+             0.6f + 0.3f * sinf(m_presetState.renderContext.time * 30.0f * 0.0129f + 6 + indexFloat * 9 + m_presetState.hueRandomOffsets[2])}};
+
+        float const max = std::max(shade[0], std::max(shade[1], shade[2]));
+
+        for (auto& component : shade)
+        {
+            component /= max;
+            component = 0.5f + 0.5f * component;
+        }
+
+        colors[i] = {shade[0], shade[1], shade[2], 1.0f};
+    }
+
+    m_mesh.Update();
+}
+
+auto PostProcess::UsesVideoEcho() const -> bool
+{
+    return m_presetState.videoEchoAlpha > 0.001f;
+}
+
+auto PostProcess::GetShader() -> std::shared_ptr<Renderer::Shader>
+{
+    auto shader = m_shader.lock();
+    if (shader)
+    {
+        return shader;
+    }
+
+    // The effect switches don't change while the preset is running, so they're compiled into the shader.
+    Renderer::ShaderDefines defines;
+    defines.Set("USE_ECHO", UsesVideoEcho() ? 1 : 0);
+    defines.Set("ECHO_ORIENTATION", UsesVideoEcho() ? m_presetState.videoEchoOrientation % 4 : 0);
+    defines.Set("BRIGHTEN", m_presetState.brighten ? 1 : 0);
+    defines.Set("DARKEN", m_presetState.darken ? 1 : 0);
+    defines.Set("SOLARIZE", m_presetState.solarize ? 1 : 0);
+    defines.Set("INVERT", m_presetState.invert ? 1 : 0);
+
+    auto const cacheKey = defines.Key("milkdrop_post_process");
+    shader = m_presetState.renderContext.shaderCache->Get(cacheKey);
+    if (!shader)
+    {
+        // First use of this variant, compile and cache.
+        auto staticShaders = libprojectM::MilkdropPreset::MilkdropStaticShaders::Get();
+
+        shader = std::make_shared<Renderer::Shader>();
+        shader->CompileProgram(staticShaders->GetTexturedDrawVertexShader(),
+                               defines.Apply(staticShaders->GetPostProcessFragmentShader()));
+
+        m_presetState.renderContext.shaderCache->Insert(cacheKey, shader);
+    }
+
+    m_shader = shader;
+
+    return shader;
+}
+
+} // namespace MilkdropPreset
+} // namespace libprojectM
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "PresetState.hpp"
+
+#include <Renderer/Mesh.hpp>
+#include <Renderer/Sampler.hpp>
+#include <Renderer/Shader.hpp>
+
+#include <memory>
+
+namespace libprojectM {
+namespace MilkdropPreset {
+
+/**
+ * @brief Applies the Milkdrop 1 post-processing effects in a single full-screen pass.
+ *
+ * Used if the preset has no composite shader. Combines the video "echo" (ghost image), the gamma
+ * adjustment with the randomized hue colors and the brighten, darken, solarize and invert filters.
+ *
+ * Milkdrop renders these effects by redrawing the image quad with different blend modes, once per
+ * echo image, gamma step and filter. As each additive pass only adds non-negative values, the sum
+ * clamped by the framebuffer equals the clamped sum of all passes, so the fragment shader computes
+ * the same result from at most two texture samples.
+ *
+ * The echo orientation and filter switches are constant for a preset and are compiled into a
+ * specialized shader variant, so the shader contains no branches.
+ */
+class PostProcess
+{
+public:
+    PostProcess() = delete;
+
+    explicit PostProcess(const PresetState& presetState);
+
+    /**
+     * @brief Renders the main texture with all effects into the current framebuffer.
+     */
+    void Draw();
+
+private:
+    /**
+     * @brief Updates the quad vertices for the current aspect ratio and the randomized hue colors.
+     */
+    void UpdateMesh();
+
+    /**
+     * @brief Returns whether the video echo image is visible.
+     * @return true if the echo image is drawn, false if not.
+     */
+    auto UsesVideoEcho() const -> bool;
+
+    /**
+     * @brief Returns the post-processing shader variant for the preset's effect switches, compiling it on first use.
+     * @return The shader program.
+     */
+    auto GetShader() -> std::shared_ptr<Renderer::Shader>;
+
+    const PresetState& m_presetState; //!< The global preset state.
+
+    Renderer::Mesh m_mesh;                                    //!< The image quad with the hue colors in the corners.
+    Renderer::Sampler m_sampler{GL_CLAMP_TO_EDGE, GL_LINEAR}; //!< Sampler for the main texture.
+    std::weak_ptr<Renderer::Shader> m_shader;                 //!< The post-processing shader variant used by this preset.
+};
+
+} // namespace MilkdropPreset
+} // namespace libprojectM
@@ -0,0 +1,565 @@
+#include "PresetBundle.hpp"
+
+#include "MappedFile.hpp"
+#include "MilkdropPresetExceptions.hpp"
+#include "PresetFileParser.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+// Fall back to boost if compiler doesn't support C++17
+#include PROJECTM_FILESYSTEM_INCLUDE
+using namespace PROJECTM_FILESYSTEM_NAMESPACE::filesystem;
+
+namespace libprojectM {
+namespace MilkdropPreset {
+
+namespace {
+
+constexpr char bundleMagic[4] = {'M', 'L', 'K', 'C'};
+constexpr uint32_t byteOrderMark = 0x01020304; //!< Bundles are written in native byte order.
+constexpr size_t recordAlignment = 8;          //!< Alignment of each record in the bundle file.
+
+/**
+ * @brief Flags for each stored value.
+ */
+enum ValueFlags : uint16_t
+{
+    HasInt = 1,  //!< The value could be converted to an integer.
+    HasFloat = 2 //!< The value could be converted to a float.
+};
+
+/**
+ * @brief The bundle file header.
+ */
+struct FileHeader {
+    char magic[4];            //!< Always "MLKC".
+    uint32_t byteOrder;       //!< Byte order mark, must read as byteOrderMark.
+    uint32_t version;         //!< Bundle format version.
+    uint32_t slotCount;       //!< Number of preset key slots the bundle was compiled with.
+    uint32_t presetCount;     //!< Number of directory entries.
+    uint32_t directoryOffset; //!< Offset of the first directory entry.
+};
+
+/**
+ * @brief Header of each preset record.
+ */
+struct RecordHeader {
+    uint32_t valueCount;     //!< Number of stored key values.
+    uint32_t codeBlockCount; //!< Number of stored code blocks.
+};
+
+/**
+ * @brief Code blocks stored in each record. Matches the blocks used by PresetState.
+ */
+auto CodePrefixes() -> std::vector<std::string>
+{
+    std::vector<std::string> prefixes{"per_frame_init_", "per_frame_", "per_pixel_", "warp_", "comp_"};
+
+    for (int index = 0; index < CustomWaveformCount; index++)
+    {
+        std::string const wavePrefix = "wave_" + std::to_string(index) + "_";
+        prefixes.push_back(wavePrefix + "init");
+        prefixes.push_back(wavePrefix + "per_frame");
+        prefixes.push_back(wavePrefix + "per_point");
+    }
+
+    for (int index = 0; index < CustomShapeCount; index++)
+    {
+        std::string const shapePrefix = "shape_" + std::to_string(index) + "_";
+        prefixes.push_back(shapePrefix + "init");
+        prefixes.push_back(shapePrefix + "per_frame");
+    }
+
+    return prefixes;
+}
+
+template<typename T>
+void AppendBytes(std::vector<char>& buffer, const T& value)
+{
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+void AlignBuffer(std::vector<char>& buffer, size_t alignment)
+{
+    buffer.resize((buffer.size() + alignment - 1) / alignment * alignment, '\0');
+}
+
+auto EqualsIgnoreCase(const char* lhs, size_t lhsLength, const std::string& rhs) -> bool
+{
+    if (lhsLength != rhs.length())
+    {
+        return false;
+    }
+
+    for (size_t index = 0; index < lhsLength; ++index)
+    {
+        if (std::tolower(static_cast<unsigned char>(lhs[index])) != std::tolower(static_cast<unsigned char>(rhs[index])))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
+constexpr uint32_t PresetBundle::FormatVersion;
+
+struct PresetBundle::DirectoryEntry {
+    uint64_t sourceHash;             //!< Hash of the source file contents.
+    int64_t sourceModificationTime; //!< Modification time of the source file.
+    uint32_t sourceSize;             //!< Size of the source file in bytes.
+    uint32_t nameOffset;             //!< Offset of the relative preset path.
+    uint32_t nameLength;             //!< Length of the relative preset path.
+    uint32_t recordOffset;           //!< Offset of the preset record.
+    uint32_t recordSize;             //!< Size of the preset record in bytes.
+    uint32_t reserved;               //!< Padding, always zero.
+};
+
+struct PresetBundle::Value {
+    uint16_t slot;         //!< The key slot.
+    uint16_t flags;        //!< ValueFlags, which conversions are valid.
+    int32_t intValue;      //!< The value converted to an integer.
+    float floatValue;      //!< The value converted to a float.
+    uint32_t stringOffset; //!< Offset of the original value string, relative to the record.
+    uint32_t stringLength; //!< Length of the original value string.
+};
+
+struct PresetBundle::CodeBlock {
+    uint32_t prefixOffset; //!< Offset of the key prefix, relative to the record.
+    uint32_t prefixLength; //!< Length of the key prefix.
+    uint32_t codeOffset;   //!< Offset of the concatenated code, relative to the record.
+    uint32_t codeLength;   //!< Length of the concatenated code.
+};
+
+PresetBundle::PresetBundle(const std::string& bundleFile)
+{
+    try
+    {
+        m_file = std::make_unique<MappedFile>(bundleFile);
+    }
+    catch (const std::runtime_error& ex)
+    {
+        throw PresetBundleException(std::string("[PresetBundle] ") + ex.what());
+    }
+
+    if (m_file->Size() < sizeof(FileHeader))
+    {
+        throw PresetBundleException("[PresetBundle] File \"" + bundleFile + "\" is not a preset bundle.");
+    }
+
+    const auto* header = reinterpret_cast<const FileHeader*>(m_file->Data());
+    if (std::memcmp(header->magic, bundleMagic, sizeof(bundleMagic)) != 0 ||
+        header->byteOrder != byteOrderMark)
+    {
+        throw PresetBundleException("[PresetBundle] File \"" + bundleFile + "\" is not a preset bundle.");
+    }
+
+    if (header->version != FormatVersion || header->slotCount != PresetKeyTable::SlotCount)
+    {
+        throw PresetBundleException("[PresetBundle] Bundle \"" + bundleFile + "\" was compiled with an incompatible version.");
+    }
+
+    if (header->directoryOffset % alignof(DirectoryEntry) != 0 ||
+        header->directoryOffset + static_cast<uint64_t>(header->presetCount) * sizeof(DirectoryEntry) > m_file->Size())
+    {
+        throw PresetBundleException("[PresetBundle] Bundle \"" + bundleFile + "\" is corrupted.");
+    }
+
+    m_presetCount = header->presetCount;
+    m_directoryEntries = reinterpret_cast<const DirectoryEntry*>(m_file->Data() + header->directoryOffset);
+
+    for (uint32_t index = 0; index < m_presetCount; ++index)
+    {
+        const auto& entry = m_directoryEntries[index];
+        if (static_cast<uint64_t>(entry.nameOffset) + entry.nameLength > m_file->Size() ||
+            entry.recordOffset % recordAlignment != 0 ||
+            static_cast<uint64_t>(entry.recordOffset) + entry.recordSize > m_file->Size())
+        {
+            throw PresetBundleException("[PresetBundle] Bundle \"" + bundleFile + "\" is corrupted.");
+        }
+    }
+
+    m_directory = absolute(path(bundleFile)).lexically_normal().parent_path().string();
+}
+
+PresetBundle::~PresetBundle() = default;
+
+auto PresetBundle::Count() const -> size_t
+{
+    return m_presetCount;
+}
+
+auto PresetBundle::Find(const std::string& presetFile) const -> int
+{
+    std::string name;
+    try
+    {
+        name = absolute(path(presetFile)).lexically_normal().lexically_relative(path(m_directory)).generic_string();
+    }
+    catch (filesystem_error&)
+    {
+        return -1;
+    }
+
+    if (name.empty())
+    {
+        return -1;
+    }
+
+    const auto* end = m_directoryEntries + m_presetCount;
+    const auto* entry = std::lower_bound(m_directoryEntries, end, name, [this](const DirectoryEntry& lhs, const std::string& rhs) {
+        return rhs.compare(0, rhs.length(), m_file->Data() + lhs.nameOffset, lhs.nameLength) > 0;
+    });
+
+    if (entry == end || name.compare(0, name.length(), m_file->Data() + entry->nameOffset, entry->nameLength) != 0)
+    {
+        return -1;
+    }
+
+    return static_cast<int>(entry - m_directoryEntries);
+}
+
+auto PresetBundle::Name(int index) const -> std::string
+{
+    const auto& entry = m_directoryEntries[index];
+    return {m_file->Data() + entry.nameOffset, entry.nameLength};
+}
+
+auto PresetBundle::SourceHash(int index) const -> uint64_t
+{
+    return m_directoryEntries[index].sourceHash;
+}
+
+auto PresetBundle::SourceSize(int index) const -> uint32_t
+{
+    return m_directoryEntries[index].sourceSize;
+}
+
+auto PresetBundle::SourceModificationTime(int index) const -> int64_t
+{
+    return m_directoryEntries[index].sourceModificationTime;
+}
+
+auto PresetBundle::Preset(int index) const -> Record
+{
+    const auto& entry = m_directoryEntries[index];
+    return {m_file->Data() + entry.recordOffset, entry.recordSize};
+}
+
+auto PresetBundle::HashSource(const char* data, size_t size) -> uint64_t
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t index = 0; index < size; ++index)
+    {
+        hash ^= static_cast<unsigned char>(data[index]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+auto PresetBundle::ModificationTime(const std::string& file) -> int64_t
+{
+#ifdef PROJECTM_FILESYSTEM_USE_BOOST
+    boost::system::error_code error;
+    auto const time = static_cast<int64_t>(last_write_time(path(file), error));
+#else
+    std::error_code error;
+    auto const time = static_cast<int64_t>(last_write_time(path(file), error).time_since_epoch().count());
+#endif
+    return error ? -1 : time;
+}
+
+PresetBundle::Record::Record(const char* data, size_t size)
+    : m_data(data)
+    , m_size(size)
+{
+    if (m_size < sizeof(RecordHeader))
+    {
+        throw PresetBundleException("[PresetBundle] Preset record is corrupted.");
+    }
+
+    const auto* header = reinterpret_cast<const RecordHeader*>(m_data);
+    uint64_t const valuesEnd = sizeof(RecordHeader) + static_cast<uint64_t>(header->valueCount) * sizeof(Value);
+    uint64_t const codeBlocksEnd = valuesEnd + static_cast<uint64_t>(header->codeBlockCount) * sizeof(CodeBlock);
+    if (header->valueCount > PresetKeyTable::SlotCount || codeBlocksEnd > m_size)
+    {
+        throw PresetBundleException("[PresetBundle] Preset record is corrupted.");
+    }
+
+    m_values = reinterpret_cast<const Value*>(m_data + sizeof(RecordHeader));
+    m_codeBlocks = reinterpret_cast<const CodeBlock*>(m_data + valuesEnd);
+    m_codeBlockCount = header->codeBlockCount;
+
+    for (uint32_t index = 0; index < header->valueCount; ++index)
+    {
+        const auto& value = m_values[index];
+        if (value.slot >= PresetKeyTable::SlotCount ||
+            static_cast<uint64_t>(value.stringOffset) + value.stringLength > m_size)
+        {
+            throw PresetBundleException("[PresetBundle] Preset record is corrupted.");
+        }
+        m_valueIndex[value.slot] = static_cast<uint16_t>(index + 1);
+    }
+
+    for (uint32_t index = 0; index < m_codeBlockCount; ++index)
+    {
+        const auto& block = m_codeBlocks[index];
+        if (static_cast<uint64_t>(block.prefixOffset) + block.prefixLength > m_size ||
+            static_cast<uint64_t>(block.codeOffset) + block.codeLength > m_size)
+        {
+            throw PresetBundleException("[PresetBundle] Preset record is corrupted.");
+        }
+    }
+}
+
+auto PresetBundle::Record::GetCode(const std::string& keyPrefix) const -> std::string
+{
+    for (uint32_t index = 0; index < m_codeBlockCount; ++index)
+    {
+        const auto& block = m_codeBlocks[index];
+        if (EqualsIgnoreCase(m_data + block.prefixOffset, block.prefixLength, keyPrefix))
+        {
+            return {m_data + block.codeOffset, block.codeLength};
+        }
+    }
+
+    return {};
+}
+
+auto PresetBundle::Record::GetInt(PresetKeySlot slot, int defaultValue) const -> int
+{
+    const auto* value = FindValue(slot);
+    if (value == nullptr || (value->flags & HasInt) == 0)
+    {
+        return defaultValue;
+    }
+
+    return value->intValue;
+}
+
+auto PresetBundle::Record::GetFloat(PresetKeySlot slot, float defaultValue) const -> float
+{
+    const auto* value = FindValue(slot);
+    if (value == nullptr || (value->flags & HasFloat) == 0)
+    {
+        return defaultValue;
+    }
+
+    return value->floatValue;
+}
+
+auto PresetBundle::Record::GetBool(PresetKeySlot slot, bool defaultValue) const -> bool
+{
+    return GetInt(slot, static_cast<int>(defaultValue)) > 0;
+}
+
+auto PresetBundle::Record::GetString(PresetKeySlot slot, const std::string& defaultValue) const -> std::string
+{
+    const auto* value = FindValue(slot);
+    if (value == nullptr)
+    {
+        return defaultValue;
+    }
+
+    return {m_data + value->stringOffset, value->stringLength};
+}
+
+auto PresetBundle::Record::FindValue(PresetKeySlot slot) const -> const Value*
+{
+    if (slot.index >= m_valueIndex.size() || m_valueIndex[slot.index] == 0)
+    {
+        return nullptr;
+    }
+
+    return &m_values[m_valueIndex[slot.index] - 1];
+}
+
+auto PresetBundle::Writer::Add(const std::string& name, std::vector<char> presetData, int64_t modificationTime) -> bool
+{
+    if (presetData.size() > PresetFileParser::maxFileSize)
+    {
+        return false;
+    }
+
+    Entry entry;
+    entry.name = name;
+    entry.sourceHash = HashSource(presetData.data(), presetData.size());
+    entry.sourceModificationTime = modificationTime;
+    entry.sourceSize = static_cast<uint32_t>(presetData.size());
+
+    PresetFileParser parser;
+    if (!parser.Read(std::move(presetData)))
+    {
+        return false;
+    }
+
+    std::vector<Value> values;
+    std::vector<CodeBlock> codeBlocks;
+    std::vector<char> strings; //!< String data, offsets are fixed up once the header size is known.
+
+    auto appendString = [&strings](const std::string& text) {
+        auto const offset = static_cast<uint32_t>(strings.size());
+        strings.insert(strings.end(), text.begin(), text.end());
+        return offset;
+    };
+
+    // Values can't contain null characters, so this can never be returned for an existing key.
+    std::string const missingValue(1, '\0');
+
+    for (int slotIndex = 0; slotIndex < PresetKeyTable::SlotCount; ++slotIndex)
+    {
+        PresetKeySlot const slot{static_cast<uint16_t>(slotIndex)};
+
+        auto const stringValue = parser.GetString(slot, missingValue);
+        if (stringValue == missingValue)
+        {
+            continue;
+        }
+
+        Value value{};
+        value.slot = slot.index;
+        value.stringOffset = appendString(stringValue);
+        value.stringLength = static_cast<uint32_t>(stringValue.length());
+
+        // The parser returns the default value if the conversion fails, so probe with two different defaults.
+        int const intValue = parser.GetInt(slot, 0);
+        if (intValue == parser.GetInt(slot, 1))
+        {
+            value.flags |= HasInt;
+            value.intValue = intValue;
+        }
+
+        float const floatValue = parser.GetFloat(slot, 0.0f);
+        float const otherFloatValue = parser.GetFloat(slot, 1.0f);
+        if (std::memcmp(&floatValue, &otherFloatValue, sizeof(float)) == 0)
+        {
+            value.flags |= HasFloat;
+            value.floatValue = floatValue;
+        }
+
+        values.push_back(value);
+    }
+
+    for (const auto& prefix : CodePrefixes())
+    {
+        auto const code = parser.GetCode(prefix);
+        if (code.empty())
+        {
+            continue;
+        }
+
+        CodeBlock block{};
+        block.prefixOffset = appendString(prefix);
+        block.prefixLength = static_cast<uint32_t>(prefix.length());
+        block.codeOffset = appendString(code);
+        block.codeLength = static_cast<uint32_t>(code.length());
+        codeBlocks.push_back(block);
+    }
+
+    auto const stringBase = static_cast<uint32_t>(sizeof(RecordHeader) + values.size() * sizeof(Value) + codeBlocks.size() * sizeof(CodeBlock));
+
+    RecordHeader const header{static_cast<uint32_t>(values.size()), static_cast<uint32_t>(codeBlocks.size())};
+    AppendBytes(entry.record, header);
+    for (auto value : values)
+    {
+        value.stringOffset += stringBase;
+        AppendBytes(entry.record, value);
+    }
+    for (auto block : codeBlocks)
+    {
+        block.prefixOffset += stringBase;
+        block.codeOffset += stringBase;
+        AppendBytes(entry.record, block);
+    }
+    entry.record.insert(entry.record.end(), strings.begin(), strings.end());
+
+    m_entries.push_back(std::move(entry));
+
+    return true;
+}
+
+void PresetBundle::Writer::Write(const std::string& bundleFile) const
+{
+    // Directory entries are sorted by name for binary search.
+    std::vector<const Entry*> sortedEntries;
+    sortedEntries.reserve(m_entries.size());
+    for (const auto& entry : m_entries)
+    {
+        sortedEntries.push_back(&entry);
+    }
+    std::sort(sortedEntries.begin(), sortedEntries.end(), [](const Entry* lhs, const Entry* rhs) {
+        return lhs->name < rhs->name;
+    });
+
+    std::vector<char> names;
+    for (const auto* entry : sortedEntries)
+    {
+        names.insert(names.end(), entry->name.begin(), entry->name.end());
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, bundleMagic, sizeof(bundleMagic));
+    header.byteOrder = byteOrderMark;
+    header.version = FormatVersion;
+    header.slotCount = PresetKeyTable::SlotCount;
+    header.presetCount = static_cast<uint32_t>(sortedEntries.size());
+    header.directoryOffset = static_cast<uint32_t>(sizeof(FileHeader));
+
+    size_t const namesOffset = header.directoryOffset + sortedEntries.size() * sizeof(DirectoryEntry);
+    size_t recordOffset = (namesOffset + names.size() + recordAlignment - 1) / recordAlignment * recordAlignment;
+
+    std::vector<char> bundleData;
+    AppendBytes(bundleData, header);
+
+    size_t nameOffset = namesOffset;
+    for (const auto* entry : sortedEntries)
+    {
+        DirectoryEntry directoryEntry{};
+        directoryEntry.sourceHash = entry->sourceHash;
+        directoryEntry.sourceModificationTime = entry->sourceModificationTime;
+        directoryEntry.sourceSize = entry->sourceSize;
+        directoryEntry.nameOffset = static_cast<uint32_t>(nameOffset);
+        directoryEntry.nameLength = static_cast<uint32_t>(entry->name.length());
+        directoryEntry.recordOffset = static_cast<uint32_t>(recordOffset);
+        directoryEntry.recordSize = static_cast<uint32_t>(entry->record.size());
+        AppendBytes(bundleData, directoryEntry);
+
+        nameOffset += entry->name.length();
+        recordOffset = (recordOffset + entry->record.size() + recordAlignment - 1) / recordAlignment * recordAlignment;
+    }
+
+    bundleData.insert(bundleData.end(), names.begin(), names.end());
+
+    for (const auto* entry : sortedEntries)
+    {
+        AlignBuffer(bundleData, recordAlignment);
+        bundleData.insert(bundleData.end(), entry->record.begin(), entry->record.end());
+    }
+
+    if (bundleData.size() > std::numeric_limits<uint32_t>::max())
+    {
+        throw PresetBundleException("[PresetBundle] Bundle \"" + bundleFile + "\" exceeds the maximum bundle size.");
+    }
+
+    std::ofstream bundleStream(bundleFile, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+    if (!bundleStream.write(bundleData.data(), static_cast<std::streamsize>(bundleData.size())))
+    {
+        throw PresetBundleException("[PresetBundle] Could not write bundle file \"" + bundleFile + "\".");
+    }
+}
+
+auto PresetBundle::Writer::Count() const -> size_t
+{
+    return m_entries.size();
+}
+
+} // namespace MilkdropPreset
+} // namespace libprojectM
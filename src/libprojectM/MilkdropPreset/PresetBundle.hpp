@@ -0,0 +1,210 @@
+/**
+ * @file PresetBundle.hpp
+ * @brief Reads and writes precompiled Milkdrop preset bundles (.milkc files).
+ *
+ * A bundle is created offline from a directory of .milk files. Each preset record contains the already
+ * converted values of all known preset keys and the concatenated code blocks, so a preset can be
+ * initialized without any text parsing. Records are keyed by the preset path relative to the directory
+ * containing the bundle file and store the size, modification time and a hash of the source file, so
+ * presets modified after compiling the bundle can be detected and loaded from source instead.
+ */
+#pragma once
+
+#include "PresetDataSource.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace libprojectM {
+namespace MilkdropPreset {
+
+class MappedFile;
+
+/**
+ * @brief A memory-mapped, read-only bundle of precompiled Milkdrop presets.
+ *
+ * The bundle file stays mapped for the lifetime of this object. Records returned by Preset() read
+ * directly from the mapping, so the bundle must outlive them.
+ */
+class PresetBundle
+{
+    struct Value;
+    struct CodeBlock;
+
+public:
+    static constexpr uint32_t FormatVersion = 2; //!< Bundle format version. Bump on any layout or key table change.
+
+    /**
+     * @brief A single precompiled preset, read in place from the bundle file.
+     */
+    class Record : public PresetDataSource
+    {
+    public:
+        /**
+         * @brief Creates a record view on the given bundle data.
+         * @param data Pointer to the first byte of the record.
+         * @param size Size of the record in bytes.
+         * @throws PresetBundleException If the record data is malformed.
+         */
+        Record(const char* data, size_t size);
+
+        auto GetCode(const std::string& keyPrefix) const -> std::string override;
+
+        auto GetInt(PresetKeySlot slot, int defaultValue) const -> int override;
+
+        auto GetFloat(PresetKeySlot slot, float defaultValue) const -> float override;
+
+        auto GetBool(PresetKeySlot slot, bool defaultValue) const -> bool override;
+
+        auto GetString(PresetKeySlot slot, const std::string& defaultValue) const -> std::string override;
+
+    private:
+        /**
+         * @brief Returns the stored value for the given slot.
+         * @param slot The key slot.
+         * @return A pointer to the value or nullptr if the key wasn't present in the source file.
+         */
+        auto FindValue(PresetKeySlot slot) const -> const Value*;
+
+        const char* m_data{nullptr};                                    //!< The record data in the bundle file.
+        size_t m_size{};                                                //!< Size of the record data.
+        const Value* m_values{nullptr};                                 //!< All stored key values.
+        const CodeBlock* m_codeBlocks{nullptr};                         //!< All stored code blocks.
+        uint32_t m_codeBlockCount{};                                    //!< Number of code blocks.
+        std::array<uint16_t, PresetKeyTable::SlotCount> m_valueIndex{}; //!< Index + 1 into m_values for each slot, 0 if not present.
+    };
+
+    /**
+     * @brief Collects presets and writes them into a bundle file.
+     */
+    class Writer
+    {
+    public:
+        /**
+         * @brief Parses the given preset file contents and adds the preset to the bundle.
+         * @param name The preset path relative to the directory the bundle file will be written to.
+         * @param presetData The raw preset file contents.
+         * @param modificationTime The source file modification time, see ModificationTime().
+         * @return True if the preset was added, false if the data could not be parsed.
+         */
+        auto Add(const std::string& name, std::vector<char> presetData, int64_t modificationTime = 0) -> bool;
+
+        /**
+         * @brief Writes all added presets into a bundle file.
+         * @param bundleFile The bundle file to write. Will be overwritten if it exists.
+         * @throws PresetBundleException If the file could not be written.
+         */
+        void Write(const std::string& bundleFile) const;
+
+        /**
+         * @brief Returns the number of presets added to the bundle so far.
+         * @return The number of presets.
+         */
+        auto Count() const -> size_t;
+
+    private:
+        /**
+         * @brief A compiled, not yet written preset.
+         */
+        struct Entry {
+            std::string name;         //!< The relative preset path, with forward slashes.
+            uint64_t sourceHash{};             //!< Hash of the source file contents.
+            int64_t sourceModificationTime{}; //!< Modification time of the source file.
+            uint32_t sourceSize{};             //!< Size of the source file in bytes.
+            std::vector<char> record;          //!< The serialized record.
+        };
+
+        std::vector<Entry> m_entries; //!< All added presets.
+    };
+
+    /**
+     * @brief Opens and maps the given bundle file.
+     * @param bundleFile The bundle file to open.
+     * @throws PresetBundleException If the file can't be opened or is not a valid bundle.
+     */
+    explicit PresetBundle(const std::string& bundleFile);
+
+    ~PresetBundle();
+
+    PresetBundle(const PresetBundle&) = delete;
+    auto operator=(const PresetBundle&) -> PresetBundle& = delete;
+
+    /**
+     * @brief Returns the number of presets in the bundle.
+     * @return The number of presets.
+     */
+    auto Count() const -> size_t;
+
+    /**
+     * @brief Searches the bundle for the given preset file.
+     * @param presetFile The preset file path, either absolute or relative to the current working directory.
+     * @return The preset index, or -1 if the bundle doesn't contain the preset.
+     */
+    auto Find(const std::string& presetFile) const -> int;
+
+    /**
+     * @brief Returns the preset path relative to the bundle directory.
+     * @param index The preset index.
+     * @return The relative path with forward slashes.
+     */
+    auto Name(int index) const -> std::string;
+
+    /**
+     * @brief Returns the hash of the source file the preset was compiled from.
+     * @param index The preset index.
+     * @return The source hash, see HashSource().
+     */
+    auto SourceHash(int index) const -> uint64_t;
+
+    /**
+     * @brief Returns the size of the source file the preset was compiled from.
+     * @param index The preset index.
+     * @return The source file size in bytes.
+     */
+    auto SourceSize(int index) const -> uint32_t;
+
+    /**
+     * @brief Returns the modification time of the source file the preset was compiled from.
+     * @param index The preset index.
+     * @return The source file modification time, see ModificationTime().
+     */
+    auto SourceModificationTime(int index) const -> int64_t;
+
+    /**
+     * @brief Returns a view on the precompiled preset data.
+     * @param index The preset index.
+     * @return The preset record. Only valid as long as the bundle exists.
+     * @throws PresetBundleException If the record data is malformed.
+     */
+    auto Preset(int index) const -> Record;
+
+    /**
+     * @brief Calculates the hash used to detect changes in preset source files.
+     * @param data The file contents.
+     * @param size The file size in bytes.
+     * @return The 64-bit FNV-1a hash of the data.
+     */
+    static auto HashSource(const char* data, size_t size) -> uint64_t;
+
+    /**
+     * @brief Returns the modification time of a file, as stored in the bundle.
+     * @param file The file path.
+     * @return The modification time in file system clock ticks, or -1 if the file doesn't exist.
+     */
+    static auto ModificationTime(const std::string& file) -> int64_t;
+
+private:
+    struct DirectoryEntry;
+
+    std::unique_ptr<MappedFile> m_file;                //!< The mapped bundle file.
+    std::string m_directory;                           //!< Absolute, normalized path of the directory containing the bundle.
+    const DirectoryEntry* m_directoryEntries{nullptr}; //!< Directory entries, sorted by name.
+    uint32_t m_presetCount{};                          //!< Number of presets in the bundle.
+};
+
+} // namespace MilkdropPreset
+} // namespace libprojectM
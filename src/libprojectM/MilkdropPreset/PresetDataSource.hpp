@@ -0,0 +1,62 @@
+#pragma once
+
+#include "PresetKeys.hpp"
+
+#include <string>
+
+namespace libprojectM {
+namespace MilkdropPreset {
+
+/**
+ * @brief Read-only access to the values and code blocks of a single preset.
+ *
+ * Implemented by the text file parser and by precompiled preset bundle records, so presets can be
+ * initialized from either source without knowing where the data came from.
+ */
+class PresetDataSource
+{
+public:
+    virtual ~PresetDataSource() = default;
+
+    /**
+     * @brief Returns a block of code, ready for parsing or use in shader compilation.
+     * @param keyPrefix The key prefix for the code block to be returned, e.g. "per_frame_".
+     * @return The code that was parsed from the given prefix. Empty if no code was found.
+     */
+    virtual auto GetCode(const std::string& keyPrefix) const -> std::string = 0;
+
+    /**
+     * @brief Returns the value of a known preset key as an integer.
+     * @param slot The key slot, see PresetKeyTable::Slot().
+     * @param defaultValue The default value to return if key is not found or can't be converted.
+     * @return The converted value or the default value.
+     */
+    virtual auto GetInt(PresetKeySlot slot, int defaultValue) const -> int = 0;
+
+    /**
+     * @brief Returns the value of a known preset key as a floating-point value.
+     * @param slot The key slot, see PresetKeyTable::Slot().
+     * @param defaultValue The default value to return if key is not found or can't be converted.
+     * @return The converted value or the default value.
+     */
+    virtual auto GetFloat(PresetKeySlot slot, float defaultValue) const -> float = 0;
+
+    /**
+     * @brief Returns the value of a known preset key as a boolean.
+     * @param slot The key slot, see PresetKeyTable::Slot().
+     * @param defaultValue The default value to return if key is not found or can't be converted.
+     * @return True if the value is non-zero, false otherwise.
+     */
+    virtual auto GetBool(PresetKeySlot slot, bool defaultValue) const -> bool = 0;
+
+    /**
+     * @brief Returns the value of a known preset key as a string.
+     * @param slot The key slot, see PresetKeyTable::Slot().
+     * @param defaultValue The default value to return if key is not found.
+     * @return the string content of the key, or the default value.
+     */
+    virtual auto GetString(PresetKeySlot slot, const std::string& defaultValue) const -> std::string = 0;
+};
+
+} // namespace MilkdropPreset
+} // namespace libprojectM
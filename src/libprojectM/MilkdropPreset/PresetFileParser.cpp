@@ -1,13 +1,70 @@
 #include "PresetFileParser.hpp"
 
 #include <algorithm>
+#include <cerrno>
+#include <cstdlib>
 #include <fstream>
-#include <sstream>
-#include <vector>
+#include <limits>
 
 namespace libprojectM {
 namespace MilkdropPreset {
 
+namespace {
+
+/**
+ * Milkdrop supports up to 99999 lines per code block.
+ */
+constexpr size_t maxCodeLineDigits = 5;
+
+inline auto ToLowerAscii(char c) -> char
+{
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+inline auto IsDigit(char c) -> bool
+{
+    return c >= '0' && c <= '9';
+}
+
+/**
+ * @brief FNV-1a hash over the lower-case representation of the given string.
+ */
+inline auto HashKey(const char* key, size_t length) -> uint32_t
+{
+    uint32_t hash = 2166136261u;
+    for (size_t index = 0; index < length; ++index)
+    {
+        hash ^= static_cast<unsigned char>(ToLowerAscii(key[index]));
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Compares a lower-case key with an arbitrary-case key.
+ */
+inline auto KeyEquals(const char* lowerKey, size_t lowerKeyLength, const char* key, size_t keyLength) -> bool
+{
+    if (lowerKeyLength != keyLength)
+    {
+        return false;
+    }
+
+    for (size_t index = 0; index < keyLength; ++index)
+    {
+        if (lowerKey[index] != ToLowerAscii(key[index]))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
+constexpr uint32_t PresetFileParser::emptySlot;
+
 auto PresetFileParser::Read(const std::string& presetFile) -> bool
 {
     std::ifstream presetStream(presetFile.c_str(), std::ios_base::in | std::ios_base::binary);
@@ -25,12 +82,15 @@ auto PresetFileParser::Read(std::istream& presetStream) -> bool
     auto fileSize = presetStream.tellg();
     presetStream.seekg(0, presetStream.beg);
 
-    if (static_cast<size_t>(fileSize) > maxFileSize)
+    if (fileSize < 0 || static_cast<size_t>(fileSize) > maxFileSize)
     {
         return false;
     }
 
-    std::vector<char> presetFileContents(fileSize);
+    // Reserve one additional byte for the terminator of the last line.
+    std::vector<char> presetFileContents;
+    presetFileContents.reserve(static_cast<size_t>(fileSize) + 1);
+    presetFileContents.resize(static_cast<size_t>(fileSize));
     presetStream.read(presetFileContents.data(), fileSize);
 
     if (presetStream.fail() || presetStream.bad())
@@ -38,26 +98,48 @@ auto PresetFileParser::Read(std::istream& presetStream) -> bool
         return false;
     }
 
+    return Read(std::move(presetFileContents));
+}
+
+auto PresetFileParser::Read(std::vector<char>&& presetData) -> bool
+{
+    m_fileData = std::move(presetData);
+    m_entries.clear();
+    m_entryTable.clear();
+    m_codeBlocks.clear();
+    m_codeBlockTable.clear();
+    m_knownKeys.fill(0);
+    m_unknownKeys.clear();
+    m_presetValues.clear();
+    m_presetValuesValid = false;
+
+    if (m_fileData.size() > maxFileSize)
+    {
+        return false;
+    }
+
+    size_t const fileSize = m_fileData.size();
+
+    // Terminate the last line, so each value can be converted in place.
+    m_fileData.push_back('\0');
+
+    // Rough estimate of the number of lines in a typical preset, avoids rehashing most of the time.
+    m_entries.reserve(fileSize / 24 + 1);
+
     size_t startPos{0}; //!< Starting position of current line
     size_t pos{0};      //!< Current read position
 
-    auto parseLineIfDataAvailable = [this, &pos, &startPos, &presetFileContents]() {
-        if (pos > startPos)
-        {
-            auto beg = presetFileContents.begin();
-            std::string line(beg + startPos, beg + pos);
-            ParseLine(line);
-        }
-    };
-
-    while (pos < presetFileContents.size())
+    while (pos < fileSize)
     {
-        switch (presetFileContents[pos])
+        switch (m_fileData[pos])
         {
             case '\r':
             case '\n':
                 // EOL, skip over CRLF
-                parseLineIfDataAvailable();
+                if (pos > startPos)
+                {
+                    ParseLine(startPos, pos);
+                }
                 startPos = pos + 1;
                 break;
 
@@ -69,127 +151,408 @@ auto PresetFileParser::Read(std::istream& presetStream) -> bool
         ++pos;
     }
 
-    parseLineIfDataAvailable();
+    if (pos > startPos)
+    {
+        ParseLine(startPos, pos);
+    }
+
+    // Sort code lines once, so GetCode() can simply walk the list.
+    for (auto& block : m_codeBlocks)
+    {
+        std::sort(block.lines.begin(), block.lines.end(), [](const CodeLine& lhs, const CodeLine& rhs) {
+            return lhs.index < rhs.index;
+        });
+    }
 
-    return !m_presetValues.empty();
+    return !m_entries.empty();
 }
 
 auto PresetFileParser::GetCode(const std::string& keyPrefix) const -> std::string
 {
-    auto lowerKey = ToLower(keyPrefix);
+    std::string code; //!< The parsed code
 
-    std::stringstream code;                        //!< The parsed code
-    std::string key(lowerKey.length() + 5, '\0'); //!< Allocate a string that can hold up to 5 digits.
+    auto appendLine = [this, &code](Span value) {
+        const char* line = Data(value);
+        size_t length = value.length;
 
-    key.replace(0, lowerKey.length(), lowerKey);
-
-    for (int index{1}; index <= 99999; ++index)
-    {
-        key.replace(lowerKey.length(), 5, std::to_string(index));
-        if (m_presetValues.find(key) == m_presetValues.end())
+        // Remove backtick char in shader code
+        if (length > 0 && line[0] == '`')
         {
-            break;
+            ++line;
+            --length;
         }
 
-        auto line = m_presetValues.at(key);
+        code.append(line, length);
+        code.push_back('\n');
+    };
 
-        // Remove backtick char in shader code
-        if (!line.empty() && line.at(0) == '`')
+    // Line numbers are parsed greedily, so prefixes ending in a digit are ambiguous and need to be probed line by line.
+    if (!keyPrefix.empty() && IsDigit(keyPrefix.back()))
+    {
+        std::string key(keyPrefix);
+        for (int index{1}; index <= 99999; ++index)
         {
-            line.erase(0, 1);
+            key.replace(keyPrefix.length(), std::string::npos, std::to_string(index));
+            const auto* entry = FindEntry(key);
+            if (entry == nullptr)
+            {
+                break;
+            }
+            appendLine(entry->value);
         }
-        code << line << std::endl;
+
+        return code;
     }
 
-    auto codeStr = code.str();
+    auto blockIndex = FindKey(m_codeBlockTable, keyPrefix.data(), keyPrefix.length(), [this](uint32_t item) {
+        return m_codeBlocks[item].prefix;
+    });
 
-    return codeStr;
-}
+    if (blockIndex == emptySlot)
+    {
+        return code;
+    }
 
-auto PresetFileParser::GetInt(const std::string& key, int defaultValue) -> int
-{
-    auto lowerKey = ToLower(key);
-    if (m_presetValues.find(lowerKey) != m_presetValues.end())
+    const auto& lines = m_codeBlocks[blockIndex].lines;
+
+    size_t totalLength{0};
+    for (const auto& line : lines)
     {
-        try
-        {
-            return std::stoi(m_presetValues.at(lowerKey));
-        }
-        catch (std::logic_error&)
+        totalLength += line.value.length + 1;
+    }
+    code.reserve(totalLength);
+
+    // Stop at the first gap in the line numbers, like Milkdrop does.
+    uint32_t expectedIndex{1};
+    for (const auto& line : lines)
+    {
+        if (line.index != expectedIndex)
         {
+            break;
         }
+        appendLine(line.value);
+        ++expectedIndex;
     }
 
-    return defaultValue;
+    return code;
+}
+
+auto PresetFileParser::GetInt(const std::string& key, int defaultValue) -> int
+{
+    return ToInt(FindEntry(key), defaultValue);
 }
 
 auto PresetFileParser::GetFloat(const std::string& key, float defaultValue) -> float
 {
-    auto lowerKey = ToLower(key);
-    if (m_presetValues.find(lowerKey) != m_presetValues.end())
+    return ToFloat(FindEntry(key), defaultValue);
+}
+
+auto PresetFileParser::GetBool(const std::string& key, bool defaultValue) -> bool
+{
+    return GetInt(key, static_cast<int>(defaultValue)) > 0;
+}
+
+auto PresetFileParser::GetString(const std::string& key, const std::string& defaultValue) -> std::string
+{
+    const auto* entry = FindEntry(key);
+    if (entry != nullptr)
     {
-        try
-        {
-            return std::stof(m_presetValues.at(lowerKey));
-        }
-        catch (std::logic_error&)
-        {
-        }
+        return {Data(entry->value), entry->value.length};
     }
 
     return defaultValue;
 }
 
-auto PresetFileParser::GetBool(const std::string& key, bool defaultValue) -> bool
+auto PresetFileParser::GetInt(PresetKeySlot slot, int defaultValue) const -> int
 {
-    return GetInt(key, static_cast<int>(defaultValue)) > 0;
+    return ToInt(FindEntry(slot), defaultValue);
 }
 
-auto PresetFileParser::GetString(const std::string& key, const std::string& defaultValue) -> std::string
+auto PresetFileParser::GetFloat(PresetKeySlot slot, float defaultValue) const -> float
+{
+    return ToFloat(FindEntry(slot), defaultValue);
+}
+
+auto PresetFileParser::GetBool(PresetKeySlot slot, bool defaultValue) const -> bool
 {
-    auto lowerKey = ToLower(key);
-    if (m_presetValues.find(lowerKey) != m_presetValues.end())
+    return GetInt(slot, static_cast<int>(defaultValue)) > 0;
+}
+
+auto PresetFileParser::GetString(PresetKeySlot slot, const std::string& defaultValue) const -> std::string
+{
+    const auto* entry = FindEntry(slot);
+    if (entry != nullptr)
     {
-        return m_presetValues.at(lowerKey);
+        return {Data(entry->value), entry->value.length};
     }
 
     return defaultValue;
 }
 
-const std::map<std::string, std::string>& PresetFileParser::PresetValues() const
+auto PresetFileParser::UnknownKeys() const -> std::vector<std::string>
 {
+    std::vector<std::string> keys;
+    keys.reserve(m_unknownKeys.size());
+    for (auto entryIndex : m_unknownKeys)
+    {
+        const auto& key = m_entries[entryIndex].key;
+        keys.emplace_back(Data(key), key.length);
+    }
+
+    return keys;
+}
+
+auto PresetFileParser::PresetValues() const -> const ValueMap&
+{
+    if (!m_presetValuesValid)
+    {
+        m_presetValues.clear();
+        for (const auto& entry : m_entries)
+        {
+            m_presetValues.emplace(std::string(Data(entry.key), entry.key.length),
+                                   std::string(Data(entry.value), entry.value.length));
+        }
+        m_presetValuesValid = true;
+    }
+
     return m_presetValues;
 }
 
-void PresetFileParser::ParseLine(const std::string& line)
+void PresetFileParser::ParseLine(size_t lineStart, size_t lineEnd)
 {
     // Search for first delimiter, either space or equal
-    auto varNameDelimiterPos = line.find_first_of(" =");
+    size_t varNameDelimiterPos = lineStart;
+    while (varNameDelimiterPos < lineEnd &&
+           m_fileData[varNameDelimiterPos] != ' ' &&
+           m_fileData[varNameDelimiterPos] != '=')
+    {
+        ++varNameDelimiterPos;
+    }
 
-    if (varNameDelimiterPos == std::string::npos || varNameDelimiterPos == 0)
+    if (varNameDelimiterPos == lineEnd || varNameDelimiterPos == lineStart)
     {
         // Empty line, delimiter at start of line or no delimiter found, skip.
         return;
     }
 
     // Convert key to lower case, as INI functions are not case-sensitive.
-    std::string varName(ToLower(std::string(line.begin(), line.begin() + varNameDelimiterPos)));
-    std::string value(line.begin() + varNameDelimiterPos + 1, line.end());
+    for (size_t pos = lineStart; pos < varNameDelimiterPos; ++pos)
+    {
+        m_fileData[pos] = ToLowerAscii(m_fileData[pos]);
+    }
+
+    // Terminate the value, overwriting the line break.
+    m_fileData[lineEnd] = '\0';
+
+    Span const key{static_cast<uint32_t>(lineStart), static_cast<uint32_t>(varNameDelimiterPos - lineStart)};
+    Span const value{static_cast<uint32_t>(varNameDelimiterPos + 1), static_cast<uint32_t>(lineEnd - varNameDelimiterPos - 1)};
 
     // Only add first occurrence to mimic Milkdrop behaviour
-    if (!varName.empty() && m_presetValues.find(varName) == m_presetValues.end())
+    auto entryKey = [this](uint32_t item) {
+        return m_entries[item].key;
+    };
+
+    GrowTable(m_entryTable, static_cast<uint32_t>(m_entries.size()), entryKey);
+    auto inserted = InsertKey(m_entryTable, static_cast<uint32_t>(m_entries.size()), key, entryKey);
+    if (!inserted.second)
+    {
+        return;
+    }
+
+    m_entries.push_back({key, value});
+
+    int const slot = PresetKeyTable::Find(Data(key), key.length);
+    if (slot >= 0)
+    {
+        m_knownKeys[slot] = inserted.first + 1;
+        return;
+    }
+
+    if (!AddCodeLine(key, value))
+    {
+        m_unknownKeys.push_back(inserted.first);
+    }
+}
+
+auto PresetFileParser::AddCodeLine(Span key, Span value) -> bool
+{
+    const char* keyData = Data(key);
+
+    size_t digitCount{0};
+    while (digitCount < key.length && IsDigit(keyData[key.length - digitCount - 1]))
+    {
+        ++digitCount;
+    }
+
+    // Needs a non-empty prefix and a line number without leading zeros.
+    if (digitCount == 0 || digitCount == key.length || digitCount > maxCodeLineDigits ||
+        keyData[key.length - digitCount] == '0')
+    {
+        return false;
+    }
+
+    uint32_t lineIndex{0};
+    for (size_t pos = key.length - digitCount; pos < key.length; ++pos)
+    {
+        lineIndex = lineIndex * 10 + static_cast<uint32_t>(keyData[pos] - '0');
+    }
+
+    Span const prefix{key.offset, static_cast<uint32_t>(key.length - digitCount)};
+
+    auto blockKey = [this](uint32_t item) {
+        return m_codeBlocks[item].prefix;
+    };
+
+    GrowTable(m_codeBlockTable, static_cast<uint32_t>(m_codeBlocks.size()), blockKey);
+    auto block = InsertKey(m_codeBlockTable, static_cast<uint32_t>(m_codeBlocks.size()), prefix, blockKey);
+    if (block.second)
+    {
+        m_codeBlocks.push_back({prefix, {}});
+    }
+
+    m_codeBlocks[block.first].lines.push_back({lineIndex, value});
+
+    return true;
+}
+
+auto PresetFileParser::FindEntry(const std::string& key) const -> const Entry*
+{
+    auto entryIndex = FindKey(m_entryTable, key.data(), key.length(), [this](uint32_t item) {
+        return m_entries[item].key;
+    });
+
+    if (entryIndex == emptySlot)
+    {
+        return nullptr;
+    }
+
+    return &m_entries[entryIndex];
+}
+
+auto PresetFileParser::FindEntry(PresetKeySlot slot) const -> const Entry*
+{
+    if (slot.index >= m_knownKeys.size() || m_knownKeys[slot.index] == 0)
+    {
+        return nullptr;
+    }
+
+    return &m_entries[m_knownKeys[slot.index] - 1];
+}
+
+auto PresetFileParser::ToInt(const Entry* entry, int defaultValue) const -> int
+{
+    if (entry == nullptr)
+    {
+        return defaultValue;
+    }
+
+    const char* valueStart = Data(entry->value);
+    char* valueEnd{nullptr};
+    errno = 0;
+    long const value = std::strtol(valueStart, &valueEnd, 10);
+
+    if (valueEnd == valueStart || errno == ERANGE ||
+        value < std::numeric_limits<int>::min() || value > std::numeric_limits<int>::max())
+    {
+        return defaultValue;
+    }
+
+    return static_cast<int>(value);
+}
+
+auto PresetFileParser::ToFloat(const Entry* entry, float defaultValue) const -> float
+{
+    if (entry == nullptr)
+    {
+        return defaultValue;
+    }
+
+    const char* valueStart = Data(entry->value);
+    char* valueEnd{nullptr};
+    errno = 0;
+    float const value = std::strtof(valueStart, &valueEnd);
+
+    if (valueEnd == valueStart || errno == ERANGE)
+    {
+        return defaultValue;
+    }
+
+    return value;
+}
+
+template<typename KeyAccessor>
+auto PresetFileParser::InsertKey(std::vector<uint32_t>& table, uint32_t itemCount, Span key, KeyAccessor keyOf) -> std::pair<uint32_t, bool>
+{
+    const char* keyData = Data(key);
+    size_t const mask = table.size() - 1;
+    size_t slot = HashKey(keyData, key.length) & mask;
+
+    while (table[slot] != emptySlot)
     {
-        m_presetValues.emplace(std::move(varName), std::move(value));
+        Span const storedKey = keyOf(table[slot]);
+        if (KeyEquals(Data(storedKey), storedKey.length, keyData, key.length))
+        {
+            return {table[slot], false};
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    table[slot] = itemCount;
+    return {itemCount, true};
+}
+
+template<typename KeyAccessor>
+auto PresetFileParser::FindKey(const std::vector<uint32_t>& table, const char* key, size_t keyLength, KeyAccessor keyOf) const -> uint32_t
+{
+    if (table.empty())
+    {
+        return emptySlot;
+    }
+
+    size_t const mask = table.size() - 1;
+    size_t slot = HashKey(key, keyLength) & mask;
+
+    while (table[slot] != emptySlot)
+    {
+        Span const storedKey = keyOf(table[slot]);
+        if (KeyEquals(Data(storedKey), storedKey.length, key, keyLength))
+        {
+            return table[slot];
+        }
+        slot = (slot + 1) & mask;
     }
+
+    return emptySlot;
 }
 
-auto PresetFileParser::ToLower(std::string str) -> std::string
+template<typename KeyAccessor>
+void PresetFileParser::GrowTable(std::vector<uint32_t>& table, uint32_t itemCount, KeyAccessor keyOf)
 {
-    std::transform(str.begin(), str.end(), str.begin(),
-                   [](unsigned char c){ return std::tolower(c); }
-    );
+    // Keep the load factor at or below 50% to keep probe sequences short.
+    if (!table.empty() && (itemCount + 1) * 2 <= table.size())
+    {
+        return;
+    }
 
-    return str;
+    size_t newSize = table.empty() ? 64 : table.size() * 2;
+    while ((itemCount + 1) * 2 > newSize)
+    {
+        newSize *= 2;
+    }
+
+    table.assign(newSize, emptySlot);
+
+    size_t const mask = newSize - 1;
+    for (uint32_t item = 0; item < itemCount; ++item)
+    {
+        Span const key = keyOf(item);
+        size_t slot = HashKey(Data(key), key.length) & mask;
+        while (table[slot] != emptySlot)
+        {
+            slot = (slot + 1) & mask;
+        }
+        table[slot] = item;
+    }
 }
 
 } // namespace MilkdropPreset
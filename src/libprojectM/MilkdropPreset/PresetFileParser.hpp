@@ -1,7 +1,14 @@
 #pragma once
 
+#include "PresetDataSource.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace libprojectM {
 namespace MilkdropPreset {
@@ -12,10 +19,15 @@ namespace MilkdropPreset {
  * Reads in the file as key/value pairs, where the key is either separated from the value by an equal sign or a space.
  * Lines not matching this pattern are simply ignored, e.g. the [preset00] INI section.
  *
+ * The parser takes ownership of the file contents and doesn't copy any keys or values. Keys are lower-cased in place
+ * and indexed in a flat, open-addressing hash table which stores offsets into the owned buffer. Numbered code lines
+ * (e.g. per_frame_1, per_frame_2, ...) are grouped by their prefix in the same pass, so retrieving a code block is a
+ * single table lookup followed by concatenating an already sorted list of lines.
+ *
  * Values and code blocks can easily be accessed via the helper functions. It is also possible to access the parsed
  * map contents directly if required.
  */
-class PresetFileParser
+class PresetFileParser : public PresetDataSource
 {
 public:
     using ValueMap = std::map<std::string, std::string>; //!< A map with key/value pairs, each representing one line in the preset file.
@@ -34,6 +46,17 @@ public:
      */
     [[nodiscard]] auto Read(std::istream& presetStream) -> bool;
 
+    /**
+     * @brief Parses the given buffer, taking ownership of the data.
+     *
+     * This is the fastest way of reading a preset if the data is already in memory, as no additional copy
+     * of the file contents is made. The buffer is modified in place while parsing.
+     *
+     * @param presetData The raw preset file contents.
+     * @return True if the data was parsed successfully, false if an error occurred or no line could be parsed.
+     */
+    [[nodiscard]] auto Read(std::vector<char>&& presetData) -> bool;
+
     /**
      * @brief Returns a block of code, ready for parsing or use in shader compilation.
      *
@@ -48,7 +71,7 @@ public:
      * @param keyPrefix The key prefix for the code block to be returned.
      * @return The code that was parsed from the given prefix. Empty if no code was found.
      */
-    [[nodiscard]] auto GetCode(const std::string& keyPrefix) const -> std::string;
+    [[nodiscard]] auto GetCode(const std::string& keyPrefix) const -> std::string override;
 
     /**
      * @brief Returns the given key value as an integer.
@@ -100,33 +123,199 @@ public:
      */
     [[nodiscard]] auto GetString(const std::string& key, const std::string& defaultValue) -> std::string;
 
+    /**
+     * @brief Returns the value of a known preset key as an integer.
+     *
+     * Known keys are resolved to their slot while reading the file, so this is a simple array lookup.
+     *
+     * @param slot The key slot, see PresetKeyTable::Slot().
+     * @param defaultValue The default value to return if key is not found.
+     * @return The converted value or the default value.
+     */
+    [[nodiscard]] auto GetInt(PresetKeySlot slot, int defaultValue) const -> int override;
+
+    /**
+     * @brief Returns the value of a known preset key as a floating-point value.
+     * @param slot The key slot, see PresetKeyTable::Slot().
+     * @param defaultValue The default value to return if key is not found.
+     * @return The converted value or the default value.
+     */
+    [[nodiscard]] auto GetFloat(PresetKeySlot slot, float defaultValue) const -> float override;
+
+    /**
+     * @brief Returns the value of a known preset key as a boolean.
+     * @param slot The key slot, see PresetKeyTable::Slot().
+     * @param defaultValue The default value to return if key is not found.
+     * @return True if the value is non-zero, false otherwise.
+     */
+    [[nodiscard]] auto GetBool(PresetKeySlot slot, bool defaultValue) const -> bool override;
+
+    /**
+     * @brief Returns the value of a known preset key as a string.
+     * @param slot The key slot, see PresetKeyTable::Slot().
+     * @param defaultValue The default value to return if key is not found.
+     * @return the string content of the key, or the default value.
+     */
+    [[nodiscard]] auto GetString(PresetKeySlot slot, const std::string& defaultValue) const -> std::string override;
+
+    /**
+     * @brief Returns all keys which are neither known preset keys nor numbered code lines.
+     *
+     * Useful for diagnosing typos or unsupported keys in preset files.
+     *
+     * @return A list of unknown keys in file order, lower-case.
+     */
+    auto UnknownKeys() const -> std::vector<std::string>;
+
     /**
      * @brief Returns a reference to the internal value map.
+     *
+     * The map is only built on the first call, as the parser itself doesn't need it. Use the typed
+     * accessors above for fast lookups.
+     *
      * @return A reference to the internal value map.
      */
     auto PresetValues() const -> const ValueMap&;
 
 protected:
     /**
-     * @brief Parses a single line and stores the result in the value map.
+     * @brief Parses a single line and stores the result in the key index.
      *
      * The function doesn't really care about invalid lines with random text or comments. The first "word"
-     * is added as key to the map, but will not be used afterwards.
+     * is added as key to the index, but will not be used afterwards.
      *
-     * @param line The line to parse.
+     * @param lineStart The offset of the first character of the line in the file buffer.
+     * @param lineEnd The offset of the line terminator in the file buffer.
      */
-    void ParseLine(const std::string& line);
+    void ParseLine(size_t lineStart, size_t lineEnd);
 
 private:
     /**
-     * @brief Converts the string to lower-case.
-     * Only letters A-Z are converted to a-z by default.
-     * @param str The original string.
-     * @return The lower-case string.
+     * @brief A reference to a string stored in the file buffer.
      */
-    static auto ToLower(std::string str) -> std::string;
+    struct Span {
+        uint32_t offset{}; //!< Offset of the first character in the file buffer.
+        uint32_t length{}; //!< Length of the string in characters.
+    };
+
+    /**
+     * @brief A single parsed key/value pair.
+     */
+    struct Entry {
+        Span key;   //!< The lower-case key.
+        Span value; //!< The value, null-terminated in the file buffer.
+    };
+
+    /**
+     * @brief A single numbered code line.
+     */
+    struct CodeLine {
+        uint32_t index{}; //!< The line number parsed from the key.
+        Span value;       //!< The line contents.
+    };
+
+    /**
+     * @brief All code lines sharing the same key prefix.
+     */
+    struct CodeBlock {
+        Span prefix;                 //!< The lower-case key prefix.
+        std::vector<CodeLine> lines; //!< The lines in this block, sorted by line number after parsing.
+    };
+
+    static constexpr uint32_t emptySlot = 0xFFFFFFFF; //!< Marks an unused hash table slot.
+
+    /**
+     * @brief Inserts a key into the given hash table if not already present.
+     * @param table The open-addressing table, storing indices into the item vector.
+     * @param itemCount The number of items already stored, used as the index of a new item.
+     * @param key The lower-case key to insert.
+     * @param keyOf Returns the key span for a stored item index.
+     * @return The item index stored for this key and whether the key was newly inserted.
+     */
+    template<typename KeyAccessor>
+    auto InsertKey(std::vector<uint32_t>& table, uint32_t itemCount, Span key, KeyAccessor keyOf) -> std::pair<uint32_t, bool>;
+
+    /**
+     * @brief Looks up a key case-insensitively in the given hash table.
+     * @param table The open-addressing table, storing indices into the item vector.
+     * @param key The key to search for. Doesn't need to be lower-case.
+     * @param keyLength The key length in characters.
+     * @param keyOf Returns the key span for a stored item index.
+     * @return The item index or emptySlot if the key was not found.
+     */
+    template<typename KeyAccessor>
+    auto FindKey(const std::vector<uint32_t>& table, const char* key, size_t keyLength, KeyAccessor keyOf) const -> uint32_t;
+
+    /**
+     * @brief Returns the parsed entry for the given key.
+     * @param key The key to search for, case-insensitive.
+     * @return A pointer to the entry, or nullptr if the key doesn't exist.
+     */
+    auto FindEntry(const std::string& key) const -> const Entry*;
+
+    /**
+     * @brief Returns the parsed entry for the given known key slot.
+     * @param slot The key slot.
+     * @return A pointer to the entry, or nullptr if the key doesn't exist.
+     */
+    auto FindEntry(PresetKeySlot slot) const -> const Entry*;
+
+    /**
+     * @brief Converts an entry value to an integer.
+     * @param entry The entry to convert, can be nullptr.
+     * @param defaultValue The value to return if the entry is missing or can't be converted.
+     * @return The converted value or the default value.
+     */
+    auto ToInt(const Entry* entry, int defaultValue) const -> int;
+
+    /**
+     * @brief Converts an entry value to a float.
+     * @param entry The entry to convert, can be nullptr.
+     * @param defaultValue The value to return if the entry is missing or can't be converted.
+     * @return The converted value or the default value.
+     */
+    auto ToFloat(const Entry* entry, float defaultValue) const -> float;
+
+    /**
+     * @brief Registers a value as a numbered code line if the key ends with a valid line number.
+     * @param key The lower-case key of the line.
+     * @param value The line value.
+     * @return True if the key was added as a code line, false if it has no valid line number.
+     */
+    auto AddCodeLine(Span key, Span value) -> bool;
+
+    /**
+     * @brief Resizes the hash tables to fit the given number of items and rehashes existing keys.
+     * @param table The table to grow.
+     * @param itemCount The current number of items in the table.
+     * @param keyOf Returns the key span for a stored item index.
+     */
+    template<typename KeyAccessor>
+    void GrowTable(std::vector<uint32_t>& table, uint32_t itemCount, KeyAccessor keyOf);
+
+    /**
+     * @brief Returns a pointer to the first character of the span in the file buffer.
+     * @param span The span to resolve.
+     * @return A pointer into the file buffer.
+     */
+    auto Data(Span span) const -> const char*
+    {
+        return m_fileData.data() + span.offset;
+    }
+
+    std::vector<char> m_fileData; //!< The owned file contents. Keys are lower-cased, values null-terminated in place.
+
+    std::vector<Entry> m_entries;        //!< All unique key/value pairs, in file order.
+    std::vector<uint32_t> m_entryTable; //!< Open-addressing hash table with indices into m_entries.
+
+    std::vector<CodeBlock> m_codeBlocks;    //!< Numbered code lines, grouped by key prefix.
+    std::vector<uint32_t> m_codeBlockTable; //!< Open-addressing hash table with indices into m_codeBlocks.
+
+    std::array<uint32_t, PresetKeyTable::SlotCount> m_knownKeys{}; //!< Index into m_entries + 1 for each known key slot, 0 if not present.
+    std::vector<uint32_t> m_unknownKeys;                            //!< Indices into m_entries of keys not in the key table.
 
-    ValueMap m_presetValues; //!< Map with preset keys and their value.
+    mutable ValueMap m_presetValues;         //!< Lazily built map with preset keys and their value.
+    mutable bool m_presetValuesValid{false}; //!< True if m_presetValues reflects the parsed data.
 };
 
 } // namespace MilkdropPreset
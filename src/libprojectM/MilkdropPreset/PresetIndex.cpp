@@ -0,0 +1,637 @@
+#include "PresetIndex.hpp"
+
+#include "Constants.hpp"
+#include "MappedFile.hpp"
+#include "PresetBundle.hpp"
+#include "PresetFileParser.hpp"
+
+#include <Renderer/FileSource.hpp>
+
+#include <Logging.hpp>
+#include <Utils.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <set>
+#include <stdexcept>
+
+// Fall back to boost if compiler doesn't support C++17
+#include PROJECTM_FILESYSTEM_INCLUDE
+using namespace PROJECTM_FILESYSTEM_NAMESPACE::filesystem;
+
+namespace libprojectM {
+namespace MilkdropPreset {
+
+namespace {
+
+constexpr char indexMagic[4] = {'M', 'L', 'K', 'I'};
+constexpr uint32_t byteOrderMark = 0x01020304; //!< Index files are written in native byte order.
+
+constexpr int defaultMeshVertices = (32 + 1) * (24 + 1); //!< Per-pixel code invocations at the default 32x24 mesh size.
+constexpr int maxWaveSamples = 512;                      //!< Maximum number of custom waveform samples.
+constexpr int maxShapeInstances = 1024;                  //!< Maximum number of custom shape instances.
+
+/**
+ * @brief The index file header.
+ */
+struct FileHeader {
+    char magic[4];          //!< Always "MLKI".
+    uint32_t byteOrder;     //!< Byte order mark, must read as byteOrderMark.
+    uint32_t version;       //!< Index format version.
+    uint32_t entryCount;    //!< Number of index entries.
+    uint32_t entriesOffset; //!< Offset of the first index entry.
+    uint32_t reserved;      //!< Unused, always 0.
+};
+
+/**
+ * @brief A preset found while scanning the preset paths.
+ */
+struct ScannedFile {
+    std::string path;           //!< Absolute, normalized preset path.
+    int64_t modificationTime{}; //!< Modification time of the file or containing archive.
+    uint64_t fileSize{};        //!< File size, 0 for files inside archives.
+    bool inArchive{};           //!< True if the file is located inside an archive.
+};
+
+/**
+ * @brief A preset to be written into the new index file.
+ */
+struct NewEntry {
+    std::string path;             //!< Absolute, normalized preset path.
+    PresetIndex::PresetInfo info; //!< Preset metadata.
+};
+
+auto NormalizePath(const std::string& presetFile) -> std::string
+{
+    return absolute(path(presetFile)).lexically_normal().string();
+}
+
+auto ModificationTime(const path& file) -> int64_t
+{
+#ifdef PROJECTM_FILESYSTEM_USE_BOOST
+    return static_cast<int64_t>(last_write_time(file));
+#else
+    return static_cast<int64_t>(last_write_time(file).time_since_epoch().count());
+#endif
+}
+
+auto IsPresetFile(const std::string& fileName) -> bool
+{
+    return fileName.length() > 5 && Utils::ToLower(fileName.substr(fileName.length() - 5)) == ".milk";
+}
+
+void ScanPath(const std::string& presetPath, std::vector<ScannedFile>& files)
+{
+    try
+    {
+        auto const basePath = absolute(path(presetPath)).lexically_normal();
+
+        if (is_directory(basePath))
+        {
+            for (const auto& entry : recursive_directory_iterator(basePath))
+            {
+                if (is_regular_file(entry.status()) && IsPresetFile(entry.path().filename().string()))
+                {
+                    files.push_back({entry.path().string(), ModificationTime(entry.path()), file_size(entry.path()), false});
+                }
+            }
+        }
+        else if (Renderer::FileSource::IsArchive(basePath.string()) && is_regular_file(basePath))
+        {
+            // All presets in an archive share its modification time, so a changed archive is re-read completely.
+            auto archive = Renderer::FileSource::Open(basePath.string());
+            if (!archive)
+            {
+                return;
+            }
+
+            auto const modificationTime = ModificationTime(basePath);
+            archive->ListFiles(true, [&files, modificationTime](const std::string& filePath) {
+                if (IsPresetFile(filePath))
+                {
+                    files.push_back({NormalizePath(filePath), modificationTime, 0, true});
+                }
+            });
+        }
+    }
+    catch (filesystem_error& ex)
+    {
+        LOG_DEBUG(std::string("[PresetIndex] Error scanning preset path: ") + ex.what());
+    }
+}
+
+void AddShaderTextures(const std::string& shaderCode, std::set<std::string>& textures)
+{
+    static const std::set<std::string> builtInTextures{
+        "main", "blur1", "blur2", "blur3",
+        "noise_lq", "noise_lq_lite", "noise_mq", "noise_hq", "noisevol_lq", "noisevol_hq"};
+
+    auto found = shaderCode.find("sampler_");
+    while (found != std::string::npos)
+    {
+        found += 8;
+        auto end = found;
+        while (end < shaderCode.length() && (std::isalnum(static_cast<unsigned char>(shaderCode.at(end))) || shaderCode.at(end) == '_'))
+        {
+            end++;
+        }
+
+        auto name = Utils::ToLower(shaderCode.substr(found, end - found));
+
+        // Remove the filtering/wrap mode prefix, as done by the texture manager.
+        if (name.length() > 3 && name.at(2) == '_')
+        {
+            name = name.substr(3);
+        }
+
+        if (!name.empty() && name != "state" && builtInTextures.find(name) == builtInTextures.end())
+        {
+            textures.insert(name);
+        }
+
+        found = shaderCode.find("sampler_", end);
+    }
+}
+
+} // namespace
+
+/**
+ * @brief A single preset in the index file.
+ */
+struct PresetIndex::IndexEntry {
+    int64_t modificationTime;       //!< Modification time of the file or containing archive.
+    uint64_t fileSize;              //!< Preset file size in bytes.
+    uint64_t contentHash;           //!< Hash of the preset file contents.
+    uint32_t pathOffset;            //!< Offset of the preset path in the file.
+    uint32_t pathLength;            //!< Length of the preset path.
+    uint32_t texturesOffset;        //!< Offset of the newline-separated texture names in the file.
+    uint32_t texturesLength;        //!< Length of the texture names.
+    uint32_t flags;                 //!< Combination of Flags values.
+    float costEstimate;             //!< Estimated per-frame expression cost.
+    int32_t presetVersion;          //!< MILKDROP_PRESET_VERSION.
+    uint8_t warpShaderVersion;      //!< Effective warp shader model version.
+    uint8_t compositeShaderVersion; //!< Effective composite shader model version.
+    uint8_t waveCount;              //!< Number of enabled custom waveforms.
+    uint8_t shapeCount;             //!< Number of enabled custom shapes.
+};
+
+constexpr uint32_t PresetIndex::FormatVersion;
+
+PresetIndex::PresetIndex(std::string indexFile)
+    : m_indexFile(std::move(indexFile))
+{
+    Map();
+}
+
+PresetIndex::~PresetIndex() = default;
+
+auto PresetIndex::Refresh(const std::vector<std::string>& presetPaths) -> uint32_t
+{
+    std::vector<ScannedFile> files;
+    for (const auto& presetPath : presetPaths)
+    {
+        ScanPath(presetPath, files);
+    }
+
+    std::sort(files.begin(), files.end(), [](const ScannedFile& left, const ScannedFile& right) {
+        return left.path < right.path;
+    });
+    files.erase(std::unique(files.begin(), files.end(), [](const ScannedFile& left, const ScannedFile& right) {
+                    return left.path == right.path;
+                }),
+                files.end());
+
+    uint32_t parsedCount{};
+    std::vector<NewEntry> newEntries;
+    newEntries.reserve(files.size());
+    for (const auto& file : files)
+    {
+        auto const index = Find(file.path);
+        if (index >= 0)
+        {
+            const auto& entry = Entry(static_cast<size_t>(index));
+            if (entry.modificationTime == file.modificationTime && (file.inArchive || entry.fileSize == file.fileSize))
+            {
+                newEntries.push_back({file.path, Info(static_cast<size_t>(index))});
+                continue;
+            }
+        }
+
+        std::vector<char> presetData;
+        if (!Renderer::FileSource::Read(file.path, presetData, PresetFileParser::maxFileSize))
+        {
+            continue;
+        }
+
+        auto const contentHash = PresetBundle::HashSource(presetData.data(), presetData.size());
+        auto const fileSize = presetData.size();
+
+        PresetFileParser parser;
+        parsedCount++;
+        if (!parser.Read(std::move(presetData)))
+        {
+            LOG_DEBUG("[PresetIndex] Could not parse preset file \"" + file.path + "\", not adding it to the index.");
+            continue;
+        }
+
+        NewEntry newEntry{file.path, ReadPresetInfo(parser)};
+        newEntry.info.modificationTime = file.modificationTime;
+        newEntry.info.fileSize = fileSize;
+        newEntry.info.contentHash = contentHash;
+        if (file.inArchive)
+        {
+            newEntry.info.flags |= InArchive;
+        }
+        newEntries.push_back(std::move(newEntry));
+    }
+
+    // Serialize everything before unmapping the old file, as the unchanged entries were copied from it.
+    std::vector<char> fileData(sizeof(FileHeader) + newEntries.size() * sizeof(IndexEntry));
+    std::vector<IndexEntry> entries(newEntries.size());
+    for (size_t index = 0; index < newEntries.size(); index++)
+    {
+        const auto& newEntry = newEntries[index];
+        const auto& info = newEntry.info;
+
+        std::string textures;
+        for (const auto& texture : info.textures)
+        {
+            textures.append(textures.empty() ? "" : "\n").append(texture);
+        }
+
+        auto& entry = entries[index];
+        entry.modificationTime = info.modificationTime;
+        entry.fileSize = info.fileSize;
+        entry.contentHash = info.contentHash;
+        entry.pathOffset = static_cast<uint32_t>(fileData.size());
+        entry.pathLength = static_cast<uint32_t>(newEntry.path.length());
+        fileData.insert(fileData.end(), newEntry.path.begin(), newEntry.path.end());
+        entry.texturesOffset = static_cast<uint32_t>(fileData.size());
+        entry.texturesLength = static_cast<uint32_t>(textures.length());
+        fileData.insert(fileData.end(), textures.begin(), textures.end());
+        entry.flags = info.flags;
+        entry.costEstimate = info.costEstimate;
+        entry.presetVersion = info.presetVersion;
+        entry.warpShaderVersion = static_cast<uint8_t>(std::max(0, std::min(info.warpShaderVersion, 255)));
+        entry.compositeShaderVersion = static_cast<uint8_t>(std::max(0, std::min(info.compositeShaderVersion, 255)));
+        entry.waveCount = static_cast<uint8_t>(info.waveCount);
+        entry.shapeCount = static_cast<uint8_t>(info.shapeCount);
+
+        if (fileData.size() > std::numeric_limits<uint32_t>::max())
+        {
+            throw std::runtime_error("[PresetIndex] Preset index \"" + m_indexFile + "\" exceeds the maximum file size.");
+        }
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, indexMagic, sizeof(indexMagic));
+    header.byteOrder = byteOrderMark;
+    header.version = FormatVersion;
+    header.entryCount = static_cast<uint32_t>(entries.size());
+    header.entriesOffset = sizeof(FileHeader);
+    std::memcpy(fileData.data(), &header, sizeof(header));
+    if (!entries.empty())
+    {
+        std::memcpy(fileData.data() + sizeof(FileHeader), entries.data(), entries.size() * sizeof(IndexEntry));
+    }
+
+    // Write to a temporary file first, so other processes never map a partially written index.
+    // The current index stays mapped and usable if writing fails.
+    auto const temporaryFile = m_indexFile + ".tmp";
+    bool written{};
+    {
+        std::ofstream indexStream(temporaryFile, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+        written = static_cast<bool>(indexStream.write(fileData.data(), static_cast<std::streamsize>(fileData.size())));
+    }
+    if (!written)
+    {
+        std::remove(temporaryFile.c_str());
+        throw std::runtime_error("[PresetIndex] Could not write preset index \"" + temporaryFile + "\".");
+    }
+
+    // Unmap before replacing the file, as mapped files can't be replaced on all platforms.
+    m_file.reset();
+    m_entries = nullptr;
+    m_entryCount = 0;
+
+    try
+    {
+        rename(path(temporaryFile), path(m_indexFile));
+    }
+    catch (filesystem_error& ex)
+    {
+        // Keep using the previous index file, which is still in place.
+        std::remove(temporaryFile.c_str());
+        Map();
+        throw std::runtime_error(std::string("[PresetIndex] Could not replace preset index: ") + ex.what());
+    }
+
+    Map();
+
+    return parsedCount;
+}
+
+auto PresetIndex::Count() const -> size_t
+{
+    return m_entryCount;
+}
+
+auto PresetIndex::Find(const std::string& presetFile) const -> int
+{
+    if (m_entryCount == 0 || presetFile.empty())
+    {
+        return -1;
+    }
+
+    std::string name;
+    try
+    {
+        name = NormalizePath(presetFile);
+    }
+    catch (std::exception&)
+    {
+        return -1;
+    }
+
+    const char* data = m_file->Data();
+    auto const* end = m_entries + m_entryCount;
+    auto const* entry = std::lower_bound(m_entries, end, name, [data](const IndexEntry& left, const std::string& right) {
+        return right.compare(0, right.length(), data + left.pathOffset, left.pathLength) > 0;
+    });
+
+    if (entry == end || name.compare(0, name.length(), data + entry->pathOffset, entry->pathLength) != 0)
+    {
+        return -1;
+    }
+
+    return static_cast<int>(entry - m_entries);
+}
+
+auto PresetIndex::List(const std::string& presetPath, bool recursive) const -> std::vector<std::string>
+{
+    std::vector<std::string> presets;
+    if (m_entryCount == 0 || presetPath.empty())
+    {
+        return presets;
+    }
+
+    std::string directory;
+    try
+    {
+        directory = NormalizePath(presetPath);
+    }
+    catch (std::exception&)
+    {
+        return presets;
+    }
+
+    // Archive contents always use forward slashes, directory contents use the native separator.
+    std::string prefixes[] = {directory + '/', directory + static_cast<char>(path::preferred_separator)};
+    size_t const prefixCount = prefixes[0] == prefixes[1] ? 1 : 2;
+
+    const char* data = m_file->Data();
+    auto const* end = m_entries + m_entryCount;
+    for (size_t prefixIndex = 0; prefixIndex < prefixCount; prefixIndex++)
+    {
+        const auto& prefix = prefixes[prefixIndex];
+
+        // Entries are sorted by path, so all presets with the prefix are stored consecutively.
+        auto const* entry = std::lower_bound(m_entries, end, prefix, [data](const IndexEntry& left, const std::string& right) {
+            return right.compare(0, right.length(), data + left.pathOffset, left.pathLength) > 0;
+        });
+
+        for (; entry != end; ++entry)
+        {
+            const char* entryPath = data + entry->pathOffset;
+            if (entry->pathLength <= prefix.length() || prefix.compare(0, prefix.length(), entryPath, prefix.length()) != 0)
+            {
+                break;
+            }
+
+            const char* name = entryPath + prefix.length();
+            const char* nameEnd = entryPath + entry->pathLength;
+            if (!recursive && std::find_if(name, nameEnd, [](char character) {
+                                  return character == '/' || character == static_cast<char>(path::preferred_separator);
+                              }) != nameEnd)
+            {
+                continue;
+            }
+
+            presets.emplace_back(entryPath, entry->pathLength);
+        }
+    }
+
+    return presets;
+}
+
+auto PresetIndex::Path(size_t index) const -> std::string
+{
+    const auto& entry = Entry(index);
+    return {m_file->Data() + entry.pathOffset, entry.pathLength};
+}
+
+auto PresetIndex::Info(size_t index) const -> PresetInfo
+{
+    const auto& entry = Entry(index);
+
+    PresetInfo info;
+    info.modificationTime = entry.modificationTime;
+    info.fileSize = entry.fileSize;
+    info.contentHash = entry.contentHash;
+    info.flags = entry.flags;
+    info.presetVersion = entry.presetVersion;
+    info.warpShaderVersion = entry.warpShaderVersion;
+    info.compositeShaderVersion = entry.compositeShaderVersion;
+    info.waveCount = entry.waveCount;
+    info.shapeCount = entry.shapeCount;
+    info.costEstimate = entry.costEstimate;
+
+    const char* textures = m_file->Data() + entry.texturesOffset;
+    const char* texturesEnd = textures + entry.texturesLength;
+    while (textures < texturesEnd)
+    {
+        const char* nameEnd = std::find(textures, texturesEnd, '\n');
+        info.textures.emplace_back(textures, nameEnd);
+        textures = nameEnd + 1;
+    }
+
+    return info;
+}
+
+auto PresetIndex::ReadPresetInfo(const PresetFileParser& parser) -> PresetInfo
+{
+    PresetInfo info;
+
+    // Same version logic as in PresetState.
+    info.presetVersion = parser.GetInt(PresetKeyTable::Slot(PresetKey::PresetVersion), 100);
+    info.warpShaderVersion = 2;
+    info.compositeShaderVersion = 2;
+    if (info.presetVersion < 200)
+    {
+        info.warpShaderVersion = 0;
+        info.compositeShaderVersion = 0;
+    }
+    else if (info.presetVersion == 200)
+    {
+        info.warpShaderVersion = parser.GetInt(PresetKeyTable::Slot(PresetKey::PsVersion), info.warpShaderVersion);
+        info.compositeShaderVersion = parser.GetInt(PresetKeyTable::Slot(PresetKey::PsVersion), info.compositeShaderVersion);
+    }
+    else
+    {
+        info.warpShaderVersion = parser.GetInt(PresetKeyTable::Slot(PresetKey::PsVersionWarp), info.warpShaderVersion);
+        info.compositeShaderVersion = parser.GetInt(PresetKeyTable::Slot(PresetKey::PsVersionComp), info.compositeShaderVersion);
+    }
+
+    auto const perFrameCodeLength = parser.GetCode("per_frame_init_").length() + parser.GetCode("per_frame_").length();
+    auto const perPixelCodeLength = parser.GetCode("per_pixel_").length();
+    auto const warpShader = parser.GetCode("warp_");
+    auto const compositeShader = parser.GetCode("comp_");
+
+    std::set<std::string> textures;
+
+    if (perFrameCodeLength > 0)
+    {
+        info.flags |= HasPerFrameCode;
+    }
+    if (perPixelCodeLength > 0)
+    {
+        info.flags |= HasPerPixelCode;
+    }
+    if (info.warpShaderVersion > 0 && !warpShader.empty())
+    {
+        info.flags |= HasWarpShader;
+        AddShaderTextures(warpShader, textures);
+    }
+    else
+    {
+        info.warpShaderVersion = 0;
+    }
+    if (info.compositeShaderVersion > 0 && !compositeShader.empty())
+    {
+        info.flags |= HasCompositeShader;
+        AddShaderTextures(compositeShader, textures);
+    }
+    else
+    {
+        info.compositeShaderVersion = 0;
+    }
+
+    // Per-frame code runs once, per-pixel code for each mesh vertex.
+    double cost = static_cast<double>(perFrameCodeLength) + static_cast<double>(perPixelCodeLength) * defaultMeshVertices;
+
+    for (int index = 0; index < CustomWaveformCount; index++)
+    {
+        if (!parser.GetBool(PresetKeyTable::Slot(WaveKey::Enabled, index), false))
+        {
+            continue;
+        }
+
+        info.waveCount++;
+
+        auto const samples = std::max(0, std::min(parser.GetInt(PresetKeyTable::Slot(WaveKey::Samples, index), maxWaveSamples), maxWaveSamples));
+        auto const prefix = "wave_" + std::to_string(index) + "_";
+        cost += static_cast<double>(parser.GetCode(prefix + "per_frame").length()) +
+                static_cast<double>(parser.GetCode(prefix + "per_point").length()) * samples;
+    }
+
+    for (int index = 0; index < CustomShapeCount; index++)
+    {
+        if (!parser.GetBool(PresetKeyTable::Slot(ShapeKey::Enabled, index), false))
+        {
+            continue;
+        }
+
+        info.shapeCount++;
+
+        auto const instances = std::max(1, std::min(parser.GetInt(PresetKeyTable::Slot(ShapeKey::Instances, index), 1), maxShapeInstances));
+        auto const prefix = "shape_" + std::to_string(index) + "_";
+        cost += static_cast<double>(parser.GetCode(prefix + "per_frame").length()) * instances;
+
+        if (parser.GetBool(PresetKeyTable::Slot(ShapeKey::Textured, index), false))
+        {
+            auto const image = Utils::ToLower(parser.GetString(PresetKeyTable::Slot(ShapeKey::Image, index), ""));
+            if (!image.empty())
+            {
+                textures.insert(image);
+            }
+        }
+    }
+
+    info.costEstimate = static_cast<float>(cost);
+    info.textures.assign(textures.begin(), textures.end());
+
+    return info;
+}
+
+void PresetIndex::Map()
+{
+    m_file.reset();
+    m_entries = nullptr;
+    m_entryCount = 0;
+
+    try
+    {
+        if (!exists(path(m_indexFile)))
+        {
+            return;
+        }
+
+        auto file = std::make_unique<MappedFile>(m_indexFile);
+
+        const auto* header = reinterpret_cast<const FileHeader*>(file->Data());
+        if (file->Size() < sizeof(FileHeader) ||
+            std::memcmp(header->magic, indexMagic, sizeof(indexMagic)) != 0 ||
+            header->byteOrder != byteOrderMark ||
+            header->version != FormatVersion)
+        {
+            LOG_INFO("[PresetIndex] Preset index \"" + m_indexFile + "\" is invalid or outdated, it will be rebuilt.");
+            return;
+        }
+
+        if (header->entriesOffset % alignof(IndexEntry) != 0 ||
+            header->entriesOffset + static_cast<uint64_t>(header->entryCount) * sizeof(IndexEntry) > file->Size())
+        {
+            LOG_INFO("[PresetIndex] Preset index \"" + m_indexFile + "\" is corrupted, it will be rebuilt.");
+            return;
+        }
+
+        const auto* entries = reinterpret_cast<const IndexEntry*>(file->Data() + header->entriesOffset);
+        for (uint32_t index = 0; index < header->entryCount; index++)
+        {
+            const auto& entry = entries[index];
+            if (static_cast<uint64_t>(entry.pathOffset) + entry.pathLength > file->Size() ||
+                static_cast<uint64_t>(entry.texturesOffset) + entry.texturesLength > file->Size())
+            {
+                LOG_INFO("[PresetIndex] Preset index \"" + m_indexFile + "\" is corrupted, it will be rebuilt.");
+                return;
+            }
+        }
+
+        m_entries = entries;
+        m_entryCount = header->entryCount;
+        m_file = std::move(file);
+    }
+    catch (std::exception& ex)
+    {
+        LOG_DEBUG(std::string("[PresetIndex] Could not map preset index: ") + ex.what());
+        m_entries = nullptr;
+        m_entryCount = 0;
+    }
+}
+
+auto PresetIndex::Entry(size_t index) const -> const IndexEntry&
+{
+    if (index >= m_entryCount)
+    {
+        throw std::out_of_range("[PresetIndex] Preset index out of range.");
+    }
+
+    return m_entries[index];
+}
+
+} // namespace MilkdropPreset
+} // namespace libprojectM
@@ -0,0 +1,154 @@
+/**
+ * @file PresetIndex.hpp
+ * @brief Persistent, memory-mapped index of Milkdrop preset metadata.
+ *
+ * The index stores the path, modification time, size and content hash of each preset file, together
+ * with some key properties extracted from the preset contents. Applications can use it to sort,
+ * filter or select presets without opening the files. On refresh, only files with a changed
+ * modification time or size are parsed again.
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace libprojectM {
+namespace MilkdropPreset {
+
+class MappedFile;
+class PresetFileParser;
+
+/**
+ * @brief A memory-mapped, versioned index of preset metadata.
+ *
+ * The index file is mapped read-only. Refresh() scans the given paths, writes a new index file and
+ * maps it again, so all queries are served from the mapping.
+ */
+class PresetIndex
+{
+public:
+    static constexpr uint32_t FormatVersion = 1; //!< Index format version. Bump on any layout change.
+
+    /**
+     * @brief Flags describing the preset contents.
+     */
+    enum Flags : uint32_t
+    {
+        HasPerFrameCode = 1,      //!< Preset has per-frame init or per-frame code.
+        HasPerPixelCode = 2,      //!< Preset has per-pixel (per-vertex) code.
+        HasWarpShader = 4,        //!< Preset has a warp shader and PSVERSION_WARP > 0.
+        HasCompositeShader = 8,   //!< Preset has a composite shader and PSVERSION_COMP > 0.
+        InArchive = 16            //!< Preset is located inside an archive, see Renderer::FileSource.
+    };
+
+    /**
+     * @brief Metadata of a single indexed preset.
+     */
+    struct PresetInfo {
+        int64_t modificationTime{};        //!< Modification time of the file (or archive), in file system clock ticks.
+        uint64_t fileSize{};               //!< Size of the preset file in bytes.
+        uint64_t contentHash{};            //!< Hash of the file contents, same as used in preset bundles.
+        uint32_t flags{};                  //!< Combination of Flags values.
+        int presetVersion{};               //!< MILKDROP_PRESET_VERSION, 100 if not set.
+        int warpShaderVersion{};           //!< Effective warp shader model version, 0 if none.
+        int compositeShaderVersion{};      //!< Effective composite shader model version, 0 if none.
+        int waveCount{};                   //!< Number of enabled custom waveforms.
+        int shapeCount{};                  //!< Number of enabled custom shapes.
+        float costEstimate{};              //!< Estimated expression code bytes evaluated per frame at the default mesh size.
+        std::vector<std::string> textures; //!< Lower-case names of user textures referenced by shaders and shapes.
+    };
+
+    /**
+     * @brief Opens the given index file.
+     *
+     * If the file doesn't exist, is invalid or was written with a different format version, the index
+     * is empty and will be rebuilt on the next refresh.
+     *
+     * @param indexFile The index file to use.
+     */
+    explicit PresetIndex(std::string indexFile);
+
+    ~PresetIndex();
+
+    PresetIndex(const PresetIndex&) = delete;
+    auto operator=(const PresetIndex&) -> PresetIndex& = delete;
+
+    /**
+     * @brief Scans the given directories or archives and updates the index file.
+     *
+     * Unchanged presets are taken over from the current index, new or modified files are parsed.
+     * Presets no longer found in any of the paths are removed from the index.
+     *
+     * @param presetPaths Directories or archives to scan recursively for .milk files.
+     * @return The number of preset files which were parsed.
+     * @throws std::runtime_error If the index file can't be written.
+     */
+    auto Refresh(const std::vector<std::string>& presetPaths) -> uint32_t;
+
+    /**
+     * @brief Returns the number of presets in the index.
+     * @return The number of presets.
+     */
+    auto Count() const -> size_t;
+
+    /**
+     * @brief Searches the index for the given preset file.
+     * @param presetFile The preset file path. Relative paths are resolved against the current working directory.
+     * @return The preset index, or -1 if the preset is not indexed.
+     */
+    auto Find(const std::string& presetFile) const -> int;
+
+    /**
+     * @brief Returns all indexed presets inside the given directory or archive.
+     * @param presetPath The directory or archive path. Relative paths are resolved against the current working directory.
+     * @param recursive If true, presets in subdirectories are also returned.
+     * @return The absolute preset paths, sorted by path.
+     */
+    auto List(const std::string& presetPath, bool recursive) const -> std::vector<std::string>;
+
+    /**
+     * @brief Returns the absolute path of an indexed preset.
+     * @param index The preset index.
+     * @return The preset path, possibly pointing into an archive.
+     */
+    auto Path(size_t index) const -> std::string;
+
+    /**
+     * @brief Returns the metadata of an indexed preset.
+     * @param index The preset index.
+     * @return The preset metadata.
+     */
+    auto Info(size_t index) const -> PresetInfo;
+
+    /**
+     * @brief Extracts the indexed metadata from a parsed preset.
+     * @param parser The parser containing the preset data.
+     * @return The preset metadata. File-related members are not set.
+     */
+    static auto ReadPresetInfo(const PresetFileParser& parser) -> PresetInfo;
+
+private:
+    struct IndexEntry;
+
+    /**
+     * @brief Maps the index file if it exists and is valid, otherwise leaves the index empty.
+     */
+    void Map();
+
+    /**
+     * @brief Returns the entry at the given index.
+     * @param index The preset index.
+     * @return A reference to the entry in the mapped file.
+     */
+    auto Entry(size_t index) const -> const IndexEntry&;
+
+    std::string m_indexFile;              //!< The index file path.
+    std::unique_ptr<MappedFile> m_file;   //!< The mapped index file, nullptr if empty.
+    const IndexEntry* m_entries{nullptr}; //!< Index entries, sorted by path.
+    uint32_t m_entryCount{};              //!< Number of entries in the index.
+};
+
+} // namespace MilkdropPreset
+} // namespace libprojectM
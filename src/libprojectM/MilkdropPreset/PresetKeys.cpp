@@ -0,0 +1,416 @@
+#include "PresetKeys.hpp"
+
+namespace libprojectM {
+namespace MilkdropPreset {
+
+namespace {
+
+// Key names, in the same order as the enum values.
+constexpr const char* globalKeyNames[] = {
+    "MILKDROP_PRESET_VERSION",
+    "PSVERSION",
+    "PSVERSION_WARP",
+    "PSVERSION_COMP",
+    "fRating",
+    "fGammaAdj",
+    "fDecay",
+    "fVideoEchoZoom",
+    "fVideoEchoAlpha",
+    "nVideoEchoOrientation",
+    "nWaveMode",
+    "bAdditiveWaves",
+    "bWaveDots",
+    "bWaveThick",
+    "bModWaveAlphaByVolume",
+    "bMaximizeWaveColor",
+    "bTexWrap",
+    "bDarkenCenter",
+    "bRedBlueStereo",
+    "bBrighten",
+    "bDarken",
+    "bSolarize",
+    "bInvert",
+    "bMotionVectorsOn",
+    "fWaveAlpha",
+    "fWaveScale",
+    "fWaveSmoothing",
+    "fWaveParam",
+    "fModWaveAlphaStart",
+    "fModWaveAlphaEnd",
+    "fWarpAnimSpeed",
+    "fWarpScale",
+    "fZoomExponent",
+    "fShader",
+    "zoom",
+    "rot",
+    "cx",
+    "cy",
+    "dx",
+    "dy",
+    "warp",
+    "sx",
+    "sy",
+    "wave_r",
+    "wave_g",
+    "wave_b",
+    "wave_a",
+    "wave_x",
+    "wave_y",
+    "ob_size",
+    "ob_r",
+    "ob_g",
+    "ob_b",
+    "ob_a",
+    "ib_size",
+    "ib_r",
+    "ib_g",
+    "ib_b",
+    "ib_a",
+    "nMotionVectorsX",
+    "nMotionVectorsY",
+    "mv_dx",
+    "mv_dy",
+    "mv_l",
+    "mv_r",
+    "mv_g",
+    "mv_b",
+    "mv_a",
+    "b1n",
+    "b2n",
+    "b3n",
+    "b1x",
+    "b2x",
+    "b3x",
+    "b1ed",
+};
+
+constexpr const char* waveKeyNames[] = {
+    "enabled",
+    "samples",
+    "sep",
+    "bSpectrum",
+    "bUseDots",
+    "bDrawThick",
+    "bAdditive",
+    "scaling",
+    "smoothing",
+    "r",
+    "g",
+    "b",
+    "a",
+    "mode",
+    "x",
+    "y",
+};
+
+constexpr const char* shapeKeyNames[] = {
+    "enabled",
+    "sides",
+    "additive",
+    "thickOutline",
+    "textured",
+    "num_inst",
+    "x",
+    "y",
+    "rad",
+    "ang",
+    "tex_ang",
+    "tex_zoom",
+    "r",
+    "g",
+    "b",
+    "a",
+    "r2",
+    "g2",
+    "b2",
+    "a2",
+    "border_r",
+    "border_g",
+    "border_b",
+    "border_a",
+    "image",
+};
+
+static_assert(sizeof(globalKeyNames) / sizeof(globalKeyNames[0]) == PresetKeyTable::GlobalKeyCount, "Global key names don't match the PresetKey enum");
+static_assert(sizeof(waveKeyNames) / sizeof(waveKeyNames[0]) == PresetKeyTable::WaveKeyCount, "Wave key names don't match the WaveKey enum");
+static_assert(sizeof(shapeKeyNames) / sizeof(shapeKeyNames[0]) == PresetKeyTable::ShapeKeyCount, "Shape key names don't match the ShapeKey enum");
+
+constexpr char wavePrefix[] = "wavecode_";
+constexpr char shapePrefix[] = "shapecode_";
+
+constexpr auto ToLowerAscii(char c) -> char
+{
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+constexpr auto StringLength(const char* str) -> size_t
+{
+    size_t length{0};
+    while (str[length] != '\0')
+    {
+        ++length;
+    }
+    return length;
+}
+
+/**
+ * @brief Seeded, case-insensitive FNV-1a hash with a final avalanche step.
+ */
+constexpr auto HashKey(const char* key, size_t length, uint32_t seed) -> uint32_t
+{
+    uint32_t hash = 2166136261u ^ (seed * 0x9E3779B9u);
+    for (size_t index = 0; index < length; ++index)
+    {
+        hash ^= static_cast<unsigned char>(ToLowerAscii(key[index]));
+        hash *= 16777619u;
+    }
+    hash ^= hash >> 15;
+    hash *= 0x2C1B3C6Du;
+    hash ^= hash >> 12;
+    return hash;
+}
+
+/**
+ * @brief A minimal perfect hash table using the "hash and displace" scheme.
+ *
+ * Each key is first hashed into a bucket. Each bucket stores a seed which, combined with the
+ * key, hashes all keys in that bucket into distinct, otherwise unused slots.
+ *
+ * @tparam KeyCount The number of keys in the table.
+ * @tparam BucketCount The number of first-level buckets, must be a power of two.
+ * @tparam SlotCount The number of second-level slots, must be a power of two.
+ */
+template<size_t KeyCount, size_t BucketCount, size_t SlotCount>
+struct PerfectHashTable {
+    uint16_t bucketSeeds[BucketCount]{}; //!< Second-level hash seed for each bucket.
+    uint16_t slots[SlotCount]{};         //!< Key index + 1 for each slot, 0 if unused.
+    bool complete{false};                //!< True if a seed was found for every bucket.
+
+    /**
+     * @brief Returns the key index for the given key, or -1 if the key might not be in the table.
+     * The caller has to compare the key with the key name stored at the returned index.
+     */
+    auto Candidate(const char* key, size_t length) const -> int
+    {
+        auto const bucket = HashKey(key, length, 0) & (BucketCount - 1);
+        auto const slot = HashKey(key, length, bucketSeeds[bucket]) & (SlotCount - 1);
+        return static_cast<int>(slots[slot]) - 1;
+    }
+};
+
+/**
+ * @brief Builds the perfect hash table for the given key names at compile time.
+ */
+template<size_t BucketCount, size_t SlotCount, size_t KeyCount>
+constexpr auto BuildPerfectHashTable(const char* const (&keys)[KeyCount]) -> PerfectHashTable<KeyCount, BucketCount, SlotCount>
+{
+    static_assert((BucketCount & (BucketCount - 1)) == 0, "BucketCount must be a power of two");
+    static_assert((SlotCount & (SlotCount - 1)) == 0, "SlotCount must be a power of two");
+    static_assert(SlotCount >= KeyCount, "SlotCount must be at least KeyCount");
+
+    PerfectHashTable<KeyCount, BucketCount, SlotCount> table{};
+
+    size_t keyLengths[KeyCount]{};
+    size_t keyBuckets[KeyCount]{};
+    size_t bucketSizes[BucketCount]{};
+    for (size_t key = 0; key < KeyCount; ++key)
+    {
+        keyLengths[key] = StringLength(keys[key]);
+        keyBuckets[key] = HashKey(keys[key], keyLengths[key], 0) & (BucketCount - 1);
+        ++bucketSizes[keyBuckets[key]];
+    }
+
+    // Place the largest buckets first, as they are the hardest to fit.
+    size_t bucketOrder[BucketCount]{};
+    for (size_t bucket = 0; bucket < BucketCount; ++bucket)
+    {
+        size_t position = bucket;
+        while (position > 0 && bucketSizes[bucketOrder[position - 1]] < bucketSizes[bucket])
+        {
+            bucketOrder[position] = bucketOrder[position - 1];
+            --position;
+        }
+        bucketOrder[position] = bucket;
+    }
+
+    size_t placedBuckets{0};
+    for (size_t orderIndex = 0; orderIndex < BucketCount; ++orderIndex)
+    {
+        size_t const bucket = bucketOrder[orderIndex];
+        if (bucketSizes[bucket] == 0)
+        {
+            ++placedBuckets;
+            continue;
+        }
+
+        size_t bucketKeys[KeyCount]{};
+        size_t bucketKeyCount{0};
+        for (size_t key = 0; key < KeyCount; ++key)
+        {
+            if (keyBuckets[key] == bucket)
+            {
+                bucketKeys[bucketKeyCount++] = key;
+            }
+        }
+
+        for (uint32_t seed = 1; seed < 0xFFFF; ++seed)
+        {
+            size_t bucketSlots[KeyCount]{};
+            bool fits{true};
+            for (size_t index = 0; index < bucketKeyCount && fits; ++index)
+            {
+                size_t const key = bucketKeys[index];
+                bucketSlots[index] = HashKey(keys[key], keyLengths[key], seed) & (SlotCount - 1);
+                if (table.slots[bucketSlots[index]] != 0)
+                {
+                    fits = false;
+                }
+                for (size_t other = 0; other < index && fits; ++other)
+                {
+                    if (bucketSlots[other] == bucketSlots[index])
+                    {
+                        fits = false;
+                    }
+                }
+            }
+
+            if (fits)
+            {
+                for (size_t index = 0; index < bucketKeyCount; ++index)
+                {
+                    table.slots[bucketSlots[index]] = static_cast<uint16_t>(bucketKeys[index] + 1);
+                }
+                table.bucketSeeds[bucket] = static_cast<uint16_t>(seed);
+                ++placedBuckets;
+                break;
+            }
+        }
+    }
+
+    table.complete = placedBuckets == BucketCount;
+
+    return table;
+}
+
+constexpr auto globalKeyTable = BuildPerfectHashTable<32, 256>(globalKeyNames);
+constexpr auto waveKeyTable = BuildPerfectHashTable<8, 64>(waveKeyNames);
+constexpr auto shapeKeyTable = BuildPerfectHashTable<8, 64>(shapeKeyNames);
+
+static_assert(globalKeyTable.complete, "Could not build a perfect hash table for the global preset keys");
+static_assert(waveKeyTable.complete, "Could not build a perfect hash table for the custom wave keys");
+static_assert(shapeKeyTable.complete, "Could not build a perfect hash table for the custom shape keys");
+
+/**
+ * @brief Compares a lower-case key with a key name in arbitrary case.
+ */
+auto KeyEquals(const char* lowerKey, size_t length, const char* keyName) -> bool
+{
+    for (size_t index = 0; index < length; ++index)
+    {
+        if (keyName[index] == '\0' || lowerKey[index] != ToLowerAscii(keyName[index]))
+        {
+            return false;
+        }
+    }
+
+    return keyName[length] == '\0';
+}
+
+template<typename Table, size_t KeyCount>
+auto FindInTable(const Table& table, const char* const (&keys)[KeyCount], const char* key, size_t length) -> int
+{
+    int const candidate = table.Candidate(key, length);
+    if (candidate < 0 || !KeyEquals(key, length, keys[candidate]))
+    {
+        return -1;
+    }
+
+    return candidate;
+}
+
+/**
+ * @brief Parses the custom wave/shape index and finds the key suffix in the given table.
+ * @return The slot offset within the wave/shape key range, or -1 if not found.
+ */
+template<typename Table, size_t KeyCount>
+auto FindIndexedKey(const Table& table, const char* const (&keys)[KeyCount], int maxIndex,
+                    const char* key, size_t length) -> int
+{
+    // Expect a single digit index followed by an underscore.
+    if (length < 3 || key[0] < '0' || key[0] > '9' || key[1] != '_')
+    {
+        return -1;
+    }
+
+    int const index = key[0] - '0';
+    if (index >= maxIndex)
+    {
+        return -1;
+    }
+
+    int const keyIndex = FindInTable(table, keys, key + 2, length - 2);
+    if (keyIndex < 0)
+    {
+        return -1;
+    }
+
+    return index * static_cast<int>(KeyCount) + keyIndex;
+}
+
+} // namespace
+
+constexpr int PresetKeyTable::GlobalKeyCount;
+constexpr int PresetKeyTable::WaveKeyCount;
+constexpr int PresetKeyTable::ShapeKeyCount;
+constexpr int PresetKeyTable::WaveSlotOffset;
+constexpr int PresetKeyTable::ShapeSlotOffset;
+constexpr int PresetKeyTable::SlotCount;
+
+auto PresetKeyTable::Find(const char* key, size_t length) -> int
+{
+    constexpr size_t wavePrefixLength = sizeof(wavePrefix) - 1;
+    constexpr size_t shapePrefixLength = sizeof(shapePrefix) - 1;
+
+    if (length > wavePrefixLength && KeyEquals(key, wavePrefixLength, wavePrefix))
+    {
+        int const slot = FindIndexedKey(waveKeyTable, waveKeyNames, CustomWaveformCount,
+                                        key + wavePrefixLength, length - wavePrefixLength);
+        return slot < 0 ? -1 : WaveSlotOffset + slot;
+    }
+
+    if (length > shapePrefixLength && KeyEquals(key, shapePrefixLength, shapePrefix))
+    {
+        int const slot = FindIndexedKey(shapeKeyTable, shapeKeyNames, CustomShapeCount,
+                                        key + shapePrefixLength, length - shapePrefixLength);
+        return slot < 0 ? -1 : ShapeSlotOffset + slot;
+    }
+
+    return FindInTable(globalKeyTable, globalKeyNames, key, length);
+}
+
+auto PresetKeyTable::Name(PresetKeySlot slot) -> std::string
+{
+    int const index = slot.index;
+
+    if (index < WaveSlotOffset)
+    {
+        return globalKeyNames[index];
+    }
+
+    if (index < ShapeSlotOffset)
+    {
+        int const waveSlot = index - WaveSlotOffset;
+        return wavePrefix + std::to_string(waveSlot / WaveKeyCount) + "_" + waveKeyNames[waveSlot % WaveKeyCount];
+    }
+
+    if (index < SlotCount)
+    {
+        int const shapeSlot = index - ShapeSlotOffset;
+        return shapePrefix + std::to_string(shapeSlot / ShapeKeyCount) + "_" + shapeKeyNames[shapeSlot % ShapeKeyCount];
+    }
+
+    return {};
+}
+
+} // namespace MilkdropPreset
+} // namespace libprojectM
@@ -0,0 +1,234 @@
+/**
+ * @file PresetKeys.hpp
+ * @brief Compile-time perfect hash tables for all known Milkdrop preset keys.
+ *
+ * Every key Milkdrop writes into a preset file is assigned a dense slot number. The preset file parser
+ * resolves each key to its slot once while reading the file, so preset initialization can read values
+ * by slot instead of building and hashing key strings.
+ */
+#pragma once
+
+#include "Constants.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace libprojectM {
+namespace MilkdropPreset {
+
+/**
+ * @brief Global (non-code) preset keys.
+ */
+enum class PresetKey : uint16_t
+{
+    PresetVersion,           //!< MILKDROP_PRESET_VERSION
+    PsVersion,               //!< PSVERSION
+    PsVersionWarp,           //!< PSVERSION_WARP
+    PsVersionComp,           //!< PSVERSION_COMP
+    Rating,                  //!< fRating
+    GammaAdj,                //!< fGammaAdj
+    Decay,                   //!< fDecay
+    VideoEchoZoom,           //!< fVideoEchoZoom
+    VideoEchoAlpha,          //!< fVideoEchoAlpha
+    VideoEchoOrientation,    //!< nVideoEchoOrientation
+    WaveMode,                //!< nWaveMode
+    AdditiveWaves,           //!< bAdditiveWaves
+    WaveDots,                //!< bWaveDots
+    WaveThick,               //!< bWaveThick
+    ModWaveAlphaByVolume,    //!< bModWaveAlphaByVolume
+    MaximizeWaveColor,       //!< bMaximizeWaveColor
+    TexWrap,                 //!< bTexWrap
+    DarkenCenter,            //!< bDarkenCenter
+    RedBlueStereo,           //!< bRedBlueStereo
+    Brighten,                //!< bBrighten
+    Darken,                  //!< bDarken
+    Solarize,                //!< bSolarize
+    Invert,                  //!< bInvert
+    MotionVectorsOn,         //!< bMotionVectorsOn
+    WaveAlpha,               //!< fWaveAlpha
+    WaveScale,               //!< fWaveScale
+    WaveSmoothing,           //!< fWaveSmoothing
+    WaveParam,               //!< fWaveParam
+    ModWaveAlphaStart,       //!< fModWaveAlphaStart
+    ModWaveAlphaEnd,         //!< fModWaveAlphaEnd
+    WarpAnimSpeed,           //!< fWarpAnimSpeed
+    WarpScale,               //!< fWarpScale
+    ZoomExponent,            //!< fZoomExponent
+    Shader,                  //!< fShader
+    Zoom,                    //!< zoom
+    Rot,                     //!< rot
+    RotCX,                   //!< cx
+    RotCY,                   //!< cy
+    XPush,                   //!< dx
+    YPush,                   //!< dy
+    WarpAmount,              //!< warp
+    StretchX,                //!< sx
+    StretchY,                //!< sy
+    WaveR,                   //!< wave_r
+    WaveG,                   //!< wave_g
+    WaveB,                   //!< wave_b
+    WaveA,                   //!< wave_a (Milkdrop 1.x, unused)
+    WaveX,                   //!< wave_x
+    WaveY,                   //!< wave_y
+    OuterBorderSize,         //!< ob_size
+    OuterBorderR,            //!< ob_r
+    OuterBorderG,            //!< ob_g
+    OuterBorderB,            //!< ob_b
+    OuterBorderA,            //!< ob_a
+    InnerBorderSize,         //!< ib_size
+    InnerBorderR,            //!< ib_r
+    InnerBorderG,            //!< ib_g
+    InnerBorderB,            //!< ib_b
+    InnerBorderA,            //!< ib_a
+    MotionVectorsX,          //!< nMotionVectorsX
+    MotionVectorsY,          //!< nMotionVectorsY
+    MotionVectorsDX,         //!< mv_dx
+    MotionVectorsDY,         //!< mv_dy
+    MotionVectorsL,          //!< mv_l
+    MotionVectorsR,          //!< mv_r
+    MotionVectorsG,          //!< mv_g
+    MotionVectorsB,          //!< mv_b
+    MotionVectorsA,          //!< mv_a
+    Blur1Min,                //!< b1n
+    Blur2Min,                //!< b2n
+    Blur3Min,                //!< b3n
+    Blur1Max,                //!< b1x
+    Blur2Max,                //!< b2x
+    Blur3Max,                //!< b3x
+    Blur1EdgeDarken,         //!< b1ed
+    Count                    //!< Number of keys, not a valid key.
+};
+
+/**
+ * @brief Per-waveform keys, stored as "wavecode_N_<key>" in the preset file.
+ */
+enum class WaveKey : uint16_t
+{
+    Enabled,   //!< enabled
+    Samples,   //!< samples
+    Sep,       //!< sep
+    Spectrum,  //!< bSpectrum
+    UseDots,   //!< bUseDots
+    DrawThick, //!< bDrawThick
+    Additive,  //!< bAdditive
+    Scaling,   //!< scaling
+    Smoothing, //!< smoothing
+    R,         //!< r
+    G,         //!< g
+    B,         //!< b
+    A,         //!< a
+    Mode,      //!< mode (written by some editors, unused)
+    X,         //!< x (written by some editors, unused)
+    Y,         //!< y (written by some editors, unused)
+    Count      //!< Number of keys, not a valid key.
+};
+
+/**
+ * @brief Per-shape keys, stored as "shapecode_N_<key>" in the preset file.
+ */
+enum class ShapeKey : uint16_t
+{
+    Enabled,      //!< enabled
+    Sides,        //!< sides
+    Additive,     //!< additive
+    ThickOutline, //!< thickOutline
+    Textured,     //!< textured
+    Instances,    //!< num_inst
+    X,            //!< x
+    Y,            //!< y
+    Radius,       //!< rad
+    Angle,        //!< ang
+    TexAngle,     //!< tex_ang
+    TexZoom,      //!< tex_zoom
+    R,            //!< r
+    G,            //!< g
+    B,            //!< b
+    A,            //!< a
+    R2,           //!< r2
+    G2,           //!< g2
+    B2,           //!< b2
+    A2,           //!< a2
+    BorderR,      //!< border_r
+    BorderG,      //!< border_g
+    BorderB,      //!< border_b
+    BorderA,      //!< border_a
+    Image,        //!< image (projectM addition)
+    Count         //!< Number of keys, not a valid key.
+};
+
+/**
+ * @brief A dense index into the table of all known preset keys.
+ */
+struct PresetKeySlot {
+    uint16_t index{}; //!< The slot index.
+};
+
+/**
+ * @brief Maps known preset keys to dense slots and back.
+ *
+ * Slots are laid out as all global keys, followed by the keys of each custom waveform and then
+ * the keys of each custom shape.
+ */
+class PresetKeyTable
+{
+public:
+    static constexpr int GlobalKeyCount = static_cast<int>(PresetKey::Count);                         //!< Number of global keys.
+    static constexpr int WaveKeyCount = static_cast<int>(WaveKey::Count);                             //!< Number of keys per custom waveform.
+    static constexpr int ShapeKeyCount = static_cast<int>(ShapeKey::Count);                           //!< Number of keys per custom shape.
+    static constexpr int WaveSlotOffset = GlobalKeyCount;                                             //!< First slot of the custom waveform keys.
+    static constexpr int ShapeSlotOffset = WaveSlotOffset + WaveKeyCount * CustomWaveformCount;       //!< First slot of the custom shape keys.
+    static constexpr int SlotCount = ShapeSlotOffset + ShapeKeyCount * CustomShapeCount;              //!< Total number of slots.
+
+    PresetKeyTable() = delete;
+
+    /**
+     * @brief Returns the slot of a global key.
+     * @param key The key.
+     * @return The key slot.
+     */
+    static constexpr auto Slot(PresetKey key) -> PresetKeySlot
+    {
+        return {static_cast<uint16_t>(key)};
+    }
+
+    /**
+     * @brief Returns the slot of a custom waveform key.
+     * @param key The key.
+     * @param waveIndex The custom waveform index, 0 to CustomWaveformCount - 1.
+     * @return The key slot.
+     */
+    static constexpr auto Slot(WaveKey key, int waveIndex) -> PresetKeySlot
+    {
+        return {static_cast<uint16_t>(WaveSlotOffset + waveIndex * WaveKeyCount + static_cast<int>(key))};
+    }
+
+    /**
+     * @brief Returns the slot of a custom shape key.
+     * @param key The key.
+     * @param shapeIndex The custom shape index, 0 to CustomShapeCount - 1.
+     * @return The key slot.
+     */
+    static constexpr auto Slot(ShapeKey key, int shapeIndex) -> PresetKeySlot
+    {
+        return {static_cast<uint16_t>(ShapeSlotOffset + shapeIndex * ShapeKeyCount + static_cast<int>(key))};
+    }
+
+    /**
+     * @brief Resolves a lower-case preset file key to its slot.
+     * @param key The lower-case key, doesn't need to be null-terminated.
+     * @param length The key length in characters.
+     * @return The key slot or -1 if the key is not a known preset key.
+     */
+    static auto Find(const char* key, size_t length) -> int;
+
+    /**
+     * @brief Returns the preset file key name for the given slot.
+     * @param slot The key slot.
+     * @return The key as written by Milkdrop, e.g. "fDecay" or "wavecode_0_bSpectrum".
+     */
+    static auto Name(PresetKeySlot slot) -> std::string;
+};
+
+} // namespace MilkdropPreset
+} // namespace libprojectM
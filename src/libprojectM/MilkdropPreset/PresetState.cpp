@@ -1,7 +1,7 @@
 #include "PresetState.hpp"
 
 #include "MilkdropStaticShaders.hpp"
-#include "PresetFileParser.hpp"
+#include "PresetDataSource.hpp"
 
 #include <Renderer/ShaderCache.hpp>
 
@@ -12,8 +12,8 @@
 namespace libprojectM {
 namespace MilkdropPreset {
 
-const glm::mat4 PresetState::orthogonalProjection = glm::ortho(-1.0f, 1.0f, 1.0f, -1.0f, -40.0f, 40.0f);
-const glm::mat4 PresetState::orthogonalProjectionFlipped = glm::ortho(-1.0f, 1.0f, -1.0f, 1.0f, -40.0f, 40.0f);
+const glm::mat4 PresetState::orthogonalProjection = glm::ortho(-1.0f, 1.0f, -1.0f, 1.0f, -40.0f, 40.0f);
+const glm::mat4 PresetState::orthogonalProjectionFlipped = glm::ortho(-1.0f, 1.0f, 1.0f, -1.0f, -40.0f, 40.0f);
 
 PresetState::PresetState()
     : globalMemory(projectm_eval_memory_buffer_create())
@@ -33,88 +33,88 @@ PresetState::~PresetState()
     projectm_eval_memory_buffer_destroy(globalMemory);
 }
 
-void PresetState::Initialize(PresetFileParser& parsedFile)
+void PresetState::Initialize(const PresetDataSource& parsedFile)
 {
 
     // General:
-    decay = parsedFile.GetFloat("fDecay", decay);
-    gammaAdj = parsedFile.GetFloat("fGammaAdj", gammaAdj);
-    videoEchoZoom = parsedFile.GetFloat("fVideoEchoZoom", videoEchoZoom);
-    videoEchoAlpha = parsedFile.GetFloat("fVideoEchoAlpha", videoEchoAlpha);
-    videoEchoOrientation = parsedFile.GetInt("nVideoEchoOrientation", videoEchoOrientation);
-    redBlueStereo = parsedFile.GetBool("bRedBlueStereo", redBlueStereo);
-    brighten = parsedFile.GetBool("bBrighten", brighten);
-    darken = parsedFile.GetBool("bDarken", darken);
-    solarize = parsedFile.GetBool("bSolarize", solarize);
-    invert = parsedFile.GetBool("bInvert", invert);
-    shader = parsedFile.GetFloat("fShader", shader);
-    blur1Min = parsedFile.GetFloat("b1n", blur1Min);
-    blur2Min = parsedFile.GetFloat("b2n", blur2Min);
-    blur3Min = parsedFile.GetFloat("b3n", blur3Min);
-    blur1Max = parsedFile.GetFloat("b1x", blur1Max);
-    blur2Max = parsedFile.GetFloat("b2x", blur2Max);
-    blur3Max = parsedFile.GetFloat("b3x", blur3Max);
-    blur1EdgeDarken = parsedFile.GetFloat("b1ed", blur1EdgeDarken);
+    decay = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::Decay), decay);
+    gammaAdj = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::GammaAdj), gammaAdj);
+    videoEchoZoom = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::VideoEchoZoom), videoEchoZoom);
+    videoEchoAlpha = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::VideoEchoAlpha), videoEchoAlpha);
+    videoEchoOrientation = parsedFile.GetInt(PresetKeyTable::Slot(PresetKey::VideoEchoOrientation), videoEchoOrientation);
+    redBlueStereo = parsedFile.GetBool(PresetKeyTable::Slot(PresetKey::RedBlueStereo), redBlueStereo);
+    brighten = parsedFile.GetBool(PresetKeyTable::Slot(PresetKey::Brighten), brighten);
+    darken = parsedFile.GetBool(PresetKeyTable::Slot(PresetKey::Darken), darken);
+    solarize = parsedFile.GetBool(PresetKeyTable::Slot(PresetKey::Solarize), solarize);
+    invert = parsedFile.GetBool(PresetKeyTable::Slot(PresetKey::Invert), invert);
+    shader = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::Shader), shader);
+    blur1Min = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::Blur1Min), blur1Min);
+    blur2Min = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::Blur2Min), blur2Min);
+    blur3Min = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::Blur3Min), blur3Min);
+    blur1Max = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::Blur1Max), blur1Max);
+    blur2Max = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::Blur2Max), blur2Max);
+    blur3Max = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::Blur3Max), blur3Max);
+    blur1EdgeDarken = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::Blur1EdgeDarken), blur1EdgeDarken);
 
     // Wave:
-    waveMode = parsedFile.GetInt("nWaveMode", waveMode);
-    additiveWaves = parsedFile.GetBool("bAdditiveWaves", additiveWaves);
-    waveDots = parsedFile.GetBool("bWaveDots", waveDots);
-    waveThick = parsedFile.GetBool("bWaveThick", waveThick);
-    modWaveAlphaByvolume = parsedFile.GetBool("bModWaveAlphaByVolume", modWaveAlphaByvolume);
-    maximizeWaveColor = parsedFile.GetBool("bMaximizeWaveColor", maximizeWaveColor);
-    waveAlpha = parsedFile.GetFloat("fWaveAlpha", waveAlpha);
-    waveScale = parsedFile.GetFloat("fWaveScale", waveScale);
-    waveSmoothing = parsedFile.GetFloat("fWaveSmoothing", waveSmoothing);
-    waveParam = parsedFile.GetFloat("fWaveParam", waveParam);
-    modWaveAlphaStart = parsedFile.GetFloat("fModWaveAlphaStart", modWaveAlphaStart);
-    modWaveAlphaEnd = parsedFile.GetFloat("fModWaveAlphaEnd", modWaveAlphaEnd);
-    waveR = parsedFile.GetFloat("wave_r", waveR);
-    waveG = parsedFile.GetFloat("wave_g", waveG);
-    waveB = parsedFile.GetFloat("wave_b", waveB);
-    waveX = parsedFile.GetFloat("wave_x", waveX);
-    waveY = parsedFile.GetFloat("wave_y", waveY);
-    mvX = parsedFile.GetFloat("nMotionVectorsX", mvX);
-    mvY = parsedFile.GetFloat("nMotionVectorsY", mvY);
-    mvDX = parsedFile.GetFloat("mv_dx", mvDX);
-    mvDY = parsedFile.GetFloat("mv_dy", mvDY);
-    mvL = parsedFile.GetFloat("mv_l", mvL);
-    mvR = parsedFile.GetFloat("mv_r", mvR);
-    mvG = parsedFile.GetFloat("mv_g", mvG);
-    mvB = parsedFile.GetFloat("mv_b", mvB);
-    mvA = parsedFile.GetBool("bMotionVectorsOn", false) ? 1.0f : 0.0f; // for backwards compatibility
-    mvA = parsedFile.GetFloat("mv_a", mvA);
+    waveMode = parsedFile.GetInt(PresetKeyTable::Slot(PresetKey::WaveMode), waveMode);
+    additiveWaves = parsedFile.GetBool(PresetKeyTable::Slot(PresetKey::AdditiveWaves), additiveWaves);
+    waveDots = parsedFile.GetBool(PresetKeyTable::Slot(PresetKey::WaveDots), waveDots);
+    waveThick = parsedFile.GetBool(PresetKeyTable::Slot(PresetKey::WaveThick), waveThick);
+    modWaveAlphaByvolume = parsedFile.GetBool(PresetKeyTable::Slot(PresetKey::ModWaveAlphaByVolume), modWaveAlphaByvolume);
+    maximizeWaveColor = parsedFile.GetBool(PresetKeyTable::Slot(PresetKey::MaximizeWaveColor), maximizeWaveColor);
+    waveAlpha = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::WaveAlpha), waveAlpha);
+    waveScale = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::WaveScale), waveScale);
+    waveSmoothing = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::WaveSmoothing), waveSmoothing);
+    waveParam = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::WaveParam), waveParam);
+    modWaveAlphaStart = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::ModWaveAlphaStart), modWaveAlphaStart);
+    modWaveAlphaEnd = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::ModWaveAlphaEnd), modWaveAlphaEnd);
+    waveR = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::WaveR), waveR);
+    waveG = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::WaveG), waveG);
+    waveB = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::WaveB), waveB);
+    waveX = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::WaveX), waveX);
+    waveY = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::WaveY), waveY);
+    mvX = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::MotionVectorsX), mvX);
+    mvY = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::MotionVectorsY), mvY);
+    mvDX = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::MotionVectorsDX), mvDX);
+    mvDY = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::MotionVectorsDY), mvDY);
+    mvL = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::MotionVectorsL), mvL);
+    mvR = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::MotionVectorsR), mvR);
+    mvG = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::MotionVectorsG), mvG);
+    mvB = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::MotionVectorsB), mvB);
+    mvA = parsedFile.GetBool(PresetKeyTable::Slot(PresetKey::MotionVectorsOn), false) ? 1.0f : 0.0f; // for backwards compatibility
+    mvA = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::MotionVectorsA), mvA);
 
     // Motion:
-    zoom = parsedFile.GetFloat("zoom", zoom);
-    rot = parsedFile.GetFloat("rot", rot);
-    rotCX = parsedFile.GetFloat("cx", rotCX);
-    rotCY = parsedFile.GetFloat("cy", rotCY);
-    xPush = parsedFile.GetFloat("dx", xPush);
-    yPush = parsedFile.GetFloat("dy", yPush);
-    warpAmount = parsedFile.GetFloat("warp", warpAmount);
-    stretchX = parsedFile.GetFloat("sx", stretchX);
-    stretchY = parsedFile.GetFloat("sy", stretchY);
-    texWrap = parsedFile.GetBool("bTexWrap", texWrap);
-    darkenCenter = parsedFile.GetBool("bDarkenCenter", darkenCenter);
-    warpAnimSpeed = parsedFile.GetFloat("fWarpAnimSpeed", warpAnimSpeed);
-    warpScale = parsedFile.GetFloat("fWarpScale", warpScale);
-    zoomExponent = parsedFile.GetFloat("fZoomExponent", zoomExponent);
+    zoom = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::Zoom), zoom);
+    rot = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::Rot), rot);
+    rotCX = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::RotCX), rotCX);
+    rotCY = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::RotCY), rotCY);
+    xPush = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::XPush), xPush);
+    yPush = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::YPush), yPush);
+    warpAmount = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::WarpAmount), warpAmount);
+    stretchX = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::StretchX), stretchX);
+    stretchY = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::StretchY), stretchY);
+    texWrap = parsedFile.GetBool(PresetKeyTable::Slot(PresetKey::TexWrap), texWrap);
+    darkenCenter = parsedFile.GetBool(PresetKeyTable::Slot(PresetKey::DarkenCenter), darkenCenter);
+    warpAnimSpeed = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::WarpAnimSpeed), warpAnimSpeed);
+    warpScale = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::WarpScale), warpScale);
+    zoomExponent = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::ZoomExponent), zoomExponent);
 
     // Borders:
-    outerBorderSize = parsedFile.GetFloat("ob_size", outerBorderSize);
-    outerBorderR = parsedFile.GetFloat("ob_r", outerBorderR);
-    outerBorderG = parsedFile.GetFloat("ob_g", outerBorderG);
-    outerBorderB = parsedFile.GetFloat("ob_b", outerBorderB);
-    outerBorderA = parsedFile.GetFloat("ob_a", outerBorderA);
-    innerBorderSize = parsedFile.GetFloat("ib_size", innerBorderSize);
-    innerBorderR = parsedFile.GetFloat("ib_r", innerBorderR);
-    innerBorderG = parsedFile.GetFloat("ib_g", innerBorderG);
-    innerBorderB = parsedFile.GetFloat("ib_b", innerBorderB);
-    innerBorderA = parsedFile.GetFloat("ib_a", innerBorderA);
+    outerBorderSize = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::OuterBorderSize), outerBorderSize);
+    outerBorderR = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::OuterBorderR), outerBorderR);
+    outerBorderG = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::OuterBorderG), outerBorderG);
+    outerBorderB = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::OuterBorderB), outerBorderB);
+    outerBorderA = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::OuterBorderA), outerBorderA);
+    innerBorderSize = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::InnerBorderSize), innerBorderSize);
+    innerBorderR = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::InnerBorderR), innerBorderR);
+    innerBorderG = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::InnerBorderG), innerBorderG);
+    innerBorderB = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::InnerBorderB), innerBorderB);
+    innerBorderA = parsedFile.GetFloat(PresetKeyTable::Slot(PresetKey::InnerBorderA), innerBorderA);
 
     // Versions:
-    presetVersion = parsedFile.GetInt("MILKDROP_PRESET_VERSION", presetVersion);
+    presetVersion = parsedFile.GetInt(PresetKeyTable::Slot(PresetKey::PresetVersion), presetVersion);
     if (presetVersion < 200)
     {
         // Milkdrop 1.x did not use shaders.
@@ -124,13 +124,13 @@ void PresetState::Initialize(PresetFileParser& parsedFile)
     else if (presetVersion == 200)
     {
         // Milkdrop 2.0 only supported a single shader language level variable.
-        warpShaderVersion = parsedFile.GetInt("PSVERSION", warpShaderVersion);
-        compositeShaderVersion = parsedFile.GetInt("PSVERSION", compositeShaderVersion);
+        warpShaderVersion = parsedFile.GetInt(PresetKeyTable::Slot(PresetKey::PsVersion), warpShaderVersion);
+        compositeShaderVersion = parsedFile.GetInt(PresetKeyTable::Slot(PresetKey::PsVersion), compositeShaderVersion);
     }
     else
     {
-        warpShaderVersion = parsedFile.GetInt("PSVERSION_WARP", warpShaderVersion);
-        compositeShaderVersion = parsedFile.GetInt("PSVERSION_COMP", compositeShaderVersion);
+        warpShaderVersion = parsedFile.GetInt(PresetKeyTable::Slot(PresetKey::PsVersionWarp), warpShaderVersion);
+        compositeShaderVersion = parsedFile.GetInt(PresetKeyTable::Slot(PresetKey::PsVersionComp), compositeShaderVersion);
     }
 
     // Code:
@@ -7,6 +7,7 @@
 
 #include "Constants.hpp"
 
+#include "AudioTexture.hpp"
 #include "BlurTexture.hpp"
 
 #include <Audio/FrameAudioData.hpp>
@@ -22,7 +23,7 @@
 namespace libprojectM {
 namespace MilkdropPreset {
 
-class PresetFileParser;
+class PresetDataSource;
 
 using BlendableFloat = float; //!< Currently a placeholder to mark blendable values.
 
@@ -41,9 +42,9 @@ public:
 
     /**
      * @brief Loads the initial values and code from the preset file.
-     * @param parsedFile The file parser with the preset data.
+     * @param parsedFile The parsed or precompiled preset data.
      */
-    void Initialize(PresetFileParser& parsedFile);
+    void Initialize(const PresetDataSource& parsedFile);
 
     /**
      * @brief Loads or compiles the generic shaders.
@@ -158,11 +159,12 @@ public:
 
     std::weak_ptr<Renderer::Texture> mainTexture; //!< A weak reference to the main texture in the preset framebuffer.
     BlurTexture blurTexture;                      //!< The blur textures used in this preset. Contents depend on the shader code using GetBlurX().
+    AudioTexture audioTexture;                    //!< Waveform and spectrum data of the current frame, exposed to preset shaders as "sampler_audio".
 
     std::map<int, Renderer::TextureSamplerDescriptor> randomTextureDescriptors; //!< Descriptors for random texture IDs. Should be the same across both warp and comp shaders.
 
-    static const glm::mat4 orthogonalProjection;        //!< Projection matrix that transforms DirectX screen-space coordinates into the OpenGL coordinate frame.
-    static const glm::mat4 orthogonalProjectionFlipped; //!< Projection matrix that transforms DirectX screen-space coordinates into the OpenGL coordinate frame.
+    static const glm::mat4 orthogonalProjection;        //!< Projection matrix that transforms DirectX screen-space coordinates into the OpenGL coordinate frame, keeping the DirectX row order. Images are stored top row first, as Milkdrop's shaders sample them.
+    static const glm::mat4 orthogonalProjectionFlipped; //!< Same as orthogonalProjection, but for coordinates with the y axis pointing up.
 };
 
 } // namespace MilkdropPreset
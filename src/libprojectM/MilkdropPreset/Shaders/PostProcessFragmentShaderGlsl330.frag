@@ -0,0 +1,47 @@
+precision mediump float;
+
+// Specialization constants, see PostProcess::GetShader():
+// USE_ECHO: 1 if the video echo image is drawn
+// ECHO_ORIENTATION: echo image flip mode, 0 = none, 1 = horizontal, 2 = vertical, 3 = both
+// BRIGHTEN, DARKEN, SOLARIZE, INVERT: 1 if the filter is enabled
+
+in vec4 fragment_color;
+in vec2 fragment_texture;
+
+uniform sampler2D texture_sampler;
+uniform float echo_scale;   // echo image u/v scale around the center
+uniform float echo_alpha;   // echo image opacity
+uniform float gamma;        // brightness multiplier
+uniform float alpha_gain;   // number of times the image alpha was accumulated by the multi-pass effects
+
+out vec4 color;
+
+void main(){
+    vec4 image = texture(texture_sampler, fragment_texture);
+
+#if USE_ECHO
+    vec2 echoFlip = vec2(ECHO_ORIENTATION % 2 == 1 ? -1.0 : 1.0, ECHO_ORIENTATION >= 2 ? -1.0 : 1.0);
+    vec4 echo = texture(texture_sampler, 0.5 + (fragment_texture - 0.5) * echo_scale * echoFlip);
+    vec3 rgb = image.rgb * (1.0 - echo_alpha) + echo.rgb * echo_alpha;
+    float alpha = image.a + echo.a;
+#else
+    vec3 rgb = image.rgb;
+    float alpha = image.a;
+#endif
+
+    // The framebuffer used to clamp each additive pass, so clamp before applying the filters.
+    color = clamp(vec4(rgb * fragment_color.rgb * gamma, alpha * alpha_gain), 0.0, 1.0);
+
+#if BRIGHTEN
+    color = 1.0 - (1.0 - color) * (1.0 - color);
+#endif
+#if DARKEN
+    color = color * color;
+#endif
+#if SOLARIZE
+    color = 2.0 * color * (1.0 - color);
+#endif
+#if INVERT
+    color = 1.0 - color;
+#endif
+}
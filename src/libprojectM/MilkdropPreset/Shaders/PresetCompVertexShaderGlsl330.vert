@@ -1,10 +1,11 @@
 precision mediump float;
 
 layout(location = 0) in vec2 vertex_position;
-layout(location = 1) in vec4 vertex_color;
 layout(location = 2) in vec2 vertex_texture;
 layout(location = 3) in vec2 vertex_rad_ang;
 
+uniform mat4 hue_shader_colors; // hue colors of the four screen corners, one per column
+
 out vec4 frag_COLOR;
 out vec2 frag_TEXCOORD0;
 out vec2 frag_TEXCOORD1;
@@ -12,7 +13,13 @@ out vec2 frag_TEXCOORD1;
 void main(){
     vec4 position = vec4(vertex_position, 0.0, 1.0);
     gl_Position = position;
-    frag_COLOR = vertex_color;
+
+    // Blend the corner colors bilinearly across the screen.
+    vec2 corner = vertex_position * 0.5 + 0.5;
+    frag_COLOR = hue_shader_colors[0] * corner.x * corner.y +
+                 hue_shader_colors[1] * (1.0 - corner.x) * corner.y +
+                 hue_shader_colors[2] * corner.x * (1.0 - corner.y) +
+                 hue_shader_colors[3] * (1.0 - corner.x) * (1.0 - corner.y);
     frag_TEXCOORD0 = vertex_texture;
     frag_TEXCOORD1 = vertex_rad_ang;
 }
@@ -1,29 +1,37 @@
 precision mediump float;
 
-layout(location = 0) in vec2 vertex_position;
 layout(location = 1) in vec4 vertex_color;
 
 uniform mat4 vertex_transformation;
 uniform float length_multiplier;
 uniform float minimum_length;
+uniform vec2 grid_scale;
+uniform vec2 grid_offset;
 
 uniform sampler2D warp_coordinates;
 
 out vec4 fragment_color;
 
 void main() {
-    // Input positions are given in texture coordinates (0...1), not the usual
-    // screen coordinates.
-    vec2 pos = vertex_position;
+    // Each instance draws one grid row, with one line per two vertices. Positions are
+    // calculated in texture coordinates (0...1), not the usual screen coordinates.
+    vec2 pos = (vec2(float(gl_VertexID / 2), float(gl_InstanceID)) + 0.25) * grid_scale + grid_offset;
+
+    // Skip vectors outside the visible area by moving both line vertices outside the clip volume.
+    if (pos.x <= 0.0001 || pos.x >= 0.9999 || pos.y <= 0.0001 || pos.y >= 0.9999)
+    {
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+        fragment_color = vertex_color;
+        return;
+    }
 
     if (gl_VertexID % 2 == 1)
     {
         // Reverse propagation using the u/v texture written in the previous frame.
         // Milkdrop's original code did a simple bilinear interpolation, but here it was already
         // done by the fragment shader during the warp mesh drawing. We just need to look up the
-        // motion vector coordinate.
-        // We simply invert the y coordinate because it's easier than flipping the u/v texture.
-        vec2 oldUV = texture(warp_coordinates, vec2(pos.x, 1.0 - pos.y)).xy;
+        // motion vector coordinate. The u/v texture is stored top row first, like the frame image.
+        vec2 oldUV = texture(warp_coordinates, pos).xy;
 
         // Enforce minimum trail length
         vec2 dist = oldUV - pos;
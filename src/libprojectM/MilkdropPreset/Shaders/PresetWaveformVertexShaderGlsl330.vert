@@ -0,0 +1,159 @@
+precision highp float;
+
+// Specialization constants, see Waveform::GetShader():
+// WAVE_MODE: the WaveformMode enum value
+
+layout(location = 1) in vec4 vertex_color;
+
+uniform mat4 vertex_transformation;
+uniform float vertex_point_size;
+uniform vec2 thick_offset;
+
+uniform sampler2D wave_samples; // scaled and smoothed left/right samples in r/g, see WaveformMath::SmoothSamples()
+uniform int wave_index;         // 0 for the first wave, 1 for the second wave of two-wave modes
+uniform int sample_count;       // number of waveform points before smoothing
+uniform int sample_offset;      // offset of the first displayed sample
+
+uniform vec2 aspect;
+uniform vec2 wave_position;
+uniform float mystery;
+uniform float time;
+uniform float skew_angle;
+
+// Line-based waveforms
+uniform vec2 line_edge;
+uniform vec2 line_distance;
+uniform vec2 line_perpendicular;
+
+out vec4 fragment_color;
+
+// Returns the scaled and smoothed left/right sample. The IIR smoothing filter depends on all
+// previous samples, so it's applied once per frame on the CPU instead of for each vertex.
+vec2 Sample(int index)
+{
+    return texelFetch(wave_samples, ivec2(min(index, 511), 0), 0).rg;
+}
+
+vec2 CircularPoint(float radius, float angle)
+{
+    return vec2(radius * cos(angle) * aspect.y, radius * sin(angle) * aspect.x) + wave_position;
+}
+
+vec2 LinePoint(int index, float amplitude)
+{
+    return line_edge + line_distance * float(index) + line_perpendicular * amplitude;
+}
+
+// Calculates the unsmoothed waveform point with the given index.
+vec2 WavePoint(int index)
+{
+    float samples = float(sample_count);
+    float sampleIndex = float(index);
+
+#if WAVE_MODE == 0 // Circle
+    float radius = 0.5 + 0.4 * Sample(index + sample_offset).y + mystery;
+    float angle = sampleIndex / samples * 6.28 + time * 0.2;
+    if (index < sample_count / 10)
+    {
+        float mixFactor = 0.5 - 0.5 * cos(sampleIndex / (samples * 0.1) * 3.1416);
+        float radius2 = 0.5 + 0.4 * Sample(index + sample_count + sample_offset).y + mystery;
+        radius = radius2 * (1.0 - mixFactor) + radius * mixFactor;
+    }
+    return CircularPoint(radius, angle);
+#elif WAVE_MODE == 1 // XYOscillationSpiral
+    float radius = 0.53 + 0.43 * Sample(index).y + mystery;
+    float angle = Sample(index + 32).x * 1.57 + time * 2.3;
+    return CircularPoint(radius, angle);
+#elif WAVE_MODE == 2 || WAVE_MODE == 3 // CenteredSpiro / CenteredSpiroVolume
+    return vec2(Sample(index).y * aspect.y, Sample(index + 32).x * aspect.x) + wave_position;
+#elif WAVE_MODE == 5 // ExplosiveHash
+    vec2 sample1 = Sample(index);
+    vec2 sample2 = Sample(index + 32);
+    float x0 = sample1.y * sample2.x + sample1.x * sample2.y;
+    float y0 = sample1.y * sample1.y - sample2.x * sample2.x;
+    float cosineRotation = cos(time * 0.3);
+    float sineRotation = sin(time * 0.3);
+    return vec2((x0 * cosineRotation - y0 * sineRotation) * aspect.y,
+                (x0 * sineRotation + y0 * cosineRotation) * aspect.x) + wave_position;
+#elif WAVE_MODE == 6 // Line
+    return LinePoint(index, 0.25 * Sample(index + sample_offset).x);
+#elif WAVE_MODE == 7 // DoubleLine
+    float separation = pow(wave_position.y * 0.5 + 0.5, 2.0);
+    if (wave_index == 0)
+    {
+        return LinePoint(index, 0.25 * Sample(index + sample_offset).x + separation);
+    }
+    return LinePoint(index, 0.25 * Sample(index + sample_offset).y - separation);
+#elif WAVE_MODE == 8 // SpectrumLine
+    return LinePoint(index, 0.1 * log(Sample(index * 2).x + Sample(index * 2 + 1).x));
+#elif WAVE_MODE == 9 // Milkdrop2077Wave9
+    return LinePoint(index, 0.35 * Sample(index + sample_offset).x);
+#elif WAVE_MODE == 10 // Milkdrop2077WaveX
+    vec2 amplitudes = Sample(index + sample_offset);
+    return LinePoint(index, 0.35 * (wave_index == 0 ? amplitudes.x : amplitudes.y));
+#elif WAVE_MODE == 11 // Milkdrop2077Wave11
+    vec2 amplitudes = Sample(index + sample_offset);
+    if (wave_index == 0)
+    {
+        return LinePoint(index, 0.35 * amplitudes.x) - vec2(0.45, 0.0);
+    }
+    return LinePoint(index, 0.35 * amplitudes.y) + vec2(0.45, 0.0);
+#elif WAVE_MODE == 12 // Milkdrop2077WaveSkewed
+    float radius = 0.63 + 0.23 * Sample(index).y + mystery;
+    float angle = Sample(index + 32).x * 0.9 + time * 3.3;
+    return vec2(radius * cos(angle + skew_angle) * aspect.y, radius * sin(angle) * aspect.x) + wave_position;
+#elif WAVE_MODE == 13 // Milkdrop2077WaveStar
+    float radius = 0.7 + 0.4 * Sample(index + sample_offset).y + mystery;
+    float angle = sampleIndex / (samples - 1.0) * 6.28 + time * 0.2;
+    if (sampleIndex < samples / radius)
+    {
+        float mixFactor = 0.5 - 0.5 * cos(sampleIndex / (samples * 0.1) * 3.1416);
+        float radius2 = 0.5 + 0.4 * Sample(index + sample_count - sample_offset).y + mystery;
+        radius = radius2 * (1.0 - mixFactor) + radius * mixFactor;
+    }
+    return CircularPoint(radius, angle);
+#elif WAVE_MODE == 14 // Milkdrop2077WaveFlower
+    float radius = 0.7 + 0.7 * Sample(index + sample_offset).y + mystery;
+    float angle = sampleIndex / (samples - 1.0) * 6.28 + time * 0.2;
+    if (sampleIndex < samples / radius)
+    {
+        float mixFactor = 0.7 - 0.7 * cos(sampleIndex / (samples * 0.1) * 3.1416);
+        float radius2 = 0.7 + 0.7 * Sample(index + sample_count - sample_offset).y + mystery;
+        radius = radius2 * (1.0 - mixFactor) + radius * mixFactor * 0.25;
+    }
+    return vec2(radius * cos(angle * 3.1416) * aspect.y / 1.5 + wave_position.x * cos(3.1416),
+                radius * sin(angle - time / 3.0) * aspect.x / 1.5 + wave_position.y * cos(3.1416));
+#elif WAVE_MODE == 15 // Milkdrop2077WaveLasso
+    float angle = Sample(index + 32).x * 1.57 + time * 2.0;
+    return vec2(cos(time) / 2.0 + cos(angle * 2.0 + tan(time / angle)),
+                sin(time) * 2.0 * sin(angle * 3.14) * aspect.x / 2.8 + wave_position.y);
+#else
+    return vec2(0.0);
+#endif
+}
+
+void main(){
+    // Each wave is drawn with 2 * sample_count - 1 vertices. Even vertices are the waveform points,
+    // odd vertices are interpolated with a better-than-linear smoothing filter.
+    int index = gl_VertexID / 2;
+    vec2 position;
+    if (gl_VertexID % 2 == 0)
+    {
+        position = WavePoint(index);
+    }
+    else
+    {
+        int lastIndex = sample_count - 1;
+        position = (-0.15 * WavePoint(max(index - 1, 0)) +
+                    1.15 * WavePoint(index) +
+                    1.15 * WavePoint(min(index + 1, lastIndex)) +
+                    -0.15 * WavePoint(min(index + 2, lastIndex))) / 2.0;
+    }
+
+    // Thick lines and dots are drawn as 4 instances, offset to the right, bottom right and bottom.
+    vec2 offset = vec2(float((gl_InstanceID + 1) / 2 % 2), float(gl_InstanceID / 2)) * thick_offset;
+
+    gl_Position = vertex_transformation * vec4(position + offset, 0.0, 1.0);
+    gl_PointSize = vertex_point_size;
+    fragment_color = vertex_color;
+}
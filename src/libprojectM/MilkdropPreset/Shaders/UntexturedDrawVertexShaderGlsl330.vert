@@ -5,11 +5,16 @@ layout(location = 1) in vec4 vertex_color;
 
 uniform mat4 vertex_transformation;
 uniform float vertex_point_size;
+uniform vec2 thick_offset;
 
 out vec4 fragment_color;
 
 void main(){
-    gl_Position = vertex_transformation * vec4(vertex_position, 0.0, 1.0);
+    // Thick lines and dots are drawn as 4 instances, offset to the right, bottom right and bottom.
+    // The first instance, and thus any non-instanced draw, is never offset.
+    vec2 offset = vec2(float((gl_InstanceID + 1) / 2 % 2), float(gl_InstanceID / 2)) * thick_offset;
+
+    gl_Position = vertex_transformation * vec4(vertex_position + offset, 0.0, 1.0);
     gl_PointSize = vertex_point_size;
     fragment_color = vertex_color;
 }
@@ -1,11 +1,15 @@
 #include "Waveform.hpp"
 
+#include "MilkdropStaticShaders.hpp"
 #include "PerFrameContext.hpp"
 #include "PresetState.hpp"
 
 #include "Waveforms/Factory.hpp"
 
 #include <Renderer/BlendMode.hpp>
+#include <Renderer/GLStateCache.hpp>
+#include <Renderer/ShaderCache.hpp>
+#include <Renderer/ShaderDefines.hpp>
 
 #include <../Renderer/OpenGL.h>
 
@@ -18,6 +22,8 @@ namespace MilkdropPreset {
 Waveform::Waveform(PresetState& presetState)
     : m_presetState(presetState)
     , m_waveMesh(Renderer::VertexBufferUsage::StreamDraw)
+    , m_sampleTexture(std::make_shared<Renderer::Texture>("wave_samples", m_sampleTexels.data(), GL_TEXTURE_2D, WaveformMaxPoints, 1, 0,
+                                                          GL_RG32F, GL_RG, GL_FLOAT, false))
 {
 }
 
@@ -35,15 +41,10 @@ void Waveform::Draw(const PerFrameContext& presetPerFrameContext)
     }
 
 #ifndef USE_GLES
-    glDisable(GL_LINE_SMOOTH);
+    Renderer::GLStateCache::Current().SetCapability(GL_LINE_SMOOTH, false);
 #endif
     glLineWidth(1);
 
-    auto shader = m_presetState.untexturedShader.lock();
-    shader->Bind();
-    shader->SetUniformMat4x4("vertex_transformation", PresetState::orthogonalProjectionFlipped);
-    shader->SetUniformFloat("vertex_point_size", 1.0f);
-
     // Additive wave drawing (vice overwrite)
     if (m_presetState.additiveWaves)
     {
@@ -54,6 +55,86 @@ void Waveform::Draw(const PerFrameContext& presetPerFrameContext)
         Renderer::BlendMode::Set(true, Renderer::BlendMode::Function::SourceAlpha, Renderer::BlendMode::Function::OneMinusSourceAlpha);
     }
 
+    m_tempAlpha = static_cast<float>(*presetPerFrameContext.wave_a);
+    MaximizeColors(presetPerFrameContext);
+
+    // Always draw "thick" dots.
+    const auto instances = m_presetState.waveThick || m_presetState.waveDots ? 4 : 1;
+
+    const auto incrementX = 2.0f / static_cast<float>(m_presetState.renderContext.viewportSizeX);
+    const auto incrementY = 2.0f / static_cast<float>(m_presetState.renderContext.viewportSizeY);
+
+    if (m_waveformMath->UsesVertexShader())
+    {
+        m_waveformMath->UpdateParameters(m_presetState, presetPerFrameContext);
+        DrawWithVertexShader(incrementX, incrementY, instances);
+    }
+    else
+    {
+        DrawWithMesh(presetPerFrameContext, incrementX, incrementY, instances);
+    }
+
+    Renderer::BlendMode::SetBlendActive(false);
+    Renderer::Shader::Unbind();
+}
+
+void Waveform::DrawWithVertexShader(float incrementX, float incrementY, int instances)
+{
+    auto shader = GetShader();
+    shader->Bind();
+    shader->SetUniformMat4x4("vertex_transformation", PresetState::orthogonalProjectionFlipped);
+    shader->SetUniformFloat("vertex_point_size", 1.0f);
+
+    // If thick outline is used, draw the wave as four instances with slight offsets
+    // (top left, top right, bottom right, bottom left), see the waveform vertex shader.
+    shader->SetUniformFloat2("thick_offset", {incrementX, incrementY});
+
+    shader->SetUniformFloat("time", m_presetState.renderContext.time);
+
+    // Scale and smooth the samples once per frame. The shader only reads the results.
+    m_waveformMath->SmoothSamples(m_presetState);
+    m_waveformMath->InterleaveSamples(m_sampleTexels);
+    m_sampleTexture->Update(m_sampleTexels.data());
+
+    shader->SetUniformInt("wave_samples", 0);
+    m_sampleTexture->Bind(0, m_sampler);
+
+    GLenum const primitiveType = m_presetState.waveDots
+                                   ? GL_POINTS
+                               : m_waveformMath->IsLoop()
+                                   ? GL_LINE_LOOP
+                                   : GL_LINE_STRIP;
+
+    m_vertexArray.Bind();
+    for (int wave = 0; wave < m_waveformMath->WaveCount(); wave++)
+    {
+        m_waveformMath->SetUniforms(*shader, wave);
+        glDrawArraysInstanced(primitiveType, 0, m_waveformMath->VertexCount(), instances);
+        Renderer::GLStateCache::Current().CountDrawCall();
+    }
+    Renderer::VertexArray::Unbind();
+
+    m_sampleTexture->Unbind(0);
+    Renderer::Sampler::Unbind(0);
+}
+
+void Waveform::DrawWithMesh(const PerFrameContext& presetPerFrameContext, float incrementX, float incrementY, int instances)
+{
+    auto shader = m_presetState.untexturedShader.lock();
+    shader->Bind();
+    shader->SetUniformMat4x4("vertex_transformation", PresetState::orthogonalProjectionFlipped);
+    shader->SetUniformFloat("vertex_point_size", 1.0f);
+
+    // If thick outline is used, draw the wave as four instances with slight offsets
+    // (top left, top right, bottom right, bottom left), see the untextured vertex shader.
+    shader->SetUniformFloat2("thick_offset", {incrementX, incrementY});
+
+    m_waveMesh.SetRenderPrimitiveType(m_presetState.waveDots
+                                          ? Renderer::Mesh::PrimitiveType::Points
+                                      : m_waveformMath->IsLoop()
+                                          ? Renderer::Mesh::PrimitiveType::LineLoop
+                                          : Renderer::Mesh::PrimitiveType::LineStrip);
+
     auto smoothedVertices = m_waveformMath->GetVertices(m_presetState, presetPerFrameContext);
 
     for (auto& smoothedWave : smoothedVertices)
@@ -63,63 +144,45 @@ void Waveform::Draw(const PerFrameContext& presetPerFrameContext)
             continue;
         }
 
-        m_tempAlpha = static_cast<float>(*presetPerFrameContext.wave_a);
-        MaximizeColors(presetPerFrameContext);
+        m_waveMesh.Vertices().Set(smoothedWave);
+        m_waveMesh.Indices().Resize(smoothedWave.size());
+        m_waveMesh.Indices().MakeContinuous();
+        m_waveMesh.Update();
+        m_waveMesh.Draw(instances);
+    }
 
-        // Always draw "thick" dots.
-        const auto iterations = m_presetState.waveThick || m_presetState.waveDots ? 4 : 1;
+    Renderer::Mesh::Unbind();
+}
 
-        const auto incrementX = 2.0f / static_cast<float>(m_presetState.renderContext.viewportSizeX);
-        const auto incrementY = 2.0f / static_cast<float>(m_presetState.renderContext.viewportSizeY);
+auto Waveform::GetShader() -> std::shared_ptr<Renderer::Shader>
+{
+    auto shader = m_waveformShader.lock();
+    if (shader)
+    {
+        return shader;
+    }
 
-        m_waveMesh.SetRenderPrimitiveType(m_presetState.waveDots
-                                              ? Renderer::Mesh::PrimitiveType::Points
-                                          : m_waveformMath->IsLoop()
-                                              ? Renderer::Mesh::PrimitiveType::LineLoop
-                                              : Renderer::Mesh::PrimitiveType::LineStrip);
+    // The wave mode doesn't change while the preset is running, so only its code is compiled into the shader.
+    Renderer::ShaderDefines defines;
+    defines.Set("WAVE_MODE", static_cast<int>(m_mode));
 
-        // If thick outline is used, draw the shape four times with slight offsets
-        // (top left, top right, bottom right, bottom left).
-        for (auto iteration = 0; iteration < iterations; iteration++)
-        {
-            switch (iteration)
-            {
-                case 0:
-                    break;
-
-                case 1:
-                    for (auto j = 0U; j < smoothedWave.size(); j++)
-                    {
-                        smoothedWave[j].SetX(smoothedWave[j].X() + incrementX);
-                    }
-                    break;
-
-                case 2:
-                    for (auto j = 0U; j < smoothedWave.size(); j++)
-                    {
-                        smoothedWave[j].SetY(smoothedWave[j].Y() + incrementY);
-                    }
-                    break;
-
-                case 3:
-                    for (auto j = 0U; j < smoothedWave.size(); j++)
-                    {
-                        smoothedWave[j].SetX(smoothedWave[j].X() - incrementX);
-                    }
-                    break;
-            }
-
-            m_waveMesh.Vertices().Set(smoothedWave);
-            m_waveMesh.Indices().Resize(smoothedWave.size());
-            m_waveMesh.Indices().MakeContinuous();
-            m_waveMesh.Update();
-            m_waveMesh.Draw();
-        }
+    auto const cacheKey = defines.Key("milkdrop_waveform");
+    shader = m_presetState.renderContext.shaderCache->Get(cacheKey);
+    if (!shader)
+    {
+        // First use of this variant, compile and cache.
+        auto staticShaders = libprojectM::MilkdropPreset::MilkdropStaticShaders::Get();
+
+        shader = std::make_shared<Renderer::Shader>();
+        shader->CompileProgram(defines.Apply(staticShaders->GetPresetWaveformVertexShader()),
+                               staticShaders->GetUntexturedDrawFragmentShader());
+
+        m_presetState.renderContext.shaderCache->Insert(cacheKey, shader);
     }
 
-    Renderer::BlendMode::SetBlendActive(false);;
-    Renderer::Mesh::Unbind();
-    Renderer::Shader::Unbind();
+    m_waveformShader = shader;
+
+    return shader;
 }
 
 void Waveform::ModulateOpacityByVolume(const PerFrameContext& presetPerFrameContext)
@@ -5,7 +5,11 @@
 #include "Waveforms/WaveformMath.hpp"
 
 #include <Renderer/Mesh.hpp>
+#include <Renderer/Sampler.hpp>
+#include <Renderer/Shader.hpp>
+#include <Renderer/VertexArray.hpp>
 
+#include <array>
 #include <memory>
 
 namespace libprojectM {
@@ -22,12 +26,41 @@ public:
     void Draw(const PerFrameContext& presetPerFrameContext);
 
 private:
+    /**
+     * @brief Draws the waves with the waveform vertex shader, reading the smoothed samples from the sample texture.
+     * @param incrementX Horizontal offset of the "thick" wave instances.
+     * @param incrementY Vertical offset of the "thick" wave instances.
+     * @param instances Number of instances to draw per wave.
+     */
+    void DrawWithVertexShader(float incrementX, float incrementY, int instances);
+
+    /**
+     * @brief Draws the waves using vertices calculated on the CPU.
+     * @param presetPerFrameContext The preset per-frame context.
+     * @param incrementX Horizontal offset of the "thick" wave instances.
+     * @param incrementY Vertical offset of the "thick" wave instances.
+     * @param instances Number of instances to draw per wave.
+     */
+    void DrawWithMesh(const PerFrameContext& presetPerFrameContext, float incrementX, float incrementY, int instances);
+
+    /**
+     * @brief Returns the waveform shader variant for the current wave mode, compiling it on first use.
+     * @return The shader program.
+     */
+    auto GetShader() -> std::shared_ptr<Renderer::Shader>;
+
     void MaximizeColors(const PerFrameContext& presetPerFrameContext);
     void ModulateOpacityByVolume(const PerFrameContext& presetPerFrameContext);
 
     PresetState& m_presetState; //!< The preset state.
 
-    Renderer::Mesh m_waveMesh;
+    Renderer::Mesh m_waveMesh;           //!< Vertex buffer for waveforms calculated on the CPU.
+    Renderer::VertexArray m_vertexArray; //!< Empty vertex array object, required for drawing with the vertex shader.
+    std::weak_ptr<Renderer::Shader> m_waveformShader;                                                                //!< The waveform shader, calculates the vertices in the GPU.
+    std::shared_ptr<Renderer::Sampler> m_sampler{std::make_shared<Renderer::Sampler>(GL_CLAMP_TO_EDGE, GL_NEAREST)}; //!< The sample texture sampler.
+
+    std::array<float, WaveformMaxPoints * 2> m_sampleTexels{}; //!< Smoothed left/right samples of the current frame, interleaved for uploading.
+    std::shared_ptr<Renderer::Texture> m_sampleTexture;        //!< The smoothed samples as a WaveformMaxPoints x 1 RG texture, read by the waveform vertex shader.
 
     WaveformMode m_mode{WaveformMode::Circle}; //!< Line drawing mode.
 
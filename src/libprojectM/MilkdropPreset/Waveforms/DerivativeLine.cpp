@@ -13,7 +13,12 @@ bool DerivativeLine::UsesNormalizedMysteryParam()
     return true;
 }
 
-void DerivativeLine::GenerateVertices(const PresetState& presetState, const PerFrameContext&)
+auto DerivativeLine::UsesVertexShader() -> bool
+{
+    return false;
+}
+
+void DerivativeLine::UpdateWaveParameters(const PresetState& presetState, const PerFrameContext&)
 {
     m_samples = Audio::WaveformSamples;
 
@@ -22,9 +27,12 @@ void DerivativeLine::GenerateVertices(const PresetState& presetState, const PerF
         m_samples /= 3;
     }
 
-    m_wave1Vertices.resize(m_samples);
+    m_sampleOffset = (Audio::WaveformSamples - m_samples) / 2;
+}
 
-    int const sampleOffset = (Audio::WaveformSamples - m_samples) / 2;
+void DerivativeLine::GenerateVertices(const PresetState&, const PerFrameContext&)
+{
+    m_wave1Vertices.resize(m_samples);
 
     const float w1 = 0.45f + 0.5f * (m_mysteryWaveParam * 0.5f + 0.5f);
     const float w2 = 1.0f - w1;
@@ -33,9 +41,9 @@ void DerivativeLine::GenerateVertices(const PresetState& presetState, const PerF
 
     for (int i = 0; i < m_samples; i++)
     {
-        assert((i + 25 + sampleOffset) < 512);
-        const float x = -1.0f + 2.0f * (static_cast<float>(i) * inverseSamples) + m_waveX + m_pcmDataR[i + 25 + sampleOffset] * 0.44f;
-        const float y = m_pcmDataL[i + sampleOffset] * 0.47f + m_waveY;
+        assert((i + 25 + m_sampleOffset) < 512);
+        const float x = -1.0f + 2.0f * (static_cast<float>(i) * inverseSamples) + m_waveX + m_pcmDataR[i + 25 + m_sampleOffset] * 0.44f;
+        const float y = m_pcmDataL[i + m_sampleOffset] * 0.47f + m_waveY;
         m_wave1Vertices[i] = {x, y};
 
         // Momentum
@@ -6,10 +6,20 @@ namespace libprojectM {
 namespace MilkdropPreset {
 namespace Waveforms {
 
+/**
+ * @brief Horizontal "script" waveform.
+ *
+ * Each vertex adds momentum from the two previous vertices, so the vertices can't be calculated
+ * independently in the vertex shader and are generated on the CPU instead.
+ */
 class DerivativeLine : public WaveformMath
 {
+public:
+    auto UsesVertexShader() -> bool override;
+
 protected:
     auto UsesNormalizedMysteryParam() -> bool override;
+    void UpdateWaveParameters(const PresetState& presetState, const PerFrameContext& presetPerFrameContext) override;
     void GenerateVertices(const PresetState& presetState, const PerFrameContext& presetPerFrameContext) override;
 };
 
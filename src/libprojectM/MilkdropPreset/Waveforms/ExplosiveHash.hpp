@@ -9,7 +9,8 @@ namespace Waveforms {
 class ExplosiveHash : public WaveformMath
 {
 protected:
-    void GenerateVertices(const PresetState& presetState, const PerFrameContext& presetPerFrameContext) override;
+    void UpdateWaveParameters(const PresetState& presetState,
+                              const PerFrameContext& presetPerFrameContext) override;
 };
 
 } // namespace Waveforms
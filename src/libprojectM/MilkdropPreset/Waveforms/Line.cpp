@@ -6,7 +6,7 @@ namespace libprojectM {
 namespace MilkdropPreset {
 namespace Waveforms {
 
-void Line::GenerateVertices(const PresetState& presetState, const PerFrameContext&)
+void Line::UpdateWaveParameters(const PresetState& presetState, const PerFrameContext&)
 {
     m_samples = Audio::WaveformSamples / 2;
 
@@ -15,16 +15,7 @@ void Line::GenerateVertices(const PresetState& presetState, const PerFrameContex
         m_samples /= 3;
     }
 
-    m_wave1Vertices.resize(m_samples);
-
-    ClipWaveformEdges(1.57f * m_mysteryWaveParam);
-
-    for (int i = 0; i < m_samples; i++)
-    {
-        m_wave1Vertices[i] = {
-            m_edgeX + m_distanceX * static_cast<float>(i) + m_perpetualDX * 0.25f * m_pcmDataL[i + m_sampleOffset],
-            m_edgeY + m_distanceY * static_cast<float>(i) + m_perpetualDY * 0.25f * m_pcmDataL[i + m_sampleOffset]};
-    }
+    m_lines[0] = ClipWaveformEdges(1.57f * m_mysteryWaveParam);
 }
 
 } // namespace Waveforms
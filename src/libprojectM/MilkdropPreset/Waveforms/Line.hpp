@@ -9,7 +9,8 @@ namespace Waveforms {
 class Line : public LineBase
 {
 protected:
-    void GenerateVertices(const PresetState& presetState, const PerFrameContext& presetPerFrameContext) override;
+    void UpdateWaveParameters(const PresetState& presetState,
+                              const PerFrameContext& presetPerFrameContext) override;
 };
 
 } // namespace Waveforms
@@ -8,18 +8,28 @@ namespace libprojectM {
 namespace MilkdropPreset {
 namespace Waveforms {
 
-void LineBase::ClipWaveformEdges(const float angle)
+void LineBase::SetUniforms(Renderer::Shader& shader, int wave)
 {
-    m_distanceX = cosf(angle);
-    m_distanceY = sinf(angle);
+    WaveformMath::SetUniforms(shader, wave);
+
+    const auto& line = m_lines.at(wave);
+    shader.SetUniformFloat2("line_edge", line.edge);
+    shader.SetUniformFloat2("line_distance", line.distance);
+    shader.SetUniformFloat2("line_perpendicular", line.perpendicular);
+}
+
+auto LineBase::ClipWaveformEdges(const float angle) -> LineEdges
+{
+    const float directionX = cosf(angle);
+    const float directionY = sinf(angle);
 
     std::array<float, 2> edgeX{
-        m_waveX * cosf(angle + 1.57f) - m_distanceX * 3.0f,
-        m_waveX * cosf(angle + 1.57f) + m_distanceX * 3.0f};
+        m_waveX * cosf(angle + 1.57f) - directionX * 3.0f,
+        m_waveX * cosf(angle + 1.57f) + directionX * 3.0f};
 
     std::array<float, 2> edgeY{
-        m_waveX * sinf(angle + 1.57f) - m_distanceY * 3.0f,
-        m_waveX * sinf(angle + 1.57f) + m_distanceY * 3.0f};
+        m_waveX * sinf(angle + 1.57f) - directionY * 3.0f,
+        m_waveX * sinf(angle + 1.57f) + directionY * 3.0f};
 
     for (int i = 0; i < 2; i++)
     {
@@ -75,15 +85,15 @@ void LineBase::ClipWaveformEdges(const float angle)
 
     m_sampleOffset = (Audio::WaveformSamples - m_samples) / 2;
 
-    m_distanceX = (edgeX[1] - edgeX[0]) / static_cast<float>(m_samples);
-    m_distanceY = (edgeY[1] - edgeY[0]) / static_cast<float>(m_samples);
+    LineEdges line;
+    line.distance = {(edgeX[1] - edgeX[0]) / static_cast<float>(m_samples),
+                     (edgeY[1] - edgeY[0]) / static_cast<float>(m_samples)};
+    line.edge = {edgeX[0], edgeY[0]};
 
-    m_edgeX = edgeX[0];
-    m_edgeY = edgeY[0];
+    const float angle2 = atan2f(line.distance.y, line.distance.x);
+    line.perpendicular = {cosf(angle2 + 1.57f), sinf(angle2 + 1.57f)};
 
-    const float angle2 = atan2f(m_distanceY, m_distanceX);
-    m_perpetualDX = cosf(angle2 + 1.57f);
-    m_perpetualDY = sinf(angle2 + 1.57f);
+    return line;
 }
 
 } // namespace Waveforms
@@ -2,29 +2,36 @@
 
 #include "Waveforms/WaveformMath.hpp"
 
+#include <glm/vec2.hpp>
+
 namespace libprojectM {
 namespace MilkdropPreset {
 namespace Waveforms {
 
 class LineBase : public WaveformMath
 {
+public:
+    void SetUniforms(Renderer::Shader& shader, int wave) override;
+
 protected:
     /**
-     * @brief Calculates the waveform x/y coordinates and distances and clips them to the screen.
-     * @param initialAngle
+     * @brief Position and direction of a straight waveform line.
      */
-    void ClipWaveformEdges(float angle);
-
-    int m_sampleOffset{}; //!< Waveform render sample offset. If less than 480, the center part of the waveform is rendered.
+    struct LineEdges {
+        glm::vec2 edge{};          //!< Waveform left/top edge offset.
+        glm::vec2 distance{};      //!< Waveform X/Y distance (stretch) between two samples.
+        glm::vec2 perpendicular{}; //!< Direction perpendicular to the line, in which the samples are displaced.
+    };
 
-    float m_edgeX{}; //!< Waveform left edge offset.
-    float m_edgeY{}; //!< Waveform top edge offset.
-
-    float m_distanceX{}; //!< Waveform X distance (stretch)
-    float m_distanceY{}; //!< Waveform Y distance (stretch)
+    /**
+     * @brief Calculates the waveform x/y coordinates and distances and clips them to the screen.
+     * Also updates the sample offset to render the center part of the waveform.
+     * @param angle The line angle in radians.
+     * @return The clipped line edges.
+     */
+    auto ClipWaveformEdges(float angle) -> LineEdges;
 
-    float m_perpetualDX{}; //!< Waveform perpetual X distance
-    float m_perpetualDY{}; //!< Waveform perpetual Y distance
+    std::array<LineEdges, 2> m_lines{}; //!< Line edges of each wave.
 };
 
 } // namespace Waveforms
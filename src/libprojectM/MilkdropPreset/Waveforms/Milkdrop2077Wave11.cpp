@@ -6,8 +6,12 @@ namespace libprojectM {
 namespace MilkdropPreset {
 namespace Waveforms {
 
+auto Milkdrop2077Wave11::WaveCount() -> int
+{
+    return 2;
+}
 
-void Milkdrop2077Wave11::GenerateVertices(const PresetState& presetState, const PerFrameContext&)
+void Milkdrop2077Wave11::UpdateWaveParameters(const PresetState& presetState, const PerFrameContext&)
 {
     m_samples = Audio::WaveformSamples / 2;
 
@@ -16,20 +20,9 @@ void Milkdrop2077Wave11::GenerateVertices(const PresetState& presetState, const
         m_samples /= 3;
     }
 
-    m_wave1Vertices.resize(m_samples);
-    m_wave2Vertices.resize(m_samples);
-
-    ClipWaveformEdges(1.57f);
-
-    for (int i = 0; i < m_samples; i++)
-    {
-        m_wave1Vertices[i] = {
-            m_edgeX - 0.45f + m_distanceX * static_cast<float>(i) + m_perpetualDX * 0.35f * m_pcmDataL[i + m_sampleOffset],
-            m_edgeY + m_distanceY * static_cast<float>(i) + m_perpetualDY * 0.35f * m_pcmDataL[i + m_sampleOffset]};
-        m_wave2Vertices[i] = {
-            m_edgeX + 0.45f + m_distanceX * static_cast<float>(i) + m_perpetualDX * 0.35f * m_pcmDataR[i + m_sampleOffset],
-            m_edgeY + m_distanceY * static_cast<float>(i) + m_perpetualDY * 0.35f * m_pcmDataR[i + m_sampleOffset]};
-    }
+    // The two lines are shifted left and right in the vertex shader.
+    m_lines[0] = ClipWaveformEdges(1.57f);
+    m_lines[1] = m_lines[0];
 }
 
 } // namespace Waveforms
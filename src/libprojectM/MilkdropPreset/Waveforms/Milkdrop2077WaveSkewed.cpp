@@ -3,33 +3,29 @@
 #include "PerFrameContext.hpp"
 
 #include <algorithm>
-#include <cmath>
 
 namespace libprojectM {
 namespace MilkdropPreset {
 namespace Waveforms {
 
-void Milkdrop2077WaveSkewed::GenerateVertices(const PresetState& presetState,
-                                              const PerFrameContext& presetPerFrameContext)
+void Milkdrop2077WaveSkewed::SetUniforms(Renderer::Shader& shader, int wave)
 {
-    m_samples = Audio::WaveformSamples / 2;
+    WaveformMath::SetUniforms(shader, wave);
+
+    shader.SetUniformFloat("skew_angle", m_skewAngle);
+}
 
-    m_wave1Vertices.resize(m_samples);
+void Milkdrop2077WaveSkewed::UpdateWaveParameters(const PresetState& presetState,
+                                                  const PerFrameContext& presetPerFrameContext)
+{
+    m_samples = Audio::WaveformSamples / 2;
 
     float alpha = static_cast<float>(*presetPerFrameContext.wave_a) * 1.25f;
     if (presetState.modWaveAlphaByvolume)
     {
         alpha *= presetState.audioData.vol;
     }
-    alpha = std::max(0.0f, std::min(1.0f, alpha));
-
-    for (size_t i = 0; i < static_cast<size_t>(m_samples); i++)
-    {
-        float rad = 0.63f + 0.23f * m_pcmDataR[i] + m_mysteryWaveParam;
-        float ang = m_pcmDataL[i + 32] * 0.9f + presetState.renderContext.time * 3.3f;
-        m_wave1Vertices[i] = {rad * cosf(ang + alpha) * m_aspectY + m_waveX,
-                              rad * sinf(ang) * m_aspectX + m_waveY};
-    }
+    m_skewAngle = std::max(0.0f, std::min(1.0f, alpha));
 }
 
 } // namespace Waveforms
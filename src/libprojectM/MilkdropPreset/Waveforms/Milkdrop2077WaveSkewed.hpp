@@ -8,9 +8,15 @@ namespace Waveforms {
 
 class Milkdrop2077WaveSkewed : public WaveformMath
 {
+public:
+    void SetUniforms(Renderer::Shader& shader, int wave) override;
+
 protected:
-    void GenerateVertices(const PresetState& presetState,
-                          const PerFrameContext& presetPerFrameContext) override;
+    void UpdateWaveParameters(const PresetState& presetState,
+                              const PerFrameContext& presetPerFrameContext) override;
+
+private:
+    float m_skewAngle{}; //!< Additional angle added to the x coordinate, depends on the wave alpha.
 };
 
 } // namespace Waveforms
@@ -12,8 +12,8 @@ public:
     auto IsLoop() -> bool override;
 
 protected:
-    void GenerateVertices(const PresetState& presetState,
-                          const PerFrameContext& presetPerFrameContext) override;
+    void UpdateWaveParameters(const PresetState& presetState,
+                              const PerFrameContext& presetPerFrameContext) override;
 };
 
 } // namespace Waveforms
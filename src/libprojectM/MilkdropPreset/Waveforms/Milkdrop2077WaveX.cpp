@@ -6,8 +6,12 @@ namespace libprojectM {
 namespace MilkdropPreset {
 namespace Waveforms {
 
+auto Milkdrop2077WaveX::WaveCount() -> int
+{
+    return 2;
+}
 
-void Milkdrop2077WaveX::GenerateVertices(const PresetState& presetState, const PerFrameContext&)
+void Milkdrop2077WaveX::UpdateWaveParameters(const PresetState& presetState, const PerFrameContext&)
 {
     m_samples = Audio::WaveformSamples / 2;
 
@@ -16,26 +20,8 @@ void Milkdrop2077WaveX::GenerateVertices(const PresetState& presetState, const P
         m_samples /= 3;
     }
 
-    m_wave1Vertices.resize(m_samples);
-    m_wave2Vertices.resize(m_samples);
-
-    ClipWaveformEdges(-0.75f + m_mysteryWaveParam * 3.15f);
-
-    for (int i = 0; i < m_samples; i++)
-    {
-        m_wave1Vertices[i] = {
-            m_edgeX + m_distanceX * static_cast<float>(i) + m_perpetualDX * 0.35f * m_pcmDataL[i + m_sampleOffset],
-            m_edgeY + m_distanceY * static_cast<float>(i) + m_perpetualDY * 0.35f * m_pcmDataL[i + m_sampleOffset]};
-    }
-
-    ClipWaveformEdges(0.75f + m_mysteryWaveParam * 3.15f);
-
-    for (int i = 0; i < m_samples; i++)
-    {
-        m_wave2Vertices[i] = {
-            m_edgeX + m_distanceX * static_cast<float>(i) + m_perpetualDX * 0.35f * m_pcmDataR[i + m_sampleOffset],
-            m_edgeY + m_distanceY * static_cast<float>(i) + m_perpetualDY * 0.35f * m_pcmDataR[i + m_sampleOffset]};
-    }
+    m_lines[0] = ClipWaveformEdges(-0.75f + m_mysteryWaveParam * 3.15f);
+    m_lines[1] = ClipWaveformEdges(0.75f + m_mysteryWaveParam * 3.15f);
 }
 
 } // namespace Waveforms
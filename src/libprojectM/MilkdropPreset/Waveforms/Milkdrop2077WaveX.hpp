@@ -8,8 +8,12 @@ namespace Waveforms {
 
 class Milkdrop2077WaveX : public LineBase
 {
+public:
+    auto WaveCount() -> int override;
+
 protected:
-    void GenerateVertices(const PresetState& presetState, const PerFrameContext& presetPerFrameContext) override;
+    void UpdateWaveParameters(const PresetState& presetState,
+                              const PerFrameContext& presetPerFrameContext) override;
 };
 
 } // namespace Waveforms
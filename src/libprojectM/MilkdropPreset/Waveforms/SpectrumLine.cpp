@@ -1,7 +1,5 @@
 #include "Waveforms/SpectrumLine.hpp"
 
-#include <cmath>
-
 namespace libprojectM {
 namespace MilkdropPreset {
 namespace Waveforms {
@@ -11,20 +9,11 @@ bool SpectrumLine::IsSpectrumWave()
     return true;
 }
 
-void SpectrumLine::GenerateVertices(const PresetState&, const PerFrameContext&)
+void SpectrumLine::UpdateWaveParameters(const PresetState&, const PerFrameContext&)
 {
     m_samples = 256;
-    m_wave1Vertices.resize(m_samples);
-
-    ClipWaveformEdges(1.57f * m_mysteryWaveParam);
 
-    for (size_t i = 0; i < static_cast<size_t>(m_samples); i++)
-    {
-        const float f = 0.1f * logf(m_pcmDataL[i * 2] + m_pcmDataL[i * 2 + 1]);
-        m_wave1Vertices[i] = {
-            m_edgeX + m_distanceX * static_cast<float>(i) + m_perpetualDX * f,
-            m_edgeY + m_distanceY * static_cast<float>(i) + m_perpetualDY * f};
-    }
+    m_lines[0] = ClipWaveformEdges(1.57f * m_mysteryWaveParam);
 }
 
 } // namespace Waveforms
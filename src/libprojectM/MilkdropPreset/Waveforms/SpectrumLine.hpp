@@ -8,9 +8,12 @@ namespace Waveforms {
 
 class SpectrumLine : public LineBase
 {
-protected:
+public:
     auto IsSpectrumWave() -> bool override;
-    void GenerateVertices(const PresetState& presetState, const PerFrameContext& presetPerFrameContext) override;
+
+protected:
+    void UpdateWaveParameters(const PresetState& presetState,
+                              const PerFrameContext& presetPerFrameContext) override;
 };
 
 } // namespace Waveforms
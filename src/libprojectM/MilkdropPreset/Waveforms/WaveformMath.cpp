@@ -12,12 +12,24 @@ namespace Waveforms {
 
 auto WaveformMath::GetVertices(const PresetState& presetState,
                                const PerFrameContext& presetPerFrameContext) -> std::array<VertexList, 2>
+{
+    SmoothSamples(presetState);
+
+    UpdateParameters(presetState, presetPerFrameContext);
+    GenerateVertices(presetState, presetPerFrameContext);
+
+    std::array<VertexList, 2> smoothedVertices;
+    SmoothWave(m_wave1Vertices, smoothedVertices.at(0));
+    SmoothWave(m_wave2Vertices, smoothedVertices.at(1));
+
+    return smoothedVertices;
+}
+
+void WaveformMath::SmoothSamples(const PresetState& presetState)
 {
     static_assert(WaveformMaxPoints >= libprojectM::Audio::SpectrumSamples, "WaveformMaxPoints is smaller than SpectrumSamples");
     static_assert(WaveformMaxPoints >= libprojectM::Audio::WaveformSamples, "WaveformMaxPoints is smaller than WaveformSamples");
 
-    using libprojectM::Audio::WaveformSamples;
-
     // Get the correct audio sample type for the current waveform mode.
     if (IsSpectrumWave())
     {
@@ -58,7 +70,20 @@ auto WaveformMath::GetVertices(const PresetState& presetState,
         m_pcmDataL[i] = m_pcmDataL[i] * mix1 + m_pcmDataL[i - 1] * mix2;
         m_pcmDataR[i] = m_pcmDataR[i] * mix1 + m_pcmDataR[i - 1] * mix2;
     }
+}
+
+void WaveformMath::InterleaveSamples(std::array<float, WaveformMaxPoints * 2>& texels) const
+{
+    for (size_t i = 0; i < m_pcmDataL.size(); ++i)
+    {
+        texels[i * 2] = m_pcmDataL[i];
+        texels[i * 2 + 1] = m_pcmDataR[i];
+    }
+}
 
+void WaveformMath::UpdateParameters(const PresetState& presetState,
+                                    const PerFrameContext& presetPerFrameContext)
+{
     // Aspect multipliers
     if (presetState.renderContext.viewportSizeX > presetState.renderContext.viewportSizeY)
     {
@@ -82,13 +107,17 @@ auto WaveformMath::GetVertices(const PresetState& presetState,
     m_waveX = 2.0f * static_cast<float>(*presetPerFrameContext.wave_x) - 1.0f;
     m_waveY = 2.0f * static_cast<float>(*presetPerFrameContext.wave_y) - 1.0f;
 
-    GenerateVertices(presetState, presetPerFrameContext);
-
-    std::array<VertexList, 2> smoothedVertices;
-    SmoothWave(m_wave1Vertices, smoothedVertices.at(0));
-    SmoothWave(m_wave2Vertices, smoothedVertices.at(1));
+    UpdateWaveParameters(presetState, presetPerFrameContext);
+}
 
-    return smoothedVertices;
+void WaveformMath::SetUniforms(Renderer::Shader& shader, int wave)
+{
+    shader.SetUniformInt("wave_index", wave);
+    shader.SetUniformInt("sample_count", m_samples);
+    shader.SetUniformInt("sample_offset", m_sampleOffset);
+    shader.SetUniformFloat2("aspect", {m_aspectX, m_aspectY});
+    shader.SetUniformFloat2("wave_position", {m_waveX, m_waveY});
+    shader.SetUniformFloat("mystery", m_mysteryWaveParam);
 }
 
 auto WaveformMath::IsLoop() -> bool
@@ -96,6 +125,21 @@ auto WaveformMath::IsLoop() -> bool
     return false;
 }
 
+auto WaveformMath::UsesVertexShader() -> bool
+{
+    return true;
+}
+
+auto WaveformMath::WaveCount() -> int
+{
+    return 1;
+}
+
+auto WaveformMath::VertexCount() const -> int
+{
+    return m_samples * 2 - 1;
+}
+
 auto WaveformMath::IsSpectrumWave() -> bool
 {
     return false;
@@ -106,6 +150,10 @@ auto WaveformMath::UsesNormalizedMysteryParam() -> bool
     return false;
 }
 
+void WaveformMath::GenerateVertices(const PresetState&, const PerFrameContext&)
+{
+}
+
 void WaveformMath::SmoothWave(const VertexList& inputVertices, VertexList& outputVertices)
 {
     constexpr float c1{-0.15f};
@@ -4,6 +4,7 @@
 #include "WaveformMode.hpp"
 
 #include "Renderer/Point.hpp"
+#include "Renderer/Shader.hpp"
 
 #include <array>
 #include <vector>
@@ -16,6 +17,13 @@ class PerFrameContext;
 
 namespace Waveforms {
 
+/**
+ * @brief Base class for the built-in waveform modes.
+ *
+ * Most waveforms calculate their vertices in the waveform vertex shader, reading the samples from
+ * the preset's audio texture. The classes only provide the per-frame parameters for the shader.
+ * Waveforms which can't be calculated per vertex generate their vertices on the CPU instead.
+ */
 class WaveformMath
 {
 public:
@@ -25,6 +33,7 @@ public:
 
     /**
      * @brief Calculates and smoothes the samples and outputs vertices ready for drawing.
+     * Only used if UsesVertexShader() returns false.
      * Depending on the waveform type, only the first set of vertices might be present.
      * @param presetState The preset state older, including the render context.
      * @param presetPerFrameContext The preset per-frame context.
@@ -34,19 +43,67 @@ public:
                      const PerFrameContext& presetPerFrameContext)
         -> std::array<VertexList, 2>;
 
+    /**
+     * @brief Scales and smoothes the waveform or spectrum samples of the current frame.
+     * Also called by GetVertices(). Vertex shader-based waveforms upload the result once per
+     * frame, so the shader doesn't need to re-run the smoothing filter for each vertex.
+     * @param presetState The preset state holder, including the frame audio data.
+     */
+    void SmoothSamples(const PresetState& presetState);
+
+    /**
+     * @brief Writes the smoothed samples as interleaved left/right pairs, e.g. for an RG texture.
+     * @param texels The buffer receiving the sample pairs.
+     */
+    void InterleaveSamples(std::array<float, WaveformMaxPoints * 2>& texels) const;
+
+    /**
+     * @brief Calculates the waveform parameters for the current frame.
+     * Must be called before setting the shader uniforms. Also called by GetVertices().
+     * @param presetState The preset state older, including the render context.
+     * @param presetPerFrameContext The preset per-frame context.
+     */
+    void UpdateParameters(const PresetState& presetState,
+                          const PerFrameContext& presetPerFrameContext);
+
+    /**
+     * @brief Sets the waveform-specific uniforms in the waveform vertex shader.
+     * @param shader The waveform shader, must be bound.
+     * @param wave The index of the wave to draw, 0 or 1.
+     */
+    virtual void SetUniforms(Renderer::Shader& shader, int wave);
+
     /**
      * @brief Indicates whether the waveform should be drawn as a closed line loop instead of a strip.
      * @return true if the waveform should be a closed loop, false if it should be drawn as a strip.
      */
     virtual auto IsLoop() -> bool;
 
-protected:
+    /**
+     * @brief Indicates whether the vertices are calculated in the waveform vertex shader.
+     * @return true if the waveform is drawn using the vertex shader, false if GetVertices() must be used.
+     */
+    virtual auto UsesVertexShader() -> bool;
+
     /**
      * @brief Indicates whether the waveform uses spectrum or normal oscilloscope data.
      * @return true if the waveform needs spectrum data, false if it only needs oscilloscope data.
      */
     virtual auto IsSpectrumWave() -> bool;
 
+    /**
+     * @brief Returns the number of waves drawn by this waveform mode.
+     * @return The number of waves, either 1 or 2.
+     */
+    virtual auto WaveCount() -> int;
+
+    /**
+     * @brief Returns the number of vertices in each wave after smoothing.
+     * @return The number of smoothed vertices.
+     */
+    auto VertexCount() const -> int;
+
+protected:
     /**
      * @brief Indicates whether the waveform wants a normalized mystery param, or uses the raw configured value.
      * @return true if the value should be normalized to [-1, 1], false to keep it as configured.
@@ -54,13 +111,21 @@ protected:
     virtual auto UsesNormalizedMysteryParam() -> bool;
 
     /**
-     * @brief The actual waveform-specific math. Overridden by each implementation.
+     * @brief Calculates the waveform-specific parameters, e.g. the number of samples. Overridden by each implementation.
+     * @param presetState The preset state older, including the render context.
+     * @param presetPerFrameContext The preset per-frame context.
+     */
+    virtual void UpdateWaveParameters(const PresetState& presetState,
+                                      const PerFrameContext& presetPerFrameContext) = 0;
+
+    /**
+     * @brief The waveform-specific vertex math for waveforms not using the vertex shader.
      * The vertices produces must not be smoothed. This is always performed afterwards.
      * @param presetState The preset state older, including the render context.
      * @param presetPerFrameContext The preset per-frame context.
      */
     virtual void GenerateVertices(const PresetState& presetState,
-                                  const PerFrameContext& presetPerFrameContext) = 0;
+                                  const PerFrameContext& presetPerFrameContext);
 
     /**
      * @brief Does a better-than-linear smooth on a wave.
@@ -74,7 +139,8 @@ protected:
 
     WaveformMode m_mode{WaveformMode::Line};
 
-    int m_samples{};
+    int m_samples{};      //!< Number of samples in the waveform before smoothing.
+    int m_sampleOffset{}; //!< Offset of the first rendered sample. If the waveform uses less samples, the center part is rendered.
     std::array<float, WaveformMaxPoints> m_pcmDataL{0.0f};
     std::array<float, WaveformMaxPoints> m_pcmDataR{0.0f};
 
@@ -16,21 +16,9 @@ auto XYOscillationSpiral::UsesNormalizedMysteryParam() -> bool
     return true;
 }
 
-void XYOscillationSpiral::GenerateVertices(const PresetState& presetState,
-                                           const PerFrameContext&)
+void XYOscillationSpiral::UpdateWaveParameters(const PresetState&, const PerFrameContext&)
 {
     m_samples = Audio::WaveformSamples / 2;
-
-    m_wave1Vertices.resize(m_samples);
-
-    for (int i = 0; i < m_samples; i++)
-    {
-        float const radius = (0.53f + 0.43f * m_pcmDataR[i] + m_mysteryWaveParam);
-        float const angle = m_pcmDataL[i + 32] * 1.57f + presetState.renderContext.time * 2.3f;
-
-        m_wave1Vertices[i] = {radius * cosf(angle) * m_aspectY + m_waveX,
-                              radius * sinf(angle) * m_aspectX + m_waveY};
-    }
 }
 
 } // namespace Waveforms
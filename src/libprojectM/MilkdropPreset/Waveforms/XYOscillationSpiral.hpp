@@ -13,8 +13,8 @@ public:
 
 protected:
     auto UsesNormalizedMysteryParam() -> bool override;
-    void GenerateVertices(const PresetState& presetState,
-                          const PerFrameContext& presetPerFrameContext) override;
+    void UpdateWaveParameters(const PresetState& presetState,
+                              const PerFrameContext& presetPerFrameContext) override;
 };
 
 } // namespace Waveforms
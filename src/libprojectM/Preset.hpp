@@ -57,6 +57,12 @@ public:
      * images or text. Depending on the preset, it's not guaranteed though that the image actually
      * is used in the next frame, or completely painted over. That said, the effect varies between
      * presets.
+     *
+     * The image is stored vertically flipped compared to the preset output, so anything drawn into
+     * it must be flipped vertically as well.
+     *
+     * The viewport is set to the framebuffer size, which can be smaller than the output size while
+     * the preset is transitioning out. Callers must restore the viewport afterwards.
      */
     virtual void BindFramebuffer() = 0;
 
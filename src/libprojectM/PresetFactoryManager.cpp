@@ -3,6 +3,7 @@
 #include "Utils.hpp"
 
 #include <MilkdropPreset/Factory.hpp>
+#include <MilkdropPreset/PresetBundle.hpp>
 
 #include <Logging.hpp>
 
@@ -65,6 +66,15 @@ std::unique_ptr<Preset> PresetFactoryManager::CreatePresetFromFile(const std::st
     {
         const std::string extension = "." + ParseExtension(filename);
 
+        if (!m_presetBundles.empty() && extension == ".milk")
+        {
+            auto preset = CreatePresetFromBundle(filename);
+            if (preset)
+            {
+                return preset;
+            }
+        }
+
         return factory(extension).LoadPresetFromFile(filename);
     }
     catch (const PresetFactoryException&)
@@ -101,6 +111,48 @@ std::unique_ptr<Preset> PresetFactoryManager::CreatePresetFromStream(const std::
     }
 }
 
+void PresetFactoryManager::LoadPresetBundle(const std::string& bundleFile)
+{
+    try
+    {
+        auto bundle = std::make_shared<MilkdropPreset::PresetBundle>(bundleFile);
+        LOG_INFO("[PresetFactoryManager] Loaded preset bundle \"" + bundleFile + "\" with " + std::to_string(bundle->Count()) + " presets.");
+        m_presetBundles.push_back(std::move(bundle));
+    }
+    catch (const std::exception& e)
+    {
+        throw PresetFactoryException(e.what());
+    }
+}
+
+void PresetFactoryManager::ClearPresetBundles()
+{
+    m_presetBundles.clear();
+}
+
+std::unique_ptr<Preset> PresetFactoryManager::CreatePresetFromBundle(const std::string& filename)
+{
+    std::string path;
+    auto protocol = PresetFactory::Protocol(filename, path);
+    if (!protocol.empty() && protocol != "file")
+    {
+        return {};
+    }
+
+    for (const auto& bundle : m_presetBundles)
+    {
+        int const index = bundle->Find(path);
+        if (index < 0)
+        {
+            continue;
+        }
+
+        return MilkdropPreset::Factory::LoadPresetFromBundle(*bundle, index, path);
+    }
+
+    return {};
+}
+
 PresetFactory& PresetFactoryManager::factory(const std::string& extension)
 {
     if (!extensionHandled(extension))
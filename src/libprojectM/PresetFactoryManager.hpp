@@ -3,11 +3,16 @@
 #include "PresetFactory.hpp"
 
 #include <map>
+#include <memory>
 #include <utility>
 #include <vector>
 
 namespace libprojectM {
 
+namespace MilkdropPreset {
+class PresetBundle;
+}
+
 /// A simple exception class to strongly type all preset factory related issues
 class PresetFactoryException : public std::exception
 {
@@ -83,14 +88,38 @@ public:
 
     std::vector<std::string> extensionsHandled() const;
 
+    /**
+     * @brief Maps a precompiled preset bundle and uses it for all presets it contains.
+     *
+     * Presets found in the bundle are created from the precompiled data without parsing the preset
+     * file. If the original preset file exists and was changed after compiling the bundle, the
+     * bundle entry is ignored and the preset is loaded from source.
+     *
+     * @param bundleFile The .milkc bundle file to load.
+     * @throws PresetFactoryException If the bundle can't be opened or is invalid.
+     */
+    void LoadPresetBundle(const std::string& bundleFile);
+
+    /**
+     * @brief Unmaps all previously loaded preset bundles.
+     */
+    void ClearPresetBundles();
 
 private:
+    /**
+     * @brief Creates a preset from a loaded preset bundle, if one contains the given file.
+     * @param filename The preset filename or URL to load.
+     * @return The preset, or nullptr if no bundle contains an up-to-date entry for the file.
+     */
+    std::unique_ptr<Preset> CreatePresetFromBundle(const std::string& filename);
+
     void registerFactory(const std::string& extension, PresetFactory* factory);
 
     auto ParseExtension(const std::string& filename) -> std::string;
 
     mutable std::map<std::string, PresetFactory*> m_factoryMap;
     mutable std::vector<PresetFactory*> m_factoryList;
+    std::vector<std::shared_ptr<MilkdropPreset::PresetBundle>> m_presetBundles; //!< Mapped precompiled preset bundles.
     void ClearFactories();
 };
 
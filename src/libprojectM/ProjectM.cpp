@@ -25,17 +25,29 @@
 #include "Preset.hpp"
 #include "PresetFactoryManager.hpp"
 #include "TimeKeeper.hpp"
+#include "Tracing.hpp"
 
 #include <Audio/PCM.hpp>
 
+#include <Renderer/CommandRecorder.hpp>
 #include <Renderer/CopyTexture.hpp>
+#include <Renderer/GLStateCache.hpp>
+#include <Renderer/GpuProfiler.hpp>
+#include <Renderer/GpuTimer.hpp>
 #include <Renderer/PresetTransition.hpp>
 #include <Renderer/ShaderCache.hpp>
+#include <Renderer/StreamingBuffer.hpp>
+#include <Renderer/TextureFormat.hpp>
 #include <Renderer/TextureManager.hpp>
+#include <Renderer/TexturePool.hpp>
 #include <Renderer/TransitionShaderManager.hpp>
 
 #include <UserSprites/SpriteManager.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
 namespace libprojectM {
 
 ProjectM::ProjectM()
@@ -46,7 +58,11 @@ ProjectM::ProjectM()
 
 ProjectM::~ProjectM()
 {
-    // Can't use "=default" in the header due to unique_ptr requiring the actual type declarations.
+    // Resources deleted below must update this instance's state cache.
+    if (m_glStateCache)
+    {
+        m_glStateCache->MakeCurrent();
+    }
 }
 
 void ProjectM::PresetSwitchRequestedEvent(bool) const
@@ -59,6 +75,8 @@ void ProjectM::PresetSwitchFailedEvent(const std::string&, const std::string&) c
 
 void ProjectM::LoadPresetFile(const std::string& presetFilename, bool smoothTransition)
 {
+    TRACE_SCOPE("LoadPresetFile");
+
     try
     {
         m_textureManager->PurgeTextures();
@@ -73,6 +91,8 @@ void ProjectM::LoadPresetFile(const std::string& presetFilename, bool smoothTran
 
 void ProjectM::LoadPresetData(std::istream& presetData, bool smoothTransition)
 {
+    TRACE_SCOPE("LoadPresetData");
+
     try
     {
         m_textureManager->PurgeTextures();
@@ -85,6 +105,20 @@ void ProjectM::LoadPresetData(std::istream& presetData, bool smoothTransition)
     }
 }
 
+auto ProjectM::LoadPresetBundle(const std::string& bundleFile) -> bool
+{
+    try
+    {
+        m_presetFactoryManager->LoadPresetBundle(bundleFile);
+        return true;
+    }
+    catch (const std::exception& ex)
+    {
+        LOG_ERROR(ex.what());
+        return false;
+    }
+}
+
 void ProjectM::SetTexturePaths(std::vector<std::string> texturePaths)
 {
     m_textureSearchPaths = std::move(texturePaths);
@@ -115,12 +149,27 @@ void ProjectM::SetTextureLoadCallback(Renderer::TextureLoadCallback callback)
 
 void ProjectM::RenderFrame(uint32_t targetFramebufferObject /*= 0*/)
 {
+    TRACE_SCOPE("RenderFrame");
+
     // Don't render if window area is zero.
     if (m_windowWidth == 0 || m_windowHeight == 0)
     {
         return;
     }
 
+    m_glStateCache->MakeCurrent();
+    m_glStateCache->BeginFrame();
+    m_streamingBuffer->MakeCurrent();
+    m_commandRecorder->BeginFrame();
+
+    // Keep the capacity of the culled pass list, so it's not reallocated every frame.
+    m_renderPassStatistics.executed = 0;
+    m_renderPassStatistics.culled = 0;
+    m_renderPassStatistics.culledPasses.clear();
+
+    // Presets keep their size until the window size stops changing, the output is scaled meanwhile.
+    m_resizeDebouncer.NextFrame();
+
     // Update FPS and other timer values.
     m_timeKeeper->UpdateTimers();
 
@@ -136,6 +185,7 @@ void ProjectM::RenderFrame(uint32_t targetFramebufferObject /*= 0*/)
         {
             m_presetChangeNotified = true;
             PresetSwitchRequestedEvent(false);
+            m_glStateCache->Invalidate();
         }
         else if (m_hardCutEnabled &&
                  m_frameCount > 50 &&
@@ -144,6 +194,7 @@ void ProjectM::RenderFrame(uint32_t targetFramebufferObject /*= 0*/)
         {
             m_presetChangeNotified = true;
             PresetSwitchRequestedEvent(true);
+            m_glStateCache->Invalidate();
         }
     }
 
@@ -153,6 +204,11 @@ void ProjectM::RenderFrame(uint32_t targetFramebufferObject /*= 0*/)
         LoadIdlePreset();
         if (!m_activePreset)
         {
+            m_streamingBuffer->EndFrame();
+            m_glStateCache->EndFrame();
+            m_commandRecorder->EndFrame();
+            m_lastRenderPassStatistics = {};
+            m_lastFrameCpuTime = 0.0;
             return;
         }
 
@@ -169,6 +225,19 @@ void ProjectM::RenderFrame(uint32_t targetFramebufferObject /*= 0*/)
         }
     }
 
+    // Measure the frame for dynamic resolution scaling, on the GPU if timer queries are available.
+    auto const frameStartTime = std::chrono::steady_clock::now();
+    if (m_dynamicResolutionEnabled)
+    {
+        m_frameTimer->Begin();
+    }
+
+    if (m_gpuProfilingEnabled)
+    {
+        m_gpuProfiler->BeginFrame(static_cast<uint32_t>(m_frameCount));
+    }
+
+    // Presets are rendered at the internal resolution, the final image is upscaled to the output size.
     auto renderContext = GetRenderContext();
 
     if (m_transition != nullptr && m_transitioningPreset != nullptr)
@@ -185,26 +254,79 @@ void ProjectM::RenderFrame(uint32_t targetFramebufferObject /*= 0*/)
         }
     }
 
+    if (m_transition != nullptr && m_transitioningPreset != nullptr)
+    {
+        RenderOutgoingPreset(audioData, renderContext);
+    }
+    else
+    {
+        // ToDo: Call the to-be-implemented render method in Renderer
+        m_activePreset->RenderFrame(audioData, renderContext);
+    }
+
+    m_glStateCache->BindFramebuffer(GL_DRAW_FRAMEBUFFER, static_cast<GLuint>(targetFramebufferObject));
+    glViewport(0, 0, static_cast<GLsizei>(m_windowWidth), static_cast<GLsizei>(m_windowHeight));
 
-    // ToDo: Call the to-be-implemented render method in Renderer
-    m_activePreset->RenderFrame(audioData, renderContext);
+    auto outputContext = renderContext;
+    outputContext.viewportSizeX = static_cast<int>(m_windowWidth);
+    outputContext.viewportSizeY = static_cast<int>(m_windowHeight);
 
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, static_cast<GLuint>(targetFramebufferObject));
+    bool const transitioning = m_transition != nullptr && m_transitioningPreset != nullptr;
+    if (m_gpuProfilingEnabled)
+    {
+        m_gpuProfiler->BeginPass(transitioning ? "transition" : "output");
+    }
 
-    if (m_transition != nullptr && m_transitioningPreset != nullptr)
+    if (transitioning)
     {
-        m_transition->Draw(*m_activePreset, *m_transitioningPreset, renderContext, audioData, m_timeKeeper->GetFrameTime());
+        m_transition->Draw(*m_activePreset, *m_transitioningPreset, outputContext, audioData, m_timeKeeper->GetFrameTime());
     }
     else
     {
         m_textureCopier->Draw(*renderContext.shaderCache, m_activePreset->OutputTexture(), false, false);
     }
 
+    if (m_gpuProfilingEnabled)
+    {
+        m_gpuProfiler->EndPass();
+        m_gpuProfiler->BeginPass("user_sprites");
+    }
+
     // Draw user sprites
-    m_spriteManager->Draw(audioData, renderContext, targetFramebufferObject, {m_activePreset, m_transitioningPreset});
+    m_spriteManager->Draw(audioData, outputContext, targetFramebufferObject, {m_activePreset, m_transitioningPreset});
+    if (m_gpuProfilingEnabled)
+    {
+        m_gpuProfiler->EndPass();
+        m_gpuProfiler->EndFrame();
+    }
+
+    m_frameTimer->End();
+    m_lastFrameCpuTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStartTime).count();
+    if (m_dynamicResolutionEnabled)
+    {
+        double frameTime{};
+        if (Renderer::GpuTimer::Supported())
+        {
+            if (m_frameTimer->Poll(frameTime))
+            {
+                m_resolutionController.Update(frameTime);
+            }
+        }
+        else
+        {
+            // Without timer queries, only the time spent issuing the commands can be measured.
+            m_resolutionController.Update(m_lastFrameCpuTime);
+        }
+    }
 
     m_frameCount++;
     m_previousFrameVolume = audioData.vol;
+
+    m_texturePool->EndFrame();
+    m_streamingBuffer->EndFrame();
+    m_glStateCache->EndFrame();
+    m_commandRecorder->EndFrame();
+    std::swap(m_lastRenderPassStatistics, m_renderPassStatistics);
 }
 
 void ProjectM::Initialize()
@@ -212,6 +334,21 @@ void ProjectM::Initialize()
     // Check OpenGL first before allocating any additional memory.
     CheckGLSLVersion();
 
+    m_glStateCache = std::make_unique<Renderer::GLStateCache>();
+    m_glStateCache->MakeCurrent();
+
+    m_streamingBuffer = std::make_unique<Renderer::StreamingBuffer>();
+    m_streamingBuffer->MakeCurrent();
+
+    m_frameTimer = std::make_unique<Renderer::GpuTimer>();
+    m_gpuProfiler = std::make_unique<Renderer::GpuProfiler>();
+    m_commandRecorder = std::make_unique<Renderer::CommandRecorder>();
+
+    m_texturePool = std::make_unique<Renderer::TexturePool>();
+
+    m_r11g11b10fRenderable = Renderer::TextureFormat::IsRenderable(Renderer::RenderFormat::R11G11B10F);
+    m_rgba16fRenderable = Renderer::TextureFormat::IsRenderable(Renderer::RenderFormat::RGBA16F);
+
     m_timeKeeper = std::make_unique<TimeKeeper>(m_presetDuration,
                                                 m_softCutDuration,
                                                 m_hardCutDuration,
@@ -271,6 +408,7 @@ void ProjectM::SetWindowSize(uint32_t width, uint32_t height)
     /** Stash the new dimensions */
     m_windowWidth = width;
     m_windowHeight = height;
+    m_resizeDebouncer.Request(width, height);
 }
 
 void ProjectM::StartPresetTransition(std::unique_ptr<Preset>&& preset, bool hardCut)
@@ -304,11 +442,32 @@ void ProjectM::StartPresetTransition(std::unique_ptr<Preset>&& preset, bool hard
     else
     {
         m_transitioningPreset = std::move(preset);
+        m_transitionFrameCount = 0;
         m_timeKeeper->StartSmoothing();
         m_transition = std::make_unique<Renderer::PresetTransition>(m_transitionShaderManager->RandomTransition(), m_softCutDuration, m_timeKeeper->GetFrameTime());
     }
 }
 
+void ProjectM::RenderOutgoingPreset(const Audio::FrameAudioData& audioData, Renderer::RenderContext renderContext)
+{
+    // Between two rendered frames, the transition blends the outgoing preset's last image again.
+    bool const renderThisFrame = m_transitionFrameCount % m_transitionOutgoingFrameInterval == 0;
+    m_transitionFrameCount++;
+    if (!renderThisFrame)
+    {
+        return;
+    }
+
+    // The aspect ratio stays the same, so the smaller image is simply upscaled by the transition shader.
+    if (m_transitionOutgoingScale < 1.0f)
+    {
+        renderContext.viewportSizeX = std::max(1, static_cast<int>(static_cast<float>(renderContext.viewportSizeX) * m_transitionOutgoingScale));
+        renderContext.viewportSizeY = std::max(1, static_cast<int>(static_cast<float>(renderContext.viewportSizeY) * m_transitionOutgoingScale));
+    }
+
+    m_activePreset->RenderFrame(audioData, renderContext);
+}
+
 auto ProjectM::WindowWidth() -> int
 {
     return m_windowWidth;
@@ -356,19 +515,83 @@ auto ProjectM::UserSpriteIdentifiers() const -> std::vector<uint32_t>
 
 void ProjectM::BurnInTexture(uint32_t openGlTextureId, int left, int top, int width, int height)
 {
+    // Preset framebuffers store the top row first, so the rectangle and image are flipped vertically.
     if (m_activePreset)
     {
         m_activePreset->BindFramebuffer();
-        m_textureCopier->Draw(*m_shaderCache, openGlTextureId, m_windowWidth, m_windowHeight, left, top, width, height);
+        m_textureCopier->Draw(*m_shaderCache, openGlTextureId, m_windowWidth, m_windowHeight, left, top, width, height, true);
     }
 
     if (m_transitioningPreset)
     {
         m_transitioningPreset->BindFramebuffer();
-        m_textureCopier->Draw(*m_shaderCache, openGlTextureId, m_windowWidth, m_windowHeight, left, top, width, height);
+        m_textureCopier->Draw(*m_shaderCache, openGlTextureId, m_windowWidth, m_windowHeight, left, top, width, height, true);
     }
 
     Renderer::Framebuffer::Unbind();
+    glViewport(0, 0, static_cast<GLsizei>(m_windowWidth), static_cast<GLsizei>(m_windowHeight));
+}
+
+void ProjectM::GLStateChangeCounts(uint32_t& issued, uint32_t& elided) const
+{
+    auto const statistics = m_glStateCache->LastFrameStatistics();
+    issued = statistics.issued;
+    elided = statistics.elided;
+}
+
+auto ProjectM::RenderPassStatistics() const -> const Renderer::RenderGraphStatistics&
+{
+    return m_lastRenderPassStatistics;
+}
+
+auto ProjectM::TexturePoolStatistics() const -> Renderer::TexturePoolStatistics
+{
+    if (!m_texturePool)
+    {
+        return {};
+    }
+
+    return m_texturePool->GetStatistics();
+}
+
+void ProjectM::SetGpuProfilingEnabled(bool enabled)
+{
+    if (!enabled)
+    {
+        m_gpuProfiler->Clear();
+    }
+
+    m_gpuProfilingEnabled = enabled;
+}
+
+auto ProjectM::GpuProfilingEnabled() const -> bool
+{
+    return m_gpuProfilingEnabled;
+}
+
+auto ProjectM::RenderPassTimings(uint32_t frameCount) const -> std::vector<Renderer::PassTiming>
+{
+    return m_gpuProfiler->Timings(frameCount);
+}
+
+void ProjectM::SetDeferredCommandRecording(bool enabled)
+{
+    m_commandRecorder->SetDeferred(enabled);
+}
+
+auto ProjectM::DeferredCommandRecording() const -> bool
+{
+    return m_commandRecorder->Deferred();
+}
+
+auto ProjectM::CommandRecordingStatistics() const -> Renderer::CommandRecordingStatistics
+{
+    return m_commandRecorder->LastFrameStatistics();
+}
+
+auto ProjectM::LastFrameCpuTime() const -> double
+{
+    return m_lastFrameCpuTime;
 }
 
 void ProjectM::SetPresetLocked(bool locked)
@@ -394,6 +617,128 @@ auto ProjectM::PresetStartClean() const -> bool
     return m_presetStartClean;
 }
 
+void ProjectM::SetTransitionOutgoingScale(float scale)
+{
+    m_transitionOutgoingScale = std::max(0.1f, std::min(1.0f, scale));
+}
+
+auto ProjectM::TransitionOutgoingScale() const -> float
+{
+    return m_transitionOutgoingScale;
+}
+
+void ProjectM::SetTransitionOutgoingFrameInterval(uint32_t interval)
+{
+    m_transitionOutgoingFrameInterval = std::max(1U, interval);
+}
+
+auto ProjectM::TransitionOutgoingFrameInterval() const -> uint32_t
+{
+    return m_transitionOutgoingFrameInterval;
+}
+
+void ProjectM::SetDynamicResolutionEnabled(bool enabled)
+{
+    if (enabled && !m_dynamicResolutionEnabled)
+    {
+        m_resolutionController.Reset();
+    }
+
+    m_dynamicResolutionEnabled = enabled;
+}
+
+auto ProjectM::DynamicResolutionEnabled() const -> bool
+{
+    return m_dynamicResolutionEnabled;
+}
+
+void ProjectM::SetDynamicResolutionTargetFrameTime(double milliseconds)
+{
+    m_resolutionController.SetTargetFrameTime(milliseconds);
+}
+
+auto ProjectM::DynamicResolutionTargetFrameTime() const -> double
+{
+    return m_resolutionController.TargetFrameTime();
+}
+
+void ProjectM::SetDynamicResolutionScaleLimits(float minScale, float maxScale)
+{
+    m_resolutionController.SetScaleLimits(minScale, maxScale);
+}
+
+void ProjectM::DynamicResolutionScaleLimits(float& minScale, float& maxScale) const
+{
+    minScale = m_resolutionController.MinScale();
+    maxScale = m_resolutionController.MaxScale();
+}
+
+auto ProjectM::RenderScale() const -> float
+{
+    return m_dynamicResolutionEnabled ? m_resolutionController.Scale() : 1.0f;
+}
+
+void ProjectM::SetMainRenderFormat(Renderer::RenderFormat format)
+{
+    m_mainRenderFormat = RenderableFormat(format, m_mainRenderFormat);
+}
+
+auto ProjectM::MainRenderFormat() const -> Renderer::RenderFormat
+{
+    return m_mainRenderFormat;
+}
+
+void ProjectM::SetBlurRenderFormat(Renderer::RenderFormat format)
+{
+    m_blurRenderFormat = RenderableFormat(format, m_blurRenderFormat);
+}
+
+auto ProjectM::BlurRenderFormat() const -> Renderer::RenderFormat
+{
+    return m_blurRenderFormat;
+}
+
+auto ProjectM::RenderableFormat(Renderer::RenderFormat format, Renderer::RenderFormat currentFormat) const -> Renderer::RenderFormat
+{
+    switch (format)
+    {
+        case Renderer::RenderFormat::RGBA8:
+        case Renderer::RenderFormat::RGB10A2:
+            return format;
+
+        case Renderer::RenderFormat::R11G11B10F:
+            if (m_r11g11b10fRenderable)
+            {
+                return format;
+            }
+            break;
+
+        case Renderer::RenderFormat::RGBA16F:
+            if (m_rgba16fRenderable)
+            {
+                return format;
+            }
+            break;
+
+        default:
+            LOG_WARN("[ProjectM] Ignoring invalid render format " + std::to_string(static_cast<int>(format)) + ".");
+            return currentFormat;
+    }
+
+    LOG_WARN("[ProjectM] The OpenGL context can't render to floating-point textures, using RGBA8 instead.");
+    return Renderer::RenderFormat::RGBA8;
+}
+
+void ProjectM::SetResizeSettleFrames(uint32_t frames)
+{
+    m_resizeDebouncer.SetSettleFrames(frames);
+}
+
+auto ProjectM::ResizeSettleFrames() const -> uint32_t
+{
+    return m_resizeDebouncer.SettleFrames();
+}
+
 void ProjectM::SetFrameTime(double secondsSinceStart)
 {
     m_timeKeeper->SetFrameTime(secondsSinceStart);
@@ -564,14 +909,18 @@ void ProjectM::TouchDestroyAll()
 auto ProjectM::GetRenderContext() -> Renderer::RenderContext
 {
     Renderer::RenderContext ctx{};
-    ctx.viewportSizeX = m_windowWidth;
-    ctx.viewportSizeY = m_windowHeight;
+
+    // Presets are rendered at the last stable window size, see m_resizeDebouncer.
+    auto const renderWidth = m_resizeDebouncer.Width();
+    auto const renderHeight = m_resizeDebouncer.Height();
+    ctx.viewportSizeX = static_cast<int>(std::ceil(static_cast<float>(renderWidth) * RenderScale()));
+    ctx.viewportSizeY = static_cast<int>(std::ceil(static_cast<float>(renderHeight) * RenderScale()));
     ctx.time = static_cast<float>(m_timeKeeper->GetRunningTime());
     ctx.progress = static_cast<float>(m_timeKeeper->PresetProgressA());
     ctx.fps = static_cast<float>(m_targetFps);
     ctx.frame = m_frameCount;
-    ctx.aspectX = (m_windowHeight > m_windowWidth) ? static_cast<float>(m_windowWidth) / static_cast<float>(m_windowHeight) : 1.0f;
-    ctx.aspectY = (m_windowWidth > m_windowHeight) ? static_cast<float>(m_windowHeight) / static_cast<float>(m_windowWidth) : 1.0f;
+    ctx.aspectX = (renderHeight > renderWidth) ? static_cast<float>(renderWidth) / static_cast<float>(renderHeight) : 1.0f;
+    ctx.aspectY = (renderWidth > renderHeight) ? static_cast<float>(renderHeight) / static_cast<float>(renderWidth) : 1.0f;
     ctx.invAspectX = 1.0f / ctx.aspectX;
     ctx.invAspectY = 1.0f / ctx.aspectY;
 
@@ -581,8 +930,15 @@ auto ProjectM::GetRenderContext() -> Renderer::RenderContext
     ctx.texelOffsetX = m_texelOffsetX;
     ctx.texelOffsetY = m_texelOffsetY;
 
+    ctx.mainRenderFormat = m_mainRenderFormat;
+    ctx.blurRenderFormat = m_blurRenderFormat;
+
     ctx.textureManager = m_textureManager.get();
     ctx.shaderCache = m_shaderCache.get();
+    ctx.texturePool = m_texturePool.get();
+    ctx.commandRecorder = m_commandRecorder.get();
+    ctx.renderGraphStatistics = &m_renderPassStatistics;
+    ctx.gpuProfiler = m_gpuProfilingEnabled ? m_gpuProfiler.get() : nullptr;
 
     if (m_transition)
     {
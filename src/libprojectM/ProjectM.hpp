@@ -23,6 +23,9 @@
 #include <projectM-4/projectM_cxx_export.h>
 
 #include <Renderer/RenderContext.hpp>
+#include <Renderer/RenderGraph.hpp>
+#include <Renderer/ResizeDebouncer.hpp>
+#include <Renderer/ResolutionController.hpp>
 #include <Renderer/TextureTypes.hpp>
 
 #include <Audio/PCM.hpp>
@@ -36,12 +39,20 @@
 namespace libprojectM {
 
 namespace Renderer {
+class CommandRecorder;
 class CopyTexture;
+class GLStateCache;
+class GpuProfiler;
+class GpuTimer;
 class PresetTransition;
 class Renderer;
 class TextureManager;
 class ShaderCache;
+class StreamingBuffer;
+class TexturePool;
 class TransitionShaderManager;
+struct CommandRecordingStatistics;
+struct TexturePoolStatistics;
 } // namespace Renderer
 
 namespace UserSprites {
@@ -100,6 +111,17 @@ public:
      */
     void LoadPresetData(std::istream& presetData, bool smoothTransition);
 
+    /**
+     * @brief Loads a precompiled preset bundle.
+     *
+     * Presets contained in the bundle are created from the precompiled data when loaded via
+     * LoadPresetFile(), unless the source file was modified after compiling the bundle.
+     *
+     * @param bundleFile The .milkc bundle file to load.
+     * @return True if the bundle was loaded, false if an error occurred.
+     */
+    auto LoadPresetBundle(const std::string& bundleFile) -> bool;
+
     void SetWindowSize(uint32_t width, uint32_t height);
 
     /**
@@ -220,6 +242,113 @@ public:
      */
     auto PresetStartClean() const -> bool;
 
+    /**
+     * @brief Sets the resolution scale of the outgoing preset during a transition.
+     * @param scale The size of the outgoing preset's image relative to the viewport, between 0.1 and 1.0.
+     */
+    void SetTransitionOutgoingScale(float scale);
+
+    /**
+     * @brief Returns the resolution scale of the outgoing preset during a transition.
+     * @return The size of the outgoing preset's image relative to the viewport.
+     */
+    auto TransitionOutgoingScale() const -> float;
+
+    /**
+     * @brief Sets how often the outgoing preset is rendered during a transition.
+     * @param interval Render the outgoing preset only every n-th frame. 0 and 1 render it every frame.
+     */
+    void SetTransitionOutgoingFrameInterval(uint32_t interval);
+
+    /**
+     * @brief Returns how often the outgoing preset is rendered during a transition.
+     * @return The number of frames between two outgoing preset frames.
+     */
+    auto TransitionOutgoingFrameInterval() const -> uint32_t;
+
+    /**
+     * @brief Enables or disables dynamic resolution scaling.
+     * If enabled, presets are rendered at a reduced resolution if frames take longer than the target frame time.
+     * @param enabled True to enable dynamic resolution scaling, false to always render at the viewport size.
+     */
+    void SetDynamicResolutionEnabled(bool enabled);
+
+    /**
+     * @brief Returns whether dynamic resolution scaling is enabled.
+     * @return True if dynamic resolution scaling is enabled.
+     */
+    auto DynamicResolutionEnabled() const -> bool;
+
+    /**
+     * @brief Sets the frame time dynamic resolution scaling tries to stay below.
+     * @param milliseconds The target frame time in milliseconds.
+     */
+    void SetDynamicResolutionTargetFrameTime(double milliseconds);
+
+    /**
+     * @brief Returns the frame time dynamic resolution scaling tries to stay below.
+     * @return The target frame time in milliseconds.
+     */
+    auto DynamicResolutionTargetFrameTime() const -> double;
+
+    /**
+     * @brief Sets the range of the dynamic resolution scale factor.
+     * @param minScale The smallest scale factor, relative to the viewport size.
+     * @param maxScale The largest scale factor, relative to the viewport size.
+     */
+    void SetDynamicResolutionScaleLimits(float minScale, float maxScale);
+
+    /**
+     * @brief Returns the range of the dynamic resolution scale factor.
+     * @param minScale Receives the smallest scale factor.
+     * @param maxScale Receives the largest scale factor.
+     */
+    void DynamicResolutionScaleLimits(float& minScale, float& maxScale) const;
+
+    /**
+     * @brief Returns the scale factor presets are currently rendered at.
+     * @return The preset resolution relative to the viewport size. Always 1.0 if dynamic resolution scaling is disabled.
+     */
+    auto RenderScale() const -> float;
+
+    /**
+     * @brief Sets the color format of the preset main images.
+     * Invalid values are ignored. Formats the OpenGL context can't render to fall back to RGBA8.
+     * @param format The render target color format.
+     */
+    void SetMainRenderFormat(Renderer::RenderFormat format);
+
+    /**
+     * @brief Returns the color format of the preset main images.
+     * @return The render target color format.
+     */
+    auto MainRenderFormat() const -> Renderer::RenderFormat;
+
+    /**
+     * @brief Sets the color format of the preset blur textures.
+     * Invalid values are ignored. Formats the OpenGL context can't render to fall back to RGBA8.
+     * @param format The render target color format.
+     */
+    void SetBlurRenderFormat(Renderer::RenderFormat format);
+
+    /**
+     * @brief Returns the color format of the preset blur textures.
+     * @return The render target color format.
+     */
+    auto BlurRenderFormat() const -> Renderer::RenderFormat;
+
+    /**
+     * @brief Sets the number of frames a new window size must stay unchanged before presets are resized.
+     * @param frames The number of frames. 0 resizes the presets immediately.
+     */
+    void SetResizeSettleFrames(uint32_t frames);
+
+    /**
+     * @brief Returns the number of frames a new window size must stay unchanged before presets are resized.
+     * @return The number of frames.
+     */
+    auto ResizeSettleFrames() const -> uint32_t;
+
     auto PCM() -> Audio::PCM&;
 
     auto WindowWidth() -> int;
@@ -281,17 +410,99 @@ public:
      */
     void BurnInTexture(uint32_t openGlTextureId, int left, int top, int width, int height);
 
+    /**
+     * @brief Returns the number of OpenGL state changes of the last rendered frame.
+     * @param issued Receives the number of state changes sent to OpenGL.
+     * @param elided Receives the number of redundant state changes which were skipped.
+     */
+    void GLStateChangeCounts(uint32_t& issued, uint32_t& elided) const;
+
+    /**
+     * @brief Returns the render passes run and culled in the last rendered frame.
+     * Contains the passes of both presets during a transition.
+     * @return The render pass statistics of the last frame.
+     */
+    auto RenderPassStatistics() const -> const Renderer::RenderGraphStatistics&;
+
+    /**
+     * @brief Returns the occupancy of the render target texture pool shared by all presets.
+     * @return The texture pool statistics.
+     */
+    auto TexturePoolStatistics() const -> Renderer::TexturePoolStatistics;
+
+    /**
+     * @brief Enables or disables measuring the GPU time and OpenGL work of each render pass.
+     * Disabling profiling discards all recorded timings.
+     * @param enabled True to enable profiling, false to disable it.
+     */
+    void SetGpuProfilingEnabled(bool enabled);
+
+    /**
+     * @brief Returns whether render pass profiling is enabled.
+     * @return True if render pass profiling is enabled.
+     */
+    auto GpuProfilingEnabled() const -> bool;
+
+    /**
+     * @brief Returns the render pass costs of the most recent profiled frames.
+     * GPU times are available a few frames after a frame was rendered, so the last frames are not included yet.
+     * @param frameCount The maximum number of frames to return.
+     * @return The pass timings, oldest frame first and passes in render order.
+     */
+    auto RenderPassTimings(uint32_t frameCount) const -> std::vector<Renderer::PassTiming>;
+
+    /**
+     * @brief Enables or disables recording the preset drawing commands on a worker thread.
+     * The OpenGL thread replays the recorded commands while the worker evaluates the next
+     * preset component. The rendered images are the same in both modes.
+     * @param enabled True to record on a worker thread, false to record on the rendering thread.
+     */
+    void SetDeferredCommandRecording(bool enabled);
+
+    /**
+     * @brief Returns whether the preset drawing commands are recorded on a worker thread.
+     * @return True if deferred command recording is enabled.
+     */
+    auto DeferredCommandRecording() const -> bool;
+
+    /**
+     * @brief Returns the command recording costs of the last rendered frame.
+     * @return The command recording statistics of the last frame.
+     */
+    auto CommandRecordingStatistics() const -> Renderer::CommandRecordingStatistics;
+
+    /**
+     * @brief Returns the CPU time spent rendering the last frame, including waiting for recorded commands.
+     * @return The CPU time of the last frame in milliseconds.
+     */
+    auto LastFrameCpuTime() const -> double;
+
 private:
     void Initialize();
 
     void CheckGLSLVersion();
 
+    /**
+     * @brief Validates a render format requested by the application.
+     * @param format The requested render target color format.
+     * @param currentFormat The format used until now, returned if format is invalid.
+     * @return The format to use. RGBA8 if the context can't render to the requested format.
+     */
+    auto RenderableFormat(Renderer::RenderFormat format, Renderer::RenderFormat currentFormat) const -> Renderer::RenderFormat;
+
     void StartPresetTransition(std::unique_ptr<Preset>&& preset, bool hardCut);
 
     void LoadIdlePreset();
 
     auto GetRenderContext() -> Renderer::RenderContext;
 
+    /**
+     * @brief Renders the outgoing preset of a transition, using the transition quality settings.
+     * @param audioData The audio data of the current frame.
+     * @param renderContext The render context of the current frame.
+     */
+    void RenderOutgoingPreset(const Audio::FrameAudioData& audioData, Renderer::RenderContext renderContext);
+
     uint32_t m_meshX{32};            //!< Per-point mesh horizontal resolution.
     uint32_t m_meshY{24};            //!< Per-point mesh vertical resolution.
     uint32_t m_targetFps{35};        //!< Target frames per second.
@@ -319,11 +530,35 @@ private:
     bool m_presetChangeNotified{false}; //!< Stores whether the user has been notified that projectM wants to switch the preset.
     bool m_presetStartClean{false};     //!< If true, new presets start with a black canvas instead of the previous frame.
 
+    float m_transitionOutgoingScale{1.0f};        //!< Resolution scale of the outgoing preset during transitions.
+    uint32_t m_transitionOutgoingFrameInterval{1}; //!< The outgoing preset is only rendered every n-th transition frame.
+    uint32_t m_transitionFrameCount{0};            //!< Frames rendered since the current transition started.
+
+    bool m_dynamicResolutionEnabled{false};                //!< If true, presets are rendered at the scale chosen by m_resolutionController.
+    Renderer::ResolutionController m_resolutionController; //!< Chooses the preset render scale from measured frame times.
+
+    Renderer::RenderFormat m_mainRenderFormat{Renderer::RenderFormat::RGBA8}; //!< Color format of the preset main images.
+    Renderer::RenderFormat m_blurRenderFormat{Renderer::RenderFormat::RGBA8}; //!< Color format of the preset blur textures.
+    bool m_r11g11b10fRenderable{true};                                        //!< true if the context can render to R11G11B10F textures.
+    bool m_rgba16fRenderable{true};                                           //!< true if the context can render to RGBA16F textures.
+
+    Renderer::ResizeDebouncer m_resizeDebouncer; //!< Delays resizing the presets until the window size is stable.
+
+    bool m_gpuProfilingEnabled{false}; //!< If true, each render pass is measured by m_gpuProfiler.
+
+    double m_lastFrameCpuTime{}; //!< CPU time in milliseconds spent rendering the last frame.
+
     std::unique_ptr<PresetFactoryManager> m_presetFactoryManager; //!< Provides access to all available preset factories.
 
     Audio::PCM m_audioStorage;                                                    //!< Audio data buffer and analyzer instance.
+    std::unique_ptr<Renderer::GLStateCache> m_glStateCache;                       //!< Tracks OpenGL state to skip redundant changes. Destroyed last.
+    std::unique_ptr<Renderer::StreamingBuffer> m_streamingBuffer;                 //!< Ring buffer for vertex data rewritten every frame.
+    std::unique_ptr<Renderer::GpuTimer> m_frameTimer;                             //!< Measures the GPU time of each frame for dynamic resolution scaling.
+    std::unique_ptr<Renderer::GpuProfiler> m_gpuProfiler;                         //!< Measures the costs of each render pass if profiling is enabled.
+    std::unique_ptr<Renderer::CommandRecorder> m_commandRecorder;                 //!< Records the preset drawing commands, optionally on a worker thread.
     std::unique_ptr<Renderer::TextureManager> m_textureManager;                   //!< The texture manager.
     std::unique_ptr<Renderer::ShaderCache> m_shaderCache;                         //!< The global shader cache.
+    std::unique_ptr<Renderer::TexturePool> m_texturePool;                         //!< Transient render targets shared by all presets.
     std::unique_ptr<Renderer::TransitionShaderManager> m_transitionShaderManager; //!< The transition shader manager.
     std::unique_ptr<Renderer::CopyTexture> m_textureCopier;                       //!< Class that copies textures 1:1 to another texture or framebuffer.
     std::unique_ptr<Preset> m_activePreset;                                       //!< Currently loaded preset.
@@ -331,6 +566,9 @@ private:
     std::unique_ptr<Renderer::PresetTransition> m_transition;                     //!< Transition effect used for blending.
     std::unique_ptr<TimeKeeper> m_timeKeeper;                                     //!< Keeps the different timers used to render and switch presets.
     std::unique_ptr<UserSprites::SpriteManager> m_spriteManager;                  //!< Manages all types of user sprites.
+
+    Renderer::RenderGraphStatistics m_renderPassStatistics;     //!< Render passes run and culled in the current frame.
+    Renderer::RenderGraphStatistics m_lastRenderPassStatistics; //!< Render passes run and culled in the last frame.
 };
 
 } // namespace libprojectM
@@ -5,9 +5,15 @@
 #include <projectM-4/projectM.h>
 
 #include <Logging.hpp>
+#include <Tracing.hpp>
+#include <Utils.hpp>
 
 #include <Audio/AudioConstants.hpp>
+#include <MilkdropPreset/PresetIndex.hpp>
+#include <Renderer/CommandRecorder.hpp>
+#include <Renderer/FileSource.hpp>
 #include <Renderer/Platform/GLResolver.hpp>
+#include <Renderer/TexturePool.hpp>
 
 #include <projectM-4/parameters.h>
 #include <projectM-4/render_opengl.h>
@@ -42,6 +48,11 @@ libprojectM::projectMWrapper* handle_to_instance(projectm_handle instance)
     return reinterpret_cast<libprojectM::projectMWrapper*>(instance);
 }
 
+libprojectM::MilkdropPreset::PresetIndex* handle_to_preset_index(projectm_preset_index_handle index)
+{
+    return reinterpret_cast<libprojectM::MilkdropPreset::PresetIndex*>(index);
+}
+
 PROJECTM_EXPORT char* projectm_alloc_string(unsigned int length)
 {
     try
@@ -69,6 +80,20 @@ void projectm_free_string(const char* str)
     delete[] str;
 }
 
+void projectm_free_string_array(char** array)
+{
+    if (array == nullptr)
+    {
+        return;
+    }
+
+    for (int index = 0; array[index] != nullptr; index++)
+    {
+        delete[] array[index];
+    }
+    delete[] array;
+}
+
 projectm_handle projectm_create()
 {
     return projectm_create_with_opengl_load_proc(nullptr, nullptr);
@@ -122,6 +147,182 @@ void projectm_load_preset_data(projectm_handle instance, const char* data,
     projectMInstance->LoadPresetData(presetDataStream, smooth_transition);
 }
 
+bool projectm_load_preset_bundle(projectm_handle instance, const char* filename)
+{
+    auto projectMInstance = handle_to_instance(instance);
+    return projectMInstance->LoadPresetBundle(filename);
+}
+
+char** projectm_list_files(const char* path, const char* extension, bool recursive)
+{
+    if (path == nullptr)
+    {
+        return nullptr;
+    }
+
+    try
+    {
+        auto source = libprojectM::Renderer::FileSource::Open(path);
+        if (!source)
+        {
+            return nullptr;
+        }
+
+        std::string const lowerCaseExtension = extension != nullptr ? libprojectM::Utils::ToLower(extension) : "";
+        std::vector<std::string> files;
+        source->ListFiles(recursive, [&files, &lowerCaseExtension](const std::string& filePath) {
+            if (lowerCaseExtension.empty() ||
+                (filePath.length() > lowerCaseExtension.length() &&
+                 libprojectM::Utils::ToLower(filePath.substr(filePath.length() - lowerCaseExtension.length())) == lowerCaseExtension))
+            {
+                files.push_back(filePath);
+            }
+        });
+
+        auto* array = new char*[files.size() + 1]{};
+        for (size_t index = 0; index < files.size(); index++)
+        {
+            array[index] = projectm_alloc_string_from_std_string(files[index]);
+        }
+        return array;
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+projectm_preset_index_handle projectm_preset_index_open(const char* index_file)
+{
+    if (index_file == nullptr)
+    {
+        return nullptr;
+    }
+
+    try
+    {
+        return reinterpret_cast<projectm_preset_index_handle>(new libprojectM::MilkdropPreset::PresetIndex(index_file));
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+void projectm_preset_index_destroy(projectm_preset_index_handle index)
+{
+    delete handle_to_preset_index(index);
+}
+
+int projectm_preset_index_refresh(projectm_preset_index_handle index, const char** paths, size_t count)
+{
+    std::vector<std::string> presetPaths;
+    for (size_t pathIndex = 0; paths != nullptr && pathIndex < count; pathIndex++)
+    {
+        if (paths[pathIndex] != nullptr)
+        {
+            presetPaths.emplace_back(paths[pathIndex]);
+        }
+    }
+
+    try
+    {
+        return static_cast<int>(handle_to_preset_index(index)->Refresh(presetPaths));
+    }
+    catch (...)
+    {
+        return -1;
+    }
+}
+
+size_t projectm_preset_index_size(projectm_preset_index_handle index)
+{
+    return handle_to_preset_index(index)->Count();
+}
+
+char* projectm_preset_index_get_path(projectm_preset_index_handle index, size_t preset_index)
+{
+    auto* presetIndex = handle_to_preset_index(index);
+    if (preset_index >= presetIndex->Count())
+    {
+        return nullptr;
+    }
+
+    return projectm_alloc_string_from_std_string(presetIndex->Path(preset_index));
+}
+
+int projectm_preset_index_find(projectm_preset_index_handle index, const char* preset_file)
+{
+    if (preset_file == nullptr)
+    {
+        return -1;
+    }
+
+    return handle_to_preset_index(index)->Find(preset_file);
+}
+
+char** projectm_preset_index_list(projectm_preset_index_handle index, const char* path, bool recursive)
+{
+    if (path == nullptr)
+    {
+        return nullptr;
+    }
+
+    auto const presets = handle_to_preset_index(index)->List(path, recursive);
+    if (presets.empty())
+    {
+        return nullptr;
+    }
+
+    auto* array = new char*[presets.size() + 1]{};
+    for (size_t presetIndex = 0; presetIndex < presets.size(); presetIndex++)
+    {
+        array[presetIndex] = projectm_alloc_string_from_std_string(presets[presetIndex]);
+    }
+    return array;
+}
+
+bool projectm_preset_index_get_info(projectm_preset_index_handle index, size_t preset_index,
+                                    projectm_preset_info* info)
+{
+    auto* presetIndex = handle_to_preset_index(index);
+    if (info == nullptr || preset_index >= presetIndex->Count())
+    {
+        return false;
+    }
+
+    auto const presetInfo = presetIndex->Info(preset_index);
+    info->modification_time = presetInfo.modificationTime;
+    info->file_size = presetInfo.fileSize;
+    info->content_hash = presetInfo.contentHash;
+    info->flags = presetInfo.flags;
+    info->preset_version = presetInfo.presetVersion;
+    info->warp_shader_version = presetInfo.warpShaderVersion;
+    info->composite_shader_version = presetInfo.compositeShaderVersion;
+    info->wave_count = presetInfo.waveCount;
+    info->shape_count = presetInfo.shapeCount;
+    info->cost_estimate = presetInfo.costEstimate;
+
+    return true;
+}
+
+char** projectm_preset_index_get_textures(projectm_preset_index_handle index, size_t preset_index)
+{
+    auto* presetIndex = handle_to_preset_index(index);
+    if (preset_index >= presetIndex->Count())
+    {
+        return nullptr;
+    }
+
+    auto const textures = presetIndex->Info(preset_index).textures;
+    auto* array = new char*[textures.size() + 1]{};
+    for (size_t textureIndex = 0; textureIndex < textures.size(); textureIndex++)
+    {
+        array[textureIndex] = projectm_alloc_string_from_std_string(textures[textureIndex]);
+    }
+    return array;
+}
+
 void projectm_set_preset_switch_requested_event_callback(projectm_handle instance,
                                                          projectm_preset_switch_requested_event callback, void* user_data)
 {
@@ -451,6 +652,120 @@ bool projectm_get_preset_start_clean(projectm_handle instance)
     return projectMInstance->PresetStartClean();
 }
 
+void projectm_set_transition_outgoing_scale(projectm_handle instance, float scale)
+{
+    auto projectMInstance = handle_to_instance(instance);
+    projectMInstance->SetTransitionOutgoingScale(scale);
+}
+
+float projectm_get_transition_outgoing_scale(projectm_handle instance)
+{
+    auto projectMInstance = handle_to_instance(instance);
+    return projectMInstance->TransitionOutgoingScale();
+}
+
+void projectm_set_transition_outgoing_frame_interval(projectm_handle instance, uint32_t interval)
+{
+    auto projectMInstance = handle_to_instance(instance);
+    projectMInstance->SetTransitionOutgoingFrameInterval(interval);
+}
+
+uint32_t projectm_get_transition_outgoing_frame_interval(projectm_handle instance)
+{
+    auto projectMInstance = handle_to_instance(instance);
+    return projectMInstance->TransitionOutgoingFrameInterval();
+}
+
+void projectm_set_dynamic_resolution_enabled(projectm_handle instance, bool enabled)
+{
+    auto projectMInstance = handle_to_instance(instance);
+    projectMInstance->SetDynamicResolutionEnabled(enabled);
+}
+
+bool projectm_get_dynamic_resolution_enabled(projectm_handle instance)
+{
+    auto projectMInstance = handle_to_instance(instance);
+    return projectMInstance->DynamicResolutionEnabled();
+}
+
+void projectm_set_dynamic_resolution_target_frame_time(projectm_handle instance, double milliseconds)
+{
+    auto projectMInstance = handle_to_instance(instance);
+    projectMInstance->SetDynamicResolutionTargetFrameTime(milliseconds);
+}
+
+double projectm_get_dynamic_resolution_target_frame_time(projectm_handle instance)
+{
+    auto projectMInstance = handle_to_instance(instance);
+    return projectMInstance->DynamicResolutionTargetFrameTime();
+}
+
+void projectm_set_dynamic_resolution_scale_limits(projectm_handle instance, float min_scale, float max_scale)
+{
+    auto projectMInstance = handle_to_instance(instance);
+    projectMInstance->SetDynamicResolutionScaleLimits(min_scale, max_scale);
+}
+
+void projectm_get_dynamic_resolution_scale_limits(projectm_handle instance, float* min_scale, float* max_scale)
+{
+    auto projectMInstance = handle_to_instance(instance);
+    projectMInstance->DynamicResolutionScaleLimits(*min_scale, *max_scale);
+}
+
+float projectm_get_dynamic_resolution_scale(projectm_handle instance)
+{
+    auto projectMInstance = handle_to_instance(instance);
+    return projectMInstance->RenderScale();
+}
+
+void projectm_set_main_render_format(projectm_handle instance, projectm_render_format format)
+{
+    auto projectMInstance = handle_to_instance(instance);
+    projectMInstance->SetMainRenderFormat(static_cast<libprojectM::Renderer::RenderFormat>(format));
+}
+
+projectm_render_format projectm_get_main_render_format(projectm_handle instance)
+{
+    auto projectMInstance = handle_to_instance(instance);
+    return static_cast<projectm_render_format>(projectMInstance->MainRenderFormat());
+}
+
+void projectm_set_blur_render_format(projectm_handle instance, projectm_render_format format)
+{
+    auto projectMInstance = handle_to_instance(instance);
+    projectMInstance->SetBlurRenderFormat(static_cast<libprojectM::Renderer::RenderFormat>(format));
+}
+
+projectm_render_format projectm_get_blur_render_format(projectm_handle instance)
+{
+    auto projectMInstance = handle_to_instance(instance);
+    return static_cast<projectm_render_format>(projectMInstance->BlurRenderFormat());
+}
+
+void projectm_set_resize_settle_frames(projectm_handle instance, uint32_t frames)
+{
+    auto projectMInstance = handle_to_instance(instance);
+    projectMInstance->SetResizeSettleFrames(frames);
+}
+
+uint32_t projectm_get_resize_settle_frames(projectm_handle instance)
+{
+    auto projectMInstance = handle_to_instance(instance);
+    return projectMInstance->ResizeSettleFrames();
+}
+
+void projectm_set_deferred_command_recording(projectm_handle instance, bool enabled)
+{
+    auto projectMInstance = handle_to_instance(instance);
+    projectMInstance->SetDeferredCommandRecording(enabled);
+}
+
+bool projectm_get_deferred_command_recording(projectm_handle instance)
+{
+    auto projectMInstance = handle_to_instance(instance);
+    return projectMInstance->DeferredCommandRecording();
+}
+
 unsigned int projectm_pcm_get_max_samples()
 {
     return libprojectM::Audio::WaveformSamples;
@@ -484,6 +799,133 @@ auto projectm_write_debug_image_on_next_frame(projectm_handle, const char*) -> v
     // UNIMPLEMENTED
 }
 
+void projectm_get_gl_state_change_counts(projectm_handle instance, uint32_t* issued, uint32_t* elided)
+{
+    auto projectMInstance = handle_to_instance(instance);
+
+    uint32_t issuedCount{};
+    uint32_t elidedCount{};
+    projectMInstance->GLStateChangeCounts(issuedCount, elidedCount);
+
+    if (issued != nullptr)
+    {
+        *issued = issuedCount;
+    }
+    if (elided != nullptr)
+    {
+        *elided = elidedCount;
+    }
+}
+
+void projectm_get_render_pass_counts(projectm_handle instance, uint32_t* executed, uint32_t* culled)
+{
+    auto projectMInstance = handle_to_instance(instance);
+    const auto& statistics = projectMInstance->RenderPassStatistics();
+    if (executed != nullptr)
+    {
+        *executed = statistics.executed;
+    }
+    if (culled != nullptr)
+    {
+        *culled = statistics.culled;
+    }
+}
+
+void projectm_get_texture_pool_statistics(projectm_handle instance, projectm_texture_pool_statistics* statistics)
+{
+    auto projectMInstance = handle_to_instance(instance);
+    auto const poolStatistics = projectMInstance->TexturePoolStatistics();
+
+    statistics->leased_textures = poolStatistics.leasedTextures;
+    statistics->leased_bytes = poolStatistics.leasedBytes;
+    statistics->released_textures = poolStatistics.releasedTextures;
+    statistics->released_bytes = poolStatistics.releasedBytes;
+    statistics->allocations = poolStatistics.allocations;
+    statistics->reuses = poolStatistics.reuses;
+}
+
+void projectm_get_frame_cpu_statistics(projectm_handle instance, projectm_frame_cpu_statistics* statistics)
+{
+    auto projectMInstance = handle_to_instance(instance);
+    auto const recordingStatistics = projectMInstance->CommandRecordingStatistics();
+
+    statistics->frame_time_ms = projectMInstance->LastFrameCpuTime();
+    statistics->record_time_ms = recordingStatistics.recordTime;
+    statistics->wait_time_ms = recordingStatistics.waitTime;
+    statistics->command_lists = recordingStatistics.commandLists;
+    statistics->commands = recordingStatistics.commands;
+    statistics->deferred = projectMInstance->DeferredCommandRecording();
+}
+
+char* projectm_get_culled_render_passes(projectm_handle instance)
+{
+    auto projectMInstance = handle_to_instance(instance);
+
+    std::string passes;
+    for (const auto& pass : projectMInstance->RenderPassStatistics().culledPasses)
+    {
+        if (!passes.empty())
+        {
+            passes += ",";
+        }
+        passes += pass;
+    }
+
+    return projectm_alloc_string_from_std_string(passes);
+}
+
+void projectm_set_gpu_profiling_enabled(projectm_handle instance, bool enabled)
+{
+    auto projectMInstance = handle_to_instance(instance);
+    projectMInstance->SetGpuProfilingEnabled(enabled);
+}
+
+bool projectm_get_gpu_profiling_enabled(projectm_handle instance)
+{
+    auto projectMInstance = handle_to_instance(instance);
+    return projectMInstance->GpuProfilingEnabled();
+}
+
+size_t projectm_get_render_pass_timings(projectm_handle instance, uint32_t frame_count,
+                                        projectm_render_pass_timing* timings, size_t max_timings)
+{
+    auto projectMInstance = handle_to_instance(instance);
+    auto const passTimings = projectMInstance->RenderPassTimings(frame_count);
+
+    if (timings != nullptr)
+    {
+        for (size_t index = 0; index < passTimings.size() && index < max_timings; index++)
+        {
+            const auto& passTiming = passTimings.at(index);
+            auto& timing = timings[index];
+
+            std::strncpy(timing.name, passTiming.name.c_str(), sizeof(timing.name) - 1);
+            timing.name[sizeof(timing.name) - 1] = '\0';
+            timing.frame = passTiming.frame;
+            timing.gpu_milliseconds = passTiming.gpuTime;
+            timing.draw_calls = passTiming.drawCalls;
+            timing.state_changes = passTiming.stateChanges;
+        }
+    }
+
+    return passTimings.size();
+}
+
+void projectm_set_tracing_enabled(bool enabled)
+{
+    libprojectM::Tracing::SetEnabled(enabled);
+}
+
+bool projectm_get_tracing_enabled()
+{
+    return libprojectM::Tracing::IsEnabled();
+}
+
+char* projectm_get_trace_json(double seconds)
+{
+    return projectm_alloc_string_from_std_string(libprojectM::Tracing::ExportChromeTrace(seconds));
+}
+
 uint32_t projectm_sprite_create(projectm_handle instance, const char* type, const char* code)
 {
     auto* projectMInstance = handle_to_instance(instance);
@@ -1,5 +1,7 @@
 #include "Renderer/BlendMode.hpp"
 
+#include "Renderer/GLStateCache.hpp"
+
 namespace libprojectM {
 namespace Renderer {
 
@@ -11,19 +13,12 @@ void BlendMode::Set(bool enable, Function srcFunc, Function dstFunc)
 
 void BlendMode::SetBlendActive(bool enable)
 {
-    if (enable)
-    {
-        glEnable(GL_BLEND);
-    }
-    else
-    {
-        glDisable(GL_BLEND);
-    }
+    GLStateCache::Current().SetCapability(GL_BLEND, enable);
 }
 
 void BlendMode::SetBlendFunction(Function srcFunc, Function dstFunc)
 {
-    glBlendFunc(FunctionToGL(srcFunc), FunctionToGL(dstFunc));
+    GLStateCache::Current().BlendFunc(FunctionToGL(srcFunc), FunctionToGL(dstFunc));
 }
 
 auto BlendMode::FunctionToGL(Function func) -> GLuint
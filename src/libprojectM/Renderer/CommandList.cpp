@@ -0,0 +1,37 @@
+#include "Renderer/CommandList.hpp"
+
+#include <utility>
+
+namespace libprojectM {
+namespace Renderer {
+
+void CommandList::Record(Command command)
+{
+    m_commands.push_back(std::move(command));
+}
+
+void CommandList::Execute() const
+{
+    for (const auto& command : m_commands)
+    {
+        command();
+    }
+}
+
+void CommandList::Clear()
+{
+    m_commands.clear();
+}
+
+auto CommandList::Size() const -> size_t
+{
+    return m_commands.size();
+}
+
+auto CommandList::Empty() const -> bool
+{
+    return m_commands.empty();
+}
+
+} // namespace Renderer
+} // namespace libprojectM
@@ -0,0 +1,73 @@
+/**
+ * @file CommandList.hpp
+ * @brief A recorded sequence of rendering commands, replayed later on the OpenGL thread.
+ */
+#pragma once
+
+#include "Renderer/InlineFunction.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace libprojectM {
+namespace Renderer {
+
+/**
+ * @brief A recorded sequence of rendering commands, replayed later on the OpenGL thread.
+ *
+ * Components split their per-frame work into a CPU part, e.g. evaluating expressions and
+ * generating vertices, and an OpenGL part, e.g. buffer uploads, uniform updates and draw calls.
+ * The CPU part runs while recording and may run on any thread, so it must not call OpenGL. It
+ * records the OpenGL part as commands, which are executed in recording order on the thread which
+ * owns the OpenGL context.
+ *
+ * Commands must not reference data which the recording thread changes after recording them.
+ * Values which differ between commands, e.g. the geometry of each shape instance, are captured
+ * by value or kept in separate storage owned by the recording component until the next frame.
+ *
+ * Commands are stored inline, so captures are limited to InlineFunction::Capacity bytes, e.g.
+ * four pointers. Clearing the list keeps its storage, so recording a similar number of commands
+ * each frame doesn't allocate memory.
+ */
+class CommandList
+{
+public:
+    using Command = InlineFunction<void()>; //!< A recorded command, executed on the OpenGL thread.
+
+    CommandList() = default;
+
+    /**
+     * @brief Appends a command to the list.
+     * @param command The command to execute on replay.
+     */
+    void Record(Command command);
+
+    /**
+     * @brief Executes all recorded commands in recording order.
+     * Must be called on the thread which owns the OpenGL context.
+     */
+    void Execute() const;
+
+    /**
+     * @brief Removes all recorded commands, keeping the allocated storage.
+     */
+    void Clear();
+
+    /**
+     * @brief Returns the number of recorded commands.
+     * @return The number of commands in the list.
+     */
+    auto Size() const -> size_t;
+
+    /**
+     * @brief Returns whether any commands were recorded.
+     * @return true if the list is empty, false if it contains at least one command.
+     */
+    auto Empty() const -> bool;
+
+private:
+    std::vector<Command> m_commands; //!< The recorded commands, in recording order.
+};
+
+} // namespace Renderer
+} // namespace libprojectM
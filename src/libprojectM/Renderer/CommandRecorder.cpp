@@ -0,0 +1,270 @@
+#include "Renderer/CommandRecorder.hpp"
+
+#include <Logging.hpp>
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+namespace libprojectM {
+namespace Renderer {
+
+CommandRecorder::~CommandRecorder()
+{
+    StopWorker();
+}
+
+void CommandRecorder::SetDeferred(bool deferred)
+{
+    m_deferred = deferred;
+
+    if (!m_deferred)
+    {
+        StopWorker();
+    }
+}
+
+auto CommandRecorder::Deferred() const -> bool
+{
+    return m_deferred;
+}
+
+auto CommandRecorder::Add(RecordFunction recordFunction) -> size_t
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    if (m_batchStarted)
+    {
+        EndBatch(lock);
+        m_error = nullptr;
+    }
+
+    size_t const index = m_recordFunctions.size();
+    m_recordFunctions.push_back(std::move(recordFunction));
+
+    if (m_commandLists.size() <= index)
+    {
+        m_commandLists.resize(index + 1);
+    }
+    m_commandLists[index].Clear();
+
+    return index;
+}
+
+void CommandRecorder::Start()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    m_batchStarted = true;
+    m_recordedCount = 0;
+    m_deferredBatch = m_deferred && !m_recordFunctions.empty() && StartWorker();
+
+    if (m_deferredBatch)
+    {
+        m_workCondition.notify_one();
+    }
+}
+
+void CommandRecorder::Replay(size_t index)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    if (index >= m_recordFunctions.size())
+    {
+        throw std::out_of_range("CommandRecorder::Replay: command list index " + std::to_string(index) + " not in current batch");
+    }
+
+    if (!m_deferredBatch)
+    {
+        while (m_recordedCount <= index)
+        {
+            RecordNext(lock);
+        }
+    }
+    else if (m_recordedCount <= index)
+    {
+        auto const waitStart = std::chrono::steady_clock::now();
+        m_recordCondition.wait(lock, [this, index]() {
+            return m_recordedCount > index;
+        });
+        m_frameStatistics.waitTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - waitStart).count();
+    }
+
+    if (m_error)
+    {
+        auto error = m_error;
+        m_error = nullptr;
+        std::rethrow_exception(error);
+    }
+
+    // The worker only writes lists which aren't recorded yet, so this one can be executed unlocked.
+    const auto& commandList = m_commandLists[index];
+    lock.unlock();
+
+    commandList.Execute();
+}
+
+void CommandRecorder::Finish()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    EndBatch(lock);
+
+    if (m_error)
+    {
+        auto error = m_error;
+        m_error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void CommandRecorder::BeginFrame()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_frameStatistics = {};
+}
+
+void CommandRecorder::EndFrame()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_lastFrameStatistics = m_frameStatistics;
+}
+
+auto CommandRecorder::LastFrameStatistics() const -> CommandRecordingStatistics
+{
+    return m_lastFrameStatistics;
+}
+
+auto CommandRecorder::StartWorker() -> bool
+{
+    if (m_worker.joinable())
+    {
+        return true;
+    }
+
+    if (m_workerFailed)
+    {
+        return false;
+    }
+
+    try
+    {
+        m_worker = std::thread(&CommandRecorder::WorkerLoop, this);
+    }
+    catch (const std::system_error& ex)
+    {
+        // E.g. Emscripten builds without pthread support.
+        LOG_WARN(std::string("[CommandRecorder] Could not start the recording thread, recording on the render thread: ") + ex.what());
+        m_workerFailed = true;
+        return false;
+    }
+
+    return true;
+}
+
+void CommandRecorder::StopWorker()
+{
+    if (!m_worker.joinable())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopWorker = true;
+    }
+    m_workCondition.notify_all();
+
+    m_worker.join();
+    m_stopWorker = false;
+}
+
+void CommandRecorder::WorkerLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (true)
+    {
+        m_workCondition.wait(lock, [this]() {
+            return m_stopWorker || (m_deferredBatch && m_recordedCount < m_recordFunctions.size());
+        });
+
+        // Pending lists are always recorded before stopping, as the render thread may wait for them.
+        if (m_deferredBatch && m_recordedCount < m_recordFunctions.size())
+        {
+            RecordNext(lock);
+            m_recordCondition.notify_all();
+            continue;
+        }
+
+        return;
+    }
+}
+
+void CommandRecorder::RecordNext(std::unique_lock<std::mutex>& lock)
+{
+    size_t const index = m_recordedCount;
+    auto& recordFunction = m_recordFunctions[index];
+    auto& commandList = m_commandLists[index];
+
+    lock.unlock();
+
+    std::exception_ptr error;
+    auto const recordStart = std::chrono::steady_clock::now();
+    try
+    {
+        recordFunction(commandList);
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+    }
+    auto const recordTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - recordStart).count();
+
+    lock.lock();
+
+    m_frameStatistics.recordTime += recordTime;
+
+    if (error)
+    {
+        // Don't replay a partially recorded list, and skip the remaining lists of the batch.
+        commandList.Clear();
+        if (!m_error)
+        {
+            m_error = error;
+        }
+        m_recordedCount = m_recordFunctions.size();
+        return;
+    }
+
+    m_frameStatistics.commandLists++;
+    m_frameStatistics.commands += static_cast<uint32_t>(commandList.Size());
+    m_recordedCount++;
+}
+
+void CommandRecorder::EndBatch(std::unique_lock<std::mutex>& lock)
+{
+    if (m_deferredBatch)
+    {
+        m_recordCondition.wait(lock, [this]() {
+            return m_recordedCount >= m_recordFunctions.size();
+        });
+    }
+    else
+    {
+        while (m_recordedCount < m_recordFunctions.size())
+        {
+            RecordNext(lock);
+        }
+    }
+
+    m_recordFunctions.clear();
+    m_recordedCount = 0;
+    m_batchStarted = false;
+    m_deferredBatch = false;
+}
+
+} // namespace Renderer
+} // namespace libprojectM
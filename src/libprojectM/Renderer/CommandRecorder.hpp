@@ -0,0 +1,175 @@
+/**
+ * @file CommandRecorder.hpp
+ * @brief Records command lists on a worker thread while the OpenGL thread replays them.
+ */
+#pragma once
+
+#include "Renderer/CommandList.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace libprojectM {
+namespace Renderer {
+
+/**
+ * @brief Command recording costs of a frame.
+ */
+struct CommandRecordingStatistics {
+    uint32_t commandLists{}; //!< Number of command lists recorded.
+    uint32_t commands{};     //!< Number of commands recorded.
+    double recordTime{};     //!< Milliseconds spent running the record functions, on the worker or the OpenGL thread.
+    double waitTime{};       //!< Milliseconds the OpenGL thread waited for the worker to finish a list.
+};
+
+/**
+ * @brief Records command lists on a worker thread while the OpenGL thread replays them.
+ *
+ * Each frame, the OpenGL thread adds one record function per component with Add(), in the order
+ * the components are drawn, and then calls Start(). In deferred mode, a worker thread runs the
+ * record functions in that order, each one into its own CommandList. Replay() waits until a list
+ * is recorded and executes it on the calling thread, so the OpenGL thread submits the commands of
+ * one component while the worker already evaluates the next one. Finish() waits until all lists
+ * are recorded and must be called before the data used by the record functions changes again.
+ *
+ * All lists are recorded by a single worker, in the order they were added. The expressions of
+ * the per-pixel mesh, custom shapes and custom waves share the global registers and megabuf, and
+ * a component may depend on the values written by the ones before it. For the same reason, the
+ * OpenGL thread must not run any expression code between Start() and Finish().
+ *
+ * In direct mode, or if no thread can be started on the platform, Replay() first records all
+ * lists up to the requested one on the calling thread. Both modes evaluate the same code in the
+ * same order and produce the same commands, so the rendered images are identical.
+ *
+ * Exceptions thrown by a record function are rethrown by the next Replay() or Finish() call.
+ * The remaining lists of the batch are left empty.
+ */
+class CommandRecorder
+{
+public:
+    using RecordFunction = InlineFunction<void(CommandList&)>; //!< Runs the CPU work of a component and records its commands.
+
+    CommandRecorder() = default;
+
+    /**
+     * Destructor. Waits for the current batch and stops the worker thread.
+     */
+    ~CommandRecorder();
+
+    CommandRecorder(const CommandRecorder&) = delete;
+    auto operator=(const CommandRecorder&) -> CommandRecorder& = delete;
+
+    /**
+     * @brief Enables or disables recording on the worker thread.
+     * The worker is started with the first deferred batch and stopped when disabling deferred
+     * recording. Must not be called between Start() and Finish().
+     * @param deferred true to record on a worker thread, false to record on the OpenGL thread.
+     */
+    void SetDeferred(bool deferred);
+
+    /**
+     * @brief Returns whether recording on the worker thread is enabled.
+     * @return true if deferred recording is enabled, false if not.
+     */
+    auto Deferred() const -> bool;
+
+    /**
+     * @brief Adds a record function to the next batch.
+     * If the previous batch wasn't finished, e.g. because an exception was thrown while rendering
+     * it, it's finished first, discarding any recording errors.
+     * @param recordFunction The function to run. Its data must stay valid until Finish() returns.
+     * @return The index of the command list to pass to Replay().
+     */
+    auto Add(RecordFunction recordFunction) -> size_t;
+
+    /**
+     * @brief Starts recording all added command lists on the worker, if deferred recording is enabled.
+     */
+    void Start();
+
+    /**
+     * @brief Waits until the given command list is recorded and executes it on the calling thread.
+     * @throws std::exception Any exception thrown by a record function since the last Replay() call.
+     * @param index The command list index returned by Add().
+     */
+    void Replay(size_t index);
+
+    /**
+     * @brief Waits until all command lists of the batch are recorded and ends the batch.
+     * Lists which weren't replayed are discarded.
+     * @throws std::exception Any exception thrown by a record function and not yet rethrown by Replay().
+     */
+    void Finish();
+
+    /**
+     * @brief Resets the recording statistics for a new frame.
+     */
+    void BeginFrame();
+
+    /**
+     * @brief Stores the statistics of the frame for LastFrameStatistics().
+     */
+    void EndFrame();
+
+    /**
+     * @brief Returns the recording statistics of the last completed frame.
+     * @return The statistics of the last frame.
+     */
+    auto LastFrameStatistics() const -> CommandRecordingStatistics;
+
+private:
+    /**
+     * @brief Starts the worker thread if it isn't running yet.
+     * @return true if the worker is running, false if no thread could be started.
+     */
+    auto StartWorker() -> bool;
+
+    /**
+     * @brief Stops the worker thread after it recorded all pending lists.
+     */
+    void StopWorker();
+
+    /**
+     * @brief Worker thread main loop. Records lists of deferred batches until stopped.
+     */
+    void WorkerLoop();
+
+    /**
+     * @brief Records the next list of the batch on the calling thread.
+     * @param lock A lock on m_mutex, which is released while the record function runs.
+     */
+    void RecordNext(std::unique_lock<std::mutex>& lock);
+
+    /**
+     * @brief Waits until all lists of the batch are recorded, then clears the batch.
+     * @param lock A lock on m_mutex.
+     */
+    void EndBatch(std::unique_lock<std::mutex>& lock);
+
+    bool m_deferred{false};      //!< If true, deferred batches are recorded by the worker.
+    bool m_workerFailed{false};  //!< True if the worker thread couldn't be started. All batches are recorded directly.
+    bool m_batchStarted{false};  //!< True between Start() and Finish().
+    bool m_deferredBatch{false}; //!< True if the current batch is recorded by the worker.
+    bool m_stopWorker{false};    //!< Set to stop the worker thread.
+
+    std::vector<RecordFunction> m_recordFunctions; //!< The record functions of the current batch.
+    std::vector<CommandList> m_commandLists;       //!< One command list per record function. Kept across frames to reuse the storage.
+    size_t m_recordedCount{};                      //!< Number of lists of the current batch which are recorded.
+    std::exception_ptr m_error;                    //!< The first exception thrown by a record function of the current batch.
+
+    CommandRecordingStatistics m_frameStatistics;     //!< Statistics of the frame currently being rendered.
+    CommandRecordingStatistics m_lastFrameStatistics; //!< Statistics of the last completed frame.
+
+    std::mutex m_mutex;                        //!< Guards the batch state shared with the worker.
+    std::condition_variable m_workCondition;   //!< Signaled when the worker has lists to record or should stop.
+    std::condition_variable m_recordCondition; //!< Signaled when the worker finished recording a list.
+    std::thread m_worker;                      //!< The recording worker thread, if started.
+};
+
+} // namespace Renderer
+} // namespace libprojectM
@@ -1,5 +1,9 @@
 #include "Renderer/CopyTexture.hpp"
 
+#include "Renderer/GLStateCache.hpp"
+
+#include <cstdlib>
+
 namespace libprojectM {
 namespace Renderer {
 
@@ -20,7 +24,7 @@ out vec2 fragment_tex_coord;
 uniform mat4 vertex_transformation;
 
 void main() {
-    gl_Position = vec4(position, 0.0, 1.0) * vertex_transformation;
+    gl_Position = vertex_transformation * vec4(position, 0.0, 1.0);
     fragment_tex_coord = tex_coord;
 }
 )";
@@ -195,7 +199,7 @@ void CopyTexture::Draw(ShaderCache& shaderCache,
     internalTexture = m_framebuffer.GetColorAttachmentTexture(0, 0);
     m_framebuffer.GetAttachment(0, TextureAttachment::AttachmentType::Color, 0)->Texture(targetTexture);
 
-    Copy(shaderCache, left, top, width, height);
+    Copy(shaderCache, left, top, width, height, false);
 
     // Rebind our internal texture.
     m_framebuffer.GetAttachment(0, TextureAttachment::AttachmentType::Color, 0)->Texture(internalTexture);
@@ -206,7 +210,8 @@ void CopyTexture::Draw(ShaderCache& shaderCache,
 void CopyTexture::Draw(ShaderCache& shaderCache,
                        GLuint originalTexture,
                        int viewportWidth, int viewportHeight,
-                       int left, int top, int width, int height)
+                       int left, int top, int width, int height,
+                       bool flipVertical)
 {
     if (originalTexture == 0)
     {
@@ -225,9 +230,8 @@ void CopyTexture::Draw(ShaderCache& shaderCache,
     m_height = viewportHeight;
 
     // Draw from original texture
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, originalTexture);
-    Copy(shaderCache, left, top, width, height);
+    GLStateCache::Current().BindTexture(0, GL_TEXTURE_2D, originalTexture);
+    Copy(shaderCache, left, top, width, height, flipVertical);
 
     m_width = oldWidth;
     m_height = oldHeight;
@@ -265,25 +269,38 @@ void CopyTexture::Copy(ShaderCache& shaderCache,
     shader->SetUniformInt("texture_sampler", 0);
     shader->SetUniformMat4x4("vertex_transformation", flipMatrix);
 
-    m_sampler.Bind(0);
+    // Samples exactly at texel centers if the sizes match, so only scaled copies are filtered.
+    m_scalingSampler.Bind(0);
 
     m_mesh.Draw();
 
-    glBindTexture(GL_TEXTURE_2D, 0);
+    GLStateCache::Current().BindTexture(0, GL_TEXTURE_2D, 0);
     Mesh::Unbind();
     Sampler::Unbind(0);
     Shader::Unbind();
 }
 
 void CopyTexture::Copy(ShaderCache& shaderCache,
-                       int left, int top, int width, int height)
+                       int left, int top, int width, int height,
+                       bool flipVertical)
 {
+    auto const targetWidth = static_cast<float>(m_width);
+    auto const targetHeight = static_cast<float>(m_height);
+
+    // The quad spans -1 to 1, so it is scaled to the rectangle size and moved to the rectangle center.
+    // Negative sizes flip the image, but keep the rectangle in place.
     glm::mat4x4 translationMatrix(1.0);
-    translationMatrix[0][0] = static_cast<float>(width) / static_cast<float>(m_width);
-    translationMatrix[1][1] = static_cast<float>(height) / static_cast<float>(m_height);
+    translationMatrix[0][0] = static_cast<float>(width) / targetWidth;
+    translationMatrix[1][1] = static_cast<float>(height) / targetHeight;
+
+    translationMatrix[3][0] = static_cast<float>(2 * left + std::abs(width)) / targetWidth - 1.0f;
+    translationMatrix[3][1] = 1.0f - static_cast<float>(2 * top + std::abs(height)) / targetHeight;
 
-    translationMatrix[3][0] = static_cast<float>(left) / static_cast<float>(m_width);
-    translationMatrix[3][1] = static_cast<float>(top) / static_cast<float>(m_height);
+    if (flipVertical)
+    {
+        translationMatrix[1][1] = -translationMatrix[1][1];
+        translationMatrix[3][1] = -translationMatrix[3][1];
+    }
 
     std::shared_ptr<Shader> shader = BindShader(shaderCache);
 
@@ -64,10 +64,10 @@ public:
      * @param shaderCache The global shader cache instance.
      * @param originalTexture The texture to be copied.
      * @param targetTexture The target texture to draw onto.
-     * @param left Left offset on the target texture in screen coordinates.
-     * @param top Top offset on the target texture in screen coordinates.
-     * @param width Width on the target texture in screen coordinates. Use a negative value to flip vertically.
-     * @param height Height on the target texture in screen coordinates. Use a negative value to flip horizontally.
+     * @param left Left offset on the target texture in pixels.
+     * @param top Top offset on the target texture in pixels, counted from the top edge.
+     * @param width Width on the target texture in pixels. Use a negative value to flip horizontally.
+     * @param height Height on the target texture in pixels. Use a negative value to flip vertically.
      */
     void Draw(ShaderCache& shaderCache,
               const std::shared_ptr<Texture>& originalTexture,
@@ -80,15 +80,17 @@ public:
      * @param originalTexture The texture ID to be copied.
      * @param viewportWidth The target surface width.
      * @param viewportHeight The target surface height.
-     * @param left Left offset on the target texture in screen coordinates.
-     * @param top Top offset on the target texture in screen coordinates.
-     * @param width Width on the target texture in screen coordinates. Use a negative value to flip vertically.
-     * @param height Height on the target texture in screen coordinates. Use a negative value to flip horizontally.
+     * @param left Left offset on the target texture in pixels.
+     * @param top Top offset on the target texture in pixels, counted from the top edge.
+     * @param width Width on the target texture in pixels. Use a negative value to flip horizontally.
+     * @param height Height on the target texture in pixels. Use a negative value to flip vertically.
+     * @param flipVertical Set if the target stores its rows top to bottom, e.g. a preset framebuffer.
      */
     void Draw(ShaderCache& shaderCache,
               GLuint originalTexture,
               int viewportWidth, int viewportHeight,
-              int left, int top, int width, int height);
+              int left, int top, int width, int height,
+              bool flipVertical = false);
 
     /**
      * @brief Returns the flipped texture.
@@ -107,12 +109,14 @@ private:
               bool flipVertical, bool flipHorizontal);
 
     void Copy(ShaderCache& shaderCache,
-              int left, int top, int width, int height);
+              int left, int top, int width, int height,
+              bool flipVertical);
 
     Mesh m_mesh;
-    std::weak_ptr<Shader> m_shader;                  //!< Simple textured shader
-    Framebuffer m_framebuffer{1};                    //!< Framebuffer for drawing the flipped texture
-    Sampler m_sampler{GL_CLAMP_TO_EDGE, GL_NEAREST}; //!< Texture sampler settings
+    std::weak_ptr<Shader> m_shader;                        //!< Simple textured shader
+    Framebuffer m_framebuffer{1};                          //!< Framebuffer for drawing the flipped texture
+    Sampler m_sampler{GL_CLAMP_TO_EDGE, GL_NEAREST};       //!< Texture sampler settings
+    Sampler m_scalingSampler{GL_CLAMP_TO_EDGE, GL_LINEAR}; //!< Sampler for full-size copies, which may scale the image.
 
     int m_width{};  //!< Last known framebuffer/texture width
     int m_height{}; //!< Last known framebuffer/texture height
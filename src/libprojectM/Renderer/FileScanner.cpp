@@ -1,5 +1,6 @@
 #include "FileScanner.hpp"
 
+#include "FileSource.hpp"
 #include "Utils.hpp"
 
 #include <algorithm>
@@ -27,55 +28,28 @@ void FileScanner::Scan(ScanCallback callback)
 {
     for (const auto& currentPath : _rootDirs)
     {
-        try
+        auto source = FileSource::Open(currentPath);
+        if (!source)
         {
-            path basePath(currentPath);
-
-            if (!exists(basePath))
-            {
-                continue;
-            }
+            continue;
+        }
 
-            // Resolve any symlinks first, so we can check the type.
-            while (is_symlink(basePath))
-            {
-                basePath = read_symlink(basePath);
-            }
+        source->ListFiles(true, [this, &callback](const std::string& filePath) {
+            path const entryPath(filePath);
 
-            // Skip regular files and other stuff
-            if (!is_directory(basePath))
+            // Skip files without extensions.
+            if (!entryPath.has_extension())
             {
-                continue;
+                return;
             }
 
-            for (const auto& entry : recursive_directory_iterator(basePath))
+            // Match the lower-case extension of the file with the provided list of valid extensions.
+            auto extension = Utils::ToLower(entryPath.extension().string());
+            if (std::find(_extensions.begin(), _extensions.end(), extension) != _extensions.end())
             {
-                // Skip files without extensions and everything that's not a normal file.
-#ifdef PROJECTM_FILESYSTEM_USE_BOOST
-                if (!entry.path().has_extension() || (entry.status().type() != file_type::symlink_file && entry.status().type() != file_type::regular_file))
-#else
-                if (!entry.path().has_extension() || (is_symlink(entry.status()) && is_regular_file(entry.status())))
-#endif
-                {
-                    continue;
-                }
-
-                // Match the lower-case extension of the file with the provided list of valid extensions.
-                auto extension = Utils::ToLower(entry.path().extension().string());
-                if (std::find(_extensions.begin(), _extensions.end(), extension) != _extensions.end())
-                {
-                    callback(entry.path().string(), entry.path().stem().string());
-                }
+                callback(filePath, entryPath.stem().string());
             }
-        }
-        catch (filesystem_error&)
-        {
-            // ToDo: Log error. We ignore it for now.
-        }
-        catch (std::exception&)
-        {
-            // ToDo: Log error. We ignore it for now.
-        }
+        });
     }
 }
 
@@ -11,7 +11,7 @@ namespace Renderer {
  * @class FileScanner
  * @brief Simple recursive scanner which returns all files matching a given list of filename extensions.
  *
- * All extensions are matched case-insensitively.
+ * Root paths can be directories or archives, see FileSource. All extensions are matched case-insensitively.
  */
 class FileScanner
 {
@@ -24,7 +24,7 @@ public:
 
     /**
      * @brief Creates a new file scanner.
-     * @param rootDirs A list of root directories to scan.
+     * @param rootDirs A list of root directories or archives to scan.
      * @param extensions A list of file extensions to search for. Matching is performed case-insensitively.
      */
 	FileScanner(const std::vector<std::string> &rootDirs, std::vector<std::string> &extensions);
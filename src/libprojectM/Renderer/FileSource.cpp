@@ -0,0 +1,219 @@
+#include "FileSource.hpp"
+
+#include "ZipFileSource.hpp"
+
+#include <Logging.hpp>
+#include <Utils.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+// Fall back to boost if compiler doesn't support C++17
+#include PROJECTM_FILESYSTEM_INCLUDE
+using namespace PROJECTM_FILESYSTEM_NAMESPACE::filesystem;
+
+namespace libprojectM {
+namespace Renderer {
+
+namespace {
+
+/**
+ * @brief An indexed archive, together with the file state it was indexed from.
+ */
+struct CachedArchive {
+    std::shared_ptr<ZipFileSource> source;             //!< The indexed archive.
+    decltype(last_write_time(path())) lastWriteTime{}; //!< Modification time of the archive when it was indexed.
+    uintmax_t fileSize{};                              //!< Size of the archive when it was indexed.
+};
+
+std::mutex archiveCacheMutex;                      //!< Guards the archive cache, as multiple projectM instances may share it.
+std::map<std::string, CachedArchive> archiveCache; //!< All archives indexed so far, by file path.
+
+auto OpenArchive(const std::string& archiveFile) -> std::shared_ptr<ZipFileSource>
+{
+    decltype(last_write_time(path())) lastWriteTime{};
+    uintmax_t fileSize{};
+    try
+    {
+        lastWriteTime = last_write_time(archiveFile);
+        fileSize = file_size(archiveFile);
+    }
+    catch (filesystem_error&)
+    {
+        return {};
+    }
+
+    std::lock_guard<std::mutex> lock(archiveCacheMutex);
+
+    auto cached = archiveCache.find(archiveFile);
+    if (cached != archiveCache.end() && cached->second.lastWriteTime == lastWriteTime && cached->second.fileSize == fileSize)
+    {
+        return cached->second.source;
+    }
+
+    try
+    {
+        auto archive = std::make_shared<ZipFileSource>(archiveFile);
+        LOG_DEBUG("[FileSource] Indexed archive \"" + archiveFile + "\" with " + std::to_string(archive->Count()) + " files.");
+        archiveCache[archiveFile] = {archive, lastWriteTime, fileSize};
+        return archive;
+    }
+    catch (std::runtime_error& ex)
+    {
+        LOG_ERROR(ex.what());
+        archiveCache.erase(archiveFile);
+        return {};
+    }
+}
+
+auto ReadDiskFile(const std::string& filePath, std::vector<char>& data,
+                  size_t maxSize = std::numeric_limits<size_t>::max()) -> bool
+{
+    std::ifstream file(filePath, std::ios_base::in | std::ios_base::binary | std::ios_base::ate);
+    if (!file.good())
+    {
+        return false;
+    }
+
+    auto const fileSize = file.tellg();
+    if (fileSize < 0 || static_cast<uintmax_t>(fileSize) > maxSize)
+    {
+        return false;
+    }
+
+    data.resize(static_cast<size_t>(fileSize));
+    file.seekg(0, std::ios_base::beg);
+    return static_cast<bool>(file.read(data.data(), fileSize));
+}
+
+} // namespace
+
+auto FileSource::Open(const std::string& sourcePath) -> std::shared_ptr<FileSource>
+{
+    try
+    {
+        if (is_directory(sourcePath))
+        {
+            return std::make_shared<DirectoryFileSource>(sourcePath);
+        }
+
+        if (IsArchive(sourcePath) && is_regular_file(sourcePath))
+        {
+            return OpenArchive(sourcePath);
+        }
+    }
+    catch (filesystem_error&)
+    {
+    }
+
+    return {};
+}
+
+auto FileSource::Read(const std::string& filePath, std::vector<char>& data, size_t maxSize) -> bool
+{
+    // Files on disk take precedence, only look into archives if the path doesn't exist.
+    if (ReadDiskFile(filePath, data, maxSize))
+    {
+        return true;
+    }
+
+    // Try each ".zip" path component as the archive, as the directory part may contain one as well.
+    auto const lowerCasePath = Utils::ToLower(filePath);
+    size_t position{};
+    while ((position = lowerCasePath.find(".zip", position)) != std::string::npos)
+    {
+        position += 4;
+        if (position >= filePath.size() || (filePath.at(position) != '/' && filePath.at(position) != '\\'))
+        {
+            continue;
+        }
+
+        auto archive = OpenArchive(filePath.substr(0, position));
+        if (archive)
+        {
+            auto entryName = filePath.substr(position + 1);
+            std::replace(entryName.begin(), entryName.end(), '\\', '/');
+            // ZipFileSource already refuses to extract huge entries, so checking the size afterwards is safe.
+            if (!archive->ReadEntry(entryName, data) || data.size() > maxSize)
+            {
+                data.clear();
+                return false;
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
+
+auto FileSource::IsArchive(const std::string& filePath) -> bool
+{
+    return filePath.length() > 4 && Utils::ToLower(filePath.substr(filePath.length() - 4)) == ".zip";
+}
+
+DirectoryFileSource::DirectoryFileSource(std::string directory)
+    : m_directory(std::move(directory))
+{
+}
+
+void DirectoryFileSource::ListFiles(bool recursive, const ListCallback& callback) const
+{
+    try
+    {
+        path basePath(m_directory);
+
+        // Resolve any symlinks first, so we can check the type.
+        while (is_symlink(basePath))
+        {
+            basePath = read_symlink(basePath);
+        }
+
+        if (!is_directory(basePath))
+        {
+            return;
+        }
+
+        auto const listEntry = [&callback](const directory_entry& entry) {
+            // Skip everything that's not a normal file or a symlink to one.
+            if (is_regular_file(entry.status()))
+            {
+                callback(entry.path().string());
+            }
+        };
+
+        if (recursive)
+        {
+            for (const auto& entry : recursive_directory_iterator(basePath))
+            {
+                listEntry(entry);
+            }
+        }
+        else
+        {
+            for (const auto& entry : directory_iterator(basePath))
+            {
+                listEntry(entry);
+            }
+        }
+    }
+    catch (filesystem_error&)
+    {
+        // ToDo: Log error. We ignore it for now.
+    }
+    catch (std::exception&)
+    {
+        // ToDo: Log error. We ignore it for now.
+    }
+}
+
+auto DirectoryFileSource::ReadFile(const std::string& filePath, std::vector<char>& data) const -> bool
+{
+    return ReadDiskFile(filePath, data);
+}
+
+} // namespace Renderer
+} // namespace libprojectM
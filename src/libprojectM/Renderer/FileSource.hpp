@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace libprojectM {
+namespace Renderer {
+
+/**
+ * @class FileSource
+ * @brief Read-only source of preset and texture files, either a directory or an archive.
+ *
+ * Files inside an archive are addressed by a virtual path, which is the archive file path followed
+ * by the path of the file inside the archive, e.g. "/usr/share/presets/pack.zip/Geiss/Reaction.milk".
+ * These paths can be used anywhere a regular file path is accepted for presets and textures.
+ */
+class FileSource
+{
+public:
+    /**
+     * Callback which gets invoked for each file in the source. path contains the full, possibly virtual path of the file.
+     */
+    using ListCallback = std::function<void(const std::string& path)>;
+
+    virtual ~FileSource() = default;
+
+    /**
+     * @brief Calls the provided callback with each file in this source.
+     * @param recursive If false, only files in the top-level directory are listed.
+     * @param callback The callback to invoke for each file.
+     */
+    virtual void ListFiles(bool recursive, const ListCallback& callback) const = 0;
+
+    /**
+     * @brief Reads the full contents of a file in this source.
+     * @param path The full path of the file, as passed to the ListFiles() callback.
+     * @param data Receives the file contents.
+     * @return True if the file was read, false if it doesn't exist in this source or couldn't be read.
+     */
+    virtual auto ReadFile(const std::string& path, std::vector<char>& data) const -> bool = 0;
+
+    /**
+     * @brief Opens a directory or archive as a file source.
+     *
+     * Archives are only indexed once and then kept in a process-wide cache until they are modified.
+     *
+     * @param path The directory or archive file path.
+     * @return The file source, or nullptr if the path is neither a directory nor a readable archive.
+     */
+    static auto Open(const std::string& path) -> std::shared_ptr<FileSource>;
+
+    /**
+     * @brief Reads a file from disk or from inside an archive.
+     * @param path A regular file path or a virtual path pointing into an archive.
+     * @param data Receives the file contents.
+     * @param maxSize Files larger than this number of bytes are not read.
+     * @return True if the file was read, false if it doesn't exist, is too large or couldn't be read.
+     */
+    static auto Read(const std::string& path, std::vector<char>& data,
+                     size_t maxSize = std::numeric_limits<size_t>::max()) -> bool;
+
+    /**
+     * @brief Checks if the given file name has the extension of a supported archive format.
+     * @param path The file path to check.
+     * @return True if the file would be opened as an archive.
+     */
+    static auto IsArchive(const std::string& path) -> bool;
+};
+
+/**
+ * @class DirectoryFileSource
+ * @brief File source reading from a directory on disk.
+ */
+class DirectoryFileSource : public FileSource
+{
+public:
+    /**
+     * @brief Creates a new directory file source.
+     * @param directory The root directory.
+     */
+    explicit DirectoryFileSource(std::string directory);
+
+    void ListFiles(bool recursive, const ListCallback& callback) const override;
+
+    auto ReadFile(const std::string& path, std::vector<char>& data) const -> bool override;
+
+private:
+    std::string m_directory; //!< The root directory.
+};
+
+} // namespace Renderer
+} // namespace libprojectM
@@ -1,5 +1,7 @@
 #include "Renderer/Framebuffer.hpp"
 
+#include "Renderer/GLStateCache.hpp"
+
 namespace libprojectM {
 namespace Renderer {
 
@@ -27,6 +29,10 @@ Framebuffer::~Framebuffer()
         // Delete attached textures first
         m_attachments.clear();
 
+        for (auto framebufferId : m_framebufferIds)
+        {
+            GLStateCache::Current().FramebufferDeleted(framebufferId);
+        }
         glDeleteFramebuffers(static_cast<int>(m_framebufferIds.size()), m_framebufferIds.data());
         m_framebufferIds.clear();
     }
@@ -44,7 +50,7 @@ void Framebuffer::Bind(int framebufferIndex)
         return;
     }
 
-    glBindFramebuffer(GL_FRAMEBUFFER, m_framebufferIds.at(framebufferIndex));
+    GLStateCache::Current().BindFramebuffer(GL_FRAMEBUFFER, m_framebufferIds.at(framebufferIndex));
 
     m_readFramebuffer = m_drawFramebuffer = framebufferIndex;
 }
@@ -56,7 +62,7 @@ void Framebuffer::BindRead(int framebufferIndex)
         return;
     }
 
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebufferIds.at(framebufferIndex));
+    GLStateCache::Current().BindFramebuffer(GL_READ_FRAMEBUFFER, m_framebufferIds.at(framebufferIndex));
 
     m_readFramebuffer = framebufferIndex;
 }
@@ -68,14 +74,14 @@ void Framebuffer::BindDraw(int framebufferIndex)
         return;
     }
 
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_framebufferIds.at(framebufferIndex));
+    GLStateCache::Current().BindFramebuffer(GL_DRAW_FRAMEBUFFER, m_framebufferIds.at(framebufferIndex));
 
     m_drawFramebuffer = framebufferIndex;
 }
 
 void Framebuffer::Unbind()
 {
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    GLStateCache::Current().BindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
 }
 
 bool Framebuffer::SetSize(int width, int height)
@@ -98,7 +104,7 @@ bool Framebuffer::SetSize(int width, int height)
             glFramebufferTexture2D(GL_FRAMEBUFFER, texture.first, GL_TEXTURE_2D, texture.second->Texture()->TextureID(), 0);
         }
     }
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    GLStateCache::Current().BindFramebuffer(GL_FRAMEBUFFER, 0);
 
     return true;
 }
@@ -177,17 +183,18 @@ void Framebuffer::SetAttachment(int framebufferIndex, int attachmentIndex, const
     }
     m_attachments.at(framebufferIndex).insert({textureType, attachment});
 
-    glBindFramebuffer(GL_FRAMEBUFFER, m_framebufferIds.at(framebufferIndex));
+    GLStateCache::Current().BindFramebuffer(GL_FRAMEBUFFER, m_framebufferIds.at(framebufferIndex));
 
-    if (m_width > 0 && m_height > 0)
+    // Already allocated textures can be attached regardless of the framebuffer size.
+    if (!attachment->Texture()->Empty() || (m_width > 0 && m_height > 0))
     {
         glFramebufferTexture2D(GL_FRAMEBUFFER, textureType, GL_TEXTURE_2D, attachment->Texture()->TextureID(), 0);
     }
     UpdateDrawBuffers(framebufferIndex);
 
     // Reset to previous read/draw buffers
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebufferIds.at(m_readFramebuffer));
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_framebufferIds.at(m_drawFramebuffer));
+    GLStateCache::Current().BindFramebuffer(GL_READ_FRAMEBUFFER, m_framebufferIds.at(m_readFramebuffer));
+    GLStateCache::Current().BindFramebuffer(GL_DRAW_FRAMEBUFFER, m_framebufferIds.at(m_drawFramebuffer));
 }
 
 void Framebuffer::CreateColorAttachment(int framebufferIndex, int attachmentIndex)
@@ -212,7 +219,30 @@ void Framebuffer::CreateColorAttachment(int framebufferIndex, int attachmentInde
         glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + attachmentIndex, GL_TEXTURE_2D, texture->TextureID(), 0);
     }
     UpdateDrawBuffers(framebufferIndex);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    GLStateCache::Current().BindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void Framebuffer::CreateColorAttachment(int framebufferIndex, int attachmentIndex,
+                                        TexturePool& texturePool, TexturePool::Usage usage, const TextureFormat& format)
+{
+    if (framebufferIndex < 0 || framebufferIndex >= static_cast<int>(m_framebufferIds.size()))
+    {
+        return;
+    }
+
+    RemoveColorAttachment(framebufferIndex, attachmentIndex);
+
+    auto textureAttachment = std::make_shared<TextureAttachment>(texturePool, usage, format, m_width, m_height);
+    const auto texture = textureAttachment->Texture();
+    m_attachments.at(framebufferIndex).insert({GL_COLOR_ATTACHMENT0 + attachmentIndex, std::move(textureAttachment)});
+
+    Bind(framebufferIndex);
+    if (m_width > 0 && m_height > 0)
+    {
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + attachmentIndex, GL_TEXTURE_2D, texture->TextureID(), 0);
+    }
+    UpdateDrawBuffers(framebufferIndex);
+    GLStateCache::Current().BindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 void Framebuffer::RemoveColorAttachment(int framebufferIndex, int attachmentIndex)
@@ -220,6 +250,28 @@ void Framebuffer::RemoveColorAttachment(int framebufferIndex, int attachmentInde
     RemoveAttachment(framebufferIndex,  GL_COLOR_ATTACHMENT0 + attachmentIndex);
 }
 
+auto Framebuffer::SetColorAttachmentFormat(int framebufferIndex, int attachmentIndex, const TextureFormat& format) -> bool
+{
+    if (framebufferIndex < 0 || framebufferIndex >= static_cast<int>(m_framebufferIds.size()))
+    {
+        return false;
+    }
+
+    const auto& framebufferAttachments = m_attachments.at(framebufferIndex);
+    auto const attachment = framebufferAttachments.find(GL_COLOR_ATTACHMENT0 + attachmentIndex);
+    if (attachment == framebufferAttachments.end() ||
+        !attachment->second->SetFormat(format))
+    {
+        return false;
+    }
+
+    Bind(framebufferIndex);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, attachment->first, GL_TEXTURE_2D, attachment->second->Texture()->TextureID(), 0);
+    GLStateCache::Current().BindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    return true;
+}
+
 auto Framebuffer::GetColorAttachmentTexture(int framebufferIndex, int attachmentIndex) const -> std::shared_ptr<class Texture>
 {
     if (framebufferIndex < 0 || framebufferIndex >= static_cast<int>(m_framebufferIds.size()))
@@ -253,7 +305,7 @@ void Framebuffer::CreateDepthAttachment(int framebufferIndex)
         glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, texture->TextureID(), 0);
     }
     UpdateDrawBuffers(framebufferIndex);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    GLStateCache::Current().BindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 void Framebuffer::RemoveDepthAttachment(int framebufferIndex)
@@ -278,7 +330,7 @@ void Framebuffer::CreateStencilAttachment(int framebufferIndex)
         glFramebufferTexture2D(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT, GL_TEXTURE_2D, texture->TextureID(), 0);
     }
     UpdateDrawBuffers(framebufferIndex);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    GLStateCache::Current().BindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 void Framebuffer::RemoveStencilAttachment(int framebufferIndex)
@@ -303,7 +355,7 @@ void Framebuffer::CreateDepthStencilAttachment(int framebufferIndex)
         glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, texture->TextureID(), 0);
     }
     UpdateDrawBuffers(framebufferIndex);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    GLStateCache::Current().BindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 void Framebuffer::RemoveDepthStencilAttachment(int framebufferIndex)
@@ -387,7 +439,7 @@ void Framebuffer::RemoveAttachment(int framebufferIndex, GLenum attachmentType)
         return;
     }
 
-    glBindFramebuffer(GL_FRAMEBUFFER, m_framebufferIds.at(framebufferIndex));
+    GLStateCache::Current().BindFramebuffer(GL_FRAMEBUFFER, m_framebufferIds.at(framebufferIndex));
 
     glFramebufferTexture2D(GL_FRAMEBUFFER, attachmentType, GL_TEXTURE_2D, 0, 0);
     UpdateDrawBuffers(framebufferIndex);
@@ -395,8 +447,8 @@ void Framebuffer::RemoveAttachment(int framebufferIndex, GLenum attachmentType)
     m_attachments.at(framebufferIndex).erase(attachmentType);
 
     // Reset to previous read/draw buffers
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebufferIds.at(m_readFramebuffer));
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_framebufferIds.at(m_drawFramebuffer));
+    GLStateCache::Current().BindFramebuffer(GL_READ_FRAMEBUFFER, m_framebufferIds.at(m_readFramebuffer));
+    GLStateCache::Current().BindFramebuffer(GL_DRAW_FRAMEBUFFER, m_framebufferIds.at(m_drawFramebuffer));
 }
 
 } // namespace Renderer
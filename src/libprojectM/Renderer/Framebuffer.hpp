@@ -22,7 +22,9 @@ namespace Renderer {
  * <p>Each framebuffer can have multiple color attachments (at least up to 8), one depth buffer,
  * one stencil buffer and one depth stencil buffer.</p>
  *
- * <p>All framebuffers and their attachments will share the same size.</p>
+ * <p>All framebuffers and their attachments will share the same size. The only exception are
+ * attachments with already allocated textures passed to SetAttachment(), which may have any size
+ * as long as SetSize() is never called.</p>
  *
  * <p>Draw buffers will be configured in this order for each framebuffer:</p>
  *
@@ -120,6 +122,8 @@ public:
      * @brief Sets a texture attachment slot to the given object.
      * Sets the read/write FBOs to the previously used ones in this instance. If a different
      * Framebuffer instance was used to read or draw, it must be bound again explicitly after this call.
+     * If the attachment's texture is already allocated, it is attached immediately, even if its size
+     * differs from the framebuffer size. Otherwise, it is attached on the next call to SetSize().
      * @param framebufferIndex The framebuffer index.
      * @param attachmentIndex The index of the color attachment, at least indices 0-7 are guaranteed
      *                        to be available. Ignored for non-color attachments.
@@ -146,6 +150,18 @@ public:
     void CreateColorAttachment(int framebufferIndex, int attachmentIndex,
                                GLint internalFormat, GLenum format, GLenum type);
 
+    /**
+     * @brief Adds a new color attachment to the framebuffer, which leases its texture from a pool.
+     * Replaces any existing attachment in the same slot. The pool must outlive the framebuffer.
+     * @param framebufferIndex The framebuffer index.
+     * @param attachmentIndex The index of the attachment, at least indices 0-7 are guaranteed to be available.
+     * @param texturePool The pool to lease the texture from.
+     * @param usage What the texture is used for.
+     * @param format The texture format.
+     */
+    void CreateColorAttachment(int framebufferIndex, int attachmentIndex,
+                               TexturePool& texturePool, TexturePool::Usage usage, const TextureFormat& format);
+
     /**
      * Removes the color attachment from the given slot, if there is any assigned.
      * Sets the read/write FBOs to the previously used ones in this instance. If a different
@@ -155,6 +171,17 @@ public:
      */
     void RemoveColorAttachment(int framebufferIndex, int attachmentIndex);
 
+    /**
+     * @brief Changes the texture format of an existing color attachment.
+     * If the format differs and the texture is allocated, the texture is reallocated and attached
+     * again. The default framebuffer is bound after the call if the texture was reallocated.
+     * @param framebufferIndex The framebuffer index.
+     * @param attachmentIndex The index of the color attachment.
+     * @param format The new texture format.
+     * @return true if the attachment texture was reallocated, false if it's contents remain unchanged.
+     */
+    auto SetColorAttachmentFormat(int framebufferIndex, int attachmentIndex, const TextureFormat& format) -> bool;
+
     /**
      * @brief Returns the texture ID of the given framebuffer and color attachment.
      * @param framebufferIndex The framebuffer index.
@@ -0,0 +1,27 @@
+#include "Renderer/GLExtensions.hpp"
+
+#include "Renderer/OpenGL.h"
+
+#include <cstring>
+
+namespace libprojectM {
+namespace Renderer {
+
+auto HasExtension(const char* extension) -> bool
+{
+    GLint extensionCount{};
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+    for (GLint index = 0; index < extensionCount; index++)
+    {
+        const auto* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(index)));
+        if (name != nullptr && std::strcmp(name, extension) == 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+} // namespace Renderer
+} // namespace libprojectM
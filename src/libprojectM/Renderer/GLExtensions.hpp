@@ -0,0 +1,18 @@
+/**
+ * @file GLExtensions.hpp
+ * @brief Queries OpenGL extensions of the current context.
+ */
+#pragma once
+
+namespace libprojectM {
+namespace Renderer {
+
+/**
+ * @brief Checks whether the current context supports the given extension.
+ * @param extension The extension name, e.g. "GL_EXT_color_buffer_float".
+ * @return true if the extension is supported, false if not.
+ */
+auto HasExtension(const char* extension) -> bool;
+
+} // namespace Renderer
+} // namespace libprojectM
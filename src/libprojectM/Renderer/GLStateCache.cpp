@@ -0,0 +1,393 @@
+#include "Renderer/GLStateCache.hpp"
+
+#include <cassert>
+
+namespace libprojectM {
+namespace Renderer {
+
+constexpr GLuint GLStateCache::Unknown;
+constexpr size_t GLStateCache::MaxTrackedTextureUnits;
+constexpr size_t GLStateCache::TrackedTextureTargets;
+
+namespace {
+
+thread_local GLStateCache* currentCache{nullptr}; //!< The cache made current on this thread.
+
+/**
+ * @brief Returns the index of a tracked texture target.
+ * @param target The texture target.
+ * @return The index into TextureUnit::textures, or -1 if the target isn't tracked.
+ */
+auto TextureTargetIndex(GLenum target) -> int
+{
+    switch (target)
+    {
+        case GL_TEXTURE_2D:
+            return 0;
+        case GL_TEXTURE_3D:
+            return 1;
+        default:
+            return -1;
+    }
+}
+
+/**
+ * @brief Returns the glGetIntegerv() parameter to query the binding of a tracked texture target.
+ * @param targetIndex The tracked target index.
+ * @return The binding parameter.
+ */
+auto TextureBindingParameter(int targetIndex) -> GLenum
+{
+    return targetIndex == 0 ? GL_TEXTURE_BINDING_2D : GL_TEXTURE_BINDING_3D;
+}
+
+} // namespace
+
+GLStateCache::GLStateCache()
+{
+    Invalidate();
+}
+
+GLStateCache::~GLStateCache()
+{
+    if (currentCache == this)
+    {
+        currentCache = nullptr;
+    }
+}
+
+auto GLStateCache::Current() -> GLStateCache&
+{
+    if (currentCache != nullptr)
+    {
+        return *currentCache;
+    }
+
+    thread_local GLStateCache fallbackCache;
+    return fallbackCache;
+}
+
+void GLStateCache::MakeCurrent()
+{
+    currentCache = this;
+}
+
+void GLStateCache::BeginFrame()
+{
+    Invalidate();
+
+    m_frameStatistics = {};
+    m_frameActive = true;
+}
+
+void GLStateCache::EndFrame()
+{
+    m_frameActive = false;
+    m_lastFrameStatistics = m_frameStatistics;
+}
+
+void GLStateCache::Invalidate()
+{
+    m_program = Unknown;
+    m_vertexArray = Unknown;
+    m_activeTexture = Unknown;
+    for (auto& unit : m_textureUnits)
+    {
+        unit.textures.fill(Unknown);
+        unit.sampler = Unknown;
+    }
+    m_readFramebuffer = Unknown;
+    m_drawFramebuffer = Unknown;
+    m_blendEnabled = Unknown;
+    m_lineSmoothEnabled = Unknown;
+    m_blendSrcFunc = Unknown;
+    m_blendDstFunc = Unknown;
+    m_blendEquation = Unknown;
+}
+
+auto GLStateCache::LastFrameStatistics() const -> Statistics
+{
+    return m_lastFrameStatistics;
+}
+
+auto GLStateCache::FrameStatistics() const -> Statistics
+{
+    return m_frameStatistics;
+}
+
+void GLStateCache::CountDrawCall()
+{
+    m_frameStatistics.drawCalls++;
+}
+
+void GLStateCache::UseProgram(GLuint program)
+{
+    if (Change(m_program, program))
+    {
+        glUseProgram(program);
+        return;
+    }
+
+    Validate(GL_CURRENT_PROGRAM, program);
+}
+
+void GLStateCache::BindVertexArray(GLuint vertexArray)
+{
+    if (Change(m_vertexArray, vertexArray))
+    {
+        glBindVertexArray(vertexArray);
+        return;
+    }
+
+    Validate(GL_VERTEX_ARRAY_BINDING, vertexArray);
+}
+
+void GLStateCache::BindTexture(GLuint unit, GLenum target, GLuint texture)
+{
+    ActiveTexture(unit);
+    BindTexture(target, texture);
+}
+
+void GLStateCache::BindTexture(GLenum target, GLuint texture)
+{
+    auto const targetIndex = TextureTargetIndex(target);
+    if (targetIndex < 0 || m_activeTexture >= MaxTrackedTextureUnits)
+    {
+        m_frameStatistics.issued++;
+        glBindTexture(target, texture);
+        return;
+    }
+
+    if (Change(m_textureUnits[m_activeTexture].textures[targetIndex], texture))
+    {
+        glBindTexture(target, texture);
+        return;
+    }
+
+    Validate(TextureBindingParameter(targetIndex), texture);
+}
+
+void GLStateCache::BindSampler(GLuint unit, GLuint sampler)
+{
+    if (unit >= MaxTrackedTextureUnits)
+    {
+        m_frameStatistics.issued++;
+        glBindSampler(unit, sampler);
+        return;
+    }
+
+    if (Change(m_textureUnits[unit].sampler, sampler))
+    {
+        glBindSampler(unit, sampler);
+        return;
+    }
+
+#ifndef NDEBUG
+    GLint activeTexture{};
+    glGetIntegerv(GL_ACTIVE_TEXTURE, &activeTexture);
+    glActiveTexture(GL_TEXTURE0 + unit);
+    Validate(GL_SAMPLER_BINDING, sampler);
+    glActiveTexture(static_cast<GLenum>(activeTexture));
+#endif
+}
+
+void GLStateCache::BindFramebuffer(GLenum target, GLuint framebuffer)
+{
+    switch (target)
+    {
+        case GL_READ_FRAMEBUFFER:
+            if (Change(m_readFramebuffer, framebuffer))
+            {
+                glBindFramebuffer(target, framebuffer);
+                return;
+            }
+            Validate(GL_READ_FRAMEBUFFER_BINDING, framebuffer);
+            break;
+
+        case GL_DRAW_FRAMEBUFFER:
+            if (Change(m_drawFramebuffer, framebuffer))
+            {
+                glBindFramebuffer(target, framebuffer);
+                return;
+            }
+            Validate(GL_DRAW_FRAMEBUFFER_BINDING, framebuffer);
+            break;
+
+        default:
+            if (!m_frameActive || m_readFramebuffer != framebuffer || m_drawFramebuffer != framebuffer)
+            {
+                m_readFramebuffer = m_drawFramebuffer = framebuffer;
+                m_frameStatistics.issued++;
+                glBindFramebuffer(target, framebuffer);
+                return;
+            }
+            m_frameStatistics.elided++;
+            Validate(GL_READ_FRAMEBUFFER_BINDING, framebuffer);
+            Validate(GL_DRAW_FRAMEBUFFER_BINDING, framebuffer);
+            break;
+    }
+}
+
+auto GLStateCache::BoundFramebuffer(GLenum target) -> GLuint
+{
+    auto& tracked = target == GL_READ_FRAMEBUFFER ? m_readFramebuffer : m_drawFramebuffer;
+    if (!m_frameActive || tracked == Unknown)
+    {
+        GLint framebuffer{};
+        glGetIntegerv(target == GL_READ_FRAMEBUFFER ? GL_READ_FRAMEBUFFER_BINDING : GL_DRAW_FRAMEBUFFER_BINDING, &framebuffer);
+        tracked = static_cast<GLuint>(framebuffer);
+    }
+
+    return tracked;
+}
+
+void GLStateCache::SetCapability(GLenum capability, bool enable)
+{
+    auto* tracked = CapabilityState(capability);
+    if (tracked == nullptr)
+    {
+        m_frameStatistics.issued++;
+    }
+    else if (!Change(*tracked, enable ? GL_TRUE : GL_FALSE))
+    {
+        Validate(capability, enable ? GL_TRUE : GL_FALSE);
+        return;
+    }
+
+    if (enable)
+    {
+        glEnable(capability);
+    }
+    else
+    {
+        glDisable(capability);
+    }
+}
+
+void GLStateCache::BlendFunc(GLenum srcFunc, GLenum dstFunc)
+{
+    if (!m_frameActive || m_blendSrcFunc != srcFunc || m_blendDstFunc != dstFunc)
+    {
+        m_blendSrcFunc = srcFunc;
+        m_blendDstFunc = dstFunc;
+        m_frameStatistics.issued++;
+        glBlendFunc(srcFunc, dstFunc);
+        return;
+    }
+
+    m_frameStatistics.elided++;
+    Validate(GL_BLEND_SRC_RGB, srcFunc);
+    Validate(GL_BLEND_DST_RGB, dstFunc);
+}
+
+void GLStateCache::BlendEquation(GLenum mode)
+{
+    if (Change(m_blendEquation, mode))
+    {
+        glBlendEquation(mode);
+        return;
+    }
+
+    Validate(GL_BLEND_EQUATION_RGB, mode);
+}
+
+void GLStateCache::TextureDeleted(GLuint texture)
+{
+    // Deleting a texture unbinds it in the deleting context. The name may be reused afterwards.
+    for (auto& unit : m_textureUnits)
+    {
+        for (auto& boundTexture : unit.textures)
+        {
+            if (boundTexture == texture)
+            {
+                boundTexture = Unknown;
+            }
+        }
+    }
+}
+
+void GLStateCache::SamplerDeleted(GLuint sampler)
+{
+    for (auto& unit : m_textureUnits)
+    {
+        if (unit.sampler == sampler)
+        {
+            unit.sampler = Unknown;
+        }
+    }
+}
+
+void GLStateCache::VertexArrayDeleted(GLuint vertexArray)
+{
+    if (m_vertexArray == vertexArray)
+    {
+        m_vertexArray = Unknown;
+    }
+}
+
+void GLStateCache::FramebufferDeleted(GLuint framebuffer)
+{
+    if (m_readFramebuffer == framebuffer)
+    {
+        m_readFramebuffer = Unknown;
+    }
+    if (m_drawFramebuffer == framebuffer)
+    {
+        m_drawFramebuffer = Unknown;
+    }
+}
+
+auto GLStateCache::Change(GLuint& tracked, GLuint value) -> bool
+{
+    if (m_frameActive && tracked == value)
+    {
+        m_frameStatistics.elided++;
+        return false;
+    }
+
+    tracked = value;
+    m_frameStatistics.issued++;
+    return true;
+}
+
+void GLStateCache::ActiveTexture(GLuint unit)
+{
+    if (Change(m_activeTexture, unit))
+    {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        return;
+    }
+
+    Validate(GL_ACTIVE_TEXTURE, GL_TEXTURE0 + unit);
+}
+
+auto GLStateCache::CapabilityState(GLenum capability) -> GLuint*
+{
+    switch (capability)
+    {
+        case GL_BLEND:
+            return &m_blendEnabled;
+#ifndef USE_GLES
+        case GL_LINE_SMOOTH:
+            return &m_lineSmoothEnabled;
+#endif
+        default:
+            return nullptr;
+    }
+}
+
+void GLStateCache::Validate(GLenum parameter, GLuint expected)
+{
+#ifndef NDEBUG
+    GLint actual{};
+    glGetIntegerv(parameter, &actual);
+    // If this fails, the state was changed without going through the cache, see Invalidate().
+    assert(static_cast<GLuint>(actual) == expected);
+#else
+    static_cast<void>(parameter);
+    static_cast<void>(expected);
+#endif
+}
+
+} // namespace Renderer
+} // namespace libprojectM
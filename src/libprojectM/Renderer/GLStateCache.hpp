@@ -0,0 +1,257 @@
+/**
+ * @file GLStateCache.hpp
+ * @brief Tracks OpenGL binding and enable state to skip redundant state changes.
+ */
+#pragma once
+
+#include "Renderer/OpenGL.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace libprojectM {
+namespace Renderer {
+
+/**
+ * @brief Shadows the OpenGL state changed by the renderer classes and skips redundant changes.
+ *
+ * All renderer classes route program, vertex array, texture, sampler, framebuffer, blend and
+ * capability changes through the cache of the current thread, see Current(). Between BeginFrame()
+ * and EndFrame(), state changes which would set the value already known to be active are not sent
+ * to OpenGL. Outside a frame, the application may change any OpenGL state at any time, so all
+ * changes are issued and the tracked state is discarded when the next frame begins.
+ *
+ * Like OpenGL contexts, a cache is made current for the calling thread. Each projectM instance owns
+ * one cache and makes it current before rendering.
+ *
+ * In debug builds, each skipped state change is checked against the actual OpenGL state.
+ */
+class GLStateCache
+{
+public:
+    /**
+     * @brief Number of issued and elided state changes and draw calls.
+     */
+    struct Statistics {
+        uint32_t issued{};    //!< Number of state changes sent to OpenGL.
+        uint32_t elided{};    //!< Number of redundant state changes which were skipped.
+        uint32_t drawCalls{}; //!< Number of draw calls.
+    };
+
+    /**
+     * Constructor. Initially, no state is known.
+     */
+    GLStateCache();
+
+    /**
+     * Destructor. If this cache is current, the thread's fallback cache will be used afterwards.
+     */
+    ~GLStateCache();
+
+    GLStateCache(const GLStateCache&) = delete;
+    auto operator=(const GLStateCache&) -> GLStateCache& = delete;
+
+    /**
+     * @brief Returns the cache current on the calling thread.
+     * If no cache was made current, a thread-local fallback cache is returned.
+     * @return The current state cache.
+     */
+    static auto Current() -> GLStateCache&;
+
+    /**
+     * @brief Makes this cache current for the calling thread.
+     */
+    void MakeCurrent();
+
+    /**
+     * @brief Starts a new frame.
+     * Invalidates all tracked state and resets the state change counters. Until EndFrame() is
+     * called, redundant state changes are skipped.
+     */
+    void BeginFrame();
+
+    /**
+     * @brief Ends the current frame.
+     * Stores the frame's statistics and issues all further state changes until the next frame.
+     */
+    void EndFrame();
+
+    /**
+     * @brief Forgets all tracked state, so the next change of each value is always issued.
+     * Call this after application code was run during a frame, as it may change OpenGL state
+     * without going through the cache.
+     */
+    void Invalidate();
+
+    /**
+     * @brief Returns the state change counts of the last completed frame.
+     * @return The statistics of the last frame.
+     */
+    auto LastFrameStatistics() const -> Statistics;
+
+    /**
+     * @brief Returns the counts of the frame currently being rendered so far.
+     * @return The statistics of the current frame.
+     */
+    auto FrameStatistics() const -> Statistics;
+
+    /**
+     * @brief Counts a draw call in the frame statistics.
+     * Call this after each glDraw*() call.
+     */
+    void CountDrawCall();
+
+    /**
+     * @brief Makes the given program current, like glUseProgram().
+     * @param program The program name, or 0 to unbind.
+     */
+    void UseProgram(GLuint program);
+
+    /**
+     * @brief Binds a vertex array object, like glBindVertexArray().
+     * @param vertexArray The VAO name, or 0 to unbind.
+     */
+    void BindVertexArray(GLuint vertexArray);
+
+    /**
+     * @brief Binds a texture to the given texture unit.
+     * @param unit The zero-based texture unit.
+     * @param target The texture target, e.g. GL_TEXTURE_2D.
+     * @param texture The texture name, or 0 to unbind.
+     */
+    void BindTexture(GLuint unit, GLenum target, GLuint texture);
+
+    /**
+     * @brief Binds a texture to the currently active texture unit, e.g. to upload texture data.
+     * @param target The texture target, e.g. GL_TEXTURE_2D.
+     * @param texture The texture name, or 0 to unbind.
+     */
+    void BindTexture(GLenum target, GLuint texture);
+
+    /**
+     * @brief Binds a sampler object to the given texture unit, like glBindSampler().
+     * @param unit The zero-based texture unit.
+     * @param sampler The sampler name, or 0 to unbind.
+     */
+    void BindSampler(GLuint unit, GLuint sampler);
+
+    /**
+     * @brief Binds a framebuffer object, like glBindFramebuffer().
+     * @param target GL_FRAMEBUFFER, GL_READ_FRAMEBUFFER or GL_DRAW_FRAMEBUFFER.
+     * @param framebuffer The framebuffer name, or 0 for the default framebuffer.
+     */
+    void BindFramebuffer(GLenum target, GLuint framebuffer);
+
+    /**
+     * @brief Returns the bound framebuffer for the given target.
+     * Only queries OpenGL if the binding isn't known.
+     * @param target GL_READ_FRAMEBUFFER or GL_DRAW_FRAMEBUFFER.
+     * @return The framebuffer name.
+     */
+    auto BoundFramebuffer(GLenum target) -> GLuint;
+
+    /**
+     * @brief Enables or disables an OpenGL capability like GL_BLEND, like glEnable()/glDisable().
+     * @param capability The capability.
+     * @param enable true to enable, false to disable the capability.
+     */
+    void SetCapability(GLenum capability, bool enable);
+
+    /**
+     * @brief Sets the blend function, like glBlendFunc().
+     * @param srcFunc The source blend function.
+     * @param dstFunc The destination blend function.
+     */
+    void BlendFunc(GLenum srcFunc, GLenum dstFunc);
+
+    /**
+     * @brief Sets the blend equation, like glBlendEquation().
+     * @param mode The blend equation.
+     */
+    void BlendEquation(GLenum mode);
+
+    /**
+     * @brief Removes a deleted texture from all tracked bindings.
+     * @param texture The deleted texture name.
+     */
+    void TextureDeleted(GLuint texture);
+
+    /**
+     * @brief Removes a deleted sampler from all tracked bindings.
+     * @param sampler The deleted sampler name.
+     */
+    void SamplerDeleted(GLuint sampler);
+
+    /**
+     * @brief Removes a deleted vertex array object from the tracked binding.
+     * @param vertexArray The deleted VAO name.
+     */
+    void VertexArrayDeleted(GLuint vertexArray);
+
+    /**
+     * @brief Removes a deleted framebuffer object from the tracked bindings.
+     * @param framebuffer The deleted framebuffer name.
+     */
+    void FramebufferDeleted(GLuint framebuffer);
+
+private:
+    static constexpr GLuint Unknown = ~0U;                //!< Marks a tracked value as not known.
+    static constexpr size_t MaxTrackedTextureUnits = 32; //!< Bindings on higher units are always issued.
+    static constexpr size_t TrackedTextureTargets = 2;   //!< Tracked texture targets: 2D and 3D.
+
+    /**
+     * @brief Tracked bindings of a single texture unit.
+     */
+    struct TextureUnit {
+        std::array<GLuint, TrackedTextureTargets> textures; //!< Bound texture per target.
+        GLuint sampler;                                     //!< Bound sampler object.
+    };
+
+    /**
+     * @brief Updates a tracked value and counts the change.
+     * @param tracked The tracked value.
+     * @param value The new value.
+     * @return true if the change needs to be sent to OpenGL, false if it is redundant.
+     */
+    auto Change(GLuint& tracked, GLuint value) -> bool;
+
+    /**
+     * @brief Makes the given texture unit active.
+     * @param unit The zero-based texture unit.
+     */
+    void ActiveTexture(GLuint unit);
+
+    /**
+     * @brief Returns the tracked enable state of a capability.
+     * @param capability The capability.
+     * @return A pointer to the tracked state, or nullptr if the capability isn't tracked.
+     */
+    auto CapabilityState(GLenum capability) -> GLuint*;
+
+    /**
+     * @brief Asserts that a skipped state change matches the actual OpenGL state. Debug builds only.
+     * @param parameter The glGetIntegerv() parameter to query.
+     * @param expected The expected value.
+     */
+    static void Validate(GLenum parameter, GLuint expected);
+
+    GLuint m_program{Unknown};                                      //!< Current program.
+    GLuint m_vertexArray{Unknown};                                  //!< Bound VAO.
+    GLuint m_activeTexture{Unknown};                                //!< Active texture unit index.
+    std::array<TextureUnit, MaxTrackedTextureUnits> m_textureUnits; //!< Texture unit bindings.
+    GLuint m_readFramebuffer{Unknown};                              //!< Bound read framebuffer.
+    GLuint m_drawFramebuffer{Unknown};                              //!< Bound draw framebuffer.
+    GLuint m_blendEnabled{Unknown};                                 //!< GL_BLEND enable state.
+    GLuint m_lineSmoothEnabled{Unknown};                            //!< GL_LINE_SMOOTH enable state, unused on GLES.
+    GLuint m_blendSrcFunc{Unknown};                                 //!< Source blend function.
+    GLuint m_blendDstFunc{Unknown};                                 //!< Destination blend function.
+    GLuint m_blendEquation{Unknown};                                //!< Blend equation.
+
+    bool m_frameActive{false};        //!< True between BeginFrame() and EndFrame().
+    Statistics m_frameStatistics;     //!< Counts of the frame currently being rendered.
+    Statistics m_lastFrameStatistics; //!< Counts of the last completed frame.
+};
+
+} // namespace Renderer
+} // namespace libprojectM
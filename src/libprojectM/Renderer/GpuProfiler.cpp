@@ -0,0 +1,246 @@
+#include "Renderer/GpuProfiler.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace libprojectM {
+namespace Renderer {
+
+constexpr size_t GpuProfiler::MaxPendingFrames;
+constexpr size_t GpuProfiler::MaxRecordedFrames;
+
+GpuProfiler::GpuProfiler()
+{
+#ifdef USE_GLES
+    if (GLAD_GL_EXT_disjoint_timer_query != 0)
+    {
+        // Timestamp support is optional in the extension and signaled by a non-zero counter size.
+        GLint counterBits{};
+        glGetQueryivEXT(GL_TIMESTAMP_EXT, GL_QUERY_COUNTER_BITS_EXT, &counterBits);
+        m_timestampsSupported = counterBits > 0;
+    }
+#else
+    m_timestampsSupported = true;
+#endif
+}
+
+GpuProfiler::~GpuProfiler()
+{
+    if (!m_queries.empty())
+    {
+        glDeleteQueries(static_cast<GLsizei>(m_queries.size()), m_queries.data());
+    }
+}
+
+void GpuProfiler::BeginFrame(uint32_t frame)
+{
+    CollectResults();
+
+    m_frame = frame;
+    m_recording = m_pendingFrames.size() < MaxPendingFrames;
+    m_currentFrame.clear();
+}
+
+void GpuProfiler::EndFrame()
+{
+    assert(!m_passActive);
+
+    if (m_recording && !m_currentFrame.empty())
+    {
+        m_pendingFrames.push_back(std::move(m_currentFrame));
+        m_currentFrame.clear();
+    }
+
+    m_recording = false;
+}
+
+void GpuProfiler::BeginPass(const std::string& name)
+{
+    assert(!m_passActive);
+
+    if (!m_recording)
+    {
+        return;
+    }
+
+    PendingPass pass;
+    pass.timing.name = name;
+    pass.timing.frame = m_frame;
+    pass.beginQuery = Timestamp();
+    m_currentFrame.push_back(std::move(pass));
+
+    m_passStartStatistics = GLStateCache::Current().FrameStatistics();
+    m_passActive = true;
+}
+
+void GpuProfiler::EndPass()
+{
+    if (!m_passActive)
+    {
+        return;
+    }
+
+    auto& pass = m_currentFrame.back();
+    pass.endQuery = Timestamp();
+
+    auto const statistics = GLStateCache::Current().FrameStatistics();
+    pass.timing.drawCalls = statistics.drawCalls - m_passStartStatistics.drawCalls;
+    pass.timing.stateChanges = statistics.issued - m_passStartStatistics.issued;
+
+    m_passActive = false;
+}
+
+auto GpuProfiler::Timings(uint32_t frameCount) const -> std::vector<PassTiming>
+{
+    std::vector<PassTiming> timings;
+
+    auto const firstFrame = m_frames.size() - std::min(m_frames.size(), static_cast<size_t>(frameCount));
+    for (auto frame = m_frames.begin() + static_cast<std::ptrdiff_t>(firstFrame); frame != m_frames.end(); ++frame)
+    {
+        timings.insert(timings.end(), frame->begin(), frame->end());
+    }
+
+    return timings;
+}
+
+void GpuProfiler::Clear()
+{
+    for (const auto& frame : m_pendingFrames)
+    {
+        ReleaseQueries(frame);
+    }
+    ReleaseQueries(m_currentFrame);
+
+    m_pendingFrames.clear();
+    m_currentFrame.clear();
+    m_frames.clear();
+    m_recording = false;
+    m_passActive = false;
+}
+
+auto GpuProfiler::AcquireQuery() -> GLuint
+{
+    if (m_freeQueries.empty())
+    {
+        GLuint query{};
+        glGenQueries(1, &query);
+        m_queries.push_back(query);
+        return query;
+    }
+
+    auto const query = m_freeQueries.back();
+    m_freeQueries.pop_back();
+    return query;
+}
+
+auto GpuProfiler::Timestamp() -> GLuint
+{
+    if (!m_timestampsSupported)
+    {
+        return 0;
+    }
+
+    auto const query = AcquireQuery();
+#ifdef USE_GLES
+    glQueryCounterEXT(query, GL_TIMESTAMP_EXT);
+#else
+    glQueryCounter(query, GL_TIMESTAMP);
+#endif
+
+    return query;
+}
+
+void GpuProfiler::CollectResults()
+{
+    size_t collectedFrames{};
+
+    while (!m_pendingFrames.empty())
+    {
+        auto& frame = m_pendingFrames.front();
+
+        // Queries finish in order, so the frame is complete if the last query has a result.
+        if (m_timestampsSupported)
+        {
+            GLuint available{};
+            glGetQueryObjectuiv(frame.back().endQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (available == GL_FALSE)
+            {
+                break;
+            }
+        }
+
+        std::vector<PassTiming> timings;
+        timings.reserve(frame.size());
+        for (auto& pass : frame)
+        {
+            if (m_timestampsSupported)
+            {
+                GLuint64 begin{};
+                GLuint64 end{};
+#ifdef USE_GLES
+                glGetQueryObjectui64vEXT(pass.beginQuery, GL_QUERY_RESULT, &begin);
+                glGetQueryObjectui64vEXT(pass.endQuery, GL_QUERY_RESULT, &end);
+#else
+                glGetQueryObjectui64v(pass.beginQuery, GL_QUERY_RESULT, &begin);
+                glGetQueryObjectui64v(pass.endQuery, GL_QUERY_RESULT, &end);
+#endif
+                pass.timing.gpuTime = static_cast<double>(end - begin) / 1000000.0;
+            }
+
+            timings.push_back(std::move(pass.timing));
+        }
+
+        ReleaseQueries(frame);
+        m_pendingFrames.pop_front();
+
+        m_frames.push_back(std::move(timings));
+        if (m_frames.size() > MaxRecordedFrames)
+        {
+            m_frames.pop_front();
+        }
+
+        collectedFrames++;
+    }
+
+#ifdef USE_GLES
+    // A disjoint event, e.g. a GPU frequency change, invalidates the timestamps of the collected frames.
+    if (m_timestampsSupported && collectedFrames > 0)
+    {
+        GLint disjoint{};
+        glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+        if (disjoint != 0)
+        {
+            collectedFrames = std::min(collectedFrames, m_frames.size());
+            for (auto frame = m_frames.end() - static_cast<std::ptrdiff_t>(collectedFrames); frame != m_frames.end(); ++frame)
+            {
+                for (auto& timing : *frame)
+                {
+                    timing.gpuTime = -1.0;
+                }
+            }
+        }
+    }
+#else
+    static_cast<void>(collectedFrames);
+#endif
+}
+
+void GpuProfiler::ReleaseQueries(const PendingFrame& frame)
+{
+    if (!m_timestampsSupported)
+    {
+        return;
+    }
+
+    for (const auto& pass : frame)
+    {
+        m_freeQueries.push_back(pass.beginQuery);
+        if (pass.endQuery != 0)
+        {
+            m_freeQueries.push_back(pass.endQuery);
+        }
+    }
+}
+
+} // namespace Renderer
+} // namespace libprojectM
@@ -0,0 +1,133 @@
+/**
+ * @file GpuProfiler.hpp
+ * @brief Records the GPU time, draw calls and state changes of each render pass.
+ */
+#pragma once
+
+#include "Renderer/GLStateCache.hpp"
+#include "Renderer/OpenGL.h"
+#include "Renderer/RenderGraph.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace libprojectM {
+namespace Renderer {
+
+/**
+ * @brief Records the GPU time, draw calls and state changes of each render pass.
+ *
+ * A GL_TIMESTAMP query is issued at the beginning and the end of each pass. The query results
+ * are read back a few frames later, once the GPU has finished the frame, so profiling never
+ * stalls the pipeline. If the results of too many frames are still pending, the current frame
+ * isn't recorded. Draw calls and state changes are counted by the current GLStateCache.
+ *
+ * The profiler is only called if profiling is enabled, so disabled profiling has no overhead
+ * besides checking for a nullptr profiler in the render context.
+ *
+ * If the OpenGL context doesn't support timestamp queries, e.g. on OpenGL ES without the
+ * EXT_disjoint_timer_query extension, only draw calls and state changes are recorded.
+ */
+class GpuProfiler
+{
+public:
+    /**
+     * @brief Checks whether the current OpenGL context supports timestamp queries.
+     */
+    GpuProfiler();
+
+    GpuProfiler(const GpuProfiler&) = delete;
+    auto operator=(const GpuProfiler&) -> GpuProfiler& = delete;
+
+    ~GpuProfiler();
+
+    /**
+     * @brief Starts recording a new frame and collects the results of earlier frames.
+     * @param frame The frame number.
+     */
+    void BeginFrame(uint32_t frame);
+
+    /**
+     * @brief Ends recording the current frame.
+     */
+    void EndFrame();
+
+    /**
+     * @brief Starts measuring a render pass. Passes can't be nested.
+     * @param name The pass name.
+     */
+    void BeginPass(const std::string& name);
+
+    /**
+     * @brief Stops measuring the current render pass.
+     */
+    void EndPass();
+
+    /**
+     * @brief Returns the passes of the most recent frames with available results.
+     * @param frameCount The maximum number of frames to return.
+     * @return The pass timings, oldest frame first and passes in render order.
+     */
+    auto Timings(uint32_t frameCount) const -> std::vector<PassTiming>;
+
+    /**
+     * @brief Discards all recorded frames, including those still waiting for results.
+     */
+    void Clear();
+
+private:
+    static constexpr size_t MaxPendingFrames = 4;    //!< Frames waiting for query results before frames are skipped.
+    static constexpr size_t MaxRecordedFrames = 120; //!< Number of frames kept for Timings().
+
+    /**
+     * @brief A pass waiting for its query results.
+     */
+    struct PendingPass {
+        PassTiming timing;   //!< The pass costs, without the GPU time.
+        GLuint beginQuery{}; //!< Timestamp query issued before the pass.
+        GLuint endQuery{};   //!< Timestamp query issued after the pass.
+    };
+
+    using PendingFrame = std::vector<PendingPass>; //!< The passes of a frame waiting for query results.
+
+    /**
+     * @brief Returns an unused query object.
+     * @return The query name.
+     */
+    auto AcquireQuery() -> GLuint;
+
+    /**
+     * @brief Issues a timestamp query, if supported.
+     * @return The query name, or 0 if timestamps aren't supported.
+     */
+    auto Timestamp() -> GLuint;
+
+    /**
+     * @brief Moves all pending frames with available query results to the recorded frames.
+     */
+    void CollectResults();
+
+    /**
+     * @brief Returns the queries of a pending frame to the pool.
+     * @param frame The pending frame.
+     */
+    void ReleaseQueries(const PendingFrame& frame);
+
+    bool m_timestampsSupported{false}; //!< True if timestamp queries are supported.
+    bool m_recording{false};           //!< True if the current frame is recorded.
+    bool m_passActive{false};          //!< True between BeginPass() and EndPass().
+    uint32_t m_frame{};                //!< Number of the frame being recorded.
+
+    GLStateCache::Statistics m_passStartStatistics; //!< State cache counts when the current pass began.
+
+    PendingFrame m_currentFrame;                  //!< The passes of the frame being recorded.
+    std::deque<PendingFrame> m_pendingFrames;     //!< Recorded frames waiting for query results, oldest first.
+    std::deque<std::vector<PassTiming>> m_frames; //!< Frames with complete results, oldest first.
+    std::vector<GLuint> m_queries;                //!< All query objects created by the profiler.
+    std::vector<GLuint> m_freeQueries;            //!< Query objects which aren't in use.
+};
+
+} // namespace Renderer
+} // namespace libprojectM
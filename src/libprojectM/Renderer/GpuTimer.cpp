@@ -0,0 +1,106 @@
+#include "Renderer/GpuTimer.hpp"
+
+namespace libprojectM {
+namespace Renderer {
+
+#ifdef USE_GLES
+static constexpr GLenum TimeElapsedQuery = GL_TIME_ELAPSED_EXT;
+#else
+static constexpr GLenum TimeElapsedQuery = GL_TIME_ELAPSED;
+#endif
+
+constexpr size_t GpuTimer::QueryCount;
+
+GpuTimer::GpuTimer()
+    : m_supported(Supported())
+{
+    if (m_supported)
+    {
+        glGenQueries(static_cast<GLsizei>(QueryCount), m_queries.data());
+    }
+}
+
+GpuTimer::~GpuTimer()
+{
+    if (m_supported)
+    {
+        glDeleteQueries(static_cast<GLsizei>(QueryCount), m_queries.data());
+    }
+}
+
+auto GpuTimer::Supported() -> bool
+{
+#ifdef USE_GLES
+    return GLAD_GL_EXT_disjoint_timer_query != 0;
+#else
+    return true;
+#endif
+}
+
+void GpuTimer::Begin()
+{
+    if (!m_supported || m_measuring || m_pendingQueries == QueryCount)
+    {
+        return;
+    }
+
+    glBeginQuery(TimeElapsedQuery, m_queries.at((m_oldestQuery + m_pendingQueries) % QueryCount));
+    m_measuring = true;
+}
+
+void GpuTimer::End()
+{
+    if (!m_measuring)
+    {
+        return;
+    }
+
+    glEndQuery(TimeElapsedQuery);
+    m_pendingQueries++;
+    m_measuring = false;
+}
+
+auto GpuTimer::Poll(double& milliseconds) -> bool
+{
+    bool resultAvailable{false};
+
+    while (m_pendingQueries > 0)
+    {
+        GLuint const query = m_queries.at(m_oldestQuery);
+
+        GLuint available{};
+        glGetQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available == GL_FALSE)
+        {
+            break;
+        }
+
+        GLuint64 nanoseconds{};
+#ifdef USE_GLES
+        glGetQueryObjectui64vEXT(query, GL_QUERY_RESULT, &nanoseconds);
+#else
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+#endif
+
+        m_oldestQuery = (m_oldestQuery + 1) % QueryCount;
+        m_pendingQueries--;
+
+        milliseconds = static_cast<double>(nanoseconds) / 1000000.0;
+        resultAvailable = true;
+    }
+
+#ifdef USE_GLES
+    // A disjoint event, e.g. a GPU frequency change, invalidates all results of the pending queries.
+    GLint disjoint{};
+    glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+    if (disjoint != 0)
+    {
+        return false;
+    }
+#endif
+
+    return resultAvailable;
+}
+
+} // namespace Renderer
+} // namespace libprojectM
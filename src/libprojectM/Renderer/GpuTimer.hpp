@@ -0,0 +1,72 @@
+/**
+ * @file GpuTimer.hpp
+ * @brief Measures the GPU time of rendered frames without waiting for the GPU.
+ */
+#pragma once
+
+#include "Renderer/OpenGL.h"
+
+#include <array>
+#include <cstddef>
+
+namespace libprojectM {
+namespace Renderer {
+
+/**
+ * @brief Measures the GPU time of rendered frames without waiting for the GPU.
+ *
+ * Uses a small ring of GL_TIME_ELAPSED queries. Query results become available a few frames
+ * after the commands were issued, so Poll() only returns results which are already available
+ * and never stalls the pipeline. If all queries are still pending, the frame isn't measured.
+ *
+ * Timer queries are always available in desktop OpenGL 3.3. OpenGL ES requires the
+ * EXT_disjoint_timer_query extension, see Supported().
+ */
+class GpuTimer
+{
+public:
+    /**
+     * @brief Creates the query objects if timer queries are supported.
+     */
+    GpuTimer();
+
+    GpuTimer(const GpuTimer&) = delete;
+    auto operator=(const GpuTimer&) -> GpuTimer& = delete;
+
+    ~GpuTimer();
+
+    /**
+     * @brief Returns whether the current OpenGL context supports timer queries.
+     * @return True if GPU times can be measured, false otherwise.
+     */
+    static auto Supported() -> bool;
+
+    /**
+     * @brief Starts measuring the commands issued until End() is called.
+     */
+    void Begin();
+
+    /**
+     * @brief Stops measuring.
+     */
+    void End();
+
+    /**
+     * @brief Retrieves the GPU time of the most recent frame for which the result is available.
+     * @param[out] milliseconds Receives the measured GPU time in milliseconds.
+     * @return True if a new result was retrieved, false if no result is available yet.
+     */
+    auto Poll(double& milliseconds) -> bool;
+
+private:
+    static constexpr size_t QueryCount = 4; //!< Number of frames which can be measured at the same time.
+
+    bool m_supported{false};                    //!< True if timer queries are supported.
+    std::array<GLuint, QueryCount> m_queries{}; //!< The query ring.
+    size_t m_oldestQuery{};                     //!< Index of the oldest pending query.
+    size_t m_pendingQueries{};                  //!< Number of queries waiting for their result.
+    bool m_measuring{false};                    //!< True between Begin() and End() if a query was started.
+};
+
+} // namespace Renderer
+} // namespace libprojectM
@@ -0,0 +1,158 @@
+/**
+ * @file InlineFunction.hpp
+ * @brief A move-only function wrapper which stores its callable inline, without allocating.
+ */
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace libprojectM {
+namespace Renderer {
+
+template<typename Signature>
+class InlineFunction;
+
+/**
+ * @brief A move-only function wrapper which stores its callable inline, without allocating.
+ *
+ * Unlike std::function, the callable is always stored in a fixed buffer inside the wrapper.
+ * Callables larger than Capacity, e.g. lambdas capturing more than four pointers or any
+ * std::string by value, are rejected at compile time instead of falling back to the heap.
+ * Wrappers stored in a std::vector can thus be cleared and refilled each frame without any
+ * memory allocation once the vector has reached its final size.
+ *
+ * @tparam Result The return type of the call operator.
+ * @tparam Arguments The argument types of the call operator.
+ */
+template<typename Result, typename... Arguments>
+class InlineFunction<Result(Arguments...)>
+{
+public:
+    static constexpr size_t Capacity = 4 * sizeof(void*); //!< Maximum size of a stored callable, in bytes.
+
+    InlineFunction() = default;
+
+    /**
+     * @brief Stores a copy of the given callable.
+     * @param callable The callable. Must fit into Capacity bytes and be nothrow move-constructible.
+     */
+    template<typename Callable,
+             typename = typename std::enable_if<!std::is_same<typename std::decay<Callable>::type, InlineFunction>::value>::type>
+    InlineFunction(Callable&& callable) // NOLINT(google-explicit-constructor)
+    {
+        using Type = typename std::decay<Callable>::type;
+
+        static_assert(sizeof(Type) <= Capacity, "Callable captures too much state to be stored inline, capture a pointer to it instead.");
+        static_assert(alignof(Type) <= alignof(Storage), "Callable alignment exceeds the inline storage alignment.");
+        static_assert(std::is_nothrow_move_constructible<Type>::value, "Callable must be nothrow move-constructible.");
+
+        new (&m_storage) Type(std::forward<Callable>(callable));
+        m_invoke = &Invoke<Type>;
+        m_manage = &Manage<Type>;
+    }
+
+    InlineFunction(InlineFunction&& other) noexcept
+    {
+        MoveFrom(other);
+    }
+
+    auto operator=(InlineFunction&& other) noexcept -> InlineFunction&
+    {
+        if (this != &other)
+        {
+            Reset();
+            MoveFrom(other);
+        }
+        return *this;
+    }
+
+    InlineFunction(const InlineFunction&) = delete;
+    auto operator=(const InlineFunction&) -> InlineFunction& = delete;
+
+    ~InlineFunction()
+    {
+        Reset();
+    }
+
+    /**
+     * @brief Calls the stored callable. The wrapper must not be empty.
+     * @param arguments The arguments passed to the callable.
+     * @return The result of the callable.
+     */
+    auto operator()(Arguments... arguments) const -> Result
+    {
+        return m_invoke(const_cast<Storage*>(&m_storage), std::forward<Arguments>(arguments)...);
+    }
+
+    /**
+     * @brief Returns whether a callable is stored.
+     * @return true if a callable is stored, false if the wrapper is empty.
+     */
+    explicit operator bool() const
+    {
+        return m_invoke != nullptr;
+    }
+
+private:
+    using Storage = typename std::aligned_storage<Capacity, alignof(std::max_align_t)>::type;
+
+    enum class Operation
+    {
+        Move,   //!< Move-construct the callable into the target storage and destroy the source.
+        Destroy //!< Destroy the callable in the source storage.
+    };
+
+    using InvokeFunction = Result (*)(void*, Arguments&&...);
+    using ManageFunction = void (*)(Operation, void*, void*);
+
+    template<typename Type>
+    static auto Invoke(void* storage, Arguments&&... arguments) -> Result
+    {
+        return (*static_cast<Type*>(storage))(std::forward<Arguments>(arguments)...);
+    }
+
+    template<typename Type>
+    static void Manage(Operation operation, void* source, void* target)
+    {
+        auto* callable = static_cast<Type*>(source);
+        if (operation == Operation::Move)
+        {
+            new (target) Type(std::move(*callable));
+        }
+        callable->~Type();
+    }
+
+    void MoveFrom(InlineFunction& other) noexcept
+    {
+        if (other.m_manage == nullptr)
+        {
+            return;
+        }
+
+        other.m_manage(Operation::Move, &other.m_storage, &m_storage);
+        m_invoke = other.m_invoke;
+        m_manage = other.m_manage;
+        other.m_invoke = nullptr;
+        other.m_manage = nullptr;
+    }
+
+    void Reset() noexcept
+    {
+        if (m_manage != nullptr)
+        {
+            m_manage(Operation::Destroy, &m_storage, nullptr);
+            m_invoke = nullptr;
+            m_manage = nullptr;
+        }
+    }
+
+    Storage m_storage;                 //!< Inline storage of the callable.
+    InvokeFunction m_invoke{nullptr};  //!< Calls the stored callable, or nullptr if empty.
+    ManageFunction m_manage{nullptr};  //!< Moves or destroys the stored callable, or nullptr if empty.
+};
+
+} // namespace Renderer
+} // namespace libprojectM
@@ -1,5 +1,11 @@
 #include "Renderer/Mesh.hpp"
 
+#include "Renderer/GLStateCache.hpp"
+#include "Renderer/StreamingBuffer.hpp"
+
+#include <cassert>
+#include <cstring>
+
 namespace libprojectM {
 namespace Renderer {
 
@@ -9,7 +15,8 @@ Mesh::Mesh()
 }
 
 Mesh::Mesh(VertexBufferUsage usage)
-    : m_vertices(usage)
+    : m_usage(usage)
+    , m_vertices(usage)
     , m_colors(usage)
     , m_textureUVs(usage)
     , m_indices(usage)
@@ -20,6 +27,7 @@ Mesh::Mesh(VertexBufferUsage usage)
 Mesh::Mesh(VertexBufferUsage usage, bool useColor, bool useTextureUVs)
     : m_useColorAttributes(useColor)
     , m_useUVAttributes(useTextureUVs)
+    , m_usage(usage)
     , m_vertices(usage)
     , m_colors(usage)
     , m_textureUVs(usage)
@@ -94,9 +102,26 @@ void Mesh::Unbind()
 void Mesh::Update()
 {
     m_vertexArray.Bind();
-    m_vertices.Update();
-    m_colors.Update();
-    m_textureUVs.Update();
+
+    auto* streamingBuffer = m_usage == VertexBufferUsage::StreamDraw ? StreamingBuffer::Current() : nullptr;
+    if (streamingBuffer != nullptr)
+    {
+        UpdateStreamed(*streamingBuffer);
+    }
+    else
+    {
+        if (m_streamed)
+        {
+            m_vertices.InitializeAttributePointer(0);
+            m_colors.InitializeAttributePointer(1);
+            m_textureUVs.InitializeAttributePointer(2);
+            m_streamed = false;
+        }
+
+        m_vertices.Update();
+        m_colors.Update();
+        m_textureUVs.Update();
+    }
 
     VertexBuffer<class Color>::SetEnableAttributeArray(1, m_useColorAttributes);
     VertexBuffer<TextureUV>::SetEnableAttributeArray(2, m_useUVAttributes);
@@ -104,7 +129,7 @@ void Mesh::Update()
     m_indices.Update();
 }
 
-void Mesh::Draw()
+void Mesh::Draw(uint32_t instanceCount)
 {
     m_vertexArray.Bind();
 
@@ -145,7 +170,15 @@ void Mesh::Draw()
             break;
     }
 
-    glDrawElements(primitiveType, m_indices.Size(), GL_UNSIGNED_INT, nullptr);
+    if (instanceCount > 1)
+    {
+        glDrawElementsInstanced(primitiveType, m_indices.Size(), GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(instanceCount));
+    }
+    else
+    {
+        glDrawElements(primitiveType, m_indices.Size(), GL_UNSIGNED_INT, nullptr);
+    }
+    GLStateCache::Current().CountDrawCall();
 
     VertexArray::Unbind();
 }
@@ -167,5 +200,71 @@ void Mesh::Initialize()
     VertexBuffer<Point>::Unbind();
 }
 
+void Mesh::UpdateStreamed(StreamingBuffer& streamingBuffer)
+{
+    auto const& vertices = m_vertices.Get();
+    if (vertices.empty())
+    {
+        return;
+    }
+
+    size_t const colorOffset = sizeof(Point);
+    size_t const uvOffset = colorOffset + (m_useColorAttributes ? sizeof(class Color) : 0);
+    size_t const stride = uvOffset + (m_useUVAttributes ? sizeof(TextureUV) : 0);
+
+    // Colors and UVs must be resized together with the vertices. If they aren't, the missing
+    // attributes are zeroed instead of reading past the end of the arrays.
+    auto const& colors = m_colors.Get();
+    auto const& textureUVs = m_textureUVs.Get();
+    assert(!m_useColorAttributes || colors.size() >= vertices.size());
+    assert(!m_useUVAttributes || textureUVs.size() >= vertices.size());
+
+    auto const allocation = streamingBuffer.Allocate(stride * vertices.size());
+    auto* data = static_cast<uint8_t*>(allocation.data);
+
+    for (size_t index = 0; index < vertices.size(); index++)
+    {
+        std::memcpy(data, &vertices[index], sizeof(Point));
+        if (m_useColorAttributes)
+        {
+            if (index < colors.size())
+            {
+                std::memcpy(data + colorOffset, &colors[index], sizeof(class Color));
+            }
+            else
+            {
+                std::memset(data + colorOffset, 0, sizeof(class Color));
+            }
+        }
+        if (m_useUVAttributes)
+        {
+            if (index < textureUVs.size())
+            {
+                std::memcpy(data + uvOffset, &textureUVs[index], sizeof(TextureUV));
+            }
+            else
+            {
+                std::memset(data + uvOffset, 0, sizeof(TextureUV));
+            }
+        }
+        data += stride;
+    }
+    streamingBuffer.Commit();
+
+    // The attribute offsets replace a base vertex, which isn't available on all platforms.
+    auto const gpuStride = static_cast<GLsizei>(stride);
+    Point::InitializeAttributePointer(0, gpuStride, allocation.offset);
+    if (m_useColorAttributes)
+    {
+        Color::InitializeAttributePointer(1, gpuStride, allocation.offset + static_cast<GLintptr>(colorOffset));
+    }
+    if (m_useUVAttributes)
+    {
+        TextureUV::InitializeAttributePointer(2, gpuStride, allocation.offset + static_cast<GLintptr>(uvOffset));
+    }
+
+    m_streamed = true;
+}
+
 } // namespace Renderer
 } // namespace libprojectM
@@ -13,6 +13,8 @@
 namespace libprojectM {
 namespace Renderer {
 
+class StreamingBuffer;
+
 /**
  * @brief A 2D mesh class for drawing lines and polygons.
  *
@@ -32,6 +34,10 @@ namespace Renderer {
  * empty on the first draw call, it will be populated with a 1:1 mapping of the vertex buffer. If
  * the vertex count changes, the caller has to make sure that the index array is updated accordingly.
  *
+ * Meshes created with VertexBufferUsage::StreamDraw don't upload into their own buffers. Instead,
+ * all enabled attributes are interleaved into a region of the current StreamingBuffer on each
+ * Update(). Such meshes must be updated in every frame they are drawn in.
+ *
  * @note When using this class, attributes indices 1 and 2 will be toggled according to the
  * attribute enable flags. When using additional vertex arrays, make sure to start with index 3.
  */
@@ -323,6 +329,7 @@ public:
      * @brief Updates the data all enabled buffers, sending it to the GPU.
      * Calling this method is required to render any changed vertex data. As long
      * as Update() is not called, Draw() will always draw the same geometry.
+     * @note For StreamDraw meshes, the uploaded data is only valid until the end of the current frame.
      * @note This method binds the vertex array object and all buffers and leaves them bound.
      */
     void Update();
@@ -334,8 +341,10 @@ public:
      * @note Before calling this method, the caller has to ensure that all buffers have the correct
      * length and were properly uploaded to the GPU by calling Update().
      * @note This method binds and unbinds the stored vertex array object.
+     * @param instanceCount The number of instances to draw. If larger than 1, the geometry is drawn
+     *                      with glDrawElementsInstanced(), and the shader can use gl_InstanceID.
      */
-    void Draw();
+    void Draw(uint32_t instanceCount = 1);
 
 private:
     /**
@@ -343,10 +352,20 @@ private:
      */
     void Initialize();
 
+    /**
+     * @brief Writes all enabled attributes interleaved into the streaming buffer.
+     * Points the attribute arrays to the newly written region.
+     * @param streamingBuffer The streaming buffer to write the vertex data to.
+     */
+    void UpdateStreamed(StreamingBuffer& streamingBuffer);
+
     PrimitiveType m_primitiveType{PrimitiveType::Lines}; //!< Mesh render primitive type.
 
     bool m_useColorAttributes{false}; //!< If true, the color attribute array is enabled and populated.
     bool m_useUVAttributes{false};    //!< If true, the UV attribute array is enabled and populated.
+    bool m_streamed{false};           //!< If true, the attribute arrays point into the streaming buffer.
+
+    VertexBufferUsage m_usage{VertexBufferUsage::StaticDraw}; //!< The buffer usage hint.
 
     VertexArray m_vertexArray; //!< The vertex array object used to store all data of the mesh.
 
@@ -63,10 +63,12 @@ public:
     /**
      * @brief Initializes the attribute array pointer for this storage type.
      * @param attributeIndex the attribute index to use.
+     * @param stride The byte distance between two consecutive elements, for interleaved vertex data.
+     * @param offset The byte offset of the first element in the bound buffer.
      */
-    static void InitializeAttributePointer(uint32_t attributeIndex)
+    static void InitializeAttributePointer(uint32_t attributeIndex, GLsizei stride = sizeof(Point), GLintptr offset = 0)
     {
-        glVertexAttribPointer(attributeIndex, sizeof(Point) / sizeof(float), GL_FLOAT, GL_FALSE, sizeof(Point), nullptr);
+        glVertexAttribPointer(attributeIndex, sizeof(Point) / sizeof(float), GL_FLOAT, GL_FALSE, stride, reinterpret_cast<const void*>(offset));
     }
 
 private:
@@ -4,13 +4,19 @@
 */
 #pragma once
 
+#include "Renderer/RenderFormat.hpp"
+
 #include <projectM-4/projectM_cxx_export.h>
 
 namespace libprojectM {
 namespace Renderer {
 
+class CommandRecorder;
+class GpuProfiler;
 class ShaderCache;
 class TextureManager;
+class TexturePool;
+struct RenderGraphStatistics;
 
 /**
  * @brief Holds all global data of the current rendering context, which can change from frame to frame.
@@ -36,8 +42,16 @@ public:
     float texelOffsetX{0.0f}; //!< Horizontal texel offset in the warp shader.
     float texelOffsetY{0.0f}; //!< Vertical texel offset in the warp shader.
 
+    RenderFormat mainRenderFormat{RenderFormat::RGBA8}; //!< Color format of the preset main images.
+    RenderFormat blurRenderFormat{RenderFormat::RGBA8}; //!< Color format of the blur textures.
+
     TextureManager* textureManager{nullptr}; //!< Holds all loaded textures for shader access.
     ShaderCache* shaderCache{nullptr}; //!< The shader chace of this projectM instance.
+    TexturePool* texturePool{nullptr}; //!< Transient render targets, shared by all presets of this projectM instance.
+    CommandRecorder* commandRecorder{nullptr}; //!< Records the preset drawing commands, on a worker thread if enabled.
+
+    RenderGraphStatistics* renderGraphStatistics{nullptr}; //!< Collects the render passes run and culled in the current frame.
+    GpuProfiler* gpuProfiler{nullptr};                     //!< Measures each render pass. nullptr if profiling is disabled.
 };
 
 } // namespace Renderer
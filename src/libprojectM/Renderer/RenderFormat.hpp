@@ -0,0 +1,25 @@
+/**
+ * @file RenderFormat.hpp
+ * @brief Color formats of the internal render targets.
+ */
+#pragma once
+
+namespace libprojectM {
+namespace Renderer {
+
+/**
+ * @brief Color formats selectable for the internal render targets.
+ *
+ * Trades memory bandwidth against color precision and range. All formats except RGBA16F use
+ * 32 bits per pixel.
+ */
+enum class RenderFormat
+{
+    RGBA8,      //!< 8 bits per channel, unsigned normalized. Same as Milkdrop.
+    RGB10A2,    //!< 10 bits per color channel and 2 bits alpha, unsigned normalized.
+    R11G11B10F, //!< Unsigned floating-point colors with 11/11/10 bits and no alpha channel.
+    RGBA16F     //!< 16-bit floating-point per channel. Uses twice the bandwidth of the other formats.
+};
+
+} // namespace Renderer
+} // namespace libprojectM
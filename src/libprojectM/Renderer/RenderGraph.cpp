@@ -0,0 +1,128 @@
+#include "Renderer/RenderGraph.hpp"
+
+#include "Renderer/GpuProfiler.hpp"
+
+#include <algorithm>
+
+namespace libprojectM {
+namespace Renderer {
+
+auto RenderGraph::AddPass(std::string name,
+                          const std::vector<std::string>& reads,
+                          const std::vector<std::string>& writes,
+                          ExecuteFunction execute,
+                          bool enabled) -> size_t
+{
+    Pass pass;
+    pass.name = std::move(name);
+    for (const auto& resource : reads)
+    {
+        pass.reads.push_back(ResourceIndex(resource));
+    }
+    for (const auto& resource : writes)
+    {
+        pass.writes.push_back(ResourceIndex(resource));
+    }
+    pass.execute = std::move(execute);
+    pass.enabled = enabled;
+
+    m_passes.push_back(std::move(pass));
+
+    return m_passes.size() - 1;
+}
+
+void RenderGraph::SetEnabled(size_t pass, bool enabled)
+{
+    m_passes.at(pass).enabled = enabled;
+}
+
+void RenderGraph::AddOutput(const std::string& resource)
+{
+    m_outputs.push_back(ResourceIndex(resource));
+}
+
+auto RenderGraph::Empty() const -> bool
+{
+    return m_passes.empty();
+}
+
+void RenderGraph::Clear()
+{
+    m_passes.clear();
+    m_resources.clear();
+    m_outputs.clear();
+    m_required.clear();
+}
+
+void RenderGraph::Execute(RenderGraphStatistics* statistics, GpuProfiler* profiler)
+{
+    m_required.assign(m_resources.size(), 0);
+    for (auto output : m_outputs)
+    {
+        m_required[output] = 1;
+    }
+
+    // Walk backwards, so each pass knows whether any later pass uses what it writes.
+    for (auto pass = m_passes.rbegin(); pass != m_passes.rend(); ++pass)
+    {
+        pass->needed = pass->enabled &&
+                       std::any_of(pass->writes.begin(), pass->writes.end(), [this](size_t resource) {
+                           return m_required[resource] != 0;
+                       });
+
+        if (pass->needed)
+        {
+            for (auto resource : pass->reads)
+            {
+                m_required[resource] = 1;
+            }
+        }
+    }
+
+    for (auto& pass : m_passes)
+    {
+        if (pass.needed)
+        {
+            if (profiler != nullptr)
+            {
+                profiler->BeginPass(pass.name);
+                pass.execute();
+                profiler->EndPass();
+            }
+            else
+            {
+                pass.execute();
+            }
+        }
+
+        if (statistics == nullptr)
+        {
+            continue;
+        }
+
+        if (pass.needed)
+        {
+            statistics->executed++;
+        }
+        else
+        {
+            statistics->culled++;
+            statistics->culledPasses.push_back(pass.name);
+        }
+    }
+}
+
+auto RenderGraph::ResourceIndex(const std::string& resource) -> size_t
+{
+    auto const entry = std::find(m_resources.begin(), m_resources.end(), resource);
+    if (entry != m_resources.end())
+    {
+        return static_cast<size_t>(entry - m_resources.begin());
+    }
+
+    m_resources.push_back(resource);
+    return m_resources.size() - 1;
+}
+
+} // namespace Renderer
+} // namespace libprojectM
@@ -0,0 +1,130 @@
+/**
+ * @file RenderGraph.hpp
+ * @brief Schedules the render passes of a frame and culls passes without visible effect.
+ */
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace libprojectM {
+namespace Renderer {
+
+class GpuProfiler;
+
+/**
+ * @brief Number and names of the render passes run and culled in a frame.
+ */
+struct RenderGraphStatistics {
+    uint32_t executed{};                   //!< Number of passes which were run.
+    uint32_t culled{};                     //!< Number of passes which were skipped.
+    std::vector<std::string> culledPasses; //!< Names of the skipped passes, in the order they were added.
+};
+
+/**
+ * @brief Measured costs of a single render pass.
+ */
+struct PassTiming {
+    std::string name;        //!< The pass name.
+    uint32_t frame{};        //!< Number of the frame the pass was rendered in.
+    double gpuTime{-1.0};    //!< GPU time in milliseconds, or a negative value if it couldn't be measured.
+    uint32_t drawCalls{};    //!< Number of draw calls issued by the pass.
+    uint32_t stateChanges{}; //!< Number of OpenGL state changes issued by the pass.
+};
+
+/**
+ * @brief Schedules the render passes of a frame and culls passes without visible effect.
+ *
+ * The renderer adds its passes once in execution order and executes the graph each frame. Every
+ * pass declares the resources it reads and writes, e.g. "previous_frame" or "blur". Resources are
+ * only names, the graph doesn't manage any OpenGL objects. Resources which are needed after the
+ * frame, like the final image, are marked as outputs.
+ *
+ * When the graph is executed, a pass is only run if it's enabled, e.g. not fully transparent, and
+ * writes at least one resource which is either an output or read by a later pass which is run.
+ * All other passes are culled. Passes can be enabled or disabled before each execution, the graph
+ * itself is kept until it's cleared. Resource names are mapped to indices when a pass is added,
+ * so executing the graph doesn't compare or copy any strings unless culled passes are reported.
+ */
+class RenderGraph
+{
+public:
+    using ExecuteFunction = std::function<void()>; //!< Renders a single pass.
+
+    /**
+     * @brief Adds a pass to the end of the frame.
+     * @param name The pass name, used in statistics.
+     * @param reads The resources read by the pass.
+     * @param writes The resources written by the pass. A pass which blends onto a resource must
+     *               also add it to the read resources.
+     * @param execute The function rendering the pass.
+     * @param enabled If false, the pass is always culled, e.g. because it wouldn't draw anything.
+     * @return The index of the pass, used to enable or disable it.
+     */
+    auto AddPass(std::string name,
+                 const std::vector<std::string>& reads,
+                 const std::vector<std::string>& writes,
+                 ExecuteFunction execute,
+                 bool enabled = true) -> size_t;
+
+    /**
+     * @brief Enables or disables a pass for the following executions.
+     * @param pass The pass index returned by AddPass().
+     * @param enabled If false, the pass is always culled.
+     */
+    void SetEnabled(size_t pass, bool enabled);
+
+    /**
+     * @brief Marks a resource as needed after the frame has been rendered.
+     * @param resource The resource name.
+     */
+    void AddOutput(const std::string& resource);
+
+    /**
+     * @brief Returns whether the graph has no passes.
+     * @return true if no pass was added since the graph was created or cleared.
+     */
+    auto Empty() const -> bool;
+
+    /**
+     * @brief Removes all passes, outputs and resources.
+     */
+    void Clear();
+
+    /**
+     * @brief Runs all passes contributing to an output in the order they were added.
+     * @param[in,out] statistics If not nullptr, the executed and culled passes are added to the statistics.
+     * @param profiler If not nullptr, each executed pass is measured by the profiler.
+     */
+    void Execute(RenderGraphStatistics* statistics = nullptr, GpuProfiler* profiler = nullptr);
+
+private:
+    /**
+     * @brief A single render pass.
+     */
+    struct Pass {
+        std::string name;           //!< The pass name.
+        std::vector<size_t> reads;  //!< Indices of the resources read by this pass.
+        std::vector<size_t> writes; //!< Indices of the resources written by this pass.
+        ExecuteFunction execute;    //!< The function rendering the pass.
+        bool enabled{true};         //!< If false, the pass is always culled.
+        bool needed{false};         //!< True if the pass is run in this frame.
+    };
+
+    /**
+     * @brief Returns the index of a resource, adding it if it's not known yet.
+     * @param resource The resource name.
+     * @return The resource index.
+     */
+    auto ResourceIndex(const std::string& resource) -> size_t;
+
+    std::vector<Pass> m_passes;           //!< All passes, in execution order.
+    std::vector<std::string> m_resources; //!< Names of all resources used by passes or outputs.
+    std::vector<size_t> m_outputs;        //!< Indices of the resources needed after the frame.
+    std::vector<char> m_required;         //!< Per resource, non-zero if it's read by a pass which is run, used while culling.
+};
+
+} // namespace Renderer
+} // namespace libprojectM
@@ -0,0 +1,77 @@
+#include "Renderer/ResizeDebouncer.hpp"
+
+namespace libprojectM {
+namespace Renderer {
+
+void ResizeDebouncer::SetSettleFrames(uint32_t frames)
+{
+    m_settleFrames = frames;
+    if (m_settleFrames == 0)
+    {
+        Apply();
+    }
+}
+
+auto ResizeDebouncer::SettleFrames() const -> uint32_t
+{
+    return m_settleFrames;
+}
+
+void ResizeDebouncer::Request(uint32_t width, uint32_t height)
+{
+    if (width != m_requestedWidth || height != m_requestedHeight)
+    {
+        m_requestedWidth = width;
+        m_requestedHeight = height;
+        m_unchangedFrames = 0;
+    }
+
+    // Nothing was displayed yet, so there's no reason to wait.
+    if (m_settleFrames == 0 || m_width == 0 || m_height == 0)
+    {
+        Apply();
+    }
+}
+
+auto ResizeDebouncer::NextFrame() -> bool
+{
+    if (!Pending())
+    {
+        return false;
+    }
+
+    m_unchangedFrames++;
+    if (m_unchangedFrames < m_settleFrames)
+    {
+        return false;
+    }
+
+    Apply();
+
+    return true;
+}
+
+auto ResizeDebouncer::Width() const -> uint32_t
+{
+    return m_width;
+}
+
+auto ResizeDebouncer::Height() const -> uint32_t
+{
+    return m_height;
+}
+
+auto ResizeDebouncer::Pending() const -> bool
+{
+    return m_width != m_requestedWidth || m_height != m_requestedHeight;
+}
+
+void ResizeDebouncer::Apply()
+{
+    m_width = m_requestedWidth;
+    m_height = m_requestedHeight;
+    m_unchangedFrames = 0;
+}
+
+} // namespace Renderer
+} // namespace libprojectM
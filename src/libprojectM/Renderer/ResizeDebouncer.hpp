@@ -0,0 +1,85 @@
+/**
+ * @file ResizeDebouncer.hpp
+ * @brief Coalesces window size changes until the size is stable.
+ */
+#pragma once
+
+#include <cstdint>
+
+namespace libprojectM {
+namespace Renderer {
+
+/**
+ * @brief Coalesces window size changes until the size is stable.
+ *
+ * Resizing the render targets reallocates all preset framebuffers and textures. While a window is
+ * resized interactively, the size changes with almost every frame, so each requested size is only
+ * applied after it didn't change for a number of frames. Until then, the previous size is kept and
+ * the rendered image is scaled to the window.
+ *
+ * The first size requested is applied immediately, as there is nothing to display before.
+ */
+class ResizeDebouncer
+{
+public:
+    ResizeDebouncer() = default;
+
+    /**
+     * @brief Sets the number of frames a new size must stay unchanged before it's applied.
+     * @param frames The number of frames. 0 applies each size immediately.
+     */
+    void SetSettleFrames(uint32_t frames);
+
+    /**
+     * @brief Returns the number of frames a new size must stay unchanged before it's applied.
+     * @return The number of frames.
+     */
+    auto SettleFrames() const -> uint32_t;
+
+    /**
+     * @brief Requests a new size, e.g. after the window was resized.
+     * @param width The requested width in pixels.
+     * @param height The requested height in pixels.
+     */
+    void Request(uint32_t width, uint32_t height);
+
+    /**
+     * @brief Counts a rendered frame and applies the requested size if it has settled.
+     * @return true if the size was changed, false if it stays the same.
+     */
+    auto NextFrame() -> bool;
+
+    /**
+     * @brief Returns the current width to render at.
+     * @return The settled width in pixels.
+     */
+    auto Width() const -> uint32_t;
+
+    /**
+     * @brief Returns the current height to render at.
+     * @return The settled height in pixels.
+     */
+    auto Height() const -> uint32_t;
+
+    /**
+     * @brief Returns whether a requested size is waiting to settle.
+     * @return true if the requested size differs from the current size.
+     */
+    auto Pending() const -> bool;
+
+private:
+    /**
+     * @brief Applies the requested size.
+     */
+    void Apply();
+
+    uint32_t m_settleFrames{10};  //!< Frames a requested size must stay unchanged before it's applied.
+    uint32_t m_width{};           //!< Current width in pixels.
+    uint32_t m_height{};          //!< Current height in pixels.
+    uint32_t m_requestedWidth{};  //!< Most recently requested width in pixels.
+    uint32_t m_requestedHeight{}; //!< Most recently requested height in pixels.
+    uint32_t m_unchangedFrames{}; //!< Frames rendered since the requested size last changed.
+};
+
+} // namespace Renderer
+} // namespace libprojectM
@@ -0,0 +1,115 @@
+#include "Renderer/ResolutionController.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace libprojectM {
+namespace Renderer {
+
+constexpr double ResolutionController::SmoothingFactor;
+constexpr double ResolutionController::LowerBand;
+constexpr double ResolutionController::TargetUtilization;
+constexpr float ResolutionController::ScaleStep;
+constexpr uint32_t ResolutionController::IgnoredFrames;
+constexpr uint32_t ResolutionController::SettleFrames;
+
+void ResolutionController::SetTargetFrameTime(double milliseconds)
+{
+    m_targetFrameTime = std::max(1.0, milliseconds);
+}
+
+auto ResolutionController::TargetFrameTime() const -> double
+{
+    return m_targetFrameTime;
+}
+
+void ResolutionController::SetScaleLimits(float minScale, float maxScale)
+{
+    m_minScale = std::max(0.1f, std::min(1.0f, minScale));
+    m_maxScale = std::max(m_minScale, std::min(1.0f, maxScale));
+    m_scale = std::max(m_minScale, std::min(m_maxScale, m_scale));
+}
+
+auto ResolutionController::MinScale() const -> float
+{
+    return m_minScale;
+}
+
+auto ResolutionController::MaxScale() const -> float
+{
+    return m_maxScale;
+}
+
+auto ResolutionController::Update(double milliseconds) -> float
+{
+    if (milliseconds <= 0.0)
+    {
+        return m_scale;
+    }
+
+    m_measurements++;
+    if (m_measurements <= IgnoredFrames)
+    {
+        return m_scale;
+    }
+
+    if (m_measurements == IgnoredFrames + 1)
+    {
+        m_smoothedFrameTime = milliseconds;
+    }
+    else
+    {
+        m_smoothedFrameTime += SmoothingFactor * (milliseconds - m_smoothedFrameTime);
+    }
+
+    if (m_measurements < SettleFrames ||
+        (m_smoothedFrameTime <= m_targetFrameTime && m_smoothedFrameTime >= m_targetFrameTime * LowerBand))
+    {
+        return m_scale;
+    }
+
+    // The render cost is roughly proportional to the pixel count, which grows with the square of the scale.
+    float newScale = m_scale * static_cast<float>(std::sqrt(m_targetFrameTime * TargetUtilization / m_smoothedFrameTime));
+    newScale = std::round(newScale / ScaleStep) * ScaleStep;
+
+    if (m_smoothedFrameTime > m_targetFrameTime)
+    {
+        newScale = std::min(newScale, m_scale - ScaleStep);
+    }
+    else
+    {
+        newScale = std::max(newScale, m_scale + ScaleStep);
+    }
+
+    newScale = std::max(m_minScale, std::min(m_maxScale, newScale));
+
+    // Don't increase the scale if the larger frames would most likely exceed the target again.
+    auto const expectedFrameTime = m_smoothedFrameTime * (newScale * newScale) / (m_scale * m_scale);
+    if (newScale > m_scale && expectedFrameTime > m_targetFrameTime)
+    {
+        return m_scale;
+    }
+
+    if (newScale != m_scale)
+    {
+        m_scale = newScale;
+        m_measurements = 0;
+    }
+
+    return m_scale;
+}
+
+auto ResolutionController::Scale() const -> float
+{
+    return m_scale;
+}
+
+void ResolutionController::Reset()
+{
+    m_scale = m_maxScale;
+    m_smoothedFrameTime = 0.0;
+    m_measurements = 0;
+}
+
+} // namespace Renderer
+} // namespace libprojectM
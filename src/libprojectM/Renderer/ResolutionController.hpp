@@ -0,0 +1,96 @@
+/**
+ * @file ResolutionController.hpp
+ * @brief Chooses the internal render resolution from measured frame times.
+ */
+#pragma once
+
+#include <cstdint>
+
+namespace libprojectM {
+namespace Renderer {
+
+/**
+ * @brief Chooses the internal render resolution from measured frame times.
+ *
+ * Presets are rendered at the output size multiplied by the scale factor returned by this class.
+ * Each frame, the measured frame time is passed to Update(). If the smoothed frame time leaves
+ * a band below the target frame time, the scale is changed so the pixel count, which the render
+ * cost is roughly proportional to, brings the frame time back into the band.
+ *
+ * Changing the scale reallocates the preset framebuffers, so the scale is quantized into coarse
+ * steps, and is kept for a number of frames after each change until the new measurements have
+ * settled.
+ */
+class ResolutionController
+{
+public:
+    ResolutionController() = default;
+
+    /**
+     * @brief Sets the frame time the controller tries to stay below.
+     * @param milliseconds The target frame time in milliseconds.
+     */
+    void SetTargetFrameTime(double milliseconds);
+
+    /**
+     * @brief Returns the frame time the controller tries to stay below.
+     * @return The target frame time in milliseconds.
+     */
+    auto TargetFrameTime() const -> double;
+
+    /**
+     * @brief Sets the smallest and largest scale factor.
+     * Both values are clamped to the range 0.1 to 1.0. The current scale is clamped to the new limits.
+     * @param minScale The smallest scale factor.
+     * @param maxScale The largest scale factor.
+     */
+    void SetScaleLimits(float minScale, float maxScale);
+
+    /**
+     * @brief Returns the smallest scale factor.
+     * @return The smallest scale factor.
+     */
+    auto MinScale() const -> float;
+
+    /**
+     * @brief Returns the largest scale factor.
+     * @return The largest scale factor.
+     */
+    auto MaxScale() const -> float;
+
+    /**
+     * @brief Adds the time of the last measured frame and updates the scale factor.
+     * @param milliseconds The measured frame time in milliseconds.
+     * @return The scale factor to use for the next frame.
+     */
+    auto Update(double milliseconds) -> float;
+
+    /**
+     * @brief Returns the current scale factor.
+     * @return The scale factor, relative to the output size.
+     */
+    auto Scale() const -> float;
+
+    /**
+     * @brief Resets the scale to the largest value and discards all measurements.
+     */
+    void Reset();
+
+private:
+    static constexpr double SmoothingFactor = 0.1;   //!< Weight of a new measurement in the smoothed frame time.
+    static constexpr double LowerBand = 0.8;         //!< Frame times below this fraction of the target increase the scale.
+    static constexpr double TargetUtilization = 0.9; //!< Fraction of the target frame time a scale change aims for.
+    static constexpr float ScaleStep = 0.05f;        //!< Scale factors are rounded to multiples of this value.
+    static constexpr uint32_t IgnoredFrames = 5;     //!< Measurements after a change which may still be from frames at the old scale.
+    static constexpr uint32_t SettleFrames = 30;     //!< Measurements after a change until the scale can change again.
+
+    double m_targetFrameTime{16.0}; //!< Target frame time in milliseconds.
+    float m_minScale{0.5f};         //!< Smallest scale factor.
+    float m_maxScale{1.0f};         //!< Largest scale factor.
+    float m_scale{1.0f};            //!< Current scale factor.
+    double m_smoothedFrameTime{};   //!< Exponentially smoothed frame time in milliseconds.
+    uint32_t m_measurements{};      //!< Measurements added since the last scale change.
+};
+
+} // namespace Renderer
+} // namespace libprojectM
@@ -1,5 +1,7 @@
 #include "Sampler.hpp"
 
+#include "GLStateCache.hpp"
+
 namespace libprojectM {
 namespace Renderer {
 
@@ -17,17 +19,18 @@ Sampler::Sampler(const GLint wrapMode, const GLint filterMode)
 
 Sampler::~Sampler()
 {
+    GLStateCache::Current().SamplerDeleted(m_samplerId);
     glDeleteSamplers(1, &m_samplerId);
 }
 
 void Sampler::Bind(GLuint unit) const
 {
-    glBindSampler(unit, m_samplerId);
+    GLStateCache::Current().BindSampler(unit, m_samplerId);
 }
 
 void Sampler::Unbind(GLuint unit)
 {
-    glBindSampler(unit, 0);
+    GLStateCache::Current().BindSampler(unit, 0);
 }
 
 auto Sampler::WrapMode() const -> GLint
@@ -1,8 +1,13 @@
 #include "Shader.hpp"
 
+#include "GLStateCache.hpp"
+
 #include <Logging.hpp>
+#include <Tracing.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <algorithm>
+#include <cstring>
 #include <vector>
 
 namespace libprojectM {
@@ -21,9 +26,23 @@ Shader::~Shader()
     }
 }
 
+void Shader::SetTransformFeedbackVaryings(const std::vector<std::string>& varyings)
+{
+    std::vector<const char*> names;
+    names.reserve(varyings.size());
+    for (const auto& varying : varyings)
+    {
+        names.push_back(varying.c_str());
+    }
+
+    glTransformFeedbackVaryings(m_shaderProgram, static_cast<GLsizei>(names.size()), names.data(), GL_INTERLEAVED_ATTRIBS);
+}
+
 void Shader::CompileProgram(const std::string& vertexShaderSource,
                             const std::string& fragmentShaderSource)
 {
+    TRACE_SCOPE("Shader::CompileProgram");
+
     auto vertexShader = CompileShader(vertexShaderSource, GL_VERTEX_SHADER);
     auto fragmentShader = CompileShader(fragmentShaderSource, GL_FRAGMENT_SHADER);
 
@@ -42,6 +61,7 @@ void Shader::CompileProgram(const std::string& vertexShaderSource,
     glGetProgramiv(m_shaderProgram, GL_LINK_STATUS, &programLinked);
     if (programLinked == GL_TRUE)
     {
+        ReadActiveUniforms();
         return;
     }
 
@@ -80,18 +100,28 @@ void Shader::Bind() const
 {
     if (m_shaderProgram > 0)
     {
-        glUseProgram(m_shaderProgram);
+        GLStateCache::Current().UseProgram(m_shaderProgram);
     }
 }
 
 void Shader::Unbind()
 {
-    glUseProgram(0);
+    GLStateCache::Current().UseProgram(0);
 }
 
-void Shader::SetUniformFloat(const char* uniform, float value) const
+void Shader::BindUniformBlock(const char* blockName, GLuint bindingPoint) const
+{
+    auto blockIndex = glGetUniformBlockIndex(m_shaderProgram, blockName);
+    if (blockIndex == GL_INVALID_INDEX)
+    {
+        return;
+    }
+    glUniformBlockBinding(m_shaderProgram, blockIndex, bindingPoint);
+}
+
+void Shader::SetUniform(UniformHandle<float> uniform, float value) const
 {
-    auto location = glGetUniformLocation(m_shaderProgram, uniform);
+    auto location = UpdateCachedValue(uniform.m_index, &value, sizeof(value));
     if (location < 0)
     {
         return;
@@ -99,9 +129,9 @@ void Shader::SetUniformFloat(const char* uniform, float value) const
     glUniform1fv(location, 1, &value);
 }
 
-void Shader::SetUniformInt(const char* uniform, int value) const
+void Shader::SetUniform(UniformHandle<int> uniform, int value) const
 {
-    auto location = glGetUniformLocation(m_shaderProgram, uniform);
+    auto location = UpdateCachedValue(uniform.m_index, &value, sizeof(value));
     if (location < 0)
     {
         return;
@@ -109,84 +139,134 @@ void Shader::SetUniformInt(const char* uniform, int value) const
     glUniform1iv(location, 1, &value);
 }
 
-void Shader::SetUniformFloat2(const char* uniform, const glm::vec2& values) const
+void Shader::SetUniform(UniformHandle<glm::vec2> uniform, const glm::vec2& value) const
 {
-    auto location = glGetUniformLocation(m_shaderProgram, uniform);
+    auto location = UpdateCachedValue(uniform.m_index, &value, sizeof(value));
     if (location < 0)
     {
         return;
     }
-    glUniform2fv(location, 1, glm::value_ptr(values));
+    glUniform2fv(location, 1, glm::value_ptr(value));
 }
 
-void Shader::SetUniformInt2(const char* uniform, const glm::ivec2& values) const
+void Shader::SetUniform(UniformHandle<glm::ivec2> uniform, const glm::ivec2& value) const
 {
-    auto location = glGetUniformLocation(m_shaderProgram, uniform);
+    auto location = UpdateCachedValue(uniform.m_index, &value, sizeof(value));
     if (location < 0)
     {
         return;
     }
-    glUniform2iv(location, 1, glm::value_ptr(values));
+    glUniform2iv(location, 1, glm::value_ptr(value));
 }
 
-void Shader::SetUniformFloat3(const char* uniform, const glm::vec3& values) const
+void Shader::SetUniform(UniformHandle<glm::vec3> uniform, const glm::vec3& value) const
 {
-    auto location = glGetUniformLocation(m_shaderProgram, uniform);
+    auto location = UpdateCachedValue(uniform.m_index, &value, sizeof(value));
     if (location < 0)
     {
         return;
     }
-    glUniform3fv(location, 1, glm::value_ptr(values));
+    glUniform3fv(location, 1, glm::value_ptr(value));
 }
 
-void Shader::SetUniformInt3(const char* uniform, const glm::ivec3& values) const
+void Shader::SetUniform(UniformHandle<glm::ivec3> uniform, const glm::ivec3& value) const
 {
-    auto location = glGetUniformLocation(m_shaderProgram, uniform);
+    auto location = UpdateCachedValue(uniform.m_index, &value, sizeof(value));
     if (location < 0)
     {
         return;
     }
-    glUniform3iv(location, 1, glm::value_ptr(values));
+    glUniform3iv(location, 1, glm::value_ptr(value));
 }
 
-void Shader::SetUniformFloat4(const char* uniform, const glm::vec4& values) const
+void Shader::SetUniform(UniformHandle<glm::vec4> uniform, const glm::vec4& value) const
 {
-    auto location = glGetUniformLocation(m_shaderProgram, uniform);
+    auto location = UpdateCachedValue(uniform.m_index, &value, sizeof(value));
     if (location < 0)
     {
         return;
     }
-    glUniform4fv(location, 1, glm::value_ptr(values));
+    glUniform4fv(location, 1, glm::value_ptr(value));
 }
 
-void Shader::SetUniformInt4(const char* uniform, const glm::ivec4& values) const
+void Shader::SetUniform(UniformHandle<glm::ivec4> uniform, const glm::ivec4& value) const
 {
-    auto location = glGetUniformLocation(m_shaderProgram, uniform);
+    auto location = UpdateCachedValue(uniform.m_index, &value, sizeof(value));
     if (location < 0)
     {
         return;
     }
-    glUniform4iv(location, 1, glm::value_ptr(values));
+    glUniform4iv(location, 1, glm::value_ptr(value));
 }
 
-void Shader::SetUniformMat3x4(const char* uniform, const glm::mat3x4& values) const
+void Shader::SetUniform(UniformHandle<glm::mat3x4> uniform, const glm::mat3x4& value) const
 {
-    auto location = glGetUniformLocation(m_shaderProgram, uniform);
+    auto location = UpdateCachedValue(uniform.m_index, &value, sizeof(value));
     if (location < 0)
     {
         return;
     }
-    glUniformMatrix3x4fv(location, 1, GL_FALSE, glm::value_ptr(values));
+    glUniformMatrix3x4fv(location, 1, GL_FALSE, glm::value_ptr(value));
 }
 
-void Shader::SetUniformMat4x4(const char* uniform, const glm::mat4x4& values) const
+void Shader::SetUniform(UniformHandle<glm::mat4x4> uniform, const glm::mat4x4& value) const
 {
-    auto location = glGetUniformLocation(m_shaderProgram, uniform);
+    auto location = UpdateCachedValue(uniform.m_index, &value, sizeof(value));
     if (location < 0)
     {
         return;
     }
-    glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(values));
+    glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value));
+}
+
+void Shader::SetUniformFloat(const char* uniform, float value) const
+{
+    SetUniform(GetUniform<float>(uniform), value);
+}
+
+void Shader::SetUniformInt(const char* uniform, int value) const
+{
+    SetUniform(GetUniform<int>(uniform), value);
+}
+
+void Shader::SetUniformFloat2(const char* uniform, const glm::vec2& values) const
+{
+    SetUniform(GetUniform<glm::vec2>(uniform), values);
+}
+
+void Shader::SetUniformInt2(const char* uniform, const glm::ivec2& values) const
+{
+    SetUniform(GetUniform<glm::ivec2>(uniform), values);
+}
+
+void Shader::SetUniformFloat3(const char* uniform, const glm::vec3& values) const
+{
+    SetUniform(GetUniform<glm::vec3>(uniform), values);
+}
+
+void Shader::SetUniformInt3(const char* uniform, const glm::ivec3& values) const
+{
+    SetUniform(GetUniform<glm::ivec3>(uniform), values);
+}
+
+void Shader::SetUniformFloat4(const char* uniform, const glm::vec4& values) const
+{
+    SetUniform(GetUniform<glm::vec4>(uniform), values);
+}
+
+void Shader::SetUniformInt4(const char* uniform, const glm::ivec4& values) const
+{
+    SetUniform(GetUniform<glm::ivec4>(uniform), values);
+}
+
+void Shader::SetUniformMat3x4(const char* uniform, const glm::mat3x4& values) const
+{
+    SetUniform(GetUniform<glm::mat3x4>(uniform), values);
+}
+
+void Shader::SetUniformMat4x4(const char* uniform, const glm::mat4x4& values) const
+{
+    SetUniform(GetUniform<glm::mat4x4>(uniform), values);
 }
 
 GLuint Shader::CompileShader(const std::string& source, GLenum type)
@@ -217,6 +297,77 @@ GLuint Shader::CompileShader(const std::string& source, GLenum type)
     throw ShaderException(compileError);
 }
 
+void Shader::ReadActiveUniforms()
+{
+    m_uniformIndices.clear();
+    m_uniforms.clear();
+
+    GLint uniformCount{};
+    GLint maxNameLength{};
+    glGetProgramiv(m_shaderProgram, GL_ACTIVE_UNIFORMS, &uniformCount);
+    glGetProgramiv(m_shaderProgram, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+    std::vector<char> nameBuffer(static_cast<size_t>(std::max(maxNameLength, 1)));
+    for (GLint index = 0; index < uniformCount; index++)
+    {
+        GLsizei nameLength{};
+        GLint size{};
+        GLenum type{};
+        glGetActiveUniform(m_shaderProgram, static_cast<GLuint>(index), static_cast<GLsizei>(nameBuffer.size()), &nameLength, &size, &type, nameBuffer.data());
+
+        std::string name(nameBuffer.data(), static_cast<size_t>(nameLength));
+
+        // Uniforms in blocks have no location.
+        auto location = glGetUniformLocation(m_shaderProgram, name.c_str());
+        if (location < 0)
+        {
+            continue;
+        }
+
+        // Arrays are reported as "name[0]", but are usually addressed by their plain name.
+        if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0)
+        {
+            name.resize(name.size() - 3);
+        }
+
+        Uniform uniform;
+        uniform.location = location;
+        m_uniformIndices.emplace(std::move(name), static_cast<int>(m_uniforms.size()));
+        m_uniforms.push_back(uniform);
+    }
+}
+
+auto Shader::FindUniform(const char* uniform) const -> int
+{
+    auto const entry = m_uniformIndices.find(uniform);
+    if (entry == m_uniformIndices.end())
+    {
+        return -1;
+    }
+
+    return entry->second;
+}
+
+auto Shader::UpdateCachedValue(int index, const void* value, size_t size) const -> GLint
+{
+    if (index < 0 || static_cast<size_t>(index) >= m_uniforms.size())
+    {
+        return -1;
+    }
+
+    // Uniform values are program state, so the cache stays valid while the program is bound elsewhere.
+    auto& uniform = m_uniforms[index];
+    if (uniform.valueSet && std::memcmp(uniform.value.data(), value, size) == 0)
+    {
+        return -1;
+    }
+
+    std::memcpy(uniform.value.data(), value, size);
+    uniform.valueSet = true;
+
+    return uniform.location;
+}
+
 auto Shader::GetShaderLanguageVersion() -> Shader::GlslVersion
 {
     const char* shaderLanguageVersion = reinterpret_cast<const char*>(glGetString(GL_SHADING_LANGUAGE_VERSION));
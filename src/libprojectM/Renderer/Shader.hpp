@@ -12,8 +12,11 @@
 #include <glm/mat3x4.hpp>
 #include <glm/mat4x4.hpp>
 
+#include <array>
+#include <functional>
 #include <map>
 #include <string>
+#include <vector>
 
 namespace libprojectM {
 namespace Renderer {
@@ -46,8 +49,47 @@ private:
 };
 
 
+/**
+ * @brief A resolved handle to a uniform of the given type.
+ *
+ * Handles are obtained once via Shader::GetUniform() after compiling the program and can then be
+ * used to set the uniform value without any name lookup. The type parameter makes sure the value
+ * is always set with the matching setter. A handle becomes invalid if the program is compiled again.
+ *
+ * @tparam T The uniform value type, e.g. float or glm::vec4.
+ */
+template<typename T>
+class UniformHandle
+{
+public:
+    UniformHandle() = default;
+
+    /**
+     * @brief Returns whether the uniform is an active uniform in the shader program.
+     * @return true if the handle refers to an active uniform, false if setting it is a no-op.
+     */
+    auto Valid() const -> bool
+    {
+        return m_index >= 0;
+    }
+
+private:
+    friend class Shader;
+
+    explicit UniformHandle(int index)
+        : m_index(index)
+    {
+    }
+
+    int m_index{-1}; //!< Index into the shader's uniform table, or -1 if the uniform is not active.
+};
+
 /**
  * @brief Base class containing a shader program, consisting of a vertex and fragment shader.
+ *
+ * After linking, the locations of all active uniforms are stored in a table, so setting a uniform
+ * by name doesn't need to query OpenGL. The last value set for each uniform is cached as well,
+ * and setting the same value again doesn't issue another glUniform call.
  */
 class Shader
 {
@@ -70,6 +112,13 @@ public:
      */
     ~Shader();
 
+    /**
+     * @brief Sets the vertex shader outputs which are captured in transform feedback mode.
+     * Must be called before CompileProgram(), e.g. to read back vertices calculated by the vertex shader.
+     * @param varyings The names of the captured outputs, written interleaved into a single buffer.
+     */
+    void SetTransformFeedbackVaryings(const std::vector<std::string>& varyings);
+
     /**
      * @brief Compiles a vertex and fragment shader into a program.
      * @throws ShaderException Thrown if compilation of a shader or program linking failed.
@@ -96,6 +145,44 @@ public:
      */
     static void Unbind();
 
+    /**
+     * @brief Resolves a uniform handle by name.
+     * @tparam T The uniform value type.
+     * @param uniform The uniform name.
+     * @return The uniform handle. If the uniform is not active in the program, the handle is invalid.
+     */
+    template<typename T>
+    auto GetUniform(const char* uniform) const -> UniformHandle<T>
+    {
+        return UniformHandle<T>(FindUniform(uniform));
+    }
+
+    /**
+     * @brief Sets a uniform value via a resolved handle.
+     * The program must be bound before calling this method! Does nothing if the handle is invalid
+     * or the value is unchanged since it was last set.
+     * @param uniform The uniform handle.
+     * @param value The value to set.
+     */
+    void SetUniform(UniformHandle<float> uniform, float value) const;
+    void SetUniform(UniformHandle<int> uniform, int value) const;
+    void SetUniform(UniformHandle<glm::vec2> uniform, const glm::vec2& value) const;
+    void SetUniform(UniformHandle<glm::ivec2> uniform, const glm::ivec2& value) const;
+    void SetUniform(UniformHandle<glm::vec3> uniform, const glm::vec3& value) const;
+    void SetUniform(UniformHandle<glm::ivec3> uniform, const glm::ivec3& value) const;
+    void SetUniform(UniformHandle<glm::vec4> uniform, const glm::vec4& value) const;
+    void SetUniform(UniformHandle<glm::ivec4> uniform, const glm::ivec4& value) const;
+    void SetUniform(UniformHandle<glm::mat3x4> uniform, const glm::mat3x4& value) const;
+    void SetUniform(UniformHandle<glm::mat4x4> uniform, const glm::mat4x4& value) const;
+
+    /**
+     * @brief Assigns a uniform block of the program to a buffer binding point.
+     * Does nothing if the program doesn't contain an active block with the given name.
+     * @param blockName The uniform block name.
+     * @param bindingPoint The binding point the block will read its data from.
+     */
+    void BindUniformBlock(const char* blockName, GLuint bindingPoint) const;
+
     /**
      * @brief Sets a single float uniform.
      * The program must be bound before calling this method!
@@ -194,7 +281,40 @@ private:
      */
     auto CompileShader(const std::string& source, GLenum type) -> GLuint;
 
+    /**
+     * @brief An active uniform of the linked program, together with the last value set.
+     */
+    struct Uniform {
+        GLint location{-1};                            //!< The uniform location.
+        bool valueSet{false};                          //!< true if value contains the current uniform value.
+        std::array<char, sizeof(glm::mat4x4)> value{}; //!< Raw bytes of the last value set.
+    };
+
+    /**
+     * @brief Queries all active uniforms of the linked program and fills the uniform table.
+     */
+    void ReadActiveUniforms();
+
+    /**
+     * @brief Returns the uniform table index for the given name.
+     * @param uniform The uniform name.
+     * @return The index in m_uniforms, or -1 if the uniform is not active.
+     */
+    auto FindUniform(const char* uniform) const -> int;
+
+    /**
+     * @brief Updates the cached uniform value.
+     * @param index The uniform table index.
+     * @param value A pointer to the raw value.
+     * @param size The size of the value in bytes.
+     * @return The uniform location if the value has changed, or -1 if no update is required.
+     */
+    auto UpdateCachedValue(int index, const void* value, size_t size) const -> GLint;
+
     GLuint m_shaderProgram{}; //!< The program ID.
+
+    std::map<std::string, int, std::less<>> m_uniformIndices; //!< Maps active uniform names to their index in m_uniforms. The transparent comparator allows lookups without a temporary string.
+    mutable std::vector<Uniform> m_uniforms;                  //!< Table of all active uniforms.
 };
 
 } // namespace Renderer
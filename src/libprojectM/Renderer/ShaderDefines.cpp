@@ -0,0 +1,64 @@
+#include "ShaderDefines.hpp"
+
+namespace libprojectM {
+namespace Renderer {
+
+void ShaderDefines::Set(const std::string& name, int value)
+{
+    m_defines[name] = value;
+}
+
+auto ShaderDefines::Empty() const -> bool
+{
+    return m_defines.empty();
+}
+
+auto ShaderDefines::Key(const std::string& baseKey) const -> std::string
+{
+    if (m_defines.empty())
+    {
+        return baseKey;
+    }
+
+    std::string key = baseKey + "[";
+    for (const auto& define : m_defines)
+    {
+        if (key.back() != '[')
+        {
+            key.append(",");
+        }
+        key.append(define.first + "=" + std::to_string(define.second));
+    }
+    key.append("]");
+
+    return key;
+}
+
+auto ShaderDefines::Apply(const std::string& source) const -> std::string
+{
+    std::string defines;
+    for (const auto& define : m_defines)
+    {
+        defines.append("#define " + define.first + " " + std::to_string(define.second) + "\n");
+    }
+
+    // The #version directive must stay the first statement in the shader.
+    size_t insertPosition{0};
+    if (source.compare(0, 8, "#version") == 0)
+    {
+        insertPosition = source.find('\n');
+        if (insertPosition == std::string::npos)
+        {
+            return source + "\n" + defines;
+        }
+        insertPosition++;
+    }
+
+    std::string result = source;
+    result.insert(insertPosition, defines);
+
+    return result;
+}
+
+} // namespace Renderer
+} // namespace libprojectM
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <map>
+#include <string>
+
+namespace libprojectM {
+namespace Renderer {
+
+/**
+ * @brief A set of preprocessor definitions used to compile a specialized shader program variant.
+ *
+ * Values which don't change while a preset is running, like mode switches and effect flags, are
+ * compiled into the program as constants instead of being passed as uniforms. This allows the
+ * shader compiler to remove all branches which are never taken.
+ *
+ * Each combination of values results in a separate program, which is stored in the ShaderCache
+ * under the key returned by Key(), so presets using the same values share the compiled variant.
+ */
+class ShaderDefines
+{
+public:
+    /**
+     * @brief Adds or replaces a definition.
+     * @param name The macro name, e.g. "WAVE_MODE".
+     * @param value The integer value of the macro.
+     */
+    void Set(const std::string& name, int value);
+
+    /**
+     * @brief Returns whether the set contains any definitions.
+     * @return true if no definitions were set, false otherwise.
+     */
+    auto Empty() const -> bool;
+
+    /**
+     * @brief Returns a unique shader cache key for the given base shader and this set of definitions.
+     * @param baseKey The cache key of the unspecialized shader, e.g. "milkdrop_waveform".
+     * @return The cache key of the shader variant, e.g. "milkdrop_waveform[USE_SPECTRUM=0,WAVE_MODE=6]".
+     */
+    auto Key(const std::string& baseKey) const -> std::string;
+
+    /**
+     * @brief Inserts the definitions into the given shader source.
+     * The definitions are inserted after the #version directive if the source starts with one.
+     * @param source The shader source code.
+     * @return The shader source code with the definitions.
+     */
+    auto Apply(const std::string& source) const -> std::string;
+
+private:
+    std::map<std::string, int> m_defines; //!< The definitions, sorted by name to create a stable key.
+};
+
+} // namespace Renderer
+} // namespace libprojectM
@@ -0,0 +1,271 @@
+#include "Renderer/StreamingBuffer.hpp"
+
+#include "Renderer/GLExtensions.hpp"
+#include "Renderer/Platform/DynamicLibrary.hpp"
+#include "Renderer/Platform/GLResolver.hpp"
+
+#include <Logging.hpp>
+
+#include <cassert>
+#include <cstring>
+
+namespace libprojectM {
+namespace Renderer {
+
+constexpr size_t StreamingBuffer::FramesInFlight;
+constexpr size_t StreamingBuffer::InitialSize;
+constexpr size_t StreamingBuffer::RegionAlignment;
+
+namespace {
+
+// Not part of the GL 3.3 and GLES 3.2 headers, values are identical for the ARB and EXT extensions.
+constexpr GLbitfield MapPersistentBit = 0x0040;
+constexpr GLbitfield MapCoherentBit = 0x0080;
+
+constexpr GLuint64 FenceTimeout = 1000000000; //!< Nanoseconds to wait per glClientWaitSync() call.
+
+thread_local StreamingBuffer* currentBuffer{nullptr}; //!< The buffer made current on this thread.
+
+/**
+ * @brief Returns the buffer storage entry point if the current context supports it.
+ * @tparam Fn The function pointer type.
+ * @return The function pointer, or nullptr if buffer storage isn't available.
+ */
+template<typename Fn>
+auto ResolveBufferStorage() -> Fn
+{
+#ifdef __EMSCRIPTEN__
+    return nullptr;
+#else
+#ifdef USE_GLES
+    if (!HasExtension("GL_EXT_buffer_storage"))
+    {
+        return nullptr;
+    }
+
+    return Platform::SymbolToFunction<Fn>(Platform::GLResolver::Instance().GetProcAddress("glBufferStorageEXT"));
+#else
+    GLint majorVersion{};
+    GLint minorVersion{};
+    glGetIntegerv(GL_MAJOR_VERSION, &majorVersion);
+    glGetIntegerv(GL_MINOR_VERSION, &minorVersion);
+
+    if (majorVersion * 10 + minorVersion < 44 && !HasExtension("GL_ARB_buffer_storage"))
+    {
+        return nullptr;
+    }
+
+    return Platform::SymbolToFunction<Fn>(Platform::GLResolver::Instance().GetProcAddress("glBufferStorage"));
+#endif
+#endif
+}
+
+} // namespace
+
+StreamingBuffer::StreamingBuffer()
+    : m_bufferStorage(ResolveBufferStorage<BufferStorageFn>())
+    , m_size(InitialSize)
+{
+    CreateBuffer();
+
+    if (m_bufferStorage == nullptr)
+    {
+        LOG_INFO("[StreamingBuffer] Buffer storage not available, using unsynchronized buffer mapping.");
+    }
+}
+
+StreamingBuffer::~StreamingBuffer()
+{
+    if (currentBuffer == this)
+    {
+        currentBuffer = nullptr;
+    }
+
+    DeleteBuffer();
+}
+
+auto StreamingBuffer::Current() -> StreamingBuffer*
+{
+    return currentBuffer;
+}
+
+void StreamingBuffer::MakeCurrent()
+{
+    currentBuffer = this;
+}
+
+auto StreamingBuffer::Persistent() const -> bool
+{
+    return m_mapping != nullptr;
+}
+
+auto StreamingBuffer::Allocate(size_t size) -> Allocation
+{
+    assert(m_pendingSize == 0);
+
+    m_offset = (m_offset + RegionAlignment - 1) / RegionAlignment * RegionAlignment;
+
+    if (m_offset + size > m_size)
+    {
+        if (Persistent())
+        {
+            // The frame doesn't fit into its segment. Draw calls issued before keep using the old buffer object.
+            do
+            {
+                m_size *= 2;
+            } while (m_size < size);
+
+            DeleteBuffer();
+            CreateBuffer();
+        }
+        else
+        {
+            while (m_size < size)
+            {
+                m_size *= 2;
+            }
+
+            // Orphan the old storage, so writes won't have to wait for pending draws.
+            glBindBuffer(GL_ARRAY_BUFFER, m_bufferID);
+            glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(m_size), nullptr, GL_STREAM_DRAW);
+        }
+
+        m_offset = 0;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_bufferID);
+
+    Allocation allocation;
+    if (Persistent())
+    {
+        if (m_offset == 0)
+        {
+            WaitForSegment();
+        }
+
+        allocation.offset = static_cast<GLintptr>(m_segment * m_size + m_offset);
+        allocation.data = m_mapping + allocation.offset;
+    }
+    else
+    {
+        allocation.offset = static_cast<GLintptr>(m_offset);
+        m_pendingOffset = allocation.offset;
+        m_pendingSize = size;
+
+#ifndef __EMSCRIPTEN__
+        // No draw call since the last orphaning can use this region, so there's nothing to wait for.
+        allocation.data = glMapBufferRange(GL_ARRAY_BUFFER, allocation.offset, static_cast<GLsizeiptr>(size),
+                                           GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+#endif
+        m_pendingMapped = allocation.data != nullptr;
+        if (!m_pendingMapped)
+        {
+            m_staging.resize(size);
+            allocation.data = m_staging.data();
+        }
+    }
+
+    m_offset += size;
+
+    return allocation;
+}
+
+void StreamingBuffer::Commit()
+{
+    if (m_pendingSize == 0)
+    {
+        return;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_bufferID);
+
+    if (m_pendingMapped)
+    {
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+    else
+    {
+        glBufferSubData(GL_ARRAY_BUFFER, m_pendingOffset, static_cast<GLsizeiptr>(m_pendingSize), m_staging.data());
+    }
+
+    m_pendingSize = 0;
+}
+
+void StreamingBuffer::EndFrame()
+{
+    if (!Persistent() || m_offset == 0)
+    {
+        return;
+    }
+
+    m_fences.at(m_segment) = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_segment = (m_segment + 1) % FramesInFlight;
+    m_offset = 0;
+}
+
+void StreamingBuffer::CreateBuffer()
+{
+    glGenBuffers(1, &m_bufferID);
+    glBindBuffer(GL_ARRAY_BUFFER, m_bufferID);
+
+    if (m_bufferStorage != nullptr)
+    {
+        GLbitfield const flags = GL_MAP_WRITE_BIT | MapPersistentBit | MapCoherentBit;
+        auto const bufferSize = static_cast<GLsizeiptr>(m_size * FramesInFlight);
+
+        m_bufferStorage(GL_ARRAY_BUFFER, bufferSize, nullptr, flags);
+        m_mapping = static_cast<uint8_t*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, bufferSize, flags));
+        if (m_mapping != nullptr)
+        {
+            m_segment = 0;
+            return;
+        }
+
+        // Storage is immutable, so a new buffer object is needed for the fallback.
+        LOG_WARN("[StreamingBuffer] Persistent buffer mapping failed, using unsynchronized buffer mapping.");
+        m_bufferStorage = nullptr;
+        glDeleteBuffers(1, &m_bufferID);
+        glGenBuffers(1, &m_bufferID);
+        glBindBuffer(GL_ARRAY_BUFFER, m_bufferID);
+    }
+
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(m_size), nullptr, GL_STREAM_DRAW);
+}
+
+void StreamingBuffer::DeleteBuffer()
+{
+    for (auto& fence : m_fences)
+    {
+        if (fence != nullptr)
+        {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+
+    // Deleting the buffer also unmaps it.
+    glDeleteBuffers(1, &m_bufferID);
+    m_bufferID = 0;
+    m_mapping = nullptr;
+}
+
+void StreamingBuffer::WaitForSegment()
+{
+    auto& fence = m_fences.at(m_segment);
+    if (fence == nullptr)
+    {
+        return;
+    }
+
+    GLenum result{GL_TIMEOUT_EXPIRED};
+    while (result == GL_TIMEOUT_EXPIRED)
+    {
+        result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FenceTimeout);
+    }
+
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+} // namespace Renderer
+} // namespace libprojectM
@@ -0,0 +1,148 @@
+/**
+ * @file StreamingBuffer.hpp
+ * @brief A ring buffer for vertex data which is rewritten every frame.
+ */
+#pragma once
+
+#include "Renderer/OpenGL.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace libprojectM {
+namespace Renderer {
+
+/**
+ * @brief A single vertex buffer ring shared by all geometry which is rewritten every frame.
+ *
+ * Instead of each mesh re-specifying its own buffer objects, per-frame vertex data is written
+ * into consecutive regions of one large buffer. Each Allocate() call returns a CPU pointer to
+ * a fresh region and its byte offset in the buffer, which is then used as the attribute pointer
+ * offset when setting up the vertex array.
+ *
+ * Depending on the OpenGL implementation, one of two strategies is used:
+ * - If buffer storage is available (OpenGL 4.4, GL_ARB_buffer_storage or GL_EXT_buffer_storage),
+ *   the buffer is mapped once, persistently. It is split into one segment per frame in flight,
+ *   and a fence is inserted at the end of each frame. Before a segment is reused, its fence is
+ *   waited on. No OpenGL calls are made to upload the data.
+ * - Otherwise, regions are mapped with GL_MAP_UNSYNCHRONIZED_BIT, as they are never reused
+ *   before the buffer wraps around. On wrap-around, the buffer storage is orphaned. On WebGL,
+ *   which can't map buffers, data is staged in memory and uploaded with glBufferSubData().
+ *   Without persistent mapping, draw calls can't source a buffer while it's mapped, so each
+ *   region is mapped and unmapped separately. Batching all uploads of a frame into a single
+ *   mapping would require recording all geometry before the first draw call.
+ *
+ * If the data of a frame exceeds a persistent segment, or a single region exceeds the whole
+ * buffer, the buffer is reallocated with twice the size.
+ *
+ * Regions are only valid until the end of the frame they were allocated in, so geometry must
+ * be re-uploaded in each frame it's drawn in. Geometry which rarely changes should use its own
+ * static or dynamic buffer objects instead.
+ *
+ * Like the GLStateCache, each projectM instance owns one buffer and makes it current for the
+ * calling thread before rendering.
+ */
+class StreamingBuffer
+{
+public:
+    /**
+     * @brief A region of the buffer to be written by the caller.
+     */
+    struct Allocation {
+        void* data{};      //!< The pointer to write the vertex data to.
+        GLintptr offset{}; //!< The byte offset of the region in the buffer object.
+    };
+
+    /**
+     * Constructor. Checks for buffer storage support and creates the buffer.
+     */
+    StreamingBuffer();
+
+    /**
+     * Destructor. Deletes the buffer and all pending fences.
+     */
+    ~StreamingBuffer();
+
+    StreamingBuffer(const StreamingBuffer&) = delete;
+    auto operator=(const StreamingBuffer&) -> StreamingBuffer& = delete;
+
+    /**
+     * @brief Returns the streaming buffer current on the calling thread.
+     * @return The current streaming buffer, or nullptr if none was made current.
+     */
+    static auto Current() -> StreamingBuffer*;
+
+    /**
+     * @brief Makes this buffer current for the calling thread.
+     */
+    void MakeCurrent();
+
+    /**
+     * @brief Returns whether the buffer is persistently mapped.
+     * @return true if buffer storage is used, false if regions are mapped individually.
+     */
+    auto Persistent() const -> bool;
+
+    /**
+     * @brief Reserves a region of the buffer for vertex data.
+     * The caller must write exactly size bytes to the returned pointer, then call Commit()
+     * before allocating the next region.
+     * @note This method binds the buffer to GL_ARRAY_BUFFER and leaves it bound.
+     * @param size The size of the region in bytes.
+     * @return The allocated region.
+     */
+    auto Allocate(size_t size) -> Allocation;
+
+    /**
+     * @brief Finishes writing the last allocated region, making the data available to draw calls.
+     * @note This method binds the buffer to GL_ARRAY_BUFFER and leaves it bound.
+     */
+    void Commit();
+
+    /**
+     * @brief Ends the current frame.
+     * All regions allocated in this frame are invalid afterwards.
+     */
+    void EndFrame();
+
+private:
+    static constexpr size_t FramesInFlight = 3;        //!< Number of persistent segments, one per frame.
+    static constexpr size_t InitialSize = 1024 * 1024; //!< Initial segment or buffer size in bytes.
+    static constexpr size_t RegionAlignment = 16;      //!< Byte alignment of each region.
+
+    /**
+     * @brief Creates the buffer object with the current size.
+     */
+    void CreateBuffer();
+
+    /**
+     * @brief Deletes the buffer object and all pending fences.
+     */
+    void DeleteBuffer();
+
+    /**
+     * @brief Waits until the GPU has finished reading the current segment.
+     */
+    void WaitForSegment();
+
+    using BufferStorageFn = void (GLAD_API_PTR*)(GLenum, GLsizeiptr, const void*, GLbitfield);
+
+    BufferStorageFn m_bufferStorage{}; //!< glBufferStorage() or glBufferStorageEXT(), if available.
+
+    GLuint m_bufferID{};                           //!< The ID of the OpenGL buffer object.
+    size_t m_size{};                               //!< Size of a single segment, or the whole buffer if not persistent.
+    size_t m_offset{};                             //!< Next free byte in the current segment or buffer.
+    uint8_t* m_mapping{};                          //!< Persistent mapping of the whole buffer.
+    size_t m_segment{};                            //!< Index of the segment used in the current frame.
+    std::array<GLsync, FramesInFlight> m_fences{}; //!< Fences of the last frames which used each segment.
+
+    GLintptr m_pendingOffset{};     //!< Byte offset of the region allocated last.
+    size_t m_pendingSize{};         //!< Size of the region allocated last, 0 if committed.
+    bool m_pendingMapped{false};    //!< True if the pending region is mapped, false if staged.
+    std::vector<uint8_t> m_staging; //!< Staging memory if the buffer can't be mapped.
+};
+
+} // namespace Renderer
+} // namespace libprojectM
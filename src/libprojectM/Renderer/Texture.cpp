@@ -1,5 +1,7 @@
 #include "Renderer/Texture.hpp"
 
+#include "Renderer/GLStateCache.hpp"
+
 #include <utility>
 
 namespace libprojectM {
@@ -64,6 +66,7 @@ Texture::~Texture()
 {
     if (m_textureId > 0 && m_owned)
     {
+        GLStateCache::Current().TextureDeleted(m_textureId);
         glDeleteTextures(1, &m_textureId);
         m_textureId = 0;
     }
@@ -71,8 +74,7 @@ Texture::~Texture()
 
 void Texture::Bind(GLint slot, const Sampler::Ptr& sampler) const
 {
-    glActiveTexture(GL_TEXTURE0 + slot);
-    glBindTexture(m_target, m_textureId);
+    GLStateCache::Current().BindTexture(slot, m_target, m_textureId);
 
     if (sampler)
     {
@@ -82,8 +84,7 @@ void Texture::Bind(GLint slot, const Sampler::Ptr& sampler) const
 
 void Texture::Unbind(GLint slot) const
 {
-    glActiveTexture(GL_TEXTURE0 + slot);
-    glBindTexture(m_target, 0);
+    GLStateCache::Current().BindTexture(slot, m_target, 0);
 }
 
 auto Texture::TextureID() const -> GLuint
@@ -126,9 +127,14 @@ auto Texture::Empty() const -> bool
     return m_textureId == 0;
 }
 
+auto Texture::Format() const -> TextureFormat
+{
+    return {m_internalFormat, m_format, m_type};
+}
+
 void Texture::Update(const void* data) const
 {
-    glBindTexture(m_target, m_textureId);
+    GLStateCache::Current().BindTexture(m_target, m_textureId);
     switch (m_target)
     {
         case GL_TEXTURE_2D:
@@ -141,13 +147,13 @@ void Texture::Update(const void* data) const
             // Unsupported, do nothing.
             break;
     }
-    glBindTexture(m_target, 0);
+    GLStateCache::Current().BindTexture(m_target, 0);
 }
 
 void Texture::CreateNewTexture()
 {
     glGenTextures(1, &m_textureId);
-    glBindTexture(m_target, m_textureId);
+    GLStateCache::Current().BindTexture(m_target, m_textureId);
     switch (m_target)
     {
         case GL_TEXTURE_2D:
@@ -160,7 +166,7 @@ void Texture::CreateNewTexture()
             // Unsupported, do nothing.
             break;
     }
-    glBindTexture(m_target, 0);
+    GLStateCache::Current().BindTexture(m_target, 0);
 }
 
 } // namespace Renderer
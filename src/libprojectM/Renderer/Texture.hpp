@@ -5,6 +5,7 @@
 #pragma once
 
 #include "Renderer/Sampler.hpp"
+#include "Renderer/TextureFormat.hpp"
 
 #include <string>
 
@@ -149,6 +150,13 @@ public:
      */
     auto Empty() const -> bool;
 
+    /**
+     * @brief Returns the format the texture was allocated with.
+     * Only known for textures allocated by this class, otherwise all values are zero.
+     * @return The texture format.
+     */
+    auto Format() const -> TextureFormat;
+
     /**
      * @brief Uploads new image data for the texture.
      * @note Automatically binds and unbinds the texture.
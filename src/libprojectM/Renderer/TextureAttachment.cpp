@@ -1,5 +1,7 @@
 #include "Renderer/TextureAttachment.hpp"
 
+#include "Renderer/GLStateCache.hpp"
+
 // OpenGL ES might not define this constant in its headers, e.g. in the iOS and Emscripten SDKs.
 #ifndef GL_STENCIL_INDEX
 #define GL_STENCIL_INDEX 0x1901
@@ -29,6 +31,28 @@ TextureAttachment::TextureAttachment(GLint internalFormat, GLenum format, GLenum
     }
 }
 
+TextureAttachment::TextureAttachment(TexturePool& texturePool, TexturePool::Usage usage, const TextureFormat& format, int width, int height)
+    : m_attachmentType(AttachmentType::Color)
+    , m_internalFormat(format.internalFormat)
+    , m_format(format.format)
+    , m_type(format.type)
+    , m_texturePool(&texturePool)
+    , m_textureUsage(usage)
+{
+    if (width > 0 && height > 0)
+    {
+        ReplaceTexture(width, height);
+    }
+}
+
+TextureAttachment::~TextureAttachment()
+{
+    if (m_texturePool != nullptr)
+    {
+        m_texturePool->Release(m_texture);
+    }
+}
+
 auto TextureAttachment::Type() const -> TextureAttachment::AttachmentType
 {
     return m_attachmentType;
@@ -52,10 +76,36 @@ void TextureAttachment::SetSize(int width, int height)
     }
     else
     {
-        m_texture = std::make_unique<class Texture>();
+        ReleaseTexture();
     }
 }
 
+auto TextureAttachment::SetFormat(const TextureFormat& format) -> bool
+{
+    if (m_attachmentType != AttachmentType::Color ||
+        (format.internalFormat == m_internalFormat && format.format == m_format && format.type == m_type))
+    {
+        return false;
+    }
+
+    m_internalFormat = format.internalFormat;
+    m_format = format.format;
+    m_type = format.type;
+
+    if (m_texture->Empty())
+    {
+        // Will be allocated in the new format on the next resize.
+        return false;
+    }
+
+    int const width = m_texture->Width();
+    int const height = m_texture->Height();
+    ReleaseTexture();
+    ReplaceTexture(width, height);
+
+    return true;
+}
+
 void TextureAttachment::ReplaceTexture(int width, int height)
 {
     GLint internalFormat;
@@ -104,11 +154,18 @@ void TextureAttachment::ReplaceTexture(int width, int height)
             return;
     }
 
+    if (m_texturePool != nullptr)
+    {
+        ReleaseTexture();
+        m_texture = m_texturePool->Acquire(width, height, {internalFormat, static_cast<GLenum>(textureFormat), pixelFormat}, m_textureUsage);
+        return;
+    }
+
     m_texture.reset();
 
     GLuint textureId;
     glGenTextures(1, &textureId);
-    glBindTexture(GL_TEXTURE_2D, textureId);
+    GLStateCache::Current().BindTexture(GL_TEXTURE_2D, textureId);
     glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, textureFormat, pixelFormat, nullptr);
 
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -116,10 +173,20 @@ void TextureAttachment::ReplaceTexture(int width, int height)
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
-    glBindTexture(GL_TEXTURE_2D, 0);
+    GLStateCache::Current().BindTexture(GL_TEXTURE_2D, 0);
 
     m_texture = std::make_shared<class Texture>("", textureId, GL_TEXTURE_2D, width, height, false);
 }
 
+void TextureAttachment::ReleaseTexture()
+{
+    if (m_texturePool != nullptr)
+    {
+        m_texturePool->Release(m_texture);
+    }
+
+    m_texture = std::make_shared<class Texture>();
+}
+
 } // namespace Renderer
 } // namespace libprojectM
@@ -5,6 +5,8 @@
 #pragma once
 
 #include "Renderer/Texture.hpp"
+#include "Renderer/TextureFormat.hpp"
+#include "Renderer/TexturePool.hpp"
 
 #include <memory>
 
@@ -22,7 +24,7 @@ public:
      */
     enum class AttachmentType
     {
-        Color,       //!< Color texture attachment. Uses GL_RGBA format.
+        Color,       //!< Color texture attachment. Uses GL_RGBA format unless created with or set to a different format.
         Depth,       //!< Depth buffer attachment. Uses GL_DEPTH_COMPONENT with GL_FLOAT pixel format.
         Stencil,     //!< Stencil buffer attachment. Uses GL_STENCIL_INDEX with GL_UNSIGNED_BYTE pixel format.
         DepthStencil //!< Depth stencil buffer attachment. Uses GL_DEPTH_STENCIL with GL_UNSIGNED_INT_24_8 pixel format.
@@ -51,10 +53,22 @@ public:
      */
     explicit TextureAttachment(GLint internalFormat, GLenum format, GLenum type, int width, int height);
 
-    TextureAttachment(TextureAttachment&& other) = default;
-    auto operator=(TextureAttachment&& other) -> TextureAttachment& = default;
+    /**
+     * @brief Creates a new 2D color texture attachment which leases its texture from a pool.
+     * The texture is returned to the pool when it's replaced or the attachment is destroyed, so the
+     * pool must outlive the attachment. The texture contents are undefined after each allocation.
+     * @param texturePool The pool to lease the texture from.
+     * @param usage What the texture is used for.
+     * @param format The texture format.
+     * @param width The width of the texture in pixels.
+     * @param height The height of the texture in pixels.
+     */
+    explicit TextureAttachment(TexturePool& texturePool, TexturePool::Usage usage, const TextureFormat& format, int width, int height);
+
+    TextureAttachment(TextureAttachment&& other) = delete;
+    auto operator=(TextureAttachment&& other) -> TextureAttachment& = delete;
 
-    ~TextureAttachment() = default;
+    ~TextureAttachment();
 
     /**
      * @brief Returns the attachment type.
@@ -83,6 +97,15 @@ public:
      */
     void SetSize(int width, int height);
 
+    /**
+     * @brief Changes the format of a color attachment.
+     * If the texture is already allocated and the format differs, the texture is reallocated with
+     * the same size. The new texture contents are undefined. Ignored for non-color attachments.
+     * @param format The new texture format.
+     * @return true if the texture was reallocated, false if it wasn't changed.
+     */
+    auto SetFormat(const TextureFormat& format) -> bool;
+
 private:
     /**
      * @brief Replaces the current texture with a new one, e.g. if the framebuffer was resized.
@@ -91,12 +114,20 @@ private:
      */
     void ReplaceTexture(int width, int height);
 
+    /**
+     * @brief Returns a leased texture to the pool and sets an empty texture.
+     */
+    void ReleaseTexture();
+
     AttachmentType m_attachmentType{AttachmentType::Color};                      //!< Attachment type of this texture.
     std::shared_ptr<class Texture> m_texture{std::make_shared<class Texture>()}; //!< The texture.
 
     GLint m_internalFormat{}; //!< OpenGL internal format, e.g. GL_RGBA8
     GLenum m_format{};        //!< OpenGL color format, e.g. GL_RGBA
     GLenum m_type{};          //!< OpenGL component storage type, e.g. GL_UNSIGNED _BYTE
+
+    TexturePool* m_texturePool{};                                     //!< Pool to lease the texture from, or nullptr if the texture is owned.
+    TexturePool::Usage m_textureUsage{TexturePool::Usage::Transient}; //!< Usage key of the leased texture.
 };
 
 } // namespace Renderer
@@ -0,0 +1,89 @@
+#include "Renderer/TextureFormat.hpp"
+
+#include "Renderer/GLExtensions.hpp"
+
+namespace libprojectM {
+namespace Renderer {
+
+auto TextureFormat::FromRenderFormat(RenderFormat renderFormat) -> TextureFormat
+{
+    // The format/type pairs are the ones OpenGL ES 3 accepts for each sized internal format.
+    switch (renderFormat)
+    {
+        case RenderFormat::RGB10A2:
+            return {GL_RGB10_A2, GL_RGBA, GL_UNSIGNED_INT_2_10_10_10_REV};
+
+        case RenderFormat::R11G11B10F:
+            return {GL_R11F_G11F_B10F, GL_RGB, GL_UNSIGNED_INT_10F_11F_11F_REV};
+
+        case RenderFormat::RGBA16F:
+            return {GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT};
+
+        case RenderFormat::RGBA8:
+        default:
+            return {GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE};
+    }
+}
+
+auto TextureFormat::IsRenderable(RenderFormat renderFormat) -> bool
+{
+#ifdef USE_GLES
+    if (renderFormat != RenderFormat::R11G11B10F && renderFormat != RenderFormat::RGBA16F)
+    {
+        return true;
+    }
+
+    // Floating-point color buffers are core since OpenGL ES 3.2.
+    GLint majorVersion{};
+    GLint minorVersion{};
+    glGetIntegerv(GL_MAJOR_VERSION, &majorVersion);
+    glGetIntegerv(GL_MINOR_VERSION, &minorVersion);
+    if (majorVersion * 10 + minorVersion >= 32 || HasExtension("GL_EXT_color_buffer_float"))
+    {
+        return true;
+    }
+
+    return renderFormat == RenderFormat::RGBA16F && HasExtension("GL_EXT_color_buffer_half_float");
+#else
+    static_cast<void>(renderFormat);
+    return true;
+#endif
+}
+
+auto TextureFormat::BytesPerPixel() const -> uint32_t
+{
+    switch (internalFormat)
+    {
+        case GL_RGBA16F:
+            return 8;
+
+        case GL_RGB:
+        case GL_RGB8:
+            return 3;
+
+        case GL_R8:
+            return 1;
+
+        case GL_RG8:
+            return 2;
+
+        default:
+            // All other formats used for render targets have 32 bits per pixel.
+            return 4;
+    }
+}
+
+auto TextureFormat::operator==(const TextureFormat& other) const -> bool
+{
+    return internalFormat == other.internalFormat &&
+           format == other.format &&
+           type == other.type;
+}
+
+auto TextureFormat::operator!=(const TextureFormat& other) const -> bool
+{
+    return !(*this == other);
+}
+
+} // namespace Renderer
+} // namespace libprojectM
@@ -0,0 +1,51 @@
+/**
+ * @file TextureFormat.hpp
+ * @brief OpenGL texture format triple for allocating render targets.
+ */
+#pragma once
+
+#include "Renderer/OpenGL.h"
+#include "Renderer/RenderFormat.hpp"
+
+#include <cstdint>
+
+namespace libprojectM {
+namespace Renderer {
+
+/**
+ * @brief The OpenGL format parameters used to allocate a texture with glTexImage2D().
+ */
+struct TextureFormat {
+    GLint internalFormat{GL_RGBA8}; //!< OpenGL internal format, e.g. GL_RGBA8
+    GLenum format{GL_RGBA};         //!< OpenGL color format, e.g. GL_RGBA
+    GLenum type{GL_UNSIGNED_BYTE};  //!< OpenGL component storage type, e.g. GL_UNSIGNED_BYTE
+
+    /**
+     * @brief Returns the texture format used to allocate render targets with the given color format.
+     * @param renderFormat The render target color format.
+     * @return The OpenGL format parameters. Unknown values return the RGBA8 format.
+     */
+    static auto FromRenderFormat(RenderFormat renderFormat) -> TextureFormat;
+
+    /**
+     * @brief Returns whether the current context can render into textures with the given color format.
+     * OpenGL 3.3 supports all formats. OpenGL ES 3.0 and 3.1 require GL_EXT_color_buffer_float for
+     * the floating-point formats, or GL_EXT_color_buffer_half_float for RGBA16F only.
+     * @param renderFormat The render target color format.
+     * @return true if the format can be used as a framebuffer color attachment, false if not.
+     */
+    static auto IsRenderable(RenderFormat renderFormat) -> bool;
+
+    /**
+     * @brief Returns the estimated memory used per pixel.
+     * Drivers may pad some formats, e.g. 3-component 8-bit formats, so the actual size can be larger.
+     * @return The size of a pixel in bytes.
+     */
+    auto BytesPerPixel() const -> uint32_t;
+
+    auto operator==(const TextureFormat& other) const -> bool;
+    auto operator!=(const TextureFormat& other) const -> bool;
+};
+
+} // namespace Renderer
+} // namespace libprojectM
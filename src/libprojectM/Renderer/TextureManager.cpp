@@ -1,17 +1,21 @@
 #include "Renderer/TextureManager.hpp"
 
 #include "Renderer/FileScanner.hpp"
+#include "Renderer/FileSource.hpp"
+#include "Renderer/GLStateCache.hpp"
 #include "Renderer/IdleTextures.hpp"
 #include "Renderer/MilkdropNoise.hpp"
 #include "Renderer/Texture.hpp"
 
 #include <Logging.hpp>
+#include <Tracing.hpp>
 #include <Utils.hpp>
 
 #include <stb_image.h>
 
 #include <algorithm>
 #include <cstdlib>
+#include <limits>
 #include <memory>
 #include <random>
 #include <vector>
@@ -181,6 +185,9 @@ auto TextureManager::TryLoadingTexture(const std::string& name) -> TextureSample
         TextureLoadData loadData;
         m_textureLoadCallback(unqualifiedName, loadData);
 
+        // The application may have changed OpenGL state in the callback.
+        GLStateCache::Current().Invalidate();
+
         // Check if callback provided an existing OpenGL texture ID
         if (loadData.textureId != 0 && loadData.width > 0 && loadData.height > 0)
         {
@@ -252,6 +259,8 @@ auto TextureManager::TryLoadingTexture(const std::string& name) -> TextureSample
 
 auto TextureManager::LoadTexture(const ScannedFile& file) -> std::shared_ptr<Texture>
 {
+    TRACE_SCOPE("TextureManager::LoadTexture");
+
     if (m_textures.find(file.lowerCaseBaseName) != m_textures.end())
     {
         return m_textures.at(file.lowerCaseBaseName);
@@ -260,7 +269,16 @@ auto TextureManager::LoadTexture(const ScannedFile& file) -> std::shared_ptr<Tex
     int width{};
     int height{};
 
-    std::unique_ptr<stbi_uc, decltype(&free)> imageData(stbi_load(file.filePath.c_str(), &width, &height, nullptr, 4), free);
+    // Read via FileSource, as the file may be located inside an archive.
+    std::vector<char> fileData;
+    if (!FileSource::Read(file.filePath, fileData) || fileData.size() > static_cast<size_t>(std::numeric_limits<int>::max()))
+    {
+        LOG_DEBUG("[TextureManager] Failed to read image file.");
+        return {};
+    }
+
+    std::unique_ptr<stbi_uc, decltype(&free)> imageData(stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(fileData.data()), static_cast<int>(fileData.size()), &width, &height, nullptr, 4), free);
+    fileData.clear();
 
     if (imageData.get() == nullptr)
     {
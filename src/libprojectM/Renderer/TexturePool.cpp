@@ -0,0 +1,149 @@
+#include "Renderer/TexturePool.hpp"
+
+#include "Renderer/GLStateCache.hpp"
+
+#include <algorithm>
+
+namespace libprojectM {
+namespace Renderer {
+
+constexpr uint32_t TexturePool::MaxUnusedFrames;
+
+auto TexturePool::Entry::Matches(int width, int height, const TextureFormat& format, Usage textureUsage) const -> bool
+{
+    return usage == textureUsage &&
+           texture->Width() == width &&
+           texture->Height() == height &&
+           texture->Format() == format;
+}
+
+auto TexturePool::Acquire(int width, int height, const TextureFormat& format, Usage usage) -> std::shared_ptr<Texture>
+{
+    // Prefer the most recently released texture, which is the most likely to still be in the GPU cache.
+    auto entry = std::find_if(m_released.rbegin(), m_released.rend(), [width, height, &format, usage](const Entry& released) {
+        return released.Matches(width, height, format, usage);
+    });
+
+    std::shared_ptr<Texture> texture;
+    if (entry == m_released.rend())
+    {
+        texture = std::make_shared<Texture>("", GL_TEXTURE_2D, width, height, 0,
+                                            format.internalFormat, format.format, format.type, false);
+
+        // Same parameters as framebuffer attachments, in case the texture is sampled without a sampler object.
+        GLStateCache::Current().BindTexture(GL_TEXTURE_2D, texture->TextureID());
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        GLStateCache::Current().BindTexture(GL_TEXTURE_2D, 0);
+
+        m_allocations++;
+    }
+    else
+    {
+        texture = std::move(entry->texture);
+        m_released.erase(std::next(entry).base());
+        m_reuses++;
+    }
+
+    m_leased.push_back({texture, usage, 0});
+
+    return texture;
+}
+
+void TexturePool::Release(const std::shared_ptr<Texture>& texture)
+{
+    if (!texture)
+    {
+        return;
+    }
+
+    auto entry = std::find_if(m_leased.begin(), m_leased.end(), [&texture](const Entry& leased) {
+        return leased.texture == texture;
+    });
+
+    if (entry == m_leased.end())
+    {
+        return;
+    }
+
+    m_released.push_back(std::move(*entry));
+    m_leased.erase(entry);
+}
+
+void TexturePool::EndFrame()
+{
+    // Keep as many spares of each persistent key as are leased, starting with the most recently released.
+    std::vector<bool> keep(m_released.size());
+    std::vector<const Entry*> unmatchedLeases;
+    for (const auto& leased : m_leased)
+    {
+        if (leased.usage != Usage::Transient)
+        {
+            unmatchedLeases.push_back(&leased);
+        }
+    }
+
+    for (size_t index = m_released.size(); index > 0; index--)
+    {
+        auto& released = m_released[index - 1];
+        released.unusedFrames++;
+
+        auto const leased = std::find_if(unmatchedLeases.begin(), unmatchedLeases.end(), [&released](const Entry* lease) {
+            return lease != nullptr &&
+                   released.Matches(lease->texture->Width(), lease->texture->Height(), lease->texture->Format(), lease->usage);
+        });
+
+        if (leased != unmatchedLeases.end())
+        {
+            *leased = nullptr;
+            keep[index - 1] = true;
+        }
+        else
+        {
+            keep[index - 1] = released.unusedFrames <= MaxUnusedFrames;
+        }
+    }
+
+    size_t index{};
+    m_released.erase(std::remove_if(m_released.begin(), m_released.end(), [&keep, &index](const Entry&) {
+                         return !keep[index++];
+                     }),
+                     m_released.end());
+}
+
+auto TexturePool::TextureCount() const -> size_t
+{
+    return m_leased.size() + m_released.size();
+}
+
+auto TexturePool::GetStatistics() const -> TexturePoolStatistics
+{
+    TexturePoolStatistics statistics;
+
+    statistics.leasedTextures = static_cast<uint32_t>(m_leased.size());
+    for (const auto& entry : m_leased)
+    {
+        statistics.leasedBytes += TextureBytes(*entry.texture);
+    }
+
+    statistics.releasedTextures = static_cast<uint32_t>(m_released.size());
+    for (const auto& entry : m_released)
+    {
+        statistics.releasedBytes += TextureBytes(*entry.texture);
+    }
+
+    statistics.allocations = m_allocations;
+    statistics.reuses = m_reuses;
+
+    return statistics;
+}
+
+auto TexturePool::TextureBytes(const Texture& texture) -> uint64_t
+{
+    return static_cast<uint64_t>(texture.Width()) * static_cast<uint64_t>(texture.Height()) * texture.Format().BytesPerPixel();
+}
+
+} // namespace Renderer
+} // namespace libprojectM
@@ -0,0 +1,138 @@
+/**
+ * @file TexturePool.hpp
+ * @brief Shares render target textures between render passes and presets.
+ */
+#pragma once
+
+#include "Renderer/Texture.hpp"
+#include "Renderer/TextureFormat.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace libprojectM {
+namespace Renderer {
+
+/**
+ * @brief Texture pool occupancy.
+ */
+struct TexturePoolStatistics {
+    uint32_t leasedTextures{};   //!< Number of textures currently leased.
+    uint64_t leasedBytes{};      //!< Estimated memory used by the leased textures.
+    uint32_t releasedTextures{}; //!< Number of returned textures kept for reuse.
+    uint64_t releasedBytes{};    //!< Estimated memory used by the returned textures.
+    uint64_t allocations{};      //!< Number of textures allocated since the pool was created.
+    uint64_t reuses{};           //!< Number of leases served with a returned texture since the pool was created.
+};
+
+/**
+ * @brief Shares render target textures between render passes and presets.
+ *
+ * Render passes and presets lease their render targets from the pool and return them when they
+ * no longer need them. Each returned texture is handed out again on the next request for the same
+ * size, format and usage. ProjectM owns a single pool, which is shared by all presets.
+ *
+ * Transient textures are only needed while rendering a part of a frame, e.g. the intermediate
+ * results of the blur passes. They are returned as soon as their contents were used, so passes
+ * with non-overlapping lifetimes alias the same texture memory.
+ *
+ * Persistent textures, e.g. the preset main images, are kept by a preset until it's destroyed or
+ * resized. Returned persistent textures are kept as spares as long as at least as many textures
+ * with the same key are still leased, so the next preset can take over the render targets of the
+ * current one instead of allocating new ones on each preset switch.
+ *
+ * Other returned textures which aren't requested again within a few frames, e.g. after a resize,
+ * are deleted in EndFrame().
+ */
+class TexturePool
+{
+public:
+    /**
+     * @brief What a texture is used for. Textures are only shared between leases of the same usage.
+     */
+    enum class Usage
+    {
+        Transient,     //!< Only used within a single frame, e.g. intermediate blur passes.
+        MainImage,     //!< Preset main images, kept across frames.
+        MotionVectors, //!< Preset motion vector u/v maps, kept across frames.
+        BlurLevel      //!< Preset blur levels, read by the preset shaders.
+    };
+
+    TexturePool() = default;
+
+    TexturePool(const TexturePool&) = delete;
+    auto operator=(const TexturePool&) -> TexturePool& = delete;
+
+    /**
+     * @brief Leases an unused texture with the given size, format and usage, allocating it if needed.
+     * The texture contents are undefined.
+     * @param width The texture width in pixels.
+     * @param height The texture height in pixels.
+     * @param format The texture format.
+     * @param usage What the texture is used for.
+     * @return A texture, exclusively used by the caller until it's released.
+     */
+    auto Acquire(int width, int height, const TextureFormat& format, Usage usage = Usage::Transient) -> std::shared_ptr<Texture>;
+
+    /**
+     * @brief Returns a leased texture to the pool, so it can be used by the next pass or preset.
+     * Textures not leased from this pool are ignored.
+     * @param texture A texture previously returned by Acquire().
+     */
+    void Release(const std::shared_ptr<Texture>& texture);
+
+    /**
+     * @brief Deletes returned textures which weren't acquired again for a few frames and aren't kept as spares.
+     */
+    void EndFrame();
+
+    /**
+     * @brief Returns the number of textures currently allocated by the pool.
+     * @return The number of leased and returned textures.
+     */
+    auto TextureCount() const -> size_t;
+
+    /**
+     * @brief Returns the current pool occupancy.
+     * @return The pool statistics.
+     */
+    auto GetStatistics() const -> TexturePoolStatistics;
+
+private:
+    static constexpr uint32_t MaxUnusedFrames = 30; //!< Frames after which a returned texture is deleted.
+
+    /**
+     * @brief A leased or returned texture.
+     */
+    struct Entry {
+        std::shared_ptr<Texture> texture; //!< The texture.
+        Usage usage{Usage::Transient};    //!< What the texture is used for.
+        uint32_t unusedFrames{};          //!< Number of frames ended since the texture was returned.
+
+        /**
+         * @brief Returns whether this entry's texture can be used for a lease with the given key.
+         * @param width The texture width in pixels.
+         * @param height The texture height in pixels.
+         * @param format The texture format.
+         * @param textureUsage What the texture is used for.
+         * @return true if size, format and usage match.
+         */
+        auto Matches(int width, int height, const TextureFormat& format, Usage textureUsage) const -> bool;
+    };
+
+    /**
+     * @brief Returns the estimated memory used by a texture.
+     * @param texture The texture.
+     * @return The texture size in bytes.
+     */
+    static auto TextureBytes(const Texture& texture) -> uint64_t;
+
+    std::vector<Entry> m_leased;   //!< Textures currently leased.
+    std::vector<Entry> m_released; //!< Textures available for reuse, most recently returned last.
+    uint64_t m_allocations{};      //!< Number of textures allocated since the pool was created.
+    uint64_t m_reuses{};           //!< Number of leases served with a returned texture.
+};
+
+} // namespace Renderer
+} // namespace libprojectM
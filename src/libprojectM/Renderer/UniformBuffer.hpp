@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Renderer/OpenGL.h"
+
+namespace libprojectM {
+namespace Renderer {
+
+/**
+ * @brief Wraps a uniform buffer object holding a single uniform block.
+ *
+ * The templated block type must exactly match the std140 layout of the uniform block declared
+ * in the shaders, e.g. by only using 16-byte aligned members like glm::vec4 and glm::mat3x4.
+ *
+ * Programs are connected to the buffer via a binding point, see Shader::BindUniformBlock(). As
+ * the binding point is shared, any number of programs can read from the same buffer without
+ * re-binding it.
+ *
+ * @tparam BT The uniform block storage type.
+ */
+template<class BT>
+class UniformBuffer
+{
+public:
+    /**
+     * Constructor. Creates the GPU buffer with storage for one block.
+     */
+    UniformBuffer();
+
+    /**
+     * Destructor. Deletes the GPU buffer.
+     */
+    ~UniformBuffer();
+
+    UniformBuffer(const UniformBuffer&) = delete;
+    auto operator=(const UniformBuffer&) -> UniformBuffer& = delete;
+
+    /**
+     * @brief Binds the buffer to the given uniform block binding point.
+     * @param bindingPoint The binding point index.
+     */
+    void Bind(GLuint bindingPoint) const;
+
+    /**
+     * @brief Uploads the block contents to the GPU.
+     * @note This method binds the buffer to the generic GL_UNIFORM_BUFFER target and leaves it bound.
+     * @param block The new block contents.
+     */
+    void Update(const BT& block);
+
+private:
+    GLuint m_uboID{}; //!< The ID of the OpenGL uniform buffer object.
+};
+
+template<class BT>
+UniformBuffer<BT>::UniformBuffer()
+{
+    glGenBuffers(1, &m_uboID);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_uboID);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(BT), nullptr, GL_DYNAMIC_DRAW);
+}
+
+template<class BT>
+UniformBuffer<BT>::~UniformBuffer()
+{
+    glDeleteBuffers(1, &m_uboID);
+}
+
+template<class BT>
+void UniformBuffer<BT>::Bind(GLuint bindingPoint) const
+{
+    glBindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, m_uboID);
+}
+
+template<class BT>
+void UniformBuffer<BT>::Update(const BT& block)
+{
+    glBindBuffer(GL_UNIFORM_BUFFER, m_uboID);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(BT), &block);
+}
+
+} // namespace Renderer
+} // namespace libprojectM
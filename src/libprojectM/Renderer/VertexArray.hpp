@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Renderer/GLStateCache.hpp"
 #include "Renderer/OpenGL.h"
 
 namespace libprojectM {
@@ -25,6 +26,7 @@ public:
      */
     virtual ~VertexArray()
     {
+        GLStateCache::Current().VertexArrayDeleted(m_vaoID);
         glDeleteVertexArrays(1, &m_vaoID);
         m_vaoID = 0;
     }
@@ -34,7 +36,7 @@ public:
      */
     void Bind() const
     {
-        glBindVertexArray(m_vaoID);
+        GLStateCache::Current().BindVertexArray(m_vaoID);
     }
 
     /**
@@ -42,7 +44,7 @@ public:
      */
     static void Unbind()
     {
-        glBindVertexArray(0);
+        GLStateCache::Current().BindVertexArray(0);
     }
 
 private:
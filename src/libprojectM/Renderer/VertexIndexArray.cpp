@@ -91,20 +91,22 @@ void VertexIndexArray::Update()
 {
     Bind();
 
-    if (m_indices.empty())
+    // Most meshes use the same indices in each frame, so only upload changed data.
+    if (m_indices.empty() || m_indices == m_uploadedIndices)
     {
         return;
     }
 
-    if (m_veabSize == m_indices.size())
+    if (m_uploadedIndices.size() == m_indices.size())
     {
         glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, static_cast<GLsizei>(sizeof(uint32_t) * m_indices.size()), m_indices.data());
     }
     else
     {
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizei>(sizeof(uint32_t) * m_indices.size()), m_indices.data(), VertexBufferUsageToGL(m_vboUsage));
-        m_veabSize = m_indices.size();
     }
+
+    m_uploadedIndices = m_indices;
 }
 
 auto VertexIndexArray::operator[](size_t index) -> uint32_t&
@@ -119,7 +119,7 @@ public:
     void MakeContinuous();
 
     /**
-     * Uploads the current index buffer contents to the GPU.
+     * Uploads the current index buffer contents to the GPU if they differ from the last upload.
      * @note this functions binds the index buffer object and leaves it bound.
      */
     void Update();
@@ -141,12 +141,12 @@ public:
     auto operator[](size_t index) const -> uint32_t;
 
 private:
-    GLuint m_veabID{};   //!< The ID of the OpenGL vertex element array buffer object.
-    size_t m_veabSize{}; //!< Stores the last number if items uploaded to the GPU.
+    GLuint m_veabID{}; //!< The ID of the OpenGL vertex element array buffer object.
 
     VertexBufferUsage m_vboUsage{VertexBufferUsage::StaticDraw}; //!< The buffer usage hint.
 
-    std::vector<uint32_t> m_indices; //!< The local copy of the vertex index buffer data.
+    std::vector<uint32_t> m_indices;         //!< The local copy of the vertex index buffer data.
+    std::vector<uint32_t> m_uploadedIndices; //!< The index data last uploaded to the GPU.
 };
 
 } // namespace Renderer
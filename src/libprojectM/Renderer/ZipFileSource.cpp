@@ -0,0 +1,296 @@
+#include "ZipFileSource.hpp"
+
+#include <stb_image.h>
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+namespace libprojectM {
+namespace Renderer {
+
+namespace {
+
+constexpr uint32_t EndOfCentralDirectorySignature{0x06054b50};
+constexpr uint32_t Zip64EndOfCentralDirectorySignature{0x06064b50};
+constexpr uint32_t Zip64EndOfCentralDirectoryLocatorSignature{0x07064b50};
+constexpr uint32_t CentralDirectoryHeaderSignature{0x02014b50};
+constexpr uint32_t LocalFileHeaderSignature{0x04034b50};
+
+constexpr size_t EndOfCentralDirectorySize{22};
+constexpr size_t Zip64EndOfCentralDirectorySize{56};
+constexpr size_t Zip64EndOfCentralDirectoryLocatorSize{20};
+constexpr size_t CentralDirectoryHeaderSize{46};
+constexpr size_t LocalFileHeaderSize{30};
+constexpr size_t MaxCommentLength{0xFFFF};
+
+constexpr uint16_t Zip64ExtraFieldId{0x0001};
+constexpr uint16_t EncryptedFlag{0x0001};
+
+constexpr uint16_t MethodStored{0};
+constexpr uint16_t MethodDeflate{8};
+
+constexpr uint64_t MaxEntrySize{64 * 1024 * 1024}; //!< Largest entry extracted. Presets and textures are far smaller.
+constexpr uint64_t MaxCompressionRatio{1032};     //!< Deflate can't compress better than about 1032:1.
+
+// Zip files are always little-endian, independent of the host byte order.
+auto ReadUInt16(const char* data) -> uint16_t
+{
+    auto const* bytes = reinterpret_cast<const unsigned char*>(data);
+    return static_cast<uint16_t>(bytes[0] | (bytes[1] << 8));
+}
+
+auto ReadUInt32(const char* data) -> uint32_t
+{
+    return static_cast<uint32_t>(ReadUInt16(data)) | (static_cast<uint32_t>(ReadUInt16(data + 2)) << 16);
+}
+
+auto ReadUInt64(const char* data) -> uint64_t
+{
+    return static_cast<uint64_t>(ReadUInt32(data)) | (static_cast<uint64_t>(ReadUInt32(data + 4)) << 32);
+}
+
+auto ReadAt(std::ifstream& file, uint64_t offset, char* data, size_t size) -> bool
+{
+    file.seekg(static_cast<std::streamoff>(offset), std::ios_base::beg);
+    return static_cast<bool>(file.read(data, static_cast<std::streamsize>(size)));
+}
+
+} // namespace
+
+ZipFileSource::ZipFileSource(std::string archiveFile)
+    : m_archiveFile(std::move(archiveFile))
+{
+    ReadCentralDirectory();
+}
+
+void ZipFileSource::ListFiles(bool recursive, const ListCallback& callback) const
+{
+    for (const auto& entry : m_entries)
+    {
+        if (!recursive && entry.name.find('/') != std::string::npos)
+        {
+            continue;
+        }
+
+        callback(m_archiveFile + "/" + entry.name);
+    }
+}
+
+auto ZipFileSource::ReadFile(const std::string& path, std::vector<char>& data) const -> bool
+{
+    if (path.length() <= m_archiveFile.length() + 1 ||
+        path.compare(0, m_archiveFile.length(), m_archiveFile) != 0 ||
+        (path.at(m_archiveFile.length()) != '/' && path.at(m_archiveFile.length()) != '\\'))
+    {
+        return false;
+    }
+
+    auto entryName = path.substr(m_archiveFile.length() + 1);
+    std::replace(entryName.begin(), entryName.end(), '\\', '/');
+    return ReadEntry(entryName, data);
+}
+
+auto ZipFileSource::ReadEntry(const std::string& entryName, std::vector<char>& data) const -> bool
+{
+    auto entry = std::lower_bound(m_entries.begin(), m_entries.end(), entryName,
+                                  [](const Entry& left, const std::string& right) {
+                                      return left.name < right;
+                                  });
+    if (entry == m_entries.end() || entry->name != entryName)
+    {
+        return false;
+    }
+
+    // Don't trust the sizes in the archive, a crafted entry could otherwise allocate gigabytes of memory.
+    if (entry->compressedSize > MaxEntrySize ||
+        entry->uncompressedSize > MaxEntrySize ||
+        entry->uncompressedSize > std::max<uint64_t>(entry->compressedSize, 1) * MaxCompressionRatio)
+    {
+        return false;
+    }
+
+    std::ifstream file(m_archiveFile, std::ios_base::in | std::ios_base::binary);
+    char localHeader[LocalFileHeaderSize];
+    if (!file.good() || !ReadAt(file, entry->localHeaderOffset, localHeader, LocalFileHeaderSize) ||
+        ReadUInt32(localHeader) != LocalFileHeaderSignature)
+    {
+        return false;
+    }
+
+    // Name and extra field lengths in the local header may differ from the central directory.
+    auto const dataOffset = entry->localHeaderOffset + LocalFileHeaderSize + ReadUInt16(localHeader + 26) + ReadUInt16(localHeader + 28);
+
+    std::vector<char> storedData(static_cast<size_t>(entry->compressedSize));
+    if (!storedData.empty() && !ReadAt(file, dataOffset, storedData.data(), storedData.size()))
+    {
+        return false;
+    }
+
+    if (entry->method == MethodStored)
+    {
+        if (entry->compressedSize != entry->uncompressedSize)
+        {
+            return false;
+        }
+        data = std::move(storedData);
+        return true;
+    }
+
+    data.resize(static_cast<size_t>(entry->uncompressedSize));
+    if (data.empty())
+    {
+        return true;
+    }
+
+    auto const decodedSize = stbi_zlib_decode_noheader_buffer(data.data(), static_cast<int>(data.size()),
+                                                              storedData.data(), static_cast<int>(storedData.size()));
+    return decodedSize == static_cast<int>(data.size());
+}
+
+auto ZipFileSource::Count() const -> size_t
+{
+    return m_entries.size();
+}
+
+void ZipFileSource::ReadCentralDirectory()
+{
+    std::ifstream file(m_archiveFile, std::ios_base::in | std::ios_base::binary | std::ios_base::ate);
+    if (!file.good())
+    {
+        throw std::runtime_error("[ZipFileSource] Could not open archive \"" + m_archiveFile + "\".");
+    }
+
+    auto const fileSize = static_cast<uint64_t>(file.tellg());
+    if (fileSize < EndOfCentralDirectorySize)
+    {
+        throw std::runtime_error("[ZipFileSource] File \"" + m_archiveFile + "\" is not a zip archive.");
+    }
+
+    // The end of central directory record is at the end of the file, followed only by the archive comment.
+    auto const tailSize = std::min<uint64_t>(fileSize, EndOfCentralDirectorySize + MaxCommentLength + Zip64EndOfCentralDirectoryLocatorSize);
+    std::vector<char> tail(static_cast<size_t>(tailSize));
+    if (!ReadAt(file, fileSize - tailSize, tail.data(), tail.size()))
+    {
+        throw std::runtime_error("[ZipFileSource] Could not read archive \"" + m_archiveFile + "\".");
+    }
+
+    size_t endRecord = tail.size() - EndOfCentralDirectorySize + 1;
+    do
+    {
+        endRecord--;
+    } while (endRecord > 0 && ReadUInt32(tail.data() + endRecord) != EndOfCentralDirectorySignature);
+
+    if (ReadUInt32(tail.data() + endRecord) != EndOfCentralDirectorySignature)
+    {
+        throw std::runtime_error("[ZipFileSource] File \"" + m_archiveFile + "\" is not a zip archive.");
+    }
+
+    uint64_t entryCount = ReadUInt16(tail.data() + endRecord + 10);
+    uint64_t directorySize = ReadUInt32(tail.data() + endRecord + 12);
+    uint64_t directoryOffset = ReadUInt32(tail.data() + endRecord + 16);
+
+    if (entryCount == 0xFFFF || directorySize == 0xFFFFFFFF || directoryOffset == 0xFFFFFFFF)
+    {
+        // Zip64 archive, the actual values are stored in a separate record pointed to by the locator.
+        char zip64Record[Zip64EndOfCentralDirectorySize];
+        if (endRecord < Zip64EndOfCentralDirectoryLocatorSize ||
+            ReadUInt32(tail.data() + endRecord - Zip64EndOfCentralDirectoryLocatorSize) != Zip64EndOfCentralDirectoryLocatorSignature ||
+            !ReadAt(file, ReadUInt64(tail.data() + endRecord - Zip64EndOfCentralDirectoryLocatorSize + 8), zip64Record, Zip64EndOfCentralDirectorySize) ||
+            ReadUInt32(zip64Record) != Zip64EndOfCentralDirectorySignature)
+        {
+            throw std::runtime_error("[ZipFileSource] Archive \"" + m_archiveFile + "\" has an invalid Zip64 directory record.");
+        }
+
+        entryCount = ReadUInt64(zip64Record + 32);
+        directorySize = ReadUInt64(zip64Record + 40);
+        directoryOffset = ReadUInt64(zip64Record + 48);
+    }
+
+    if (directoryOffset > fileSize || directorySize > fileSize - directoryOffset ||
+        entryCount > directorySize / CentralDirectoryHeaderSize)
+    {
+        throw std::runtime_error("[ZipFileSource] Archive \"" + m_archiveFile + "\" has an invalid central directory.");
+    }
+
+    std::vector<char> directory(static_cast<size_t>(directorySize));
+    if (!directory.empty() && !ReadAt(file, directoryOffset, directory.data(), directory.size()))
+    {
+        throw std::runtime_error("[ZipFileSource] Could not read archive \"" + m_archiveFile + "\".");
+    }
+
+    m_entries.clear();
+    m_entries.reserve(static_cast<size_t>(entryCount));
+
+    size_t position{};
+    for (uint64_t index = 0; index < entryCount; index++)
+    {
+        const char* header = directory.data() + position;
+        if (directory.size() - position < CentralDirectoryHeaderSize ||
+            ReadUInt32(header) != CentralDirectoryHeaderSignature)
+        {
+            throw std::runtime_error("[ZipFileSource] Archive \"" + m_archiveFile + "\" has an invalid central directory.");
+        }
+
+        auto const flags = ReadUInt16(header + 8);
+        auto const nameLength = ReadUInt16(header + 28);
+        auto const extraLength = ReadUInt16(header + 30);
+        auto const commentLength = ReadUInt16(header + 32);
+        auto const headerSize = CentralDirectoryHeaderSize + nameLength + extraLength + commentLength;
+        if (directory.size() - position < headerSize)
+        {
+            throw std::runtime_error("[ZipFileSource] Archive \"" + m_archiveFile + "\" has an invalid central directory.");
+        }
+
+        Entry entry;
+        entry.name.assign(header + CentralDirectoryHeaderSize, nameLength);
+        entry.method = ReadUInt16(header + 10);
+        entry.compressedSize = ReadUInt32(header + 20);
+        entry.uncompressedSize = ReadUInt32(header + 24);
+        entry.localHeaderOffset = ReadUInt32(header + 42);
+
+        // Sizes and offsets exceeding 32 bits are stored in the Zip64 extra field, in this order.
+        const char* extraField = header + CentralDirectoryHeaderSize + nameLength;
+        const char* extraFieldEnd = extraField + extraLength;
+        while (extraFieldEnd - extraField >= 4)
+        {
+            auto const fieldId = ReadUInt16(extraField);
+            auto const fieldSize = ReadUInt16(extraField + 2);
+            const char* fieldData = extraField + 4;
+            const char* fieldDataEnd = std::min(fieldData + fieldSize, extraFieldEnd);
+            if (fieldId == Zip64ExtraFieldId)
+            {
+                for (auto* value : {&entry.uncompressedSize, &entry.compressedSize, &entry.localHeaderOffset})
+                {
+                    if (*value == 0xFFFFFFFF && fieldDataEnd - fieldData >= 8)
+                    {
+                        *value = ReadUInt64(fieldData);
+                        fieldData += 8;
+                    }
+                }
+            }
+            extraField += 4 + fieldSize;
+        }
+
+        position += headerSize;
+
+        // Some archivers use backslashes as path separators.
+        std::replace(entry.name.begin(), entry.name.end(), '\\', '/');
+
+        if (entry.name.empty() || entry.name.back() == '/' || (flags & EncryptedFlag) != 0 ||
+            (entry.method != MethodStored && entry.method != MethodDeflate))
+        {
+            continue;
+        }
+
+        m_entries.push_back(std::move(entry));
+    }
+
+    std::sort(m_entries.begin(), m_entries.end(),
+              [](const Entry& left, const Entry& right) {
+                  return left.name < right.name;
+              });
+}
+
+} // namespace Renderer
+} // namespace libprojectM
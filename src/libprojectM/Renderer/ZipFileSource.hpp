@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Renderer/FileSource.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace libprojectM {
+namespace Renderer {
+
+/**
+ * @class ZipFileSource
+ * @brief File source reading from a zip archive.
+ *
+ * The central directory is read once when opening the archive and kept as a sorted index, so
+ * listing files and looking up a single file doesn't touch the archive again. Only uncompressed
+ * ("stored") and deflate-compressed entries are supported, encrypted entries are skipped.
+ */
+class ZipFileSource : public FileSource
+{
+public:
+    /**
+     * @brief Opens the archive and reads its central directory.
+     * @param archiveFile The zip file path.
+     * @throws std::runtime_error If the file can't be read or is not a valid zip archive.
+     */
+    explicit ZipFileSource(std::string archiveFile);
+
+    void ListFiles(bool recursive, const ListCallback& callback) const override;
+
+    auto ReadFile(const std::string& path, std::vector<char>& data) const -> bool override;
+
+    /**
+     * @brief Reads a file from the archive.
+     * @param entryName The path of the file inside the archive, with forward slashes.
+     * @param data Receives the uncompressed file contents.
+     * @return True if the file was read, false if it doesn't exist or couldn't be extracted.
+     */
+    auto ReadEntry(const std::string& entryName, std::vector<char>& data) const -> bool;
+
+    /**
+     * @brief Returns the number of files in the archive.
+     * @return The number of indexed files, excluding directories and unsupported entries.
+     */
+    auto Count() const -> size_t;
+
+private:
+    /**
+     * @brief A single file in the archive's central directory.
+     */
+    struct Entry {
+        std::string name;             //!< Path inside the archive.
+        uint16_t method{};            //!< Compression method, 0 (stored) or 8 (deflate).
+        uint64_t compressedSize{};    //!< Size of the stored data.
+        uint64_t uncompressedSize{};  //!< Size of the extracted file.
+        uint64_t localHeaderOffset{}; //!< Offset of the entry's local header in the archive.
+    };
+
+    /**
+     * @brief Reads the central directory and fills the entry index.
+     * @throws std::runtime_error If the central directory is missing or malformed.
+     */
+    void ReadCentralDirectory();
+
+    std::string m_archiveFile;    //!< The zip file path.
+    std::vector<Entry> m_entries; //!< All supported files in the archive, sorted by name.
+};
+
+} // namespace Renderer
+} // namespace libprojectM
@@ -0,0 +1,161 @@
+#include "Tracing.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace libprojectM {
+
+namespace {
+
+constexpr size_t EventsPerThread = 16384; //!< Size of each thread's ring buffer.
+
+/**
+ * @brief A single recorded event.
+ */
+struct Event {
+    const char* name{}; //!< The event name.
+    int64_t start{};    //!< Start time in nanoseconds.
+    int64_t end{};      //!< End time in nanoseconds.
+};
+
+/**
+ * @brief The event ring buffer of a single thread. Only written by the owning thread.
+ */
+struct ThreadBuffer {
+    explicit ThreadBuffer(uint32_t id)
+        : threadId(id)
+        , events(EventsPerThread)
+    {
+    }
+
+    uint32_t threadId;               //!< Thread ID used in the exported trace.
+    std::vector<Event> events;       //!< The ring buffer.
+    std::atomic<uint64_t> written{}; //!< Total number of events written to the buffer.
+};
+
+/**
+ * @brief All thread buffers created so far.
+ */
+struct Registry {
+    std::mutex mutex;                                   //!< Protects the buffer list.
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers; //!< All thread buffers, in creation order.
+};
+
+auto GetRegistry() -> Registry&
+{
+    static Registry registry;
+    return registry;
+}
+
+auto GetThreadBuffer() -> ThreadBuffer&
+{
+    thread_local std::shared_ptr<ThreadBuffer> threadBuffer;
+
+    if (!threadBuffer)
+    {
+        auto& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        threadBuffer = std::make_shared<ThreadBuffer>(static_cast<uint32_t>(registry.buffers.size() + 1));
+        registry.buffers.push_back(threadBuffer);
+    }
+
+    return *threadBuffer;
+}
+
+void WriteJsonString(std::ostringstream& stream, const char* text)
+{
+    stream << '"';
+    for (const char* character = text; *character != '\0'; ++character)
+    {
+        if (*character == '"' || *character == '\\')
+        {
+            stream << '\\';
+        }
+        stream << *character;
+    }
+    stream << '"';
+}
+
+} // namespace
+
+std::atomic<bool> Tracing::m_enabled{false};
+
+void Tracing::SetEnabled(bool enabled)
+{
+    m_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+auto Tracing::Now() -> int64_t
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Tracing::Record(const char* name, int64_t start, int64_t end)
+{
+    auto& buffer = GetThreadBuffer();
+
+    auto const index = buffer.written.load(std::memory_order_relaxed);
+    buffer.events[index % EventsPerThread] = {name, start, end};
+    buffer.written.store(index + 1, std::memory_order_release);
+}
+
+auto Tracing::ExportChromeTrace(double seconds) -> std::string
+{
+    auto const oldestEnd = Now() - static_cast<int64_t>(seconds * 1000000000.0);
+
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(3);
+    json << R"({"traceEvents":[)";
+
+    bool firstEvent{true};
+
+    auto& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (const auto& buffer : registry.buffers)
+    {
+        auto const written = buffer->written.load(std::memory_order_acquire);
+        auto const first = written > EventsPerThread ? written - EventsPerThread : 0;
+
+        for (auto index = first; index < written; index++)
+        {
+            auto const event = buffer->events[index % EventsPerThread];
+            if (event.name == nullptr || event.end < oldestEnd)
+            {
+                continue;
+            }
+
+            if (!firstEvent)
+            {
+                json << ',';
+            }
+            firstEvent = false;
+
+            // Chrome trace timestamps and durations are in microseconds.
+            json << R"({"name":)";
+            WriteJsonString(json, event.name);
+            json << R"(,"cat":"projectM","ph":"X","pid":1,"tid":)" << buffer->threadId
+                 << R"(,"ts":)" << static_cast<double>(event.start) / 1000.0
+                 << R"(,"dur":)" << static_cast<double>(event.end - event.start) / 1000.0 << '}';
+        }
+    }
+
+    json << R"(],"displayTimeUnit":"ms"})";
+
+    return json.str();
+}
+
+void Tracing::Clear()
+{
+    auto& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (const auto& buffer : registry.buffers)
+    {
+        buffer->written.store(0, std::memory_order_release);
+    }
+}
+
+} // namespace libprojectM
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <projectM-4/projectM_cxx_export.h>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace libprojectM {
+
+/**
+ * @class Tracing
+ * @brief Records the duration of marked code scopes and exports them as Chrome trace events.
+ *
+ * Scopes are marked with the TRACE_SCOPE() macro, which is only compiled in if libprojectM is
+ * built with ENABLE_TRACING. Even then, tracing must be enabled at runtime. While disabled, a
+ * marker only costs a single relaxed atomic load and branch.
+ *
+ * Each thread writes its events into its own fixed-size ring buffer, so recording an event needs
+ * no locks. Only the first event of each thread registers the thread's buffer. Buffers of finished
+ * threads are kept, so their events can still be exported.
+ */
+class Tracing
+{
+public:
+    /**
+     * @brief Measures the time between construction and destruction and records it as an event.
+     */
+    class Scope
+    {
+    public:
+        /**
+         * @brief Starts measuring the scope if tracing is enabled.
+         * @param name The event name. Must be a string literal or otherwise outlive the trace buffers.
+         */
+        explicit Scope(const char* name)
+            : m_name(IsEnabled() ? name : nullptr)
+            , m_start(m_name != nullptr ? Now() : 0)
+        {
+        }
+
+        Scope(const Scope&) = delete;
+        auto operator=(const Scope&) -> Scope& = delete;
+
+        /**
+         * @brief Records the event if tracing was enabled when the scope was entered.
+         */
+        ~Scope()
+        {
+            if (m_name != nullptr)
+            {
+                Record(m_name, m_start, Now());
+            }
+        }
+
+    private:
+        const char* m_name; //!< The event name, or nullptr if tracing was disabled.
+        int64_t m_start;    //!< Start time in nanoseconds.
+    };
+
+    Tracing() = delete;
+
+    /**
+     * @brief Enables or disables recording trace events in all threads.
+     * Recorded events are kept when disabling tracing.
+     * @param enabled True to record events, false to stop recording.
+     */
+    PROJECTM_CXX_EXPORT static void SetEnabled(bool enabled);
+
+    /**
+     * @brief Returns whether trace events are recorded.
+     * @return True if tracing is enabled.
+     */
+    static auto IsEnabled() -> bool
+    {
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns the current time of the trace clock.
+     * @return A monotonic time in nanoseconds.
+     */
+    PROJECTM_CXX_EXPORT static auto Now() -> int64_t;
+
+    /**
+     * @brief Adds an event to the calling thread's trace buffer.
+     * If the buffer is full, the oldest event is overwritten.
+     * @param name The event name. Must outlive the trace buffers.
+     * @param start The start time, as returned by Now().
+     * @param end The end time, as returned by Now().
+     */
+    PROJECTM_CXX_EXPORT static void Record(const char* name, int64_t start, int64_t end);
+
+    /**
+     * @brief Exports the recorded events of all threads as Chrome trace event JSON.
+     *
+     * The result can be loaded into chrome://tracing or Perfetto. Events recorded by other threads
+     * while exporting may be missing or incomplete.
+     *
+     * @param seconds Only events which ended within this many seconds before now are exported.
+     * @return A JSON object with a "traceEvents" array of complete ("X") events.
+     */
+    PROJECTM_CXX_EXPORT static auto ExportChromeTrace(double seconds) -> std::string;
+
+    /**
+     * @brief Discards all recorded events.
+     * Must not be called while other threads are recording events.
+     */
+    PROJECTM_CXX_EXPORT static void Clear();
+
+private:
+    static std::atomic<bool> m_enabled; //!< True if events are recorded.
+};
+
+#ifdef ENABLE_TRACING
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) ::libprojectM::Tracing::Scope TRACE_CONCAT(traceScope, __LINE__)(name)
+#else
+#define TRACE_SCOPE(name)
+#endif
+
+} // namespace libprojectM
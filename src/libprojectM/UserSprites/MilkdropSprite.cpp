@@ -9,6 +9,7 @@
 #include <Preset.hpp>
 
 #include <Renderer/BlendMode.hpp>
+#include <Renderer/GLStateCache.hpp>
 #include <Renderer/ShaderCache.hpp>
 #include <Renderer/TextureManager.hpp>
 
@@ -263,6 +264,13 @@ void MilkdropSprite::Draw(const Audio::FrameAudioData& audioData,
 
     if (burnIn)
     {
+        // Preset framebuffers are stored vertically flipped.
+        for (auto& vertex : vertices)
+        {
+            vertex.SetY(-vertex.Y());
+        }
+        m_mesh.Update();
+
         // Also draw into all active preset main textures for next-frame burn-in effect
         for (const auto preset : presets)
         {
@@ -275,8 +283,9 @@ void MilkdropSprite::Draw(const Audio::FrameAudioData& audioData,
             m_mesh.Draw();
         }
 
-        // Reset to original FBO
-        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, static_cast<GLuint>(outputFramebufferObject));
+        // Reset to original FBO and viewport
+        Renderer::GLStateCache::Current().BindFramebuffer(GL_DRAW_FRAMEBUFFER, static_cast<GLuint>(outputFramebufferObject));
+        glViewport(0, 0, renderContext.viewportSizeX, renderContext.viewportSizeY);
     }
 
     m_texture->Unbind(0);
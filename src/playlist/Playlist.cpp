@@ -1,5 +1,9 @@
 #include "Playlist.hpp"
 
+#include <projectM-4/core.h>
+#include <projectM-4/memory.h>
+#include <projectM-4/preset_index.h>
+
 #include <algorithm>
 #include <chrono>
 
@@ -93,7 +97,56 @@ auto Playlist::AddPath(const std::string& path, uint32_t index, bool recursive,
 {
     uint32_t presetsAdded{0};
 
-    if (recursive)
+    auto const addPreset = [this, index, allowDuplicates, &presetsAdded](const std::string& filename) {
+        uint32_t currentIndex{InsertAtEnd};
+        if (index < InsertAtEnd)
+        {
+            currentIndex = index + presetsAdded;
+        }
+        if (AddItem(filename, currentIndex, allowDuplicates))
+        {
+            presetsAdded++;
+        }
+    };
+
+    // The preset index is only queried in memory, which is much faster than scanning large directories.
+    auto* indexedFiles = m_presetIndex != nullptr ? projectm_preset_index_list(m_presetIndex, path.c_str(), recursive) : nullptr;
+
+    bool isFile{false};
+    try
+    {
+        isFile = indexedFiles == nullptr && is_regular_file(path);
+    }
+    catch (filesystem_error&)
+    {
+        // Todo: Add failure feedback
+        return presetsAdded;
+    }
+
+    if (indexedFiles != nullptr)
+    {
+        for (int fileIndex = 0; indexedFiles[fileIndex] != nullptr; fileIndex++)
+        {
+            addPreset(indexedFiles[fileIndex]);
+        }
+        projectm_free_string_array(indexedFiles);
+    }
+    else if (isFile)
+    {
+        // Archives are indexed by libprojectM, which also loads the presets from the returned paths.
+        auto* archiveFiles = projectm_list_files(path.c_str(), ".milk", recursive);
+        if (archiveFiles == nullptr)
+        {
+            return presetsAdded;
+        }
+
+        for (int fileIndex = 0; archiveFiles[fileIndex] != nullptr; fileIndex++)
+        {
+            addPreset(archiveFiles[fileIndex]);
+        }
+        projectm_free_string_array(archiveFiles);
+    }
+    else if (recursive)
     {
         try
         {
@@ -101,15 +154,7 @@ auto Playlist::AddPath(const std::string& path, uint32_t index, bool recursive,
             {
                 if (is_regular_file(entry) && entry.path().extension() == ".milk")
                 {
-                    uint32_t currentIndex{InsertAtEnd};
-                    if (index < InsertAtEnd)
-                    {
-                        currentIndex = index + presetsAdded;
-                    }
-                    if (AddItem(entry.path().string(), currentIndex, allowDuplicates))
-                    {
-                        presetsAdded++;
-                    }
+                    addPreset(entry.path().string());
                 }
             }
         }
@@ -125,15 +170,7 @@ auto Playlist::AddPath(const std::string& path, uint32_t index, bool recursive,
         {
             if (is_regular_file(entry) && entry.path().extension() == ".milk")
             {
-                uint32_t currentIndex{InsertAtEnd};
-                if (index < InsertAtEnd)
-                {
-                    currentIndex = index + presetsAdded;
-                }
-                if (AddItem(entry.path().string(), currentIndex, allowDuplicates))
-                {
-                    presetsAdded++;
-                }
+                addPreset(entry.path().string());
             }
         }
     }
@@ -151,6 +188,12 @@ auto Playlist::AddPath(const std::string& path, uint32_t index, bool recursive,
 }
 
 
+void Playlist::UsePresetIndex(projectm_preset_index_handle presetIndex)
+{
+    m_presetIndex = presetIndex;
+}
+
+
 auto Playlist::RemoveItem(uint32_t index) -> bool
 {
     if (index >= m_items.size())
@@ -3,6 +3,8 @@
 #include "Filter.hpp"
 #include "Item.hpp"
 
+#include <projectM-4/types.h>
+
 #include <cstdint>
 #include <limits>
 #include <list>
@@ -119,14 +121,16 @@ public:
      * @brief Adds presets (recursively) from the given path.
      *
      * The function will scan the given path (and possible subdirs) for files with a .milk extension
-     * and add them to the playlist, starting at the given index.
+     * and add them to the playlist, starting at the given index. If the path is a zip archive, the
+     * presets are read from the archive index, see projectm_list_files(). If a preset index is used
+     * and contains presets inside the path, these are added without scanning the file system.
      *
      * The playback history will be kept, and indices are updated accordingly.
      *
      * The order of the added files is unspecified. Use the Sort() method to sort the playlist or
      * the newly added range.
      *
-     * @param path The path to scan for preset files.
+     * @param path The path or archive to scan for preset files.
      * @param index The index to insert the files at. If larger than the playlist size, it's added
 *                   to the end of the playlist.
      * @param recursive True to recursively scan subdirectories. False to only scan the exact
@@ -138,6 +142,12 @@ public:
     virtual auto AddPath(const std::string& path, uint32_t index, bool recursive,
                          bool allowDuplicates) -> uint32_t;
 
+    /**
+     * @brief Sets the preset index AddPath() lists presets from instead of scanning the file system.
+     * @param presetIndex The preset index to use, or nullptr to always scan the file system. Not owned.
+     */
+    virtual void UsePresetIndex(projectm_preset_index_handle presetIndex);
+
     /**
      * @brief Removes a playlist item at the given playlist index.
      * The playback history will be kept, and indices are updated accordingly.
@@ -266,6 +276,8 @@ private:
     uint32_t m_currentPosition{0};       //!< Current playlist position.
     std::list<uint32_t> m_presetHistory; //!< The playback history.
 
+    projectm_preset_index_handle m_presetIndex{nullptr}; //!< Optional preset index used by AddPath().
+
     std::default_random_engine m_randomGenerator;
 };
 
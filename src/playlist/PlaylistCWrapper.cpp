@@ -361,6 +361,13 @@ auto projectm_playlist_insert_path(projectm_playlist_handle instance, const char
 }
 
 
+void projectm_playlist_use_preset_index(projectm_playlist_handle instance, projectm_preset_index_handle index)
+{
+    auto* playlist = playlist_handle_to_instance(instance);
+    playlist->UsePresetIndex(index);
+}
+
+
 auto projectm_playlist_add_preset(projectm_playlist_handle instance, const char* filename,
                                   bool allow_duplicates) -> bool
 {
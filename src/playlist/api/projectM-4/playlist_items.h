@@ -27,6 +27,7 @@
 #pragma once
 
 #include "projectM-4/playlist_types.h"
+#include "projectM-4/types.h"
 
 #include <stdint.h>
 #include <stdbool.h>
@@ -87,12 +88,12 @@ PROJECTM_PLAYLIST_EXPORT char* projectm_playlist_item(projectm_playlist_handle i
  * @brief Appends presets from the given path to the end of the current playlist.
  *
  * This method will scan the given path for files with a ".milk" extension and add these to the
- * playlist.
+ * playlist. If the path is a zip archive, the presets inside the archive are added instead.
  *
  * Symbolic links are not followed.
  *
  * @param instance The playlist manager instance.
- * @param path A local filesystem path to scan for presets.
+ * @param path A local filesystem path or zip archive to scan for presets.
  * @param recurse_subdirs If true, subdirectories of the given path will also be scanned. If false,
  *                        only the exact path given is searched for presets.
  * @param allow_duplicates If true, files found will always be added. If false, only files are
@@ -108,12 +109,12 @@ PROJECTM_PLAYLIST_EXPORT uint32_t projectm_playlist_add_path(projectm_playlist_h
  * @brief Inserts presets from the given path to the end of the current playlist.
  *
  * This method will scan the given path for files with a ".milk" extension and add these to the
- * playlist.
+ * playlist. If the path is a zip archive, the presets inside the archive are added instead.
  *
  * Symbolic links are not followed.
  *
  * @param instance The playlist manager instance.
- * @param path A local filesystem path to scan for presets.
+ * @param path A local filesystem path or zip archive to scan for presets.
  * @param index The index to insert the presets at. If it exceeds the playlist size, the presets are
 *              added at the end of the playlist.
  * @param recurse_subdirs If true, subdirectories of the given path will also be scanned. If false,
@@ -126,6 +127,22 @@ PROJECTM_PLAYLIST_EXPORT uint32_t projectm_playlist_add_path(projectm_playlist_h
 PROJECTM_PLAYLIST_EXPORT uint32_t projectm_playlist_insert_path(projectm_playlist_handle instance, const char* path,
                                                                 uint32_t index, bool recurse_subdirs, bool allow_duplicates);
 
+/**
+ * @brief Sets a preset index to list presets from when adding or inserting paths.
+ *
+ * If the index contains presets inside a path passed to projectm_playlist_add_path() or
+ * projectm_playlist_insert_path(), the indexed presets are added without scanning the file system.
+ * Otherwise, the path is scanned as usual. Refresh the index with projectm_preset_index_refresh()
+ * before adding paths to pick up new or removed presets.
+ *
+ * @param instance The playlist manager instance.
+ * @param index The preset index to use, or NULL to always scan the file system. The index must stay
+ *              valid until it is replaced or the playlist is destroyed.
+ * @since 4.2.0
+ */
+PROJECTM_PLAYLIST_EXPORT void projectm_playlist_use_preset_index(projectm_playlist_handle instance,
+                                                                 projectm_preset_index_handle index);
+
 /**
  * @brief Adds a single preset to the end of the playlist.
  *
@@ -0,0 +1,121 @@
+/**
+ * @file main.cpp
+ * @brief Offline compiler for precompiled Milkdrop preset bundles.
+ *
+ * Scans a directory recursively for .milk files and writes all presets that could be parsed into
+ * a single .milkc bundle file, which can then be loaded with projectm_load_preset_bundle().
+ */
+#include "MilkdropPresetExceptions.hpp"
+#include "PresetBundle.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include PROJECTM_FILESYSTEM_INCLUDE
+using namespace PROJECTM_FILESYSTEM_NAMESPACE::filesystem;
+
+namespace {
+
+auto IsPresetFile(const path& file) -> bool
+{
+    auto extension = file.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return extension == ".milk";
+}
+
+auto ReadFile(const path& file, std::vector<char>& data) -> bool
+{
+    std::ifstream stream(file.string(), std::ios::binary);
+    if (!stream.good())
+    {
+        return false;
+    }
+
+    data.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    return !stream.bad();
+}
+
+void PrintUsage(const char* executable)
+{
+    std::cerr << "Usage: " << executable << " <preset directory> [<output file>]" << std::endl
+              << std::endl
+              << "Compiles all .milk files in the given directory and its subdirectories into a single" << std::endl
+              << "preset bundle. The output file defaults to \"presets.milkc\" in the preset directory." << std::endl
+              << "Presets are looked up relative to the directory containing the bundle file, so it" << std::endl
+              << "should be placed in the preset directory or one of its parents." << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2 || argc > 3)
+    {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    path presetDirectory(argv[1]);
+    std::error_code error;
+    if (!is_directory(presetDirectory, error))
+    {
+        std::cerr << "Not a directory: " << presetDirectory.string() << std::endl;
+        return 1;
+    }
+
+    path bundleFile = argc == 3 ? path(argv[2]) : presetDirectory / "presets.milkc";
+    auto bundleDirectory = absolute(bundleFile).lexically_normal().parent_path();
+
+    // Sort the file list to make the output reproducible.
+    std::vector<path> presetFiles;
+    for (recursive_directory_iterator it(presetDirectory, directory_options::follow_directory_symlink, error), end;
+         !error && it != end;
+         it.increment(error))
+    {
+        if (it->is_regular_file(error) && IsPresetFile(it->path()))
+        {
+            presetFiles.push_back(it->path());
+        }
+    }
+    std::sort(presetFiles.begin(), presetFiles.end());
+
+    libprojectM::MilkdropPreset::PresetBundle::Writer writer;
+    size_t failedCount{};
+    for (const auto& presetFile : presetFiles)
+    {
+        auto name = absolute(presetFile).lexically_normal().lexically_relative(bundleDirectory).generic_string();
+
+        std::vector<char> data;
+        if (!ReadFile(presetFile, data) ||
+            !writer.Add(name, std::move(data), libprojectM::MilkdropPreset::PresetBundle::ModificationTime(presetFile.string())))
+        {
+            std::cerr << "Skipping " << presetFile.string() << ": file could not be read or parsed." << std::endl;
+            failedCount++;
+        }
+    }
+
+    try
+    {
+        writer.Write(bundleFile.string());
+    }
+    catch (const libprojectM::MilkdropPreset::PresetBundleException& ex)
+    {
+        std::cerr << ex.message() << std::endl;
+        return 1;
+    }
+
+    std::cout << "Compiled " << writer.Count() << " presets into " << bundleFile.string();
+    if (failedCount > 0)
+    {
+        std::cout << ", " << failedCount << " failed";
+    }
+    std::cout << "." << std::endl;
+
+    return 0;
+}
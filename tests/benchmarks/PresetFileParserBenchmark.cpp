@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include <MilkdropPreset/PresetFileParser.hpp>
+
+#include <Renderer/FileScanner.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using libprojectM::MilkdropPreset::PresetFileParser;
+
+TEST(PresetFileParserBenchmark, ThroughputPresetPack)
+{
+    // Uses the bundled test presets by default. Point PROJECTM_BENCHMARK_PRESET_DIR to a full preset pack
+    // to get meaningful numbers.
+    std::string presetDir{PROJECTM_TEST_PRESET_DIR};
+    const char* benchmarkDir = std::getenv("PROJECTM_BENCHMARK_PRESET_DIR");
+    if (benchmarkDir != nullptr && benchmarkDir[0] != '\0')
+    {
+        presetDir = benchmarkDir;
+    }
+
+    std::vector<std::string> extensions{".milk"};
+    std::vector<std::vector<char>> presetFiles;
+    size_t totalBytes{0};
+
+    libprojectM::Renderer::FileScanner scanner({presetDir}, extensions);
+    scanner.Scan([&presetFiles, &totalBytes](const std::string& path, const std::string&) {
+        std::ifstream file(path, std::ios_base::in | std::ios_base::binary);
+        std::vector<char> contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        totalBytes += contents.size();
+        presetFiles.push_back(std::move(contents));
+    });
+
+    ASSERT_FALSE(presetFiles.empty());
+
+    // Repeat small packs so the measurement isn't dominated by timer resolution.
+    int const iterations = std::max(1, static_cast<int>(16 * 1024 * 1024 / std::max<size_t>(totalBytes, 1)));
+
+    size_t codeBytes{0};
+    auto start = std::chrono::steady_clock::now();
+    for (int iteration = 0; iteration < iterations; ++iteration)
+    {
+        for (const auto& presetFile : presetFiles)
+        {
+            PresetFileParser parser;
+            if (!parser.Read(std::vector<char>(presetFile)))
+            {
+                continue;
+            }
+
+            // Mimic the lookups done by PresetState::Initialize().
+            codeBytes += static_cast<size_t>(parser.GetFloat("fDecay", 0.98f) > 0.0f);
+            codeBytes += parser.GetCode("per_frame_init_").size();
+            codeBytes += parser.GetCode("per_frame_").size();
+            codeBytes += parser.GetCode("per_pixel_").size();
+            codeBytes += parser.GetCode("warp_").size();
+            codeBytes += parser.GetCode("comp_").size();
+            for (int index = 0; index < 4; ++index)
+            {
+                codeBytes += parser.GetCode("wave_" + std::to_string(index) + "_per_point").size();
+                codeBytes += parser.GetCode("shape_" + std::to_string(index) + "_per_frame").size();
+            }
+        }
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double const megabytes = static_cast<double>(totalBytes) * iterations / (1024.0 * 1024.0);
+    std::cout << "Parsed " << presetFiles.size() * iterations << " presets (" << megabytes << " MiB, "
+              << codeBytes << " code bytes) in " << elapsed << " s: " << megabytes / std::max(elapsed, 1e-9) << " MiB/s" << std::endl;
+}
@@ -0,0 +1,117 @@
+#include "HeadlessGLContext.hpp"
+#include "OffscreenRenderer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+static constexpr auto renderTestDataPath{PROJECTM_TEST_DATA_DIR "/Rendering/"};
+
+/**
+ * Renders presets into an offscreen framebuffer and prints the average frame time. Skipped if no
+ * EGL display is available.
+ */
+class RenderBenchmark : public ::testing::Test
+{
+protected:
+    static constexpr uint32_t Width = 1280;
+    static constexpr uint32_t Height = 720;
+    static constexpr int WarmupFrames = 30;
+    static constexpr int Frames = 120;
+
+    void SetUp() override
+    {
+        if (!m_context.Create())
+        {
+            GTEST_SKIP() << "No EGL display with OpenGL 3.3 core profile support available.";
+        }
+    }
+
+    /**
+     * @brief Renders the given number of frames and returns the average wall time per frame.
+     * Waits for the GPU after each frame, so the time includes the driver and rasterization work.
+     * @return The average frame time in milliseconds.
+     */
+    static auto MeasureFrameTime(OffscreenRenderer& renderer, int frames) -> double
+    {
+        auto const start = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < frames; frame++)
+        {
+            renderer.RenderFrame();
+            glFinish();
+        }
+
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / frames;
+    }
+
+    HeadlessGLContext m_context;
+};
+
+/**
+ * Compares the frame time of a shape-heavy preset with direct and deferred command recording.
+ */
+TEST_F(RenderBenchmark, DeferredCommandRecording)
+{
+    auto const presetFile = std::string(renderTestDataPath) + "custom-shapes.milk";
+
+    for (bool const deferred : {false, true})
+    {
+        OffscreenRenderer renderer(Width, Height);
+        ASSERT_TRUE(renderer.Valid());
+        projectm_set_deferred_command_recording(renderer.Instance(), deferred);
+        renderer.LoadPreset(presetFile);
+
+        MeasureFrameTime(renderer, WarmupFrames);
+        auto const frameTime = MeasureFrameTime(renderer, Frames);
+
+        std::cout << (deferred ? "Deferred" : "Direct") << " command recording: " << frameTime << " ms/frame" << std::endl;
+    }
+}
+
+/**
+ * Compares the frame time of a soft transition, rendering the outgoing preset at full cost and
+ * with the reduced scale and frame interval settings, with the frame time without a transition.
+ */
+TEST_F(RenderBenchmark, TransitionOutgoingPreset)
+{
+    struct OutgoingSettings {
+        float scale;
+        uint32_t frameInterval;
+    };
+
+    auto const presetFile = std::string(renderTestDataPath) + "custom-shapes.milk";
+
+    {
+        OffscreenRenderer renderer(Width, Height);
+        ASSERT_TRUE(renderer.Valid());
+        renderer.LoadPreset(presetFile);
+
+        MeasureFrameTime(renderer, WarmupFrames);
+        auto const frameTime = MeasureFrameTime(renderer, Frames);
+
+        std::cout << "No transition: " << frameTime << " ms/frame" << std::endl;
+    }
+
+    for (auto const& settings : {OutgoingSettings{1.0f, 1}, OutgoingSettings{0.5f, 1}, OutgoingSettings{1.0f, 2}, OutgoingSettings{0.5f, 2}})
+    {
+        OffscreenRenderer renderer(Width, Height);
+        ASSERT_TRUE(renderer.Valid());
+        projectm_set_transition_outgoing_scale(renderer.Instance(), settings.scale);
+        projectm_set_transition_outgoing_frame_interval(renderer.Instance(), settings.frameInterval);
+
+        // Keep the transition running for all measured frames.
+        projectm_set_soft_cut_duration(renderer.Instance(), 3600.0);
+        renderer.LoadPreset(presetFile);
+        MeasureFrameTime(renderer, WarmupFrames);
+        renderer.LoadPreset(presetFile, true);
+
+        MeasureFrameTime(renderer, WarmupFrames);
+        auto const frameTime = MeasureFrameTime(renderer, Frames);
+
+        std::cout << "Transition with outgoing scale " << settings.scale << ", frame interval " << settings.frameInterval
+                  << ": " << frameTime << " ms/frame" << std::endl;
+    }
+}
@@ -0,0 +1,28 @@
+#include <gtest/gtest.h>
+
+#include <Tracing.hpp>
+
+#include <chrono>
+#include <iostream>
+
+using libprojectM::Tracing;
+
+/**
+ * Measures the cost of a trace marker while tracing is disabled at runtime, which has to be low
+ * enough to leave the markers in hot code paths.
+ */
+TEST(TracingBenchmark, DisabledScopeOverhead)
+{
+    constexpr int iterations = 1000000;
+
+    Tracing::SetEnabled(false);
+
+    auto const start = std::chrono::steady_clock::now();
+    for (int iteration = 0; iteration < iterations; iteration++)
+    {
+        Tracing::Scope scope("Benchmark");
+    }
+    auto const elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Disabled trace marker overhead: " << elapsed / iterations << " ns" << std::endl;
+}
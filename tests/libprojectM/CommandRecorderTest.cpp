@@ -0,0 +1,188 @@
+#include <Renderer/CommandRecorder.hpp>
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using libprojectM::Renderer::CommandList;
+using libprojectM::Renderer::CommandRecorder;
+
+namespace {
+
+/**
+ * Adds a record function which logs "r<index>" when recording and "x<index>" when replayed.
+ */
+auto AddLogging(CommandRecorder& recorder, std::vector<std::string>& log, int index) -> size_t
+{
+    return recorder.Add([&log, index](CommandList& commandList) {
+        log.push_back("r" + std::to_string(index));
+        commandList.Record([&log, index]() {
+            log.push_back("x" + std::to_string(index));
+        });
+    });
+}
+
+} // namespace
+
+TEST(CommandRecorder, DirectRecordsOnReplay)
+{
+    CommandRecorder recorder;
+    std::vector<std::string> log;
+
+    auto const first = AddLogging(recorder, log, 0);
+    auto const second = AddLogging(recorder, log, 1);
+    recorder.Start();
+
+    EXPECT_TRUE(log.empty());
+
+    recorder.Replay(first);
+    recorder.Replay(second);
+    recorder.Finish();
+
+    EXPECT_EQ(log, (std::vector<std::string>{"r0", "x0", "r1", "x1"}));
+}
+
+TEST(CommandRecorder, RecordsSkippedListsInOrder)
+{
+    for (bool const deferred : {false, true})
+    {
+        CommandRecorder recorder;
+        recorder.SetDeferred(deferred);
+
+        std::vector<int> recorded;
+        std::vector<int> replayed;
+        std::vector<size_t> indices;
+        for (int index = 0; index < 4; index++)
+        {
+            indices.push_back(recorder.Add([&recorded, &replayed, index](CommandList& commandList) {
+                recorded.push_back(index);
+                commandList.Record([&replayed, index]() {
+                    replayed.push_back(index);
+                });
+            }));
+        }
+        recorder.Start();
+
+        recorder.Replay(indices[2]);
+        recorder.Finish();
+
+        EXPECT_EQ(recorded, (std::vector<int>{0, 1, 2, 3}));
+        EXPECT_EQ(replayed, (std::vector<int>{2}));
+    }
+}
+
+TEST(CommandRecorder, DeferredRecordsOnWorkerThread)
+{
+    CommandRecorder recorder;
+    recorder.SetDeferred(true);
+
+    std::thread::id recordThread;
+    std::thread::id replayThread;
+    auto const index = recorder.Add([&recordThread, &replayThread](CommandList& commandList) {
+        recordThread = std::this_thread::get_id();
+        commandList.Record([&replayThread]() {
+            replayThread = std::this_thread::get_id();
+        });
+    });
+    recorder.Start();
+    recorder.Replay(index);
+    recorder.Finish();
+
+    EXPECT_NE(recordThread, std::this_thread::get_id());
+    EXPECT_EQ(replayThread, std::this_thread::get_id());
+}
+
+TEST(CommandRecorder, ReusedAcrossBatches)
+{
+    CommandRecorder recorder;
+    recorder.SetDeferred(true);
+
+    for (int frame = 0; frame < 3; frame++)
+    {
+        // Recording and replay run concurrently, so each thread writes its own log.
+        std::vector<int> recorded;
+        std::vector<int> replayed;
+        std::vector<size_t> indices;
+        for (int index = 0; index < 2; index++)
+        {
+            indices.push_back(recorder.Add([&recorded, &replayed, frame, index](CommandList& commandList) {
+                recorded.push_back(frame * 2 + index);
+                commandList.Record([&replayed, frame, index]() {
+                    replayed.push_back(frame * 2 + index);
+                });
+            }));
+        }
+        recorder.Start();
+        recorder.Replay(indices[0]);
+        recorder.Replay(indices[1]);
+        recorder.Finish();
+
+        EXPECT_EQ(recorded, (std::vector<int>{frame * 2, frame * 2 + 1}));
+        EXPECT_EQ(replayed, recorded);
+    }
+
+    recorder.SetDeferred(false);
+
+    std::vector<std::string> log;
+    auto const index = AddLogging(recorder, log, 0);
+    recorder.Start();
+    recorder.Replay(index);
+    recorder.Finish();
+
+    EXPECT_EQ(log, (std::vector<std::string>{"r0", "x0"}));
+}
+
+TEST(CommandRecorder, RethrowsRecordErrors)
+{
+    for (bool const deferred : {false, true})
+    {
+        CommandRecorder recorder;
+        recorder.SetDeferred(deferred);
+
+        std::vector<std::string> log;
+        auto const first = recorder.Add([](CommandList&) {
+            throw std::runtime_error("record failed");
+        });
+        auto const second = AddLogging(recorder, log, 1);
+        recorder.Start();
+
+        EXPECT_THROW(recorder.Replay(first), std::runtime_error);
+        recorder.Replay(second);
+        EXPECT_NO_THROW(recorder.Finish());
+
+        EXPECT_TRUE(log.empty());
+    }
+}
+
+TEST(CommandRecorder, InvalidIndexThrows)
+{
+    CommandRecorder recorder;
+    recorder.Start();
+
+    EXPECT_THROW(recorder.Replay(0), std::out_of_range);
+
+    recorder.Finish();
+}
+
+TEST(CommandRecorder, Statistics)
+{
+    CommandRecorder recorder;
+    std::vector<std::string> log;
+
+    recorder.BeginFrame();
+    auto const index = AddLogging(recorder, log, 0);
+    AddLogging(recorder, log, 1);
+    recorder.Start();
+    recorder.Replay(index);
+    recorder.Finish();
+    recorder.EndFrame();
+
+    auto const statistics = recorder.LastFrameStatistics();
+    EXPECT_EQ(statistics.commandLists, 2);
+    EXPECT_EQ(statistics.commands, 2);
+    EXPECT_GE(statistics.recordTime, 0.0);
+    EXPECT_EQ(statistics.waitTime, 0.0);
+}
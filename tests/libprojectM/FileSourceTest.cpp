@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+
+#include <MilkdropPreset/PresetFileParser.hpp>
+
+#include <Renderer/FileSource.hpp>
+#include <Renderer/ZipFileSource.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+static constexpr auto fileSourceTestDataPath{PROJECTM_TEST_DATA_DIR "/FileSource/"};
+
+using libprojectM::MilkdropPreset::PresetFileParser;
+using libprojectM::Renderer::FileSource;
+using libprojectM::Renderer::ZipFileSource;
+
+namespace {
+
+auto ListFiles(const FileSource& source, bool recursive) -> std::vector<std::string>
+{
+    std::vector<std::string> files;
+    source.ListFiles(recursive, [&files](const std::string& path) {
+        files.push_back(path);
+    });
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+auto ArchivePath() -> std::string
+{
+    return std::string(fileSourceTestDataPath) + "presets.zip";
+}
+
+} // namespace
+
+TEST(FileSource, ListZipArchiveRecursively)
+{
+    ZipFileSource archive(ArchivePath());
+
+    EXPECT_EQ(archive.Count(), 4);
+    EXPECT_EQ(ListFiles(archive, true), std::vector<std::string>({ArchivePath() + "/deflated.milk",
+                                                                  ArchivePath() + "/stored.milk",
+                                                                  ArchivePath() + "/subdir/nested.milk",
+                                                                  ArchivePath() + "/subdir/readme.txt"}));
+}
+
+TEST(FileSource, ListZipArchiveNonRecursively)
+{
+    ZipFileSource archive(ArchivePath());
+
+    EXPECT_EQ(ListFiles(archive, false), std::vector<std::string>({ArchivePath() + "/deflated.milk",
+                                                                   ArchivePath() + "/stored.milk"}));
+}
+
+TEST(FileSource, ReadStoredEntry)
+{
+    ZipFileSource archive(ArchivePath());
+
+    std::vector<char> data;
+    ASSERT_TRUE(archive.ReadEntry("stored.milk", data));
+    EXPECT_EQ(std::string(data.begin(), data.end()), "[preset00]\nfRating=3.000000\nper_frame_1=zoom=1.01;\n");
+}
+
+TEST(FileSource, ReadDeflatedEntry)
+{
+    ZipFileSource archive(ArchivePath());
+
+    std::vector<char> data;
+    ASSERT_TRUE(archive.ReadEntry("subdir/nested.milk", data));
+    ASSERT_EQ(data.size(), 560);
+
+    std::string expected;
+    for (int line = 0; line < 20; line++)
+    {
+        expected += "[preset00]\nfRating=5.000000\n";
+    }
+    EXPECT_EQ(std::string(data.begin(), data.end()), expected);
+}
+
+TEST(FileSource, ReadMissingEntry)
+{
+    ZipFileSource archive(ArchivePath());
+
+    std::vector<char> data;
+    EXPECT_FALSE(archive.ReadEntry("subdir", data));
+    EXPECT_FALSE(archive.ReadEntry("missing.milk", data));
+    EXPECT_FALSE(archive.ReadFile("/some/other/archive.zip/stored.milk", data));
+}
+
+TEST(FileSource, RejectOversizedEntries)
+{
+    // Both entries are small, but claim to extract to more than 64 MiB and 25 MiB.
+    ZipFileSource archive(std::string(fileSourceTestDataPath) + "oversized.zip");
+
+    std::vector<char> data;
+    EXPECT_FALSE(archive.ReadEntry("oversized.milk", data));
+    EXPECT_FALSE(archive.ReadEntry("bomb.milk", data));
+    EXPECT_TRUE(data.empty());
+}
+
+TEST(FileSource, ReadVirtualPath)
+{
+    std::vector<char> data;
+    ASSERT_TRUE(FileSource::Read(ArchivePath() + "/deflated.milk", data));
+
+    PresetFileParser parser;
+    ASSERT_TRUE(parser.Read(std::move(data)));
+    EXPECT_EQ(parser.GetFloat("fRating", 0.0f), 4.0f);
+    EXPECT_EQ(parser.GetCode("per_frame_").substr(0, 9), "x=0;\nx=1;");
+}
+
+TEST(FileSource, ReadPlainFile)
+{
+    std::vector<char> data;
+    ASSERT_TRUE(FileSource::Read(std::string(PROJECTM_TEST_DATA_DIR) + "/PresetFileParser/parser-simple.milk", data));
+    EXPECT_FALSE(data.empty());
+
+    EXPECT_FALSE(FileSource::Read(std::string(fileSourceTestDataPath) + "missing.zip/stored.milk", data));
+}
+
+TEST(FileSource, ReadMaxSize)
+{
+    auto const presetFile = std::string(PROJECTM_TEST_DATA_DIR) + "/PresetFileParser/parser-simple.milk";
+
+    std::vector<char> data;
+    ASSERT_TRUE(FileSource::Read(presetFile, data));
+    auto const fileSize = data.size();
+
+    data.clear();
+    EXPECT_TRUE(FileSource::Read(presetFile, data, fileSize));
+    EXPECT_EQ(data.size(), fileSize);
+
+    data.clear();
+    EXPECT_FALSE(FileSource::Read(presetFile, data, fileSize - 1));
+    EXPECT_TRUE(data.empty());
+
+    ASSERT_TRUE(FileSource::Read(ArchivePath() + "/deflated.milk", data));
+    auto const entrySize = data.size();
+    EXPECT_FALSE(FileSource::Read(ArchivePath() + "/deflated.milk", data, entrySize - 1));
+    EXPECT_TRUE(data.empty());
+}
+
+TEST(FileSource, OpenArchive)
+{
+    auto source = FileSource::Open(ArchivePath());
+    ASSERT_NE(source, nullptr);
+
+    // The index is cached and shared.
+    EXPECT_EQ(FileSource::Open(ArchivePath()), source);
+
+    std::vector<char> data;
+    EXPECT_TRUE(source->ReadFile(ArchivePath() + "/subdir/readme.txt", data));
+    EXPECT_EQ(std::string(data.begin(), data.end()), "Not a preset.\n");
+}
+
+TEST(FileSource, OpenDirectory)
+{
+    auto source = FileSource::Open(fileSourceTestDataPath);
+    ASSERT_NE(source, nullptr);
+
+    EXPECT_EQ(ListFiles(*source, true).size(), 2);
+}
+
+TEST(FileSource, OpenInvalidPath)
+{
+    EXPECT_EQ(FileSource::Open(std::string(fileSourceTestDataPath) + "missing.zip"), nullptr);
+    EXPECT_THROW(ZipFileSource(std::string(PROJECTM_TEST_DATA_DIR) + "/PresetFileParser/parser-simple.milk"), std::runtime_error);
+}
@@ -0,0 +1,77 @@
+#include "HeadlessGLContext.hpp"
+
+#include <EGL/eglext.h>
+
+HeadlessGLContext::~HeadlessGLContext()
+{
+    if (m_display == EGL_NO_DISPLAY)
+    {
+        return;
+    }
+
+    eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (m_context != EGL_NO_CONTEXT)
+    {
+        eglDestroyContext(m_display, m_context);
+    }
+    eglTerminate(m_display);
+}
+
+auto HeadlessGLContext::Create() -> bool
+{
+    // Prefer the surfaceless platform, which doesn't need a display server.
+    auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (getPlatformDisplay != nullptr)
+    {
+        m_display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    }
+    if (m_display == EGL_NO_DISPLAY)
+    {
+        m_display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+
+    EGLint majorVersion{};
+    EGLint minorVersion{};
+    if (m_display == EGL_NO_DISPLAY || !eglInitialize(m_display, &majorVersion, &minorVersion))
+    {
+        m_display = EGL_NO_DISPLAY;
+        return false;
+    }
+
+    if (!eglBindAPI(EGL_OPENGL_API))
+    {
+        return false;
+    }
+
+    // The context is used without a surface, but the surfaceless platform only offers pbuffer configs.
+    const EGLint configAttributes[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_NONE};
+
+    EGLConfig config{};
+    EGLint configCount{};
+    if (!eglChooseConfig(m_display, configAttributes, &config, 1, &configCount) || configCount < 1)
+    {
+        return false;
+    }
+
+    const EGLint contextAttributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE};
+
+    m_context = eglCreateContext(m_display, config, EGL_NO_CONTEXT, contextAttributes);
+    if (m_context == EGL_NO_CONTEXT)
+    {
+        return false;
+    }
+
+    return eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, m_context) == EGL_TRUE;
+}
+
+auto HeadlessGLContext::GetProcAddress(const char* name, void*) -> void*
+{
+    return reinterpret_cast<void*>(eglGetProcAddress(name));
+}
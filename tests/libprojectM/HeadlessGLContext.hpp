@@ -0,0 +1,36 @@
+#pragma once
+
+#include <EGL/egl.h>
+
+/**
+ * @brief An offscreen OpenGL 3.3 core context for rendering tests, e.g. using Mesa's llvmpipe driver.
+ *
+ * The context has no default framebuffer, so tests must render into their own framebuffer object.
+ */
+class HeadlessGLContext
+{
+public:
+    HeadlessGLContext() = default;
+
+    ~HeadlessGLContext();
+
+    HeadlessGLContext(const HeadlessGLContext&) = delete;
+    auto operator=(const HeadlessGLContext&) -> HeadlessGLContext& = delete;
+
+    /**
+     * @brief Creates the context and makes it current on the calling thread.
+     * @return true if the context was created, false if no suitable EGL display is available.
+     */
+    auto Create() -> bool;
+
+    /**
+     * @brief OpenGL function loader to pass to projectm_create_with_opengl_load_proc().
+     * @param name The function name.
+     * @return The function pointer, or nullptr if the function isn't available.
+     */
+    static auto GetProcAddress(const char* name, void*) -> void*;
+
+private:
+    EGLDisplay m_display{EGL_NO_DISPLAY}; //!< The EGL display.
+    EGLContext m_context{EGL_NO_CONTEXT}; //!< The OpenGL context.
+};
@@ -0,0 +1,88 @@
+#include <Renderer/InlineFunction.hpp>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+using libprojectM::Renderer::InlineFunction;
+
+TEST(InlineFunction, DefaultIsEmpty)
+{
+    InlineFunction<void()> function;
+
+    EXPECT_FALSE(function);
+}
+
+TEST(InlineFunction, CallsStoredCallable)
+{
+    int offset{10};
+    InlineFunction<int(int)> function([&offset](int value) {
+        return value + offset;
+    });
+
+    ASSERT_TRUE(function);
+    EXPECT_EQ(function(5), 15);
+}
+
+TEST(InlineFunction, PassesReferenceArguments)
+{
+    InlineFunction<void(std::vector<int>&)> function([](std::vector<int>& values) {
+        values.push_back(1);
+    });
+
+    std::vector<int> values;
+    function(values);
+
+    EXPECT_EQ(values.size(), 1);
+}
+
+TEST(InlineFunction, MoveTransfersCallable)
+{
+    auto counter = std::make_shared<int>(0);
+    InlineFunction<void()> source([counter]() {
+        (*counter)++;
+    });
+
+    InlineFunction<void()> target(std::move(source));
+    target();
+
+    EXPECT_FALSE(source);
+    ASSERT_TRUE(target);
+    EXPECT_EQ(*counter, 1);
+    EXPECT_EQ(counter.use_count(), 2);
+}
+
+TEST(InlineFunction, DestroysCallable)
+{
+    auto counter = std::make_shared<int>(0);
+    {
+        InlineFunction<void()> function([counter]() {});
+        EXPECT_EQ(counter.use_count(), 2);
+
+        function = InlineFunction<void()>();
+        EXPECT_EQ(counter.use_count(), 1);
+
+        function = [counter]() {};
+        EXPECT_EQ(counter.use_count(), 2);
+    }
+
+    EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(InlineFunction, SurvivesVectorGrowth)
+{
+    std::vector<InlineFunction<int()>> functions;
+    for (int index = 0; index < 100; index++)
+    {
+        functions.emplace_back([index, twice = index * 2, thrice = index * 3]() {
+            return index + twice + thrice;
+        });
+    }
+
+    for (int index = 0; index < 100; index++)
+    {
+        EXPECT_EQ(functions[index](), index * 6);
+    }
+}
@@ -0,0 +1,98 @@
+#include "OffscreenRenderer.hpp"
+
+#include "HeadlessGLContext.hpp"
+
+#include <cmath>
+
+namespace {
+constexpr double FrameRate = 60.0; //!< The frame rate the frame times are calculated from.
+constexpr unsigned int AudioSamples = 735; //!< Stereo samples added per frame, 44.1 kHz at 60 FPS.
+} // namespace
+
+OffscreenRenderer::OffscreenRenderer(uint32_t width, uint32_t height)
+    : m_width(width)
+    , m_height(height)
+    , m_projectM(projectm_create_with_opengl_load_proc(&HeadlessGLContext::GetProcAddress, nullptr))
+{
+    if (m_projectM == nullptr)
+    {
+        return;
+    }
+
+    projectm_set_window_size(m_projectM, width, height);
+    projectm_set_fps(m_projectM, static_cast<int32_t>(FrameRate));
+    projectm_set_preset_locked(m_projectM, true);
+    projectm_set_hard_cut_enabled(m_projectM, false);
+
+    glGenTextures(1, &m_colorTexture);
+    glBindTexture(GL_TEXTURE_2D, m_colorTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, static_cast<GLsizei>(width), static_cast<GLsizei>(height), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(1, &m_framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_colorTexture, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    // A mix of two sines, so waveforms and spectrum have some shape.
+    m_audioData.resize(AudioSamples * 2);
+    for (unsigned int sample = 0; sample < AudioSamples; sample++)
+    {
+        auto const time = static_cast<float>(sample) / 44100.0f;
+        m_audioData[sample * 2] = 0.5f * std::sin(2.0f * 3.14159265f * 110.0f * time);
+        m_audioData[sample * 2 + 1] = 0.3f * std::sin(2.0f * 3.14159265f * 1760.0f * time);
+    }
+}
+
+OffscreenRenderer::~OffscreenRenderer()
+{
+    if (m_projectM == nullptr)
+    {
+        return;
+    }
+
+    projectm_destroy(m_projectM);
+    glDeleteFramebuffers(1, &m_framebuffer);
+    glDeleteTextures(1, &m_colorTexture);
+}
+
+auto OffscreenRenderer::Valid() const -> bool
+{
+    return m_projectM != nullptr;
+}
+
+auto OffscreenRenderer::Instance() const -> projectm_handle
+{
+    return m_projectM;
+}
+
+void OffscreenRenderer::LoadPreset(const std::string& presetFile, bool smoothTransition)
+{
+    projectm_load_preset_file(m_projectM, presetFile.c_str(), smoothTransition);
+}
+
+void OffscreenRenderer::RenderFrame()
+{
+    projectm_pcm_add_float(m_projectM, m_audioData.data(), AudioSamples, PROJECTM_STEREO);
+    projectm_set_frame_time(m_projectM, static_cast<double>(m_frame) / FrameRate);
+    projectm_opengl_render_frame_fbo(m_projectM, m_framebuffer);
+    m_frame++;
+}
+
+void OffscreenRenderer::BindFramebuffer() const
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    glViewport(0, 0, static_cast<GLsizei>(m_width), static_cast<GLsizei>(m_height));
+}
+
+auto OffscreenRenderer::ReadPixels() const -> std::vector<uint8_t>
+{
+    std::vector<uint8_t> pixels(static_cast<size_t>(m_width) * m_height * 4);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, static_cast<GLsizei>(m_width), static_cast<GLsizei>(m_height), GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    return pixels;
+}
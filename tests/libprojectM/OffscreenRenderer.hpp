@@ -0,0 +1,76 @@
+#pragma once
+
+#include <projectM-4/projectM.h>
+
+#include <Renderer/OpenGL.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Renders presets with a projectM instance into an offscreen framebuffer.
+ *
+ * An OpenGL context must be current when creating the renderer, e.g. a HeadlessGLContext. All
+ * frames are rendered with a fixed frame time and the same synthetic audio, so two renderers
+ * produce identical images for the same preset if projectM renders deterministically.
+ */
+class OffscreenRenderer
+{
+public:
+    /**
+     * @brief Creates a projectM instance and the framebuffer.
+     * @param width The framebuffer width.
+     * @param height The framebuffer height.
+     */
+    OffscreenRenderer(uint32_t width, uint32_t height);
+
+    ~OffscreenRenderer();
+
+    OffscreenRenderer(const OffscreenRenderer&) = delete;
+    auto operator=(const OffscreenRenderer&) -> OffscreenRenderer& = delete;
+
+    /**
+     * @brief Returns whether the projectM instance was created successfully.
+     * @return true if frames can be rendered, false if not.
+     */
+    auto Valid() const -> bool;
+
+    /**
+     * @brief Returns the projectM instance handle, e.g. to change settings before rendering.
+     * @return The projectM instance handle.
+     */
+    auto Instance() const -> projectm_handle;
+
+    /**
+     * @brief Loads a preset.
+     * @param presetFile The preset file to load.
+     * @param smoothTransition If true, a soft transition from the current preset is started.
+     */
+    void LoadPreset(const std::string& presetFile, bool smoothTransition = false);
+
+    /**
+     * @brief Adds audio and renders the next frame.
+     */
+    void RenderFrame();
+
+    /**
+     * @brief Binds the framebuffer and sets the viewport to its size, e.g. to draw into it directly.
+     */
+    void BindFramebuffer() const;
+
+    /**
+     * @brief Reads back the last rendered image.
+     * @return The RGBA pixels, bottom row first.
+     */
+    auto ReadPixels() const -> std::vector<uint8_t>;
+
+private:
+    uint32_t m_width{};             //!< The framebuffer width.
+    uint32_t m_height{};            //!< The framebuffer height.
+    uint32_t m_frame{};             //!< Number of frames rendered so far.
+    projectm_handle m_projectM{};   //!< The projectM instance.
+    GLuint m_framebuffer{};         //!< The framebuffer projectM renders into.
+    GLuint m_colorTexture{};        //!< The color attachment of the framebuffer.
+    std::vector<float> m_audioData; //!< Stereo samples added each frame.
+};
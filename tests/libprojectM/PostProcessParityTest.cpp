@@ -0,0 +1,424 @@
+#include "HeadlessGLContext.hpp"
+#include "OffscreenRenderer.hpp"
+
+#include <MilkdropPreset/PostProcess.hpp>
+#include <MilkdropPreset/PresetState.hpp>
+
+#include <MilkdropStaticShaders.hpp>
+
+#include <Renderer/BlendMode.hpp>
+#include <Renderer/Mesh.hpp>
+#include <Renderer/Sampler.hpp>
+#include <Renderer/Shader.hpp>
+#include <Renderer/ShaderCache.hpp>
+#include <Renderer/Texture.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <ostream>
+#include <random>
+#include <vector>
+
+using libprojectM::MilkdropPreset::MilkdropStaticShaders;
+using libprojectM::MilkdropPreset::PresetState;
+using libprojectM::Renderer::BlendMode;
+
+namespace {
+
+/**
+ * The former multi-pass implementation of the video echo, gamma adjustment and color filters,
+ * which redraws the image quad with different blend modes.
+ */
+class MultiPassReference
+{
+public:
+    explicit MultiPassReference(const PresetState& presetState)
+        : m_presetState(presetState)
+        , m_echoMesh(libprojectM::Renderer::VertexBufferUsage::DynamicDraw, true, true)
+        , m_filterMesh(libprojectM::Renderer::VertexBufferUsage::StaticDraw)
+    {
+        auto staticShaders = MilkdropStaticShaders::Get();
+        m_texturedShader.CompileProgram(staticShaders->GetTexturedDrawVertexShader(),
+                                        staticShaders->GetTexturedDrawFragmentShader());
+        m_untexturedShader.CompileProgram(staticShaders->GetUntexturedDrawVertexShader(),
+                                          staticShaders->GetUntexturedDrawFragmentShader());
+
+        m_echoMesh.SetRenderPrimitiveType(libprojectM::Renderer::Mesh::PrimitiveType::TriangleStrip);
+        m_echoMesh.SetVertexCount(4);
+        m_filterMesh.SetRenderPrimitiveType(libprojectM::Renderer::Mesh::PrimitiveType::TriangleStrip);
+        m_filterMesh.SetVertexCount(4);
+    }
+
+    void Draw()
+    {
+        DrawVideoEchoOrGamma();
+        DrawFilters();
+    }
+
+private:
+    void DrawVideoEchoOrGamma()
+    {
+        auto const& renderContext = m_presetState.renderContext;
+        float const aspect = renderContext.viewportSizeX / static_cast<float>(renderContext.viewportSizeY * renderContext.invAspectY);
+        float const aspectMultX = aspect > 1 ? 1.0f : 1.0f / aspect;
+        float const aspectMultY = aspect > 1 ? aspect : 1.0f;
+
+        float const fOnePlusInvWidth = 1.0f + 1.0f / static_cast<float>(renderContext.viewportSizeX);
+        float const fOnePlusInvHeight = 1.0f + 1.0f / static_cast<float>(renderContext.viewportSizeY);
+        m_echoMesh.Vertices().Set({{-fOnePlusInvWidth * aspectMultX, fOnePlusInvHeight * aspectMultY},
+                                   {fOnePlusInvWidth * aspectMultX, fOnePlusInvHeight * aspectMultY},
+                                   {-fOnePlusInvWidth * aspectMultX, -fOnePlusInvHeight * aspectMultY},
+                                   {fOnePlusInvWidth * aspectMultX, -fOnePlusInvHeight * aspectMultY}});
+
+        for (int i = 0; i < 4; i++)
+        {
+            auto const indexFloat = static_cast<float>(i);
+            m_shade[i][0] = 0.6f + 0.3f * sinf(renderContext.time * 30.0f * 0.0143f + 3 + indexFloat * 21 + m_presetState.hueRandomOffsets[3]);
+            m_shade[i][1] = 0.6f + 0.3f * sinf(renderContext.time * 30.0f * 0.0107f + 1 + indexFloat * 13 + m_presetState.hueRandomOffsets[1]);
+            m_shade[i][2] = 0.6f + 0.3f * sinf(renderContext.time * 30.0f * 0.0129f + 6 + indexFloat * 9 + m_presetState.hueRandomOffsets[2]);
+
+            float const max = std::max(m_shade[i][0], std::max(m_shade[i][1], m_shade[i][2]));
+            for (auto& component : m_shade[i])
+            {
+                component /= max;
+                component = 0.5f + 0.5f * component;
+            }
+        }
+
+        m_texturedShader.Bind();
+        m_texturedShader.SetUniformMat4x4("vertex_transformation", PresetState::orthogonalProjection);
+        m_texturedShader.SetUniformInt("texture_sampler", 0);
+
+        m_presetState.mainTexture.lock()->Bind(0);
+        m_sampler.Bind(0);
+
+        if (m_presetState.videoEchoAlpha > 0.001f)
+        {
+            DrawVideoEcho();
+        }
+        else
+        {
+            DrawGammaAdjustment();
+        }
+
+        BlendMode::SetBlendActive(false);
+        libprojectM::Renderer::Mesh::Unbind();
+        libprojectM::Renderer::Shader::Unbind();
+        m_presetState.mainTexture.lock()->Unbind(0);
+        libprojectM::Renderer::Sampler::Unbind(0);
+    }
+
+    void DrawVideoEcho()
+    {
+        float const videoEchoZoom = m_presetState.videoEchoZoom;
+        float const videoEchoAlpha = m_presetState.videoEchoAlpha;
+        int const videoEchoOrientation = m_presetState.videoEchoOrientation % 4;
+        float const gammaAdj = m_presetState.gammaAdj;
+
+        BlendMode::Set(true, BlendMode::Function::One, BlendMode::Function::Zero);
+
+        for (int pass = 0; pass < 2; pass++)
+        {
+            float const zoom = (pass == 0) ? 1.0f : videoEchoZoom;
+            float const tempLow = 0.5f - 0.5f / zoom;
+            float const tempHigh = 0.5f + 0.5f / zoom;
+
+            m_echoMesh.UVs().Set({{tempLow, tempLow},
+                                  {tempHigh, tempLow},
+                                  {tempLow, tempHigh},
+                                  {tempHigh, tempHigh}});
+
+            if (pass == 1)
+            {
+                for (int vertex = 0; vertex < 4; vertex++)
+                {
+                    if (videoEchoOrientation % 2 == 1)
+                    {
+                        m_echoMesh.UVs()[vertex].SetU(1.0f - m_echoMesh.UVs()[vertex].U());
+                    }
+                    if (videoEchoOrientation >= 2)
+                    {
+                        m_echoMesh.UVs()[vertex].SetV(1.0f - m_echoMesh.UVs()[vertex].V());
+                    }
+                }
+            }
+
+            float const mix = (pass == 1) ? videoEchoAlpha : 1.0f - videoEchoAlpha;
+            SetShade(mix);
+            m_echoMesh.Update();
+            m_echoMesh.Draw();
+
+            if (pass == 0)
+            {
+                BlendMode::SetBlendFunction(BlendMode::Function::One, BlendMode::Function::One);
+            }
+
+            if (gammaAdj > 0.001f)
+            {
+                int const redrawCount = static_cast<int>(gammaAdj - 0.0001f);
+                for (int redraw = 0; redraw < redrawCount; redraw++)
+                {
+                    float const gamma = redraw == redrawCount - 1 ? gammaAdj - static_cast<float>(redrawCount) : 1.0f;
+                    SetShade(gamma * mix);
+                    m_echoMesh.Update();
+                    m_echoMesh.Draw();
+                }
+            }
+        }
+    }
+
+    void DrawGammaAdjustment()
+    {
+        m_echoMesh.UVs().Set({{0.0f, 0.0f},
+                              {1.0f, 0.0f},
+                              {0.0f, 1.0f},
+                              {1.0f, 1.0f}});
+
+        BlendMode::Set(true, BlendMode::Function::One, BlendMode::Function::Zero);
+
+        float const gammaAdj = m_presetState.gammaAdj;
+        int const redrawCount = static_cast<int>(gammaAdj - 0.0001f) + 1;
+        for (int redraw = 0; redraw < redrawCount; redraw++)
+        {
+            float const gamma = redraw == redrawCount - 1 ? gammaAdj - static_cast<float>(redraw) : 1.0f;
+            SetShade(gamma);
+            m_echoMesh.Update();
+            m_echoMesh.Draw();
+
+            if (redraw == 0)
+            {
+                BlendMode::Set(true, BlendMode::Function::One, BlendMode::Function::One);
+            }
+        }
+    }
+
+    void DrawFilters()
+    {
+        if (!m_presetState.brighten && !m_presetState.darken && !m_presetState.solarize && !m_presetState.invert)
+        {
+            return;
+        }
+
+        float const fOnePlusInvWidth = 1.0f + 1.0f / static_cast<float>(m_presetState.renderContext.viewportSizeX);
+        float const fOnePlusInvHeight = 1.0f + 1.0f / static_cast<float>(m_presetState.renderContext.viewportSizeY);
+        m_filterMesh.Vertices().Set({{-fOnePlusInvWidth, fOnePlusInvHeight},
+                                     {fOnePlusInvWidth, fOnePlusInvHeight},
+                                     {-fOnePlusInvWidth, -fOnePlusInvHeight},
+                                     {fOnePlusInvWidth, -fOnePlusInvHeight}});
+        m_filterMesh.Update();
+
+        BlendMode::SetBlendActive(true);
+
+        m_untexturedShader.Bind();
+        m_untexturedShader.SetUniformMat4x4("vertex_transformation", PresetState::orthogonalProjection);
+        m_untexturedShader.SetUniformFloat("vertex_point_size", 1.0f);
+
+        glVertexAttrib4f(1, 1.0, 1.0, 1.0, 1.0);
+
+        if (m_presetState.brighten)
+        {
+            DrawFilterPass(BlendMode::Function::OneMinusDestinationColor, BlendMode::Function::Zero);
+            DrawFilterPass(BlendMode::Function::Zero, BlendMode::Function::DestinationColor);
+            DrawFilterPass(BlendMode::Function::OneMinusDestinationColor, BlendMode::Function::Zero);
+        }
+        if (m_presetState.darken)
+        {
+            DrawFilterPass(BlendMode::Function::Zero, BlendMode::Function::DestinationColor);
+        }
+        if (m_presetState.solarize)
+        {
+            DrawFilterPass(BlendMode::Function::Zero, BlendMode::Function::OneMinusDestinationColor);
+            DrawFilterPass(BlendMode::Function::DestinationColor, BlendMode::Function::One);
+        }
+        if (m_presetState.invert)
+        {
+            DrawFilterPass(BlendMode::Function::OneMinusDestinationColor, BlendMode::Function::Zero);
+        }
+
+        libprojectM::Renderer::Mesh::Unbind();
+        libprojectM::Renderer::Shader::Unbind();
+        BlendMode::SetBlendActive(false);
+    }
+
+    void DrawFilterPass(BlendMode::Function source, BlendMode::Function destination)
+    {
+        BlendMode::SetBlendFunction(source, destination);
+        m_filterMesh.Draw();
+    }
+
+    void SetShade(float factor)
+    {
+        for (int vertex = 0; vertex < 4; vertex++)
+        {
+            m_echoMesh.Colors()[vertex] = {factor * m_shade[vertex][0],
+                                           factor * m_shade[vertex][1],
+                                           factor * m_shade[vertex][2],
+                                           1.0f};
+        }
+    }
+
+    const PresetState& m_presetState;
+    std::array<std::array<float, 3>, 4> m_shade{};
+    libprojectM::Renderer::Mesh m_echoMesh;
+    libprojectM::Renderer::Mesh m_filterMesh;
+    libprojectM::Renderer::Sampler m_sampler{GL_CLAMP_TO_EDGE, GL_LINEAR};
+    libprojectM::Renderer::Shader m_texturedShader;
+    libprojectM::Renderer::Shader m_untexturedShader;
+};
+
+/**
+ * Effect settings of a single parity check.
+ */
+struct PostProcessSettings {
+    float videoEchoAlpha{};
+    int videoEchoOrientation{};
+    float gammaAdj{1.0f};
+    bool brighten{};
+    bool darken{};
+    bool solarize{};
+    bool invert{};
+};
+
+auto operator<<(std::ostream& stream, const PostProcessSettings& settings) -> std::ostream&
+{
+    return stream << "echo alpha " << settings.videoEchoAlpha << ", orientation " << settings.videoEchoOrientation
+                  << ", gamma " << settings.gammaAdj << ", filters " << settings.brighten << settings.darken
+                  << settings.solarize << settings.invert;
+}
+
+} // namespace
+
+/**
+ * Renders random image contents with the fused post-processing pass and the former multi-pass
+ * implementation and compares the results. Skipped if no EGL display is available.
+ */
+class PostProcessParityTest : public ::testing::TestWithParam<PostProcessSettings>
+{
+protected:
+    static constexpr uint32_t Width = 128;
+    static constexpr uint32_t Height = 96;
+
+    /**
+     * Each pass of the multi-pass path rounds the framebuffer contents to 8 bits, and the filters
+     * amplify differences in the darker or brighter half by up to a factor of two. With all
+     * filters, echo and gamma enabled, the image is rounded more than ten times.
+     */
+    static constexpr int Tolerance = 6;
+
+    void SetUp() override
+    {
+        if (!m_context.Create())
+        {
+            GTEST_SKIP() << "No EGL display with OpenGL 3.3 core profile support available.";
+        }
+
+        m_renderer = std::make_unique<OffscreenRenderer>(Width, Height);
+        ASSERT_TRUE(m_renderer->Valid());
+
+        std::mt19937 randomGenerator(42);
+        std::uniform_int_distribution<int> distribution(0, 255);
+        std::vector<uint8_t> pixels(Width * Height * 4);
+        for (auto& component : pixels)
+        {
+            component = static_cast<uint8_t>(distribution(randomGenerator));
+        }
+        m_mainTexture = std::make_shared<libprojectM::Renderer::Texture>("main", pixels.data(), GL_TEXTURE_2D, Width, Height, 0,
+                                                                         GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, false);
+
+        auto const& settings = GetParam();
+        m_presetState = std::make_unique<PresetState>();
+        m_presetState->renderContext.viewportSizeX = Width;
+        m_presetState->renderContext.viewportSizeY = Height;
+        m_presetState->renderContext.aspectY = static_cast<float>(Height) / static_cast<float>(Width);
+        m_presetState->renderContext.invAspectY = 1.0f / m_presetState->renderContext.aspectY;
+        m_presetState->renderContext.time = 2.0f;
+        m_presetState->renderContext.shaderCache = &m_shaderCache;
+        m_presetState->hueRandomOffsets = {1.0f, 2.0f, 3.0f, 4.0f};
+        m_presetState->mainTexture = m_mainTexture;
+        m_presetState->videoEchoAlpha = settings.videoEchoAlpha;
+        m_presetState->videoEchoZoom = 1.3f;
+        m_presetState->videoEchoOrientation = settings.videoEchoOrientation;
+        m_presetState->gammaAdj = settings.gammaAdj;
+        m_presetState->brighten = settings.brighten;
+        m_presetState->darken = settings.darken;
+        m_presetState->solarize = settings.solarize;
+        m_presetState->invert = settings.invert;
+    }
+
+    void TearDown() override
+    {
+        m_presetState.reset();
+        m_mainTexture.reset();
+        m_renderer.reset();
+    }
+
+    /**
+     * @brief Clears the framebuffer, draws and reads back the image.
+     */
+    template<typename DrawFunction>
+    auto Render(DrawFunction draw) -> std::vector<uint8_t>
+    {
+        m_renderer->BindFramebuffer();
+        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        draw();
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        return m_renderer->ReadPixels();
+    }
+
+    HeadlessGLContext m_context;
+    std::unique_ptr<OffscreenRenderer> m_renderer;
+    libprojectM::Renderer::ShaderCache m_shaderCache;
+    std::shared_ptr<libprojectM::Renderer::Texture> m_mainTexture;
+    std::unique_ptr<PresetState> m_presetState;
+};
+
+TEST_P(PostProcessParityTest, MatchesMultiPassRendering)
+{
+    libprojectM::MilkdropPreset::PostProcess postProcess(*m_presetState);
+    auto const fusedImage = Render([&postProcess]() {
+        postProcess.Draw();
+    });
+
+    MultiPassReference reference(*m_presetState);
+    auto const referenceImage = Render([&reference]() {
+        reference.Draw();
+    });
+
+    ASSERT_EQ(fusedImage.size(), referenceImage.size());
+
+    // Only compare the color, the alpha channel of the output isn't used.
+    int maxDifference{};
+    for (size_t index = 0; index < fusedImage.size(); index++)
+    {
+        if (index % 4 != 3)
+        {
+            maxDifference = std::max(maxDifference, std::abs(static_cast<int>(fusedImage[index]) - static_cast<int>(referenceImage[index])));
+        }
+    }
+
+    EXPECT_LE(maxDifference, Tolerance);
+}
+
+INSTANTIATE_TEST_SUITE_P(PostProcess, PostProcessParityTest,
+                         ::testing::Values(
+                             // Gamma below and above 1, without echo.
+                             PostProcessSettings{0.0f, 0, 0.6f},
+                             PostProcessSettings{0.0f, 0, 2.5f},
+                             // Echo with each orientation, gamma below and above 1.
+                             PostProcessSettings{0.4f, 0, 0.6f},
+                             PostProcessSettings{0.4f, 1, 2.5f},
+                             PostProcessSettings{0.4f, 2, 1.0f},
+                             PostProcessSettings{0.7f, 3, 1.7f},
+                             // Each filter on its own, and all combined with echo.
+                             PostProcessSettings{0.0f, 0, 1.0f, true, false, false, false},
+                             PostProcessSettings{0.0f, 0, 1.0f, false, true, false, false},
+                             PostProcessSettings{0.0f, 0, 1.0f, false, false, true, false},
+                             PostProcessSettings{0.0f, 0, 1.0f, false, false, false, true},
+                             PostProcessSettings{0.4f, 3, 2.5f, true, true, true, true}));
@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+
+#include <MilkdropPreset/MilkdropPresetExceptions.hpp>
+#include <MilkdropPreset/PresetBundle.hpp>
+#include <MilkdropPreset/PresetFileParser.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include PROJECTM_FILESYSTEM_INCLUDE
+
+using libprojectM::MilkdropPreset::PresetBundle;
+using libprojectM::MilkdropPreset::PresetBundleException;
+using libprojectM::MilkdropPreset::PresetFileParser;
+using libprojectM::MilkdropPreset::PresetKeySlot;
+using libprojectM::MilkdropPreset::PresetKeyTable;
+
+namespace fs = PROJECTM_FILESYSTEM_NAMESPACE::filesystem;
+
+namespace {
+
+auto ReadFile(const fs::path& file) -> std::vector<char>
+{
+    std::ifstream stream(file.string(), std::ios::binary);
+    return {std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+}
+
+auto TestPresetFiles() -> std::vector<fs::path>
+{
+    std::vector<fs::path> files;
+    for (const auto& entry : fs::directory_iterator(PROJECTM_TEST_PRESET_DIR))
+    {
+        if (entry.path().extension() == ".milk")
+        {
+            files.push_back(entry.path());
+        }
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+/**
+ * Compiles all test presets into a bundle in the temp directory, which is removed afterwards.
+ */
+class PresetBundleTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_bundleFile = fs::temp_directory_path() / "projectM-unittest-presets.milkc";
+        m_presetFiles = TestPresetFiles();
+
+        auto bundleDirectory = fs::absolute(m_bundleFile).lexically_normal().parent_path();
+
+        PresetBundle::Writer writer;
+        for (const auto& file : m_presetFiles)
+        {
+            auto name = fs::absolute(file).lexically_normal().lexically_relative(bundleDirectory).generic_string();
+            if (writer.Add(name, ReadFile(file), PresetBundle::ModificationTime(file.string())))
+            {
+                m_compiledFiles.push_back(file);
+            }
+        }
+        writer.Write(m_bundleFile.string());
+    }
+
+    void TearDown() override
+    {
+        std::error_code error;
+        fs::remove(m_bundleFile, error);
+    }
+
+    fs::path m_bundleFile;
+    std::vector<fs::path> m_presetFiles;
+    std::vector<fs::path> m_compiledFiles;
+};
+
+} // namespace
+
+TEST_F(PresetBundleTest, ContainsAllPresets)
+{
+    PresetBundle bundle(m_bundleFile.string());
+
+    ASSERT_FALSE(m_compiledFiles.empty());
+    EXPECT_EQ(bundle.Count(), m_compiledFiles.size());
+
+    for (const auto& file : m_compiledFiles)
+    {
+        auto index = bundle.Find(file.string());
+        ASSERT_GE(index, 0) << file.string();
+
+        auto data = ReadFile(file);
+        EXPECT_EQ(bundle.SourceSize(index), data.size());
+        EXPECT_EQ(bundle.SourceHash(index), PresetBundle::HashSource(data.data(), data.size()));
+        EXPECT_EQ(bundle.SourceModificationTime(index), PresetBundle::ModificationTime(file.string()));
+    }
+}
+
+TEST_F(PresetBundleTest, RecordMatchesParser)
+{
+    PresetBundle bundle(m_bundleFile.string());
+
+    const std::vector<std::string> codePrefixes{
+        "per_frame_init_", "per_frame_", "per_pixel_", "warp_", "comp_",
+        "wave_0_init", "wave_0_per_frame", "wave_0_per_point",
+        "shape_0_init", "shape_0_per_frame"};
+
+    for (const auto& file : m_compiledFiles)
+    {
+        PresetFileParser parser;
+        ASSERT_TRUE(parser.Read(file.string()));
+
+        auto record = bundle.Preset(bundle.Find(file.string()));
+
+        for (uint16_t index = 0; index < PresetKeyTable::SlotCount; index++)
+        {
+            PresetKeySlot slot{index};
+            EXPECT_EQ(record.GetString(slot, "default"), parser.GetString(slot, "default")) << file.string();
+            EXPECT_EQ(record.GetInt(slot, -12345), parser.GetInt(slot, -12345)) << file.string();
+            EXPECT_EQ(record.GetFloat(slot, -1.5f), parser.GetFloat(slot, -1.5f)) << file.string();
+            EXPECT_EQ(record.GetBool(slot, true), parser.GetBool(slot, true)) << file.string();
+        }
+
+        for (const auto& prefix : codePrefixes)
+        {
+            EXPECT_EQ(record.GetCode(prefix), parser.GetCode(prefix)) << file.string() << ": " << prefix;
+        }
+    }
+}
+
+TEST_F(PresetBundleTest, FindUnknownPreset)
+{
+    PresetBundle bundle(m_bundleFile.string());
+
+    EXPECT_EQ(bundle.Find(std::string(PROJECTM_TEST_PRESET_DIR) + "/does-not-exist.milk"), -1);
+    EXPECT_EQ(bundle.Find(""), -1);
+}
+
+TEST(PresetBundle, OpenMissingFile)
+{
+    EXPECT_THROW(PresetBundle("/this/file/does/not/exist.milkc"), PresetBundleException);
+}
+
+TEST(PresetBundle, OpenInvalidFile)
+{
+    EXPECT_THROW(PresetBundle(std::string(PROJECTM_TEST_PRESET_DIR) + "/001-line.milk"), PresetBundleException);
+}
+
+TEST(PresetBundle, ModificationTimeOfMissingFile)
+{
+    EXPECT_EQ(PresetBundle::ModificationTime(std::string(PROJECTM_TEST_PRESET_DIR) + "/does-not-exist.milk"), -1);
+}
+
+TEST(PresetBundle, AddInvalidPreset)
+{
+    PresetBundle::Writer writer;
+    EXPECT_FALSE(writer.Add("empty.milk", {}));
+    EXPECT_EQ(writer.Count(), 0);
+}
@@ -2,9 +2,18 @@
 
 #include <MilkdropPreset/PresetFileParser.hpp>
 
+#include <algorithm>
+#include <string>
+#include <vector>
+
 static constexpr auto fileParserTestDataPath{ PROJECTM_TEST_DATA_DIR "/PresetFileParser/" };
 
 using libprojectM::MilkdropPreset::PresetFileParser;
+using libprojectM::MilkdropPreset::PresetKey;
+using libprojectM::MilkdropPreset::PresetKeySlot;
+using libprojectM::MilkdropPreset::PresetKeyTable;
+using libprojectM::MilkdropPreset::ShapeKey;
+using libprojectM::MilkdropPreset::WaveKey;
 
 /**
  * Class to make protected function accessible to tests.
@@ -132,6 +141,46 @@ TEST(PresetFileParser, GetCodeShaderSyntax)
     EXPECT_EQ(code, "r=1.0;\ng=1.0;\nb=1.0;\n");
 }
 
+TEST(PresetFileParser, GetCodeOutOfOrder)
+{
+    PresetFileParser parser;
+    ASSERT_TRUE(parser.Read(std::string(fileParserTestDataPath) + "parser-code.milk"));
+
+    auto code = parser.GetCode("out_of_order_");
+    EXPECT_EQ(code, "r=1.0;\ng=1.0;\nb=1.0;\n");
+}
+
+TEST(PresetFileParser, GetCodeIgnoresLeadingZeros)
+{
+    PresetFileParser parser;
+    ASSERT_TRUE(parser.Read(std::string(fileParserTestDataPath) + "parser-code.milk"));
+
+    auto code = parser.GetCode("leading_zero_");
+    EXPECT_EQ(code, "r=1.0;\ng=1.0;\n");
+}
+
+TEST(PresetFileParser, GetCodePrefixEndingInDigit)
+{
+    PresetFileParser parser;
+    ASSERT_TRUE(parser.Read(std::string(fileParserTestDataPath) + "parser-code.milk"));
+
+    EXPECT_EQ(parser.GetCode("digit_prefix_2"), "r=1.0;\ng=1.0;\nb=1.0;\n");
+
+    // Parsed as lines 21 to 23 of "digit_prefix_", so there's no first line.
+    EXPECT_EQ(parser.GetCode("digit_prefix_"), "");
+}
+
+TEST(PresetFileParser, ReadBufferWithCrLf)
+{
+    const std::string presetText = "[preset00]\r\nfRating=3.5\r\nper_frame_1=r=1.0;\r\nper_frame_2=g=1.0;\r\n\r\nper_frame_3=b=1.0;";
+
+    PresetFileParser parser;
+    ASSERT_TRUE(parser.Read(std::vector<char>(presetText.begin(), presetText.end())));
+
+    EXPECT_EQ(parser.GetFloat("fRating", 0.0f), 3.5f);
+    EXPECT_EQ(parser.GetCode("per_frame_"), "r=1.0;\ng=1.0;\nb=1.0;\n");
+}
+
 TEST(PresetFileParser, GetIntValid)
 {
     PresetFileParser parser;
@@ -203,3 +252,40 @@ TEST(PresetFileParser, GetBooleanDefault)
 
     EXPECT_EQ(parser.GetBool("RandomKey", true), true);
 }
+
+TEST(PresetFileParser, GetValueByKeySlot)
+{
+    PresetFileParser parser;
+    ASSERT_TRUE(parser.Read(std::string(fileParserTestDataPath) + "parser-valueconversion.milk"));
+
+    EXPECT_FLOAT_EQ(parser.GetFloat(PresetKeyTable::Slot(PresetKey::VideoEchoAlpha), 0.0f), 0.5f);
+    EXPECT_EQ(parser.GetInt(PresetKeyTable::Slot(PresetKey::VideoEchoOrientation), 0), 3);
+    EXPECT_EQ(parser.GetBool(PresetKeyTable::Slot(PresetKey::AdditiveWaves), false), true);
+    EXPECT_FLOAT_EQ(parser.GetFloat(PresetKeyTable::Slot(PresetKey::Decay), 123.0f), 123.0f);
+}
+
+TEST(PresetFileParser, KeyTableRoundTrip)
+{
+    for (int slot = 0; slot < PresetKeyTable::SlotCount; slot++)
+    {
+        auto name = PresetKeyTable::Name({static_cast<uint16_t>(slot)});
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        EXPECT_EQ(PresetKeyTable::Find(name.data(), name.length()), slot) << name;
+    }
+
+    EXPECT_EQ(PresetKeyTable::Name(PresetKeyTable::Slot(WaveKey::Spectrum, 2)), "wavecode_2_bSpectrum");
+    EXPECT_EQ(PresetKeyTable::Name(PresetKeyTable::Slot(ShapeKey::Instances, 3)), "shapecode_3_num_inst");
+    EXPECT_EQ(PresetKeyTable::Find("wavecode_4_r", 12), -1);
+    EXPECT_EQ(PresetKeyTable::Find("per_frame_1", 11), -1);
+    EXPECT_EQ(PresetKeyTable::Find("fdecayx", 7), -1);
+}
+
+TEST(PresetFileParser, UnknownKeys)
+{
+    PresetFileParser parser;
+    ASSERT_TRUE(parser.Read(std::string(fileParserTestDataPath) + "parser-valueconversion.milk"));
+
+    auto unknownKeys = parser.UnknownKeys();
+    EXPECT_NE(std::find(unknownKeys.begin(), unknownKeys.end(), "fsomeweirdstuff"), unknownKeys.end());
+    EXPECT_EQ(std::find(unknownKeys.begin(), unknownKeys.end(), "fvideoechoalpha"), unknownKeys.end());
+}
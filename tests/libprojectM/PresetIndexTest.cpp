@@ -0,0 +1,223 @@
+#include <gtest/gtest.h>
+
+#include <MilkdropPreset/PresetFileParser.hpp>
+#include <MilkdropPreset/PresetIndex.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include PROJECTM_FILESYSTEM_INCLUDE
+
+using libprojectM::MilkdropPreset::PresetFileParser;
+using libprojectM::MilkdropPreset::PresetIndex;
+
+namespace fs = PROJECTM_FILESYSTEM_NAMESPACE::filesystem;
+
+namespace {
+
+auto CountTestPresets() -> size_t
+{
+    size_t count{};
+    for (const auto& entry : fs::directory_iterator(PROJECTM_TEST_PRESET_DIR))
+    {
+        if (entry.path().extension() == ".milk")
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+auto ParseInfo(const std::string& presetData) -> PresetIndex::PresetInfo
+{
+    std::stringstream stream(presetData);
+    PresetFileParser parser;
+    EXPECT_TRUE(parser.Read(stream));
+    return PresetIndex::ReadPresetInfo(parser);
+}
+
+/**
+ * Provides an index file and a preset directory in the temp directory, both removed afterwards.
+ */
+class PresetIndexTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_indexFile = (fs::temp_directory_path() / "projectM-unittest-presets.milki").string();
+        m_presetDirectory = fs::temp_directory_path() / "projectM-unittest-index-presets";
+        fs::remove(m_indexFile);
+        fs::remove_all(m_presetDirectory);
+        fs::create_directories(m_presetDirectory);
+    }
+
+    void TearDown() override
+    {
+        fs::remove(m_indexFile);
+        fs::remove_all(m_presetDirectory);
+    }
+
+    std::string m_indexFile;
+    fs::path m_presetDirectory;
+};
+
+} // namespace
+
+TEST_F(PresetIndexTest, MissingFileIsEmpty)
+{
+    PresetIndex index(m_indexFile);
+
+    EXPECT_EQ(index.Count(), 0);
+    EXPECT_EQ(index.Find(std::string(PROJECTM_TEST_PRESET_DIR) + "/110-per_pixel.milk"), -1);
+}
+
+TEST_F(PresetIndexTest, InvalidFileIsEmpty)
+{
+    {
+        std::ofstream file(m_indexFile, std::ios::binary);
+        file << "This is not a preset index, but long enough to contain a header.";
+    }
+
+    PresetIndex index(m_indexFile);
+
+    EXPECT_EQ(index.Count(), 0);
+}
+
+TEST_F(PresetIndexTest, RefreshDirectory)
+{
+    auto const presetCount = CountTestPresets();
+
+    PresetIndex index(m_indexFile);
+    EXPECT_EQ(index.Refresh({PROJECTM_TEST_PRESET_DIR}), presetCount);
+    ASSERT_EQ(index.Count(), presetCount);
+
+    auto const presetIndex = index.Find(std::string(PROJECTM_TEST_PRESET_DIR) + "/110-per_pixel.milk");
+    ASSERT_GE(presetIndex, 0);
+    EXPECT_EQ(fs::path(index.Path(presetIndex)).filename().string(), "110-per_pixel.milk");
+
+    auto const info = index.Info(presetIndex);
+    EXPECT_EQ(info.fileSize, fs::file_size(index.Path(presetIndex)));
+    EXPECT_NE(info.contentHash, 0);
+    EXPECT_NE(info.flags & PresetIndex::HasPerPixelCode, 0);
+    EXPECT_EQ(info.flags & PresetIndex::InArchive, 0);
+
+    for (size_t entry = 1; entry < index.Count(); entry++)
+    {
+        EXPECT_LT(index.Path(entry - 1), index.Path(entry));
+    }
+}
+
+TEST_F(PresetIndexTest, RefreshOnlyParsesChangedFiles)
+{
+    auto const presetFile = (m_presetDirectory / "changed.milk").string();
+    {
+        std::ofstream file(presetFile);
+        file << "[preset00]\nper_frame_1=x=1;\n";
+    }
+    {
+        std::ofstream file((m_presetDirectory / "unchanged.milk").string());
+        file << "[preset00]\nper_pixel_1=x=1;\n";
+    }
+
+    {
+        PresetIndex index(m_indexFile);
+        EXPECT_EQ(index.Refresh({m_presetDirectory.string()}), 2);
+    }
+
+    // A new instance maps the file written before.
+    PresetIndex index(m_indexFile);
+    ASSERT_EQ(index.Count(), 2);
+    EXPECT_EQ(index.Refresh({m_presetDirectory.string()}), 0);
+
+    auto const oldHash = index.Info(index.Find(presetFile)).contentHash;
+    {
+        std::ofstream file(presetFile);
+        file << "[preset00]\nper_frame_1=x=2;\nper_frame_2=y=1;\n";
+    }
+
+    EXPECT_EQ(index.Refresh({m_presetDirectory.string()}), 1);
+    ASSERT_EQ(index.Count(), 2);
+    EXPECT_NE(index.Info(index.Find(presetFile)).contentHash, oldHash);
+
+    fs::remove(presetFile);
+    EXPECT_EQ(index.Refresh({m_presetDirectory.string()}), 0);
+    EXPECT_EQ(index.Count(), 1);
+    EXPECT_EQ(index.Find(presetFile), -1);
+}
+
+TEST_F(PresetIndexTest, RefreshArchive)
+{
+    auto const archiveFile = std::string(PROJECTM_TEST_DATA_DIR) + "/FileSource/presets.zip";
+
+    PresetIndex index(m_indexFile);
+    EXPECT_EQ(index.Refresh({archiveFile}), 3);
+    ASSERT_EQ(index.Count(), 3);
+
+    auto const presetIndex = index.Find(archiveFile + "/subdir/nested.milk");
+    ASSERT_GE(presetIndex, 0);
+    EXPECT_NE(index.Info(presetIndex).flags & PresetIndex::InArchive, 0);
+
+    EXPECT_EQ(index.Refresh({archiveFile}), 0);
+}
+
+TEST(PresetIndex, ReadPresetInfo)
+{
+    auto const info = ParseInfo("[preset00]\n"
+                                "MILKDROP_PRESET_VERSION=201\n"
+                                "PSVERSION_WARP=2\n"
+                                "PSVERSION_COMP=3\n"
+                                "wavecode_1_enabled=1\n"
+                                "wavecode_1_samples=100\n"
+                                "wave_1_per_point1=y=x;\n"
+                                "shapecode_2_enabled=1\n"
+                                "shapecode_2_textured=1\n"
+                                "shapecode_2_image=Flower.jpg\n"
+                                "per_frame_1=zoom=1;\n"
+                                "warp_1=`shader_body { ret = tex2D(sampler_main, uv).xyz; }\n"
+                                "comp_1=`shader_body { ret = tex2D(sampler_FW_Clouds, uv).xyz + tex2D(sampler_noise_lq, uv).xyz; }\n");
+
+    EXPECT_EQ(info.presetVersion, 201);
+    EXPECT_EQ(info.warpShaderVersion, 2);
+    EXPECT_EQ(info.compositeShaderVersion, 3);
+    EXPECT_EQ(info.waveCount, 1);
+    EXPECT_EQ(info.shapeCount, 1);
+    EXPECT_EQ(info.flags, PresetIndex::HasPerFrameCode | PresetIndex::HasWarpShader | PresetIndex::HasCompositeShader);
+    // Code lengths include the line breaks: 8 bytes of per-frame code plus 5 bytes per sample.
+    EXPECT_FLOAT_EQ(info.costEstimate, 8.0f + 5.0f * 100.0f);
+    EXPECT_EQ(info.textures, std::vector<std::string>({"clouds", "flower.jpg"}));
+}
+
+TEST(PresetIndex, ReadPresetInfoLegacyShaders)
+{
+    auto const info = ParseInfo("[preset00]\n"
+                                "PSVERSION=3\n"
+                                "warp_1=`shader_body { ret = tex2D(sampler_clouds, uv).xyz; }\n");
+
+    EXPECT_EQ(info.presetVersion, 100);
+    EXPECT_EQ(info.warpShaderVersion, 0);
+    EXPECT_EQ(info.compositeShaderVersion, 0);
+    EXPECT_EQ(info.flags, 0);
+    EXPECT_TRUE(info.textures.empty());
+}
+
+TEST_F(PresetIndexTest, ListPath)
+{
+    auto const archiveFile = std::string(PROJECTM_TEST_DATA_DIR) + "/FileSource/presets.zip";
+
+    PresetIndex index(m_indexFile);
+    index.Refresh({archiveFile});
+
+    auto const recursive = index.List(archiveFile, true);
+    ASSERT_EQ(recursive.size(), 3);
+    EXPECT_NE(std::find(recursive.begin(), recursive.end(), archiveFile + "/subdir/nested.milk"), recursive.end());
+
+    auto const topLevel = index.List(archiveFile, false);
+    EXPECT_EQ(topLevel.size(), 2);
+    EXPECT_EQ(std::find(topLevel.begin(), topLevel.end(), archiveFile + "/subdir/nested.milk"), topLevel.end());
+
+    EXPECT_EQ(index.List(archiveFile + "/subdir", false).size(), 1);
+    EXPECT_TRUE(index.List(std::string(PROJECTM_TEST_PRESET_DIR), true).empty());
+}
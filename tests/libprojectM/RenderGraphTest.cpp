@@ -0,0 +1,150 @@
+#include <Renderer/RenderGraph.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+using libprojectM::Renderer::RenderGraph;
+using libprojectM::Renderer::RenderGraphStatistics;
+
+TEST(RenderGraph, RunsPassesInOrder)
+{
+    RenderGraph graph;
+    std::vector<std::string> executed;
+
+    graph.AddPass("first", {}, {"image"}, [&executed]() { executed.emplace_back("first"); });
+    graph.AddPass("second", {"image"}, {"image"}, [&executed]() { executed.emplace_back("second"); });
+    graph.AddPass("third", {"image"}, {"output"}, [&executed]() { executed.emplace_back("third"); });
+    graph.AddOutput("output");
+
+    RenderGraphStatistics statistics;
+    graph.Execute(&statistics);
+
+    EXPECT_EQ(executed, std::vector<std::string>({"first", "second", "third"}));
+    EXPECT_EQ(statistics.executed, 3U);
+    EXPECT_EQ(statistics.culled, 0U);
+    EXPECT_TRUE(statistics.culledPasses.empty());
+}
+
+TEST(RenderGraph, CullsDisabledPasses)
+{
+    RenderGraph graph;
+    std::vector<std::string> executed;
+
+    graph.AddPass("background", {}, {"image"}, [&executed]() { executed.emplace_back("background"); });
+    graph.AddPass("border", {"image"}, {"image"}, [&executed]() { executed.emplace_back("border"); }, false);
+    graph.AddPass("composite", {"image"}, {"output"}, [&executed]() { executed.emplace_back("composite"); });
+    graph.AddOutput("output");
+
+    RenderGraphStatistics statistics;
+    graph.Execute(&statistics);
+
+    EXPECT_EQ(executed, std::vector<std::string>({"background", "composite"}));
+    EXPECT_EQ(statistics.executed, 2U);
+    EXPECT_EQ(statistics.culled, 1U);
+    EXPECT_EQ(statistics.culledPasses, std::vector<std::string>({"border"}));
+}
+
+TEST(RenderGraph, CullsPassesWithUnusedOutputs)
+{
+    RenderGraph graph;
+    std::vector<std::string> executed;
+
+    graph.AddPass("blur", {"image"}, {"blur"}, [&executed]() { executed.emplace_back("blur"); });
+    graph.AddPass("composite", {}, {"output"}, [&executed]() { executed.emplace_back("composite"); });
+    graph.AddOutput("output");
+
+    RenderGraphStatistics statistics;
+    graph.Execute(&statistics);
+
+    EXPECT_EQ(executed, std::vector<std::string>({"composite"}));
+    EXPECT_EQ(statistics.culledPasses, std::vector<std::string>({"blur"}));
+}
+
+TEST(RenderGraph, CullsPassesOnlyFeedingCulledPasses)
+{
+    RenderGraph graph;
+    std::vector<std::string> executed;
+
+    graph.AddPass("horizontal", {}, {"intermediate"}, [&executed]() { executed.emplace_back("horizontal"); });
+    graph.AddPass("vertical", {"intermediate"}, {"blur"}, [&executed]() { executed.emplace_back("vertical"); });
+    graph.AddPass("composite", {}, {"output"}, [&executed]() { executed.emplace_back("composite"); });
+    graph.AddOutput("output");
+
+    RenderGraphStatistics statistics;
+    graph.Execute(&statistics);
+
+    EXPECT_EQ(executed, std::vector<std::string>({"composite"}));
+    EXPECT_EQ(statistics.culledPasses, std::vector<std::string>({"horizontal", "vertical"}));
+}
+
+TEST(RenderGraph, KeepsPassesWritingOutputs)
+{
+    RenderGraph graph;
+    std::vector<std::string> executed;
+
+    graph.AddPass("blur", {}, {"blur"}, [&executed]() { executed.emplace_back("blur"); });
+    graph.AddOutput("blur");
+
+    graph.Execute();
+
+    EXPECT_EQ(executed, std::vector<std::string>({"blur"}));
+}
+
+TEST(RenderGraph, KeepsPassesAfterExecution)
+{
+    RenderGraph graph;
+    int runs{};
+
+    EXPECT_TRUE(graph.Empty());
+
+    graph.AddPass("pass", {}, {"output"}, [&runs]() { runs++; });
+    graph.AddOutput("output");
+    graph.Execute();
+
+    RenderGraphStatistics statistics;
+    graph.Execute(&statistics);
+
+    EXPECT_FALSE(graph.Empty());
+    EXPECT_EQ(runs, 2);
+    EXPECT_EQ(statistics.executed, 1U);
+    EXPECT_EQ(statistics.culled, 0U);
+}
+
+TEST(RenderGraph, EnablesPassesBetweenExecutions)
+{
+    RenderGraph graph;
+    std::vector<std::string> executed;
+
+    graph.AddPass("background", {}, {"image"}, [&executed]() { executed.emplace_back("background"); });
+    auto const border = graph.AddPass("border", {"image"}, {"image"}, [&executed]() { executed.emplace_back("border"); }, false);
+    graph.AddPass("composite", {"image"}, {"output"}, [&executed]() { executed.emplace_back("composite"); });
+    graph.AddOutput("output");
+
+    graph.Execute();
+    EXPECT_EQ(executed, std::vector<std::string>({"background", "composite"}));
+
+    executed.clear();
+    graph.SetEnabled(border, true);
+    graph.Execute();
+    EXPECT_EQ(executed, std::vector<std::string>({"background", "border", "composite"}));
+}
+
+TEST(RenderGraph, IsEmptyAfterClear)
+{
+    RenderGraph graph;
+    int runs{};
+
+    graph.AddPass("pass", {}, {"output"}, [&runs]() { runs++; });
+    graph.AddOutput("output");
+    graph.Clear();
+
+    RenderGraphStatistics statistics;
+    graph.Execute(&statistics);
+
+    EXPECT_TRUE(graph.Empty());
+    EXPECT_EQ(runs, 0);
+    EXPECT_EQ(statistics.executed, 0U);
+    EXPECT_EQ(statistics.culled, 0U);
+}
@@ -0,0 +1,168 @@
+#include "HeadlessGLContext.hpp"
+#include "OffscreenRenderer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+static constexpr auto renderTestDataPath{PROJECTM_TEST_DATA_DIR "/Rendering/"};
+
+/**
+ * Renders presets into an offscreen framebuffer. Skipped if no EGL display is available.
+ */
+class RenderTest : public ::testing::Test
+{
+protected:
+    static constexpr uint32_t Width = 256;
+    static constexpr uint32_t Height = 192;
+    static constexpr int Frames = 30;
+
+    void SetUp() override
+    {
+        if (!m_context.Create())
+        {
+            GTEST_SKIP() << "No EGL display with OpenGL 3.3 core profile support available.";
+        }
+    }
+
+    /**
+     * @brief Returns the largest difference of any color channel between two images.
+     */
+    static auto MaxDifference(const std::vector<uint8_t>& left, const std::vector<uint8_t>& right) -> int
+    {
+        int maxDifference{};
+        for (size_t index = 0; index < left.size() && index < right.size(); index++)
+        {
+            maxDifference = std::max(maxDifference, std::abs(static_cast<int>(left[index]) - static_cast<int>(right[index])));
+        }
+
+        return maxDifference;
+    }
+
+    /**
+     * @brief Returns whether any pixel of the image is not black.
+     */
+    static auto HasContent(const std::vector<uint8_t>& image) -> bool
+    {
+        for (size_t index = 0; index < image.size(); index += 4)
+        {
+            if (image[index] != 0 || image[index + 1] != 0 || image[index + 2] != 0)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Returns the red channel of the pixel at the given position, counted from the bottom left.
+     */
+    static auto Red(const std::vector<uint8_t>& image, uint32_t x, uint32_t y) -> int
+    {
+        return image.at((static_cast<size_t>(y) * Width + x) * 4);
+    }
+
+    /**
+     * @brief Renders a few frames of the given preset and returns whether the blur pass was culled in the last one.
+     */
+    static auto BlurPassCulled(const std::string& presetFile) -> bool
+    {
+        OffscreenRenderer renderer(Width, Height);
+        EXPECT_TRUE(renderer.Valid());
+        renderer.LoadPreset(std::string(renderTestDataPath) + presetFile);
+        for (int frame = 0; frame < 3; frame++)
+        {
+            renderer.RenderFrame();
+        }
+
+        auto* culledPassNames = projectm_get_culled_render_passes(renderer.Instance());
+        std::string culledPasses = "," + std::string(culledPassNames) + ",";
+        projectm_free_string(culledPassNames);
+
+        return culledPasses.find(",blur,") != std::string::npos;
+    }
+
+    HeadlessGLContext m_context;
+};
+
+TEST_F(RenderTest, DeferredRecordingMatchesDirect)
+{
+    auto const presetFile = std::string(renderTestDataPath) + "custom-shapes.milk";
+
+    std::vector<uint8_t> directImage;
+    {
+        OffscreenRenderer renderer(Width, Height);
+        ASSERT_TRUE(renderer.Valid());
+        projectm_set_deferred_command_recording(renderer.Instance(), false);
+        renderer.LoadPreset(presetFile);
+        for (int frame = 0; frame < Frames; frame++)
+        {
+            renderer.RenderFrame();
+        }
+        directImage = renderer.ReadPixels();
+    }
+
+    std::vector<uint8_t> deferredImage;
+    {
+        OffscreenRenderer renderer(Width, Height);
+        ASSERT_TRUE(renderer.Valid());
+        projectm_set_deferred_command_recording(renderer.Instance(), true);
+        renderer.LoadPreset(presetFile);
+        for (int frame = 0; frame < Frames; frame++)
+        {
+            renderer.RenderFrame();
+        }
+        deferredImage = renderer.ReadPixels();
+    }
+
+    ASSERT_TRUE(HasContent(directImage));
+    ASSERT_EQ(directImage.size(), deferredImage.size());
+    EXPECT_EQ(MaxDifference(directImage, deferredImage), 0);
+}
+
+TEST_F(RenderTest, BurnInTexturePosition)
+{
+    OffscreenRenderer renderer(Width, Height);
+    ASSERT_TRUE(renderer.Valid());
+    renderer.LoadPreset(std::string(renderTestDataPath) + "burn-in.milk");
+    renderer.RenderFrame();
+    renderer.RenderFrame();
+
+    std::vector<uint8_t> const whitePixels(4 * 4 * 4, 255);
+    GLuint texture{};
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 4, 4, 0, GL_RGBA, GL_UNSIGNED_BYTE, whitePixels.data());
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // Pixel coordinates with the origin in the upper left corner, so this covers the second quarter
+    // in both directions. ReadPixels() returns the bottom row first.
+    projectm_opengl_burn_texture(renderer.Instance(), texture, Width / 4, Height / 4, Width / 4, Height / 4);
+    glDeleteTextures(1, &texture);
+
+    renderer.RenderFrame();
+    auto const image = renderer.ReadPixels();
+
+    EXPECT_GT(Red(image, Width * 3 / 8, Height * 5 / 8), 200);
+    EXPECT_LT(Red(image, Width * 3 / 8, Height * 3 / 8), 50) << "Burn-in is vertically mirrored.";
+    EXPECT_LT(Red(image, Width * 5 / 8, Height * 5 / 8), 50) << "Burn-in is horizontally mirrored.";
+
+    // Only the rectangle is covered.
+    EXPECT_GT(Red(image, Width / 4 + 2, Height * 3 / 4 - 2), 200);
+    EXPECT_GT(Red(image, Width / 2 - 2, Height / 2 + 2), 200);
+    EXPECT_LT(Red(image, Width / 4 - 2, Height * 5 / 8), 50);
+    EXPECT_LT(Red(image, Width / 2 + 2, Height * 5 / 8), 50);
+    EXPECT_LT(Red(image, Width * 3 / 8, Height * 3 / 4 + 2), 50);
+    EXPECT_LT(Red(image, Width * 3 / 8, Height / 2 - 2), 50);
+}
+
+TEST_F(RenderTest, BlurPassCulledIfNoShaderSamplesIt)
+{
+    EXPECT_TRUE(BlurPassCulled("burn-in.milk"));
+    EXPECT_FALSE(BlurPassCulled("blur-warp.milk"));
+    EXPECT_FALSE(BlurPassCulled("blur-composite.milk"));
+}
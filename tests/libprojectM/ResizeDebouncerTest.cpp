@@ -0,0 +1,105 @@
+#include <Renderer/ResizeDebouncer.hpp>
+
+#include <gtest/gtest.h>
+
+using libprojectM::Renderer::ResizeDebouncer;
+
+TEST(ResizeDebouncer, AppliesFirstSizeImmediately)
+{
+    ResizeDebouncer debouncer;
+    debouncer.Request(800, 600);
+
+    EXPECT_EQ(debouncer.Width(), 800);
+    EXPECT_EQ(debouncer.Height(), 600);
+    EXPECT_FALSE(debouncer.Pending());
+}
+
+TEST(ResizeDebouncer, WaitsUntilSizeSettles)
+{
+    ResizeDebouncer debouncer;
+    debouncer.SetSettleFrames(3);
+    debouncer.Request(800, 600);
+    debouncer.Request(1024, 768);
+
+    EXPECT_TRUE(debouncer.Pending());
+    EXPECT_FALSE(debouncer.NextFrame());
+    EXPECT_FALSE(debouncer.NextFrame());
+    EXPECT_EQ(debouncer.Width(), 800);
+    EXPECT_EQ(debouncer.Height(), 600);
+
+    EXPECT_TRUE(debouncer.NextFrame());
+    EXPECT_EQ(debouncer.Width(), 1024);
+    EXPECT_EQ(debouncer.Height(), 768);
+    EXPECT_FALSE(debouncer.Pending());
+    EXPECT_FALSE(debouncer.NextFrame());
+}
+
+TEST(ResizeDebouncer, CoalescesContinuousResizing)
+{
+    ResizeDebouncer debouncer;
+    debouncer.SetSettleFrames(3);
+    debouncer.Request(800, 600);
+
+    // Simulates dragging the window border, changing the size every frame.
+    int changes{};
+    for (uint32_t width = 801; width < 900; width++)
+    {
+        debouncer.Request(width, 600);
+        if (debouncer.NextFrame())
+        {
+            changes++;
+        }
+    }
+    EXPECT_EQ(changes, 0);
+    EXPECT_EQ(debouncer.Width(), 800);
+
+    for (int frame = 0; frame < 10; frame++)
+    {
+        debouncer.Request(899, 600);
+        if (debouncer.NextFrame())
+        {
+            changes++;
+        }
+    }
+    EXPECT_EQ(changes, 1);
+    EXPECT_EQ(debouncer.Width(), 899);
+}
+
+TEST(ResizeDebouncer, ReturnToCurrentSizeCancelsRequest)
+{
+    ResizeDebouncer debouncer;
+    debouncer.SetSettleFrames(3);
+    debouncer.Request(800, 600);
+    debouncer.Request(1024, 768);
+    debouncer.Request(800, 600);
+
+    EXPECT_FALSE(debouncer.Pending());
+    for (int frame = 0; frame < 5; frame++)
+    {
+        EXPECT_FALSE(debouncer.NextFrame());
+    }
+    EXPECT_EQ(debouncer.Width(), 800);
+}
+
+TEST(ResizeDebouncer, ZeroSettleFramesAppliesImmediately)
+{
+    ResizeDebouncer debouncer;
+    debouncer.SetSettleFrames(0);
+    debouncer.Request(800, 600);
+    debouncer.Request(1024, 768);
+
+    EXPECT_EQ(debouncer.Width(), 1024);
+    EXPECT_EQ(debouncer.Height(), 768);
+}
+
+TEST(ResizeDebouncer, DisablingAppliesPendingSize)
+{
+    ResizeDebouncer debouncer;
+    debouncer.SetSettleFrames(3);
+    debouncer.Request(800, 600);
+    debouncer.Request(1024, 768);
+    debouncer.SetSettleFrames(0);
+
+    EXPECT_EQ(debouncer.Width(), 1024);
+    EXPECT_FALSE(debouncer.Pending());
+}
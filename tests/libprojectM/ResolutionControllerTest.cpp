@@ -0,0 +1,91 @@
+#include <Renderer/ResolutionController.hpp>
+
+#include <gtest/gtest.h>
+
+using libprojectM::Renderer::ResolutionController;
+
+namespace {
+
+/**
+ * Feeds the controller with frame times of a renderer whose cost is proportional to the pixel count.
+ */
+auto Simulate(ResolutionController& controller, double fullResolutionFrameTime, int frames) -> float
+{
+    for (int frame = 0; frame < frames; frame++)
+    {
+        auto const scale = controller.Scale();
+        controller.Update(fullResolutionFrameTime * scale * scale);
+    }
+
+    return controller.Scale();
+}
+
+} // namespace
+
+TEST(ResolutionController, KeepsFullScaleWithinBudget)
+{
+    ResolutionController controller;
+    controller.SetTargetFrameTime(16.0);
+
+    EXPECT_FLOAT_EQ(Simulate(controller, 10.0, 200), 1.0f);
+}
+
+TEST(ResolutionController, ReducesScaleOverBudget)
+{
+    ResolutionController controller;
+    controller.SetTargetFrameTime(16.0);
+
+    auto const scale = Simulate(controller, 32.0, 200);
+
+    EXPECT_LT(scale, 1.0f);
+    EXPECT_LE(32.0 * scale * scale, 16.0);
+    EXPECT_GE(32.0 * scale * scale, 16.0 * 0.8);
+}
+
+TEST(ResolutionController, StaysWithinLimits)
+{
+    ResolutionController controller;
+    controller.SetTargetFrameTime(16.0);
+    controller.SetScaleLimits(0.6f, 0.9f);
+
+    EXPECT_FLOAT_EQ(controller.Scale(), 0.9f);
+    EXPECT_FLOAT_EQ(Simulate(controller, 1000.0, 500), 0.6f);
+}
+
+TEST(ResolutionController, RecoversWhenLoadDrops)
+{
+    ResolutionController controller;
+    controller.SetTargetFrameTime(16.0);
+
+    Simulate(controller, 40.0, 300);
+    ASSERT_LT(controller.Scale(), 1.0f);
+
+    EXPECT_FLOAT_EQ(Simulate(controller, 5.0, 500), 1.0f);
+}
+
+TEST(ResolutionController, IgnoresMeasurementsAfterChange)
+{
+    ResolutionController controller;
+    controller.SetTargetFrameTime(16.0);
+
+    // The scale must not change before enough frames have been measured.
+    for (int frame = 0; frame < 20; frame++)
+    {
+        controller.Update(100.0);
+    }
+
+    EXPECT_FLOAT_EQ(controller.Scale(), 1.0f);
+}
+
+TEST(ResolutionController, ResetRestoresMaximumScale)
+{
+    ResolutionController controller;
+    controller.SetTargetFrameTime(16.0);
+
+    Simulate(controller, 40.0, 300);
+    ASSERT_LT(controller.Scale(), 1.0f);
+
+    controller.Reset();
+
+    EXPECT_FLOAT_EQ(controller.Scale(), 1.0f);
+}
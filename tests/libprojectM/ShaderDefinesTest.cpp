@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include <Renderer/ShaderDefines.hpp>
+
+using libprojectM::Renderer::ShaderDefines;
+
+TEST(ShaderDefines, EmptyKey)
+{
+    ShaderDefines defines;
+
+    EXPECT_TRUE(defines.Empty());
+    EXPECT_EQ(defines.Key("shader"), "shader");
+}
+
+TEST(ShaderDefines, KeySortedByName)
+{
+    ShaderDefines defines;
+    defines.Set("WAVE_MODE", 6);
+    defines.Set("USE_SPECTRUM", 0);
+
+    EXPECT_FALSE(defines.Empty());
+    EXPECT_EQ(defines.Key("shader"), "shader[USE_SPECTRUM=0,WAVE_MODE=6]");
+}
+
+TEST(ShaderDefines, SameValuesSameKey)
+{
+    ShaderDefines first;
+    first.Set("A", 1);
+    first.Set("B", 2);
+
+    ShaderDefines second;
+    second.Set("B", 2);
+    second.Set("A", 1);
+
+    ShaderDefines different;
+    different.Set("A", 1);
+    different.Set("B", 3);
+
+    EXPECT_EQ(first.Key("shader"), second.Key("shader"));
+    EXPECT_NE(first.Key("shader"), different.Key("shader"));
+}
+
+TEST(ShaderDefines, ReplaceValue)
+{
+    ShaderDefines defines;
+    defines.Set("INVERT", 0);
+    defines.Set("INVERT", 1);
+
+    EXPECT_EQ(defines.Key("shader"), "shader[INVERT=1]");
+    EXPECT_EQ(defines.Apply("void main(){}"), "#define INVERT 1\nvoid main(){}");
+}
+
+TEST(ShaderDefines, ApplyAfterVersion)
+{
+    ShaderDefines defines;
+    defines.Set("BRIGHTEN", 1);
+    defines.Set("DARKEN", 0);
+
+    EXPECT_EQ(defines.Apply("#version 330\nvoid main(){}"),
+              "#version 330\n#define BRIGHTEN 1\n#define DARKEN 0\nvoid main(){}");
+}
+
+TEST(ShaderDefines, ApplyVersionOnly)
+{
+    ShaderDefines defines;
+    defines.Set("USE_ECHO", 1);
+
+    EXPECT_EQ(defines.Apply("#version 300 es"), "#version 300 es\n#define USE_ECHO 1\n");
+}
+
+TEST(ShaderDefines, ApplyEmpty)
+{
+    ShaderDefines defines;
+
+    EXPECT_EQ(defines.Apply("#version 330\nvoid main(){}"), "#version 330\nvoid main(){}");
+}
@@ -0,0 +1,270 @@
+#include "HeadlessGLContext.hpp"
+#include "OffscreenRenderer.hpp"
+
+#include <MilkdropPreset/PerFrameContext.hpp>
+#include <MilkdropPreset/PresetState.hpp>
+#include <MilkdropPreset/Waveforms/Line.hpp>
+
+#include <MilkdropStaticShaders.hpp>
+
+#include <Renderer/BlendMode.hpp>
+#include <Renderer/Mesh.hpp>
+#include <Renderer/Sampler.hpp>
+#include <Renderer/Shader.hpp>
+#include <Renderer/ShaderDefines.hpp>
+#include <Renderer/Texture.hpp>
+#include <Renderer/VertexArray.hpp>
+
+#include <gtest/gtest.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+using libprojectM::MilkdropPreset::MilkdropStaticShaders;
+using libprojectM::MilkdropPreset::PerFrameContext;
+using libprojectM::MilkdropPreset::PresetState;
+using libprojectM::MilkdropPreset::WaveformMaxPoints;
+using libprojectM::MilkdropPreset::WaveformMode;
+using libprojectM::Renderer::BlendMode;
+using libprojectM::Renderer::Mesh;
+using libprojectM::Renderer::Shader;
+
+/**
+ * Compares thick lines drawn as four instances, offset by the vertex shaders, with the former
+ * four separately offset draw calls. Both are blended additively, so each instance must be drawn
+ * exactly once at the right position. Skipped if no EGL display is available.
+ */
+class ThickLineParityTest : public ::testing::Test
+{
+protected:
+    static constexpr uint32_t Width = 256;
+    static constexpr uint32_t Height = 192;
+
+    void SetUp() override
+    {
+        if (!m_context.Create())
+        {
+            GTEST_SKIP() << "No EGL display with OpenGL 3.3 core profile support available.";
+        }
+
+        // The projectM instance loads the OpenGL functions.
+        m_renderer = std::make_unique<OffscreenRenderer>(Width, Height);
+        ASSERT_TRUE(m_renderer->Valid());
+    }
+
+    void TearDown() override
+    {
+        BlendMode::SetBlendActive(false);
+        m_renderer.reset();
+    }
+
+    /**
+     * @brief Clears the offscreen framebuffer and enables additive blending.
+     */
+    void BeginImage()
+    {
+        m_renderer->BindFramebuffer();
+        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        BlendMode::Set(true, BlendMode::Function::SourceAlpha, BlendMode::Function::One);
+    }
+
+    /**
+     * @brief Returns the image drawn since BeginImage().
+     */
+    auto EndImage() -> std::vector<uint8_t>
+    {
+        EXPECT_EQ(glGetError(), GL_NO_ERROR);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        return m_renderer->ReadPixels();
+    }
+
+    /**
+     * @brief Returns the largest difference of any color channel between two images.
+     */
+    static auto MaxDifference(const std::vector<uint8_t>& left, const std::vector<uint8_t>& right) -> int
+    {
+        int maxDifference{};
+        for (size_t index = 0; index < left.size() && index < right.size(); index++)
+        {
+            maxDifference = std::max(maxDifference, std::abs(static_cast<int>(left[index]) - static_cast<int>(right[index])));
+        }
+
+        return maxDifference;
+    }
+
+    /**
+     * @brief Returns the number of pixels with a red channel brighter than a single instance.
+     * Only pixels covered by more than one instance exceed it, so there must be some in a thick line.
+     */
+    static auto OverlappingPixels(const std::vector<uint8_t>& image) -> int
+    {
+        int count{};
+        for (size_t index = 0; index < image.size(); index += 4)
+        {
+            if (image[index] > 128)
+            {
+                count++;
+            }
+        }
+
+        return count;
+    }
+
+    /**
+     * @brief Returns the translation applied to each of the four former thick line draws.
+     * The offsets are right, bottom right and bottom of the original line, in this order.
+     */
+    static auto DrawOffsets(float incrementX, float incrementY) -> std::array<glm::vec2, 4>
+    {
+        return {glm::vec2{0.0f, 0.0f},
+                glm::vec2{incrementX, 0.0f},
+                glm::vec2{incrementX, incrementY},
+                glm::vec2{0.0f, incrementY}};
+    }
+
+    HeadlessGLContext m_context;
+    std::unique_ptr<OffscreenRenderer> m_renderer;
+};
+
+TEST_F(ThickLineParityTest, CustomShapeOutline)
+{
+    auto staticShaders = MilkdropStaticShaders::Get();
+    Shader shader;
+    shader.CompileProgram(staticShaders->GetUntexturedDrawVertexShader(), staticShaders->GetUntexturedDrawFragmentShader());
+
+    // Same increments as CustomShape::Draw().
+    auto const incrementX = 1.0f / static_cast<float>(Width);
+    auto const incrementY = 1.0f / static_cast<float>(Height);
+
+    constexpr int sides = 7;
+    std::vector<libprojectM::Renderer::Point> points(sides);
+    std::vector<libprojectM::Renderer::Color> colors(sides, {0.6f, 0.4f, 0.2f, 0.5f});
+    for (int side = 0; side < sides; side++)
+    {
+        auto const angle = static_cast<float>(side) * 6.2831853f / static_cast<float>(sides) + 0.3f;
+        points[side] = {0.6f * std::cos(angle), 0.7f * std::sin(angle)};
+    }
+
+    Mesh outline(libprojectM::Renderer::VertexBufferUsage::StreamDraw, true, false);
+    outline.SetRenderPrimitiveType(Mesh::PrimitiveType::LineLoop);
+    outline.Colors().Set(colors);
+
+    shader.Bind();
+    shader.SetUniformMat4x4("vertex_transformation", glm::mat4(1.0f));
+    shader.SetUniformFloat("vertex_point_size", 1.0f);
+
+    // The former outline drawing: shift the vertices on the CPU and draw the loop four times.
+    BeginImage();
+    shader.SetUniformFloat2("thick_offset", {0.0f, 0.0f});
+    for (auto const& offset : DrawOffsets(incrementX, incrementY))
+    {
+        std::vector<libprojectM::Renderer::Point> shiftedPoints(points);
+        for (auto& point : shiftedPoints)
+        {
+            point = {point.X() + offset.x, point.Y() + offset.y};
+        }
+        outline.Vertices().Set(shiftedPoints);
+        outline.Update();
+        outline.Draw();
+    }
+    auto const drawsImage = EndImage();
+
+    BeginImage();
+    shader.Bind();
+    shader.SetUniformFloat2("thick_offset", {incrementX, incrementY});
+    outline.Vertices().Set(points);
+    outline.Update();
+    outline.Draw(4);
+    auto const instancesImage = EndImage();
+
+    Mesh::Unbind();
+    Shader::Unbind();
+
+    EXPECT_GT(OverlappingPixels(instancesImage), 0);
+    EXPECT_EQ(MaxDifference(drawsImage, instancesImage), 0);
+}
+
+TEST_F(ThickLineParityTest, Waveform)
+{
+    PresetState presetState;
+    presetState.renderContext.viewportSizeX = Width;
+    presetState.renderContext.viewportSizeY = Height;
+    presetState.waveScale = 1.4f;
+    presetState.waveSmoothing = 0.6f;
+    for (size_t sample = 0; sample < presetState.audioData.waveformLeft.size(); sample++)
+    {
+        presetState.audioData.waveformLeft[sample] = 40.0f * std::sin(static_cast<float>(sample) * 0.07f);
+        presetState.audioData.waveformRight[sample] = 30.0f * std::cos(static_cast<float>(sample) * 0.05f);
+    }
+
+    PerFrameContext perFrameContext(presetState.globalMemory, &presetState.globalRegisters);
+    perFrameContext.RegisterBuiltinVariables();
+    perFrameContext.LoadStateVariables(presetState);
+
+    libprojectM::MilkdropPreset::Waveforms::Line line;
+    line.GetVertices(presetState, perFrameContext);
+
+    libprojectM::Renderer::ShaderDefines defines;
+    defines.Set("WAVE_MODE", static_cast<int>(WaveformMode::Line));
+
+    auto staticShaders = MilkdropStaticShaders::Get();
+    Shader shader;
+    shader.CompileProgram(defines.Apply(staticShaders->GetPresetWaveformVertexShader()),
+                          staticShaders->GetUntexturedDrawFragmentShader());
+
+    std::array<float, WaveformMaxPoints * 2> texels{};
+    line.SmoothSamples(presetState);
+    line.InterleaveSamples(texels);
+    libprojectM::Renderer::Texture sampleTexture("wave_samples", texels.data(), GL_TEXTURE_2D, WaveformMaxPoints, 1, 0,
+                                                 GL_RG32F, GL_RG, GL_FLOAT, false);
+    auto sampler = std::make_shared<libprojectM::Renderer::Sampler>(GL_CLAMP_TO_EDGE, GL_NEAREST);
+
+    // Same increments as Waveform::Draw().
+    auto const incrementX = 2.0f / static_cast<float>(Width);
+    auto const incrementY = 2.0f / static_cast<float>(Height);
+
+    auto prepareDraw = [&]() {
+        shader.Bind();
+        shader.SetUniformFloat("vertex_point_size", 1.0f);
+        shader.SetUniformFloat("time", 0.0f);
+        shader.SetUniformInt("wave_samples", 0);
+        line.SetUniforms(shader, 0);
+        sampleTexture.Bind(0, sampler);
+        glVertexAttrib4f(1, 0.6f, 0.4f, 0.2f, 0.5f);
+    };
+
+    libprojectM::Renderer::VertexArray vertexArray;
+    vertexArray.Bind();
+
+    // The vertices are generated in the shader, so the former draws are offset by the transformation.
+    BeginImage();
+    prepareDraw();
+    shader.SetUniformFloat2("thick_offset", {0.0f, 0.0f});
+    for (auto const& offset : DrawOffsets(incrementX, incrementY))
+    {
+        shader.SetUniformMat4x4("vertex_transformation", glm::translate(glm::mat4(1.0f), glm::vec3(offset, 0.0f)));
+        glDrawArrays(GL_LINE_STRIP, 0, line.VertexCount());
+    }
+    auto const drawsImage = EndImage();
+
+    BeginImage();
+    prepareDraw();
+    shader.SetUniformMat4x4("vertex_transformation", glm::mat4(1.0f));
+    shader.SetUniformFloat2("thick_offset", {incrementX, incrementY});
+    glDrawArraysInstanced(GL_LINE_STRIP, 0, line.VertexCount(), 4);
+    auto const instancesImage = EndImage();
+
+    libprojectM::Renderer::VertexArray::Unbind();
+    sampleTexture.Unbind(0);
+    libprojectM::Renderer::Sampler::Unbind(0);
+    Shader::Unbind();
+
+    EXPECT_GT(OverlappingPixels(instancesImage), 0);
+    EXPECT_EQ(MaxDifference(drawsImage, instancesImage), 0);
+}
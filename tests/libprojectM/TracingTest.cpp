@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+
+#include <Tracing.hpp>
+
+#include <string>
+#include <thread>
+
+using libprojectM::Tracing;
+
+class TracingTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        Tracing::SetEnabled(false);
+        Tracing::Clear();
+    }
+
+    void TearDown() override
+    {
+        Tracing::SetEnabled(false);
+        Tracing::Clear();
+    }
+
+    static auto CountEvents(const std::string& json, const std::string& name) -> size_t
+    {
+        auto const pattern = R"("name":")" + name + "\"";
+
+        size_t count{};
+        for (auto position = json.find(pattern); position != std::string::npos; position = json.find(pattern, position + 1))
+        {
+            count++;
+        }
+
+        return count;
+    }
+};
+
+TEST_F(TracingTest, EnabledFlag)
+{
+    EXPECT_FALSE(Tracing::IsEnabled());
+
+    Tracing::SetEnabled(true);
+    EXPECT_TRUE(Tracing::IsEnabled());
+
+    Tracing::SetEnabled(false);
+    EXPECT_FALSE(Tracing::IsEnabled());
+}
+
+TEST_F(TracingTest, EmptyTrace)
+{
+    EXPECT_EQ(Tracing::ExportChromeTrace(10.0), R"({"traceEvents":[],"displayTimeUnit":"ms"})");
+}
+
+TEST_F(TracingTest, RecordEvent)
+{
+    auto const end = Tracing::Now();
+    Tracing::Record("RecordEvent", end - 1500, end);
+
+    auto const json = Tracing::ExportChromeTrace(10.0);
+    EXPECT_EQ(CountEvents(json, "RecordEvent"), 1);
+    EXPECT_NE(json.find(R"("ph":"X")"), std::string::npos);
+    EXPECT_NE(json.find(R"("dur":1.500)"), std::string::npos);
+}
+
+TEST_F(TracingTest, ScopeWhileDisabled)
+{
+    {
+        Tracing::Scope scope("DisabledScope");
+    }
+
+    EXPECT_EQ(CountEvents(Tracing::ExportChromeTrace(10.0), "DisabledScope"), 0);
+}
+
+TEST_F(TracingTest, ScopeWhileEnabled)
+{
+    Tracing::SetEnabled(true);
+    {
+        Tracing::Scope scope("EnabledScope");
+    }
+    {
+        Tracing::Scope scope("EnabledScope");
+    }
+
+    EXPECT_EQ(CountEvents(Tracing::ExportChromeTrace(10.0), "EnabledScope"), 2);
+}
+
+TEST_F(TracingTest, ScopeEnteredBeforeEnabling)
+{
+    {
+        Tracing::Scope scope("LateScope");
+        Tracing::SetEnabled(true);
+    }
+
+    EXPECT_EQ(CountEvents(Tracing::ExportChromeTrace(10.0), "LateScope"), 0);
+}
+
+TEST_F(TracingTest, TimeWindow)
+{
+    auto const now = Tracing::Now();
+    Tracing::Record("OldEvent", now - 3000000000, now - 2000000000);
+    Tracing::Record("NewEvent", now - 1000, now);
+
+    auto const json = Tracing::ExportChromeTrace(1.0);
+    EXPECT_EQ(CountEvents(json, "OldEvent"), 0);
+    EXPECT_EQ(CountEvents(json, "NewEvent"), 1);
+}
+
+TEST_F(TracingTest, Clear)
+{
+    auto const now = Tracing::Now();
+    Tracing::Record("ClearedEvent", now - 1000, now);
+    Tracing::Clear();
+
+    EXPECT_EQ(CountEvents(Tracing::ExportChromeTrace(10.0), "ClearedEvent"), 0);
+}
+
+TEST_F(TracingTest, EscapeNames)
+{
+    auto const now = Tracing::Now();
+    Tracing::Record(R"(Quote"Back\slash)", now - 1000, now);
+
+    EXPECT_NE(Tracing::ExportChromeTrace(10.0).find(R"("name":"Quote\"Back\\slash")"), std::string::npos);
+}
+
+TEST_F(TracingTest, RingBufferOverflow)
+{
+    auto const now = Tracing::Now();
+    for (int event = 0; event < 20000; event++)
+    {
+        Tracing::Record("OverflowEvent", now - 1000, now);
+    }
+
+    EXPECT_EQ(CountEvents(Tracing::ExportChromeTrace(10.0), "OverflowEvent"), 16384);
+}
+
+TEST_F(TracingTest, MultipleThreads)
+{
+    Tracing::SetEnabled(true);
+
+    std::thread thread([]() {
+        Tracing::Scope scope("OtherThread");
+    });
+    thread.join();
+
+    {
+        Tracing::Scope scope("MainThread");
+    }
+
+    auto const json = Tracing::ExportChromeTrace(10.0);
+    EXPECT_EQ(CountEvents(json, "OtherThread"), 1);
+    EXPECT_EQ(CountEvents(json, "MainThread"), 1);
+}
+
+TEST_F(TracingTest, DisabledScopeRecordsNoEvents)
+{
+    for (int iteration = 0; iteration < 1000; iteration++)
+    {
+        Tracing::Scope scope("Disabled");
+    }
+
+    EXPECT_EQ(CountEvents(Tracing::ExportChromeTrace(10.0), "Disabled"), 0);
+}
@@ -0,0 +1,463 @@
+#include "HeadlessGLContext.hpp"
+#include "OffscreenRenderer.hpp"
+
+#include <MilkdropPreset/PerFrameContext.hpp>
+#include <MilkdropPreset/PresetState.hpp>
+#include <MilkdropPreset/Waveforms/Circle.hpp>
+#include <MilkdropPreset/Waveforms/DoubleLine.hpp>
+#include <MilkdropPreset/Waveforms/Line.hpp>
+#include <MilkdropPreset/Waveforms/Milkdrop2077Wave11.hpp>
+#include <MilkdropPreset/Waveforms/Milkdrop2077WaveFlower.hpp>
+#include <MilkdropPreset/Waveforms/Milkdrop2077WaveStar.hpp>
+#include <MilkdropPreset/Waveforms/Milkdrop2077WaveX.hpp>
+#include <MilkdropPreset/Waveforms/SpectrumLine.hpp>
+
+#include <MilkdropStaticShaders.hpp>
+
+#include <Renderer/Sampler.hpp>
+#include <Renderer/Shader.hpp>
+#include <Renderer/ShaderDefines.hpp>
+#include <Renderer/Texture.hpp>
+#include <Renderer/VertexArray.hpp>
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+using libprojectM::MilkdropPreset::MilkdropStaticShaders;
+using libprojectM::MilkdropPreset::PerFrameContext;
+using libprojectM::MilkdropPreset::PresetState;
+using libprojectM::MilkdropPreset::WaveformMaxPoints;
+using libprojectM::MilkdropPreset::WaveformMode;
+using libprojectM::MilkdropPreset::Waveforms::WaveformMath;
+
+namespace {
+
+/**
+ * The circle waveform with the vertex math of the former CPU implementation.
+ */
+class ReferenceCircle : public libprojectM::MilkdropPreset::Waveforms::Circle
+{
+protected:
+    void GenerateVertices(const PresetState& presetState, const PerFrameContext&) override
+    {
+        m_wave1Vertices.resize(m_samples);
+
+        const float inverseSamplesMinusOne{1.0f / static_cast<float>(m_samples)};
+
+        for (int i = 0; i < m_samples; i++)
+        {
+            float radius = 0.5f + 0.4f * m_pcmDataR[i + m_sampleOffset] + m_mysteryWaveParam;
+            float const angle = static_cast<float>(i) * inverseSamplesMinusOne * 6.28f + presetState.renderContext.time * 0.2f;
+            if (i < m_samples / 10)
+            {
+                float mix = static_cast<float>(i) / (static_cast<float>(m_samples) * 0.1f);
+                mix = 0.5f - 0.5f * cosf(mix * 3.1416f);
+                float const radius2 = 0.5f + 0.4f * m_pcmDataR[i + m_samples + m_sampleOffset] + m_mysteryWaveParam;
+                radius = radius2 * (1.0f - mix) + radius * (mix);
+            }
+
+            m_wave1Vertices[i] = {
+                radius * cosf(angle) * m_aspectY + m_waveX,
+                radius * sinf(angle) * m_aspectX + m_waveY};
+        }
+    }
+};
+
+/**
+ * The line waveform with the vertex math of the former CPU implementation.
+ */
+class ReferenceLine : public libprojectM::MilkdropPreset::Waveforms::Line
+{
+protected:
+    void GenerateVertices(const PresetState&, const PerFrameContext&) override
+    {
+        m_wave1Vertices.resize(m_samples);
+
+        const auto& line = m_lines[0];
+        for (int i = 0; i < m_samples; i++)
+        {
+            m_wave1Vertices[i] = {
+                line.edge.x + line.distance.x * static_cast<float>(i) + line.perpendicular.x * 0.25f * m_pcmDataL[i + m_sampleOffset],
+                line.edge.y + line.distance.y * static_cast<float>(i) + line.perpendicular.y * 0.25f * m_pcmDataL[i + m_sampleOffset]};
+        }
+    }
+};
+
+/**
+ * The double line waveform with the vertex math of the former CPU implementation.
+ */
+class ReferenceDoubleLine : public libprojectM::MilkdropPreset::Waveforms::DoubleLine
+{
+protected:
+    void GenerateVertices(const PresetState&, const PerFrameContext&) override
+    {
+        m_wave1Vertices.resize(m_samples);
+        m_wave2Vertices.resize(m_samples);
+
+        const auto& line = m_lines[0];
+        float const separation = powf(m_waveY * 0.5f + 0.5f, 2.0f);
+        for (int i = 0; i < m_samples; i++)
+        {
+            m_wave1Vertices[i] = {
+                line.edge.x + line.distance.x * static_cast<float>(i) +
+                    line.perpendicular.x * (0.25f * m_pcmDataL[i + m_sampleOffset] + separation),
+                line.edge.y + line.distance.y * static_cast<float>(i) +
+                    line.perpendicular.y * (0.25f * m_pcmDataL[i + m_sampleOffset] + separation)};
+
+            m_wave2Vertices[i] = {
+                line.edge.x + line.distance.x * static_cast<float>(i) +
+                    line.perpendicular.x * (0.25f * m_pcmDataR[i + m_sampleOffset] - separation),
+                line.edge.y + line.distance.y * static_cast<float>(i) +
+                    line.perpendicular.y * (0.25f * m_pcmDataR[i + m_sampleOffset] - separation)};
+        }
+    }
+};
+
+/**
+ * The Milkdrop2077 "X" waveform with the vertex math of the former CPU implementation.
+ */
+class ReferenceMilkdrop2077WaveX : public libprojectM::MilkdropPreset::Waveforms::Milkdrop2077WaveX
+{
+protected:
+    void GenerateVertices(const PresetState&, const PerFrameContext&) override
+    {
+        m_wave1Vertices.resize(m_samples);
+        m_wave2Vertices.resize(m_samples);
+
+        const auto& line1 = m_lines[0];
+        for (int i = 0; i < m_samples; i++)
+        {
+            m_wave1Vertices[i] = {
+                line1.edge.x + line1.distance.x * static_cast<float>(i) + line1.perpendicular.x * 0.35f * m_pcmDataL[i + m_sampleOffset],
+                line1.edge.y + line1.distance.y * static_cast<float>(i) + line1.perpendicular.y * 0.35f * m_pcmDataL[i + m_sampleOffset]};
+        }
+
+        const auto& line2 = m_lines[1];
+        for (int i = 0; i < m_samples; i++)
+        {
+            m_wave2Vertices[i] = {
+                line2.edge.x + line2.distance.x * static_cast<float>(i) + line2.perpendicular.x * 0.35f * m_pcmDataR[i + m_sampleOffset],
+                line2.edge.y + line2.distance.y * static_cast<float>(i) + line2.perpendicular.y * 0.35f * m_pcmDataR[i + m_sampleOffset]};
+        }
+    }
+};
+
+/**
+ * The Milkdrop2077 wave 11 with the vertex math of the former CPU implementation.
+ */
+class ReferenceMilkdrop2077Wave11 : public libprojectM::MilkdropPreset::Waveforms::Milkdrop2077Wave11
+{
+protected:
+    void GenerateVertices(const PresetState&, const PerFrameContext&) override
+    {
+        m_wave1Vertices.resize(m_samples);
+        m_wave2Vertices.resize(m_samples);
+
+        const auto& line = m_lines[0];
+        for (int i = 0; i < m_samples; i++)
+        {
+            m_wave1Vertices[i] = {
+                line.edge.x - 0.45f + line.distance.x * static_cast<float>(i) + line.perpendicular.x * 0.35f * m_pcmDataL[i + m_sampleOffset],
+                line.edge.y + line.distance.y * static_cast<float>(i) + line.perpendicular.y * 0.35f * m_pcmDataL[i + m_sampleOffset]};
+            m_wave2Vertices[i] = {
+                line.edge.x + 0.45f + line.distance.x * static_cast<float>(i) + line.perpendicular.x * 0.35f * m_pcmDataR[i + m_sampleOffset],
+                line.edge.y + line.distance.y * static_cast<float>(i) + line.perpendicular.y * 0.35f * m_pcmDataR[i + m_sampleOffset]};
+        }
+    }
+};
+
+/**
+ * The spectrum line waveform with the vertex math of the former CPU implementation.
+ */
+class ReferenceSpectrumLine : public libprojectM::MilkdropPreset::Waveforms::SpectrumLine
+{
+protected:
+    void GenerateVertices(const PresetState&, const PerFrameContext&) override
+    {
+        m_wave1Vertices.resize(m_samples);
+
+        const auto& line = m_lines[0];
+        for (size_t i = 0; i < static_cast<size_t>(m_samples); i++)
+        {
+            const float f = 0.1f * logf(m_pcmDataL[i * 2] + m_pcmDataL[i * 2 + 1]);
+            m_wave1Vertices[i] = {
+                line.edge.x + line.distance.x * static_cast<float>(i) + line.perpendicular.x * f,
+                line.edge.y + line.distance.y * static_cast<float>(i) + line.perpendicular.y * f};
+        }
+    }
+};
+
+/**
+ * The Milkdrop2077 star waveform with the vertex math of the former CPU implementation.
+ */
+class ReferenceMilkdrop2077WaveStar : public libprojectM::MilkdropPreset::Waveforms::Milkdrop2077WaveStar
+{
+protected:
+    void GenerateVertices(const PresetState& presetState, const PerFrameContext&) override
+    {
+        m_wave1Vertices.resize(m_samples + 1);
+
+        float const invertedSamplesMinusOne = 1.0f / static_cast<float>(m_samples - 1);
+        float const tenthSamples = static_cast<float>(m_samples) * 0.1f;
+
+        for (int sample = 0; sample < m_samples; sample++)
+        {
+            float radius = 0.7f + 0.4f * m_pcmDataR[sample + m_sampleOffset] + m_mysteryWaveParam;
+            float const angle = static_cast<float>(sample) * invertedSamplesMinusOne * 6.28f + presetState.renderContext.time * 0.2f;
+            if (static_cast<float>(sample) < m_samples / radius)
+            {
+                float mix = static_cast<float>(sample) / tenthSamples;
+                mix = 0.5f - 0.5f * cosf(mix * 3.1416f);
+                float const radius2 = 0.5f + 0.4f * m_pcmDataR[sample + m_samples - m_sampleOffset] + m_mysteryWaveParam;
+                radius = radius2 * (1.0f - mix) + radius * mix;
+            }
+            m_wave1Vertices[sample] = {radius * cosf(angle) * m_aspectY + m_waveX,
+                                       radius * sinf(angle) * m_aspectX + m_waveY};
+        }
+    }
+};
+
+/**
+ * The Milkdrop2077 flower waveform with the vertex math of the former CPU implementation.
+ */
+class ReferenceMilkdrop2077WaveFlower : public libprojectM::MilkdropPreset::Waveforms::Milkdrop2077WaveFlower
+{
+protected:
+    void GenerateVertices(const PresetState& presetState, const PerFrameContext&) override
+    {
+        m_wave1Vertices.resize(m_samples + 1);
+
+        float const invertedSamplesMinusOne = 1.0f / static_cast<float>(m_samples - 1);
+        float const tenthSamples = static_cast<float>(m_samples) * 0.1f;
+
+        for (int sample = 0; sample < m_samples; sample++)
+        {
+            float radius = 0.7f + 0.7f * m_pcmDataR[sample + m_sampleOffset] + m_mysteryWaveParam;
+            float angle = static_cast<float>(sample) * invertedSamplesMinusOne * 6.28f + presetState.renderContext.time * 0.2f;
+            if (static_cast<float>(sample) < static_cast<float>(m_samples) / radius)
+            {
+                float mix = static_cast<float>(sample) / tenthSamples;
+                mix = 0.7f - 0.7f * cosf(mix * 3.1416f);
+                float const radius2 = 0.7f + 0.7f * m_pcmDataR[sample + m_samples - m_sampleOffset] + m_mysteryWaveParam;
+                radius = radius2 * (1.0f - mix) + radius * mix * .25f;
+            }
+
+            m_wave1Vertices[sample] = {
+                radius * cosf(angle * 3.1416f) * m_aspectY / 1.5f + m_waveX * cosf(3.1416f),
+                radius * sinf(angle - presetState.renderContext.time / 3.0f) * m_aspectX / 1.5f + m_waveY * cosf(3.1416f)};
+        }
+    }
+};
+
+} // namespace
+
+/**
+ * Compares the waveform vertex shader output, captured with transform feedback, with the
+ * vertices calculated by the former CPU implementation. Skipped if no EGL display is available.
+ */
+class WaveformParityTest : public ::testing::Test
+{
+protected:
+    static constexpr uint32_t Width = 256;
+    static constexpr uint32_t Height = 192;
+
+    void SetUp() override
+    {
+        if (!m_context.Create())
+        {
+            GTEST_SKIP() << "No EGL display with OpenGL 3.3 core profile support available.";
+        }
+
+        // The projectM instance loads the OpenGL functions.
+        m_renderer = std::make_unique<OffscreenRenderer>(Width, Height);
+        ASSERT_TRUE(m_renderer->Valid());
+
+        m_presetState = std::make_unique<PresetState>();
+        m_presetState->renderContext.viewportSizeX = Width;
+        m_presetState->renderContext.viewportSizeY = Height;
+        m_presetState->renderContext.time = 1.3f;
+        m_presetState->waveScale = 1.4f;
+        m_presetState->waveSmoothing = 0.6f;
+
+        auto& audioData = m_presetState->audioData;
+        for (size_t sample = 0; sample < audioData.waveformLeft.size(); sample++)
+        {
+            audioData.waveformLeft[sample] = 40.0f * std::sin(static_cast<float>(sample) * 0.07f);
+            audioData.waveformRight[sample] = 30.0f * std::cos(static_cast<float>(sample) * 0.05f);
+        }
+
+        // Spectrum waveforms take the logarithm of the samples, so they must be positive.
+        for (size_t sample = 0; sample < audioData.spectrumLeft.size(); sample++)
+        {
+            audioData.spectrumLeft[sample] = 20.0f + 15.0f * std::sin(static_cast<float>(sample) * 0.11f);
+            audioData.spectrumRight[sample] = 20.0f + 15.0f * std::cos(static_cast<float>(sample) * 0.13f);
+        }
+
+        m_perFrameContext = std::make_unique<PerFrameContext>(m_presetState->globalMemory, &m_presetState->globalRegisters);
+        m_perFrameContext->RegisterBuiltinVariables();
+        m_perFrameContext->LoadStateVariables(*m_presetState);
+        *m_perFrameContext->wave_x = 0.45;
+        *m_perFrameContext->wave_y = 0.55;
+        *m_perFrameContext->wave_mystery = 0.2;
+    }
+
+    void TearDown() override
+    {
+        m_perFrameContext.reset();
+        m_presetState.reset();
+        m_renderer.reset();
+    }
+
+    /**
+     * @brief Runs the waveform vertex shader and returns the positions of the given wave.
+     * The samples are smoothed and uploaded the same way as in Waveform::DrawWithVertexShader().
+     */
+    auto CaptureShaderVertices(WaveformMath& waveformMath, WaveformMode mode, int wave) -> std::vector<glm::vec2>
+    {
+        libprojectM::Renderer::ShaderDefines defines;
+        defines.Set("WAVE_MODE", static_cast<int>(mode));
+
+        auto staticShaders = MilkdropStaticShaders::Get();
+        libprojectM::Renderer::Shader shader;
+        shader.SetTransformFeedbackVaryings({"gl_Position"});
+        shader.CompileProgram(defines.Apply(staticShaders->GetPresetWaveformVertexShader()),
+                              staticShaders->GetUntexturedDrawFragmentShader());
+        shader.Bind();
+
+        shader.SetUniformMat4x4("vertex_transformation", glm::mat4(1.0f));
+        shader.SetUniformFloat("vertex_point_size", 1.0f);
+        shader.SetUniformFloat2("thick_offset", {0.0f, 0.0f});
+        shader.SetUniformFloat("time", m_presetState->renderContext.time);
+        shader.SetUniformInt("wave_samples", 0);
+        waveformMath.SetUniforms(shader, wave);
+
+        std::array<float, WaveformMaxPoints * 2> texels{};
+        waveformMath.SmoothSamples(*m_presetState);
+        waveformMath.InterleaveSamples(texels);
+        libprojectM::Renderer::Texture sampleTexture("wave_samples", texels.data(), GL_TEXTURE_2D, WaveformMaxPoints, 1, 0,
+                                                     GL_RG32F, GL_RG, GL_FLOAT, false);
+        auto sampler = std::make_shared<libprojectM::Renderer::Sampler>(GL_CLAMP_TO_EDGE, GL_NEAREST);
+        sampleTexture.Bind(0, sampler);
+
+        auto const vertexCount = waveformMath.VertexCount();
+
+        GLuint feedbackBuffer{};
+        glGenBuffers(1, &feedbackBuffer);
+        glBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, feedbackBuffer);
+        glBufferData(GL_TRANSFORM_FEEDBACK_BUFFER, static_cast<GLsizeiptr>(vertexCount * sizeof(glm::vec4)), nullptr, GL_STATIC_READ);
+        glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, feedbackBuffer);
+
+        // Drawing requires a complete framebuffer, even if nothing is rasterized. The surfaceless
+        // context has no default framebuffer.
+        m_renderer->BindFramebuffer();
+
+        libprojectM::Renderer::VertexArray vertexArray;
+        vertexArray.Bind();
+        glEnable(GL_RASTERIZER_DISCARD);
+        glBeginTransformFeedback(GL_POINTS);
+        glDrawArrays(GL_POINTS, 0, vertexCount);
+        glEndTransformFeedback();
+        glDisable(GL_RASTERIZER_DISCARD);
+        libprojectM::Renderer::VertexArray::Unbind();
+
+        std::vector<glm::vec4> positions(vertexCount);
+        glGetBufferSubData(GL_TRANSFORM_FEEDBACK_BUFFER, 0, static_cast<GLsizeiptr>(positions.size() * sizeof(glm::vec4)), positions.data());
+        glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+        glDeleteBuffers(1, &feedbackBuffer);
+        EXPECT_EQ(glGetError(), GL_NO_ERROR);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        sampleTexture.Unbind(0);
+        libprojectM::Renderer::Sampler::Unbind(0);
+        libprojectM::Renderer::Shader::Unbind();
+
+        std::vector<glm::vec2> vertices;
+        for (const auto& position : positions)
+        {
+            vertices.emplace_back(position.x, position.y);
+        }
+
+        return vertices;
+    }
+
+    /**
+     * @brief Compares the CPU reference vertices of each wave with the vertex shader output.
+     */
+    void ExpectParity(WaveformMath& referenceMath, WaveformMode mode, int expectedWaveCount = 1)
+    {
+        auto const referenceWaves = referenceMath.GetVertices(*m_presetState, *m_perFrameContext);
+        ASSERT_EQ(referenceMath.WaveCount(), expectedWaveCount);
+
+        for (int wave = 0; wave < referenceMath.WaveCount(); wave++)
+        {
+            auto const& referenceVertices = referenceWaves.at(wave);
+            auto const shaderVertices = CaptureShaderVertices(referenceMath, mode, wave);
+
+            ASSERT_FALSE(referenceVertices.empty()) << "Wave " << wave;
+            ASSERT_EQ(shaderVertices.size(), referenceVertices.size()) << "Wave " << wave;
+            for (size_t index = 0; index < referenceVertices.size(); index++)
+            {
+                EXPECT_NEAR(shaderVertices[index].x, referenceVertices[index].X(), 1e-4f) << "Wave " << wave << ", vertex " << index;
+                EXPECT_NEAR(shaderVertices[index].y, referenceVertices[index].Y(), 1e-4f) << "Wave " << wave << ", vertex " << index;
+            }
+        }
+    }
+
+    HeadlessGLContext m_context;
+    std::unique_ptr<OffscreenRenderer> m_renderer;
+    std::unique_ptr<PresetState> m_presetState;
+    std::unique_ptr<PerFrameContext> m_perFrameContext;
+};
+
+TEST_F(WaveformParityTest, Circle)
+{
+    ReferenceCircle circle;
+    ExpectParity(circle, WaveformMode::Circle);
+}
+
+TEST_F(WaveformParityTest, Line)
+{
+    ReferenceLine line;
+    ExpectParity(line, WaveformMode::Line);
+}
+
+TEST_F(WaveformParityTest, DoubleLine)
+{
+    ReferenceDoubleLine doubleLine;
+    ExpectParity(doubleLine, WaveformMode::DoubleLine, 2);
+}
+
+TEST_F(WaveformParityTest, SpectrumLine)
+{
+    ReferenceSpectrumLine spectrumLine;
+    ExpectParity(spectrumLine, WaveformMode::SpectrumLine);
+}
+
+TEST_F(WaveformParityTest, Milkdrop2077WaveX)
+{
+    ReferenceMilkdrop2077WaveX waveX;
+    ExpectParity(waveX, WaveformMode::Milkdrop2077WaveX, 2);
+}
+
+TEST_F(WaveformParityTest, Milkdrop2077Wave11)
+{
+    ReferenceMilkdrop2077Wave11 wave11;
+    ExpectParity(wave11, WaveformMode::Milkdrop2077Wave11, 2);
+}
+
+TEST_F(WaveformParityTest, Milkdrop2077WaveStar)
+{
+    ReferenceMilkdrop2077WaveStar star;
+    ExpectParity(star, WaveformMode::Milkdrop2077WaveStar);
+}
+
+TEST_F(WaveformParityTest, Milkdrop2077WaveFlower)
+{
+    ReferenceMilkdrop2077WaveFlower flower;
+    ExpectParity(flower, WaveformMode::Milkdrop2077WaveFlower);
+}
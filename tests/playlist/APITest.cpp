@@ -229,6 +229,18 @@ TEST(projectMPlaylistAPI, InsertPath)
 }
 
 
+TEST(projectMPlaylistAPI, UsePresetIndex)
+{
+    PlaylistCWrapperMock mockPlaylist;
+
+    auto* presetIndex = reinterpret_cast<projectm_preset_index_handle>(0x1234);
+    EXPECT_CALL(mockPlaylist, UsePresetIndex(presetIndex))
+        .Times(1);
+
+    projectm_playlist_use_preset_index(reinterpret_cast<projectm_playlist_handle>(&mockPlaylist), presetIndex);
+}
+
+
 TEST(projectMPlaylistAPI, AddPreset)
 {
     PlaylistCWrapperMock mockPlaylist;
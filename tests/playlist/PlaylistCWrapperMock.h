@@ -20,6 +20,7 @@ public:
     MOCK_METHOD(const std::vector<libprojectM::Playlist::Item>&, Items, (), (const));
     MOCK_METHOD(bool, AddItem, (const std::string&, uint32_t, bool) );
     MOCK_METHOD(uint32_t, AddPath, (const std::string&, uint32_t, bool, bool) );
+    MOCK_METHOD(void, UsePresetIndex, (projectm_preset_index_handle) );
     MOCK_METHOD(bool, RemoveItem, (uint32_t));
     MOCK_METHOD(bool, Shuffle, (), (const));
     MOCK_METHOD(void, SetShuffle, (bool) );
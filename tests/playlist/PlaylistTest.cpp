@@ -261,6 +261,23 @@ TEST(projectMPlaylistPlaylist, AddPathNonRecursivelyNoDuplicates)
 }
 
 
+TEST(projectMPlaylistPlaylist, AddPathFromPresetIndex)
+{
+    Playlist playlist;
+    playlist.UsePresetIndex(reinterpret_cast<projectm_preset_index_handle>(0x1234));
+
+    // The mocked index returns a single preset instead of the four files in the directory.
+    EXPECT_EQ(playlist.AddPath(PROJECTM_PLAYLIST_TEST_DATA_DIR "/presets", 0, true, false), 1);
+
+    ASSERT_EQ(playlist.Size(), 1);
+    EXPECT_EQ(playlist.Items().at(0).Filename(), PROJECTM_PLAYLIST_TEST_DATA_DIR "/presets/Indexed.milk");
+
+    playlist.UsePresetIndex(nullptr);
+
+    EXPECT_EQ(playlist.AddPath(PROJECTM_PLAYLIST_TEST_DATA_DIR "/presets", 0, true, false), 4);
+}
+
+
 TEST(projectMPlaylistPlaylist, RemoveItemFromEnd)
 {
     Playlist playlist;
@@ -6,6 +6,9 @@
 #include <projectM-4/projectM.h>
 #include <projectM-4/projectM_export.h>
 
+#include <cstring>
+#include <string>
+
 PROJECTM_EXPORT void projectm_set_preset_switch_requested_event_callback(projectm_handle,
                                                          projectm_preset_switch_requested_event,
                                                          void*)
@@ -22,3 +25,34 @@ PROJECTM_EXPORT void projectm_load_preset_file(projectm_handle, const char*,
                                bool)
 {
 }
+
+PROJECTM_EXPORT char** projectm_list_files(const char*, const char*, bool)
+{
+    return nullptr;
+}
+
+/**
+ * Pretends any path is indexed and contains a single preset named "Indexed.milk".
+ */
+PROJECTM_EXPORT char** projectm_preset_index_list(projectm_preset_index_handle, const char* path, bool)
+{
+    std::string const preset = std::string(path) + "/Indexed.milk";
+    auto* array = new char*[2]{};
+    array[0] = new char[preset.length() + 1];
+    std::strcpy(array[0], preset.c_str());
+    return array;
+}
+
+PROJECTM_EXPORT void projectm_free_string_array(char** array)
+{
+    if (array == nullptr)
+    {
+        return;
+    }
+
+    for (int index = 0; array[index] != nullptr; index++)
+    {
+        delete[] array[index];
+    }
+    delete[] array;
+}